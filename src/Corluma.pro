@@ -211,28 +211,13 @@ ICON = images/icon.icns
 # Sources
 #----------
 
+# everything that does not need QtWidgets, shared with the daemon
+include(backend.pri)
+
 SOURCES += main.cpp \
     colorpicker/colorpicker.cpp \
-    comm/arducor/arducordiscovery.cpp \
-    comm/arducor/arducorpacketparser.cpp \
-    comm/arducor/controller.cpp \
-    comm/arducor/crccalculator.cpp \
-    comm/commarducor.cpp \
-    comm/commhttp.cpp \
-    comm/commudp.cpp \
-    comm/commtype.cpp \
-    comm/commhue.cpp \
-    comm/commnanoleaf.cpp \
-    comm/commlayer.cpp \
-    comm/datasync.cpp \
-    comm/datasynchue.cpp \
-    comm/datasyncarduino.cpp \
-    comm/datasyncnanoleaf.cpp \
-    comm/datasynctimeout.cpp \
     comm/nanoleaf/leafeffectcontainer.cpp \
-    comm/nanoleaf/leafmetadata.cpp \
     comm/nanoleaf/leafpanelimage.cpp \
-    comm/upnpdiscovery.cpp \
     colorpicker/rgbsliders.cpp \
     colorpicker/tempbrightsliders.cpp \
     colorpicker/colorschemecircles.cpp \
@@ -243,13 +228,8 @@ SOURCES += main.cpp \
     colorpicker/colorwheel.cpp \
     colorpicker/schemegenerator.cpp \
     controllerwidget.cpp \
-    cor/lightlist.cpp \
     cor/widgets/loadingscreen.cpp \
     cor/widgets/palettewidget.cpp \
-    data/appdata.cpp \
-    data/groupdata.cpp \
-    data/mooddata.cpp \
-    data/palettedata.cpp \
     debugconnectionspoofer.cpp \
     discovery/discoveryhuewidget.cpp \
     discovery/discoverynanoleafwidget.cpp \
@@ -259,7 +239,6 @@ SOURCES += main.cpp \
     display/displaypreviewbridgewidget.cpp \
     cor/widgets/slider.cpp \
     cor/widgets/listwidget.cpp \
-    cor/jsonsavedata.cpp \
     cor/widgets/lightvectorwidget.cpp \
     cor/listlayout.cpp \
     cor/widgets/groupbutton.cpp \
@@ -295,22 +274,16 @@ SOURCES += main.cpp \
     mooddetailedwidget.cpp \
     moodsyncwidget.cpp \
     stateobserver.cpp \
-    data/subgroupdata.cpp \
     storedpalettewidget.cpp \
     timeoutpage.cpp \
     utils/painterutils.cpp \
     utils/qt.cpp \
-    utils/cormath.cpp \
     comm/hue/lightdiscovery.cpp \
-    comm/hue/bridgediscovery.cpp \
-    comm/hue/bridge.cpp \
     comm/hue/hueinfowidget.cpp \
     comm/hue/bridgegroupswidget.cpp \
     comm/hue/bridgescheduleswidget.cpp \
     comm/hue/huegroupwidget.cpp \
     comm/hue/hueschedulewidget.cpp \
-    comm/nanoleaf/leafdiscovery.cpp \
-    comm/syncstatus.cpp \
     globalbrightnesswidget.cpp \
     mainwindow.cpp \
     settingspage.cpp \
@@ -326,7 +299,6 @@ SOURCES += main.cpp \
     palettepage.cpp \
     moodpage.cpp \
     lightinfolistwidget.cpp \
-    appsettings.cpp \
     listsimplegroupwidget.cpp \
     nowifiwidget.cpp \
     listmoodpreviewwidget.cpp \
@@ -343,39 +315,14 @@ SOURCES += main.cpp \
     lightinfoscrollarea.cpp \
     touchlistener.cpp
 
-HEADERS  +=  comm/arducor/arducordiscovery.h \
-    colorpicker/colorpicker.h \
-    comm/arducor/arducormetadata.h \
-    comm/arducor/arducorpacketparser.h \
-    comm/arducor/controller.h \
-    comm/arducor/crccalculator.h \
-    comm/commtype.h \
-    comm/commarducor.h \
-    comm/commhttp.h \
-    comm/commudp.h \
-    comm/commhue.h \
-    comm/commnanoleaf.h \
-    comm/commlayer.h \
-    comm/datasync.h \
-    comm/datasynchue.h \
-    comm/datasyncarduino.h \
-    comm/datasyncnanoleaf.h \
-    comm/datasynctimeout.h \
+HEADERS  +=  colorpicker/colorpicker.h \
     comm/hue/bridgebutton.h \
-    comm/hue/command.h \
-    comm/hue/huemetadata.h \
-    comm/hue/schedule.h \
-    comm/nanoleaf/leafeffect.h \
     comm/nanoleaf/leafeffectcontainer.h \
     comm/nanoleaf/leafeffectpage.h \
     comm/nanoleaf/leafeffectscrollarea.h \
     comm/nanoleaf/leafeffectwidget.h \
-    comm/nanoleaf/leafmetadata.h \
-    comm/nanoleaf/leafpacketparser.h \
     comm/nanoleaf/leafpanelimage.h \
-    comm/nanoleaf/leafprotocols.h \
     comm/nanoleaf/leafschedulewidget.h \
-    comm/upnpdiscovery.h \
     colorpicker/rgbsliders.h \
     colorpicker/tempbrightsliders.h \
     colorpicker/colorschemecircles.h \
@@ -387,35 +334,23 @@ HEADERS  +=  comm/arducor/arducordiscovery.h \
     colorpicker/schemegenerator.h \
     connectionbutton.h \
     controllerwidget.h \
-    cor/lightlist.h \
-    cor/objects/groupstate.h \
-    cor/objects/lightid.h \
-    cor/objects/palettegroup.h \
-    cor/objects/uuid.h \
     cor/stylesheets.h \
     cor/widgets/expandingtextscrollarea.h \
     cor/widgets/loadingscreen.h \
     cor/widgets/palettecolorpicker.h \
     cor/widgets/palettewidget.h \
+    cor/widgets/rendercache.h \
     cor/widgets/widgetoutlinebox.h \
-    data/appdata.h \
-    data/groupdata.h \
-    data/groupparentdata.h \
-    data/lightorphandata.h \
-    data/mooddata.h \
-    data/moodparentdata.h \
-    data/palettedata.h \
     debugconnectionspoofer.h \
     discovery/discoveryhuewidget.h \
     discovery/discoverynanoleafwidget.h \
     discovery/discoverytopmenu.h \
     discovery/discoverytypewidget.h \
     discovery/discoveryarducorwidget.h \
-    cor/protocols.h \
-    cor/range.h \
-    cor/jsonsavedata.h \
+    cor/routinesimulator.h \
     cor/listlayout.h \
-    cor/dictionary.h \
+    cor/virtuallist.h \
+    cor/contenthash.h \
     discoverywidget.h \
     display/displayarducorcontrollerwidget.h \
     display/displayhuebridgewidget.h \
@@ -490,27 +425,15 @@ HEADERS  +=  comm/arducor/arducordiscovery.h \
     singlelightbrightnesswidget.h \
     speedwidget.h \
     stateobserver.h \
-    data/subgroupdata.h \
     storedpalettewidget.h \
     timeobserver.h \
     timeoutpage.h \
-    utils/exception.h \
     comm/hue/lightdiscovery.h \
-    comm/hue/bridgediscovery.h \
-    comm/hue/hueprotocols.h \
-    comm/hue/bridge.h \
     comm/hue/hueinfowidget.h \
     comm/hue/bridgegroupswidget.h \
     comm/hue/bridgescheduleswidget.h \
     comm/hue/huegroupwidget.h \
     comm/hue/hueschedulewidget.h \
-    comm/nanoleaf/panels.h \
-    comm/nanoleaf/rhythmcontroller.h \
-    comm/nanoleaf/leafdiscovery.h \
-    comm/nanoleaf/leafdate.h \
-    comm/nanoleaf/leafschedule.h \
-    comm/nanoleaf/leafaction.h \
-    comm/syncstatus.h \
     mainwindow.h \
     settingspage.h \
     icondata.h \
@@ -524,13 +447,10 @@ HEADERS  +=  comm/arducor/arducordiscovery.h \
     palettepage.h \
     moodpage.h \
     lightinfolistwidget.h \
-    appsettings.h \
     listsimplegroupwidget.h \
     nowifiwidget.h \
     listmoodpreviewwidget.h \
     utils/painterutils.h \
-    utils/reachability.h \
-    utils/color.h \
     utils/qt.h \
     menu/lefthandmenu.h \
     selectlightsbutton.h \
@@ -542,17 +462,11 @@ HEADERS  +=  comm/arducor/arducordiscovery.h \
     syncwidget.h \
     singlecolorstatewidget.h \
     multicolorstatewidget.h \
-    utils/cormath.h \
     lightinfoscrollarea.h \
     touchlistener.h
 
 
-HEADERS  += cor/objects/light.h \
-    cor/objects/lightstate.h \
-    cor/objects/group.h \
-    cor/objects/palette.h \
-    cor/objects/page.h \
-    cor/objects/mood.h \
+HEADERS  += cor/objects/page.h \
     cor/widgets/slider.h \
     cor/widgets/button.h \
     cor/widgets/checkbox.h \
@@ -566,15 +480,6 @@ HEADERS  += cor/objects/light.h \
     cor/widgets/textinputwidget.h
 
 
-#----------
-# Build specific sources
-#----------
-
-equals(SHOULD_USE_SERIAL, 1) {
-    HEADERS += comm/commserial.h
-    SOURCES += comm/commserial.cpp
-}
-
 #--------
 # ShareUtils setup
 #--------
@@ -6,7 +6,7 @@
 
 #include "appsettings.h"
 
-#include "utils/qt.h"
+#include <QDebug>
 
 AppSettings::AppSettings() {
     mSettings = new QSettings();
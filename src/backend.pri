@@ -0,0 +1,154 @@
+#-------------------------------------------------
+#
+# Corluma backend
+# Copyright (C) 2015 - 2020.
+# Released under the GNU General Public License.
+# Full license in root of git repo.
+#
+# Communication, syncing, discovery, and persistence. None of
+# these files use QtWidgets, so they are shared by the app and
+# the headless daemon in daemon/.
+#
+#-------------------------------------------------
+
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+SOURCES += \
+    $$PWD/comm/arducor/arducordiscovery.cpp \
+    $$PWD/comm/arducor/arducorpacketparser.cpp \
+    $$PWD/comm/arducor/controller.cpp \
+    $$PWD/comm/arducor/crccalculator.cpp \
+    $$PWD/comm/commarducor.cpp \
+    $$PWD/comm/commhttp.cpp \
+    $$PWD/comm/commudp.cpp \
+    $$PWD/comm/commtype.cpp \
+    $$PWD/comm/commthread.cpp \
+    $$PWD/comm/lightstateservice.cpp \
+    $$PWD/comm/networkclient.cpp \
+    $$PWD/comm/networkmonitor.cpp \
+    $$PWD/comm/udpworker.cpp \
+    $$PWD/comm/commhue.cpp \
+    $$PWD/comm/commnanoleaf.cpp \
+    $$PWD/comm/commlayer.cpp \
+    $$PWD/comm/datasync.cpp \
+    $$PWD/comm/datasynchue.cpp \
+    $$PWD/comm/datasyncarduino.cpp \
+    $$PWD/comm/datasyncnanoleaf.cpp \
+    $$PWD/comm/datasynctimeout.cpp \
+    $$PWD/comm/nanoleaf/leafmetadata.cpp \
+    $$PWD/comm/upnpdiscovery.cpp \
+    $$PWD/cor/lightlist.cpp \
+    $$PWD/data/appdata.cpp \
+    $$PWD/data/groupdata.cpp \
+    $$PWD/data/mooddata.cpp \
+    $$PWD/data/palettedata.cpp \
+    $$PWD/cor/jsonsavedata.cpp \
+    $$PWD/data/subgroupdata.cpp \
+    $$PWD/utils/cormath.cpp \
+    $$PWD/comm/hue/bridgediscovery.cpp \
+    $$PWD/comm/hue/bridge.cpp \
+    $$PWD/comm/nanoleaf/leafdiscovery.cpp \
+    $$PWD/comm/syncstatus.cpp \
+    $$PWD/appsettings.cpp \
+    $$PWD/utils/qtcore.cpp
+
+HEADERS += \
+    $$PWD/comm/arducor/arducordiscovery.h \
+    $$PWD/comm/arducor/arducormetadata.h \
+    $$PWD/comm/arducor/arducorpacketparser.h \
+    $$PWD/comm/arducor/arducorpacketvalues.h \
+    $$PWD/comm/arducor/controller.h \
+    $$PWD/comm/arducor/crccalculator.h \
+    $$PWD/comm/commtype.h \
+    $$PWD/comm/commarducor.h \
+    $$PWD/comm/commhttp.h \
+    $$PWD/comm/commudp.h \
+    $$PWD/comm/commthread.h \
+    $$PWD/comm/lightstateservice.h \
+    $$PWD/comm/networkclient.h \
+    $$PWD/comm/networkmonitor.h \
+    $$PWD/comm/udpworker.h \
+    $$PWD/comm/commhue.h \
+    $$PWD/comm/commnanoleaf.h \
+    $$PWD/comm/commlayer.h \
+    $$PWD/comm/datasync.h \
+    $$PWD/comm/datasynchue.h \
+    $$PWD/comm/datasyncarduino.h \
+    $$PWD/comm/datasyncnanoleaf.h \
+    $$PWD/comm/datasynctimeout.h \
+    $$PWD/comm/hue/command.h \
+    $$PWD/comm/hue/huelightparser.h \
+    $$PWD/comm/hue/huemetadata.h \
+    $$PWD/comm/hue/schedule.h \
+    $$PWD/comm/nanoleaf/leafeffect.h \
+    $$PWD/comm/nanoleaf/leafeffectcache.h \
+    $$PWD/comm/nanoleaf/leafmetadata.h \
+    $$PWD/comm/nanoleaf/leafpacketparser.h \
+    $$PWD/comm/nanoleaf/leafprotocols.h \
+    $$PWD/comm/nanoleaf/leafstateupdate.h \
+    $$PWD/comm/upnpdiscovery.h \
+    $$PWD/cor/lightlist.h \
+    $$PWD/cor/objects/groupstate.h \
+    $$PWD/cor/objects/lightid.h \
+    $$PWD/cor/objects/moodplan.h \
+    $$PWD/cor/objects/palettegroup.h \
+    $$PWD/cor/objects/uuid.h \
+    $$PWD/data/appdata.h \
+    $$PWD/data/groupdata.h \
+    $$PWD/data/groupparentdata.h \
+    $$PWD/data/lightorphandata.h \
+    $$PWD/data/mooddata.h \
+    $$PWD/data/moodparentdata.h \
+    $$PWD/data/palettedata.h \
+    $$PWD/cor/protocols.h \
+    $$PWD/cor/range.h \
+    $$PWD/cor/routine.h \
+    $$PWD/cor/jsonsavedata.h \
+    $$PWD/cor/metrics.h \
+    $$PWD/cor/commandqueue.h \
+    $$PWD/cor/deltaqueue.h \
+    $$PWD/cor/discoveryscheduler.h \
+    $$PWD/cor/timingwheel.h \
+    $$PWD/cor/palettesignature.h \
+    $$PWD/cor/interner.h \
+    $$PWD/cor/ssdpmessage.h \
+    $$PWD/cor/ssdpcache.h \
+    $$PWD/cor/tokenizer.h \
+    $$PWD/cor/timeouttable.h \
+    $$PWD/cor/dictionary.h \
+    $$PWD/cor/trafficlog.h \
+    $$PWD/cor/trafficreplay.h \
+    $$PWD/cor/devicewatcher.h \
+    $$PWD/cor/networkavailability.h \
+    $$PWD/cor/stateaggregate.h \
+    $$PWD/cor/transitionplanner.h \
+    $$PWD/data/subgroupdata.h \
+    $$PWD/utils/exception.h \
+    $$PWD/comm/hue/bridgediscovery.h \
+    $$PWD/comm/hue/hueprotocols.h \
+    $$PWD/comm/hue/bridge.h \
+    $$PWD/comm/nanoleaf/panels.h \
+    $$PWD/comm/nanoleaf/rhythmcontroller.h \
+    $$PWD/comm/nanoleaf/leafdiscovery.h \
+    $$PWD/comm/nanoleaf/leafdate.h \
+    $$PWD/comm/nanoleaf/leafschedule.h \
+    $$PWD/comm/nanoleaf/leafaction.h \
+    $$PWD/comm/syncstatus.h \
+    $$PWD/appsettings.h \
+    $$PWD/utils/reachability.h \
+    $$PWD/utils/color.h \
+    $$PWD/utils/cormath.h \
+    $$PWD/cor/objects/light.h \
+    $$PWD/cor/objects/lightstate.h \
+    $$PWD/cor/objects/group.h \
+    $$PWD/cor/objects/palette.h \
+    $$PWD/cor/objects/mood.h \
+    $$PWD/utils/qtcore.h
+
+equals(SHOULD_USE_SERIAL, 1) {
+    HEADERS += $$PWD/comm/commserial.h \
+        $$PWD/comm/serialworker.h
+    SOURCES += $$PWD/comm/commserial.cpp \
+        $$PWD/comm/serialworker.cpp
+}
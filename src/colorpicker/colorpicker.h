@@ -6,6 +6,7 @@
 #include "colorpicker/colorschemecircles.h"
 #include "colorschemechooser.h"
 #include "colorwheel.h"
+#include "cor/protocols.h"
 #include "hsvsliders.h"
 #include "rgbsliders.h"
 #include "tempbrightsliders.h"
@@ -43,9 +44,6 @@ enum class EColorPickerMode {
     multi
 };
 
-/// type of colors allowed by selected lights
-enum class EColorPickerType { dimmable, CT, color };
-
 
 
 /*!
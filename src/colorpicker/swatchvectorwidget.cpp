@@ -6,97 +6,103 @@
 
 #include "swatchvectorwidget.h"
 
+#include <QMouseEvent>
+#include <QPainter>
+#include <algorithm>
+
+namespace {
+
+/// color of a swatch without a color
+const QColor kEmptySwatchColor(140, 140, 140);
+
+/// background of a swatch, matching an unchecked QPushButton in the app's stylesheet.
+const QColor kBackgroundColor(48, 47, 47);
+
+/// border of a swatch, matching an unchecked QPushButton in the app's stylesheet.
+const QColor kBorderColor(74, 73, 73);
+
+/// background of a selected swatch, matching a checked QPushButton in the app's stylesheet.
+const QColor kSelectedBackgroundColor(74, 73, 73);
+
+/// border of a selected swatch, matching a checked QPushButton in the app's stylesheet.
+const QColor kSelectedBorderColor(106, 105, 105);
+
+} // namespace
+
 SwatchVectorWidget::SwatchVectorWidget(std::uint32_t width, uint32_t height, QWidget* parent)
     : QWidget(parent) {
     mAllowInteraction = false;
     mWidth = width;
     mHeight = height;
     mMaximumSize = width * height;
-    mColors = std::vector<QColor>(10, QColor(140, 140, 140));
-
-    // --------------
-    // Setup Layout
-    // --------------
-
-    mLayout = new QGridLayout;
-    mLayout->setContentsMargins(0, 0, 0, 0);
-    mLayout->setHorizontalSpacing(0);
-
-    // --------------
-    // Setup Array Color Buttons
-    // --------------
-
-    mSwatches = std::vector<QPushButton*>(mMaximumSize, nullptr);
-    uint32_t i = 0;
-    for (std::uint32_t h = 0; h < mHeight; ++h) {
-        for (std::uint32_t w = 0; w < mWidth; ++w) {
-            mSwatches[i] = new QPushButton(this);
-            mSwatches[i]->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
-            connect(mSwatches[i], SIGNAL(clicked()), this, SLOT(toggleArrayColor()));
-
-            QSizePolicy sizePolicy = mSwatches[i]->sizePolicy();
-            sizePolicy.setRetainSizeWhenHidden(true);
-            mSwatches[i]->setSizePolicy(sizePolicy);
-
-            mLayout->addWidget(mSwatches[i], int(h), int(w));
-            ++i;
-        }
-    }
-    setLayout(mLayout);
+    mSelected = std::vector<bool>(mMaximumSize, false);
+    mColors = std::vector<QColor>(10, kEmptySwatchColor);
 }
 
 void SwatchVectorWidget::updateColors(const std::vector<QColor>& colors) {
     mColors = colors;
+    update();
+}
 
-    uint32_t i = 0;
-    for (const auto& color : colors) {
-        if (i < mMaximumSize) {
-            int size =
-                std::min(int(mSwatches[i]->width() * 0.8f), int(mSwatches[i]->height() * 0.8f));
-            QImage image(size, size, QImage::Format_RGB32);
-            image.fill(color);
-            mSwatches[i]->setIcon(QIcon(QPixmap::fromImage(image)));
-            mSwatches[i]->setIconSize(QSize(size, size));
-        }
-        ++i;
-    }
+uint32_t SwatchVectorWidget::selectedCount() {
+    return uint32_t(std::count(mSelected.begin(), mSelected.end(), true));
+}
 
-    for (; i < mMaximumSize; ++i) {
-        int size = std::min(int(mSwatches[i]->width() * 0.8f), int(mSwatches[i]->height() * 0.8f));
-        QImage image(size, size, QImage::Format_RGB32);
-        image.fill(QColor(140, 140, 140));
-        mSwatches[i]->setIcon(QIcon(QPixmap::fromImage(image)));
-        mSwatches[i]->setIconSize(QSize(size, size));
+void SwatchVectorWidget::allowInteraction(bool shouldAllowInteraction) {
+    mAllowInteraction = shouldAllowInteraction;
+    if (!mAllowInteraction) {
+        std::fill(mSelected.begin(), mSelected.end(), false);
+        update();
     }
 }
 
-uint32_t SwatchVectorWidget::selectedCount() {
-    uint32_t i = 0;
-    for (const auto& widget : mSwatches) {
-        if (widget->isChecked()) {
-            ++i;
+void SwatchVectorWidget::updateSelected(const QColor& color) {
+    for (std::size_t i = 0u; i < mSelected.size(); ++i) {
+        if (mSelected[i]) {
+            if (i >= mColors.size()) {
+                mColors.resize(i + 1u, kEmptySwatchColor);
+            }
+            mColors[i] = color;
         }
     }
-    return i;
+    update();
 }
 
-void SwatchVectorWidget::toggleArrayColor() {
-    if (mAllowInteraction) {
-        emit selectedCountChanged(int(selectedCount()));
+QRect SwatchVectorWidget::swatchRect(std::uint32_t i) const {
+    auto cellWidth = width() / int(mWidth);
+    auto cellHeight = height() / int(mHeight);
+    return QRect(int(i % mWidth) * cellWidth, int(i / mWidth) * cellHeight, cellWidth, cellHeight);
+}
+
+void SwatchVectorWidget::paintEvent(QPaintEvent*) {
+    QPainter painter(this);
+    for (std::uint32_t i = 0u; i < mMaximumSize; ++i) {
+        auto rect = swatchRect(i);
+        auto isSelected = mSelected[i];
+        painter.fillRect(rect, isSelected ? kSelectedBackgroundColor : kBackgroundColor);
+        painter.setPen(isSelected ? kSelectedBorderColor : kBorderColor);
+        painter.drawRect(rect.adjusted(0, 0, -1, -1));
+
+        auto side = std::min(int(rect.width() * 0.8f), int(rect.height() * 0.8f));
+        QRect swatch(rect.x() + (rect.width() - side) / 2,
+                     rect.y() + (rect.height() - side) / 2,
+                     side,
+                     side);
+        painter.fillRect(swatch, i < mColors.size() ? mColors[i] : kEmptySwatchColor);
     }
 }
 
-void SwatchVectorWidget::updateSelected(const QColor& color) {
-    for (std::size_t i = 0u; i < mSwatches.size(); ++i) {
-        if (mSwatches[i]->isChecked()) {
-            int size =
-                std::min(int(mSwatches[i]->width() * 0.8f), int(mSwatches[i]->height() * 0.8f));
-            QImage image(size, size, QImage::Format_RGB32);
-            image.fill(color);
-            mSwatches[i]->setIcon(QIcon(QPixmap::fromImage(image)));
-            mSwatches[i]->setVisible(true);
-            mSwatches[i]->setIconSize(QSize(size, size));
-            mColors[i] = color;
+void SwatchVectorWidget::mouseReleaseEvent(QMouseEvent* event) {
+    if (!mAllowInteraction) {
+        event->ignore();
+        return;
+    }
+    for (std::uint32_t i = 0u; i < mMaximumSize; ++i) {
+        if (swatchRect(i).contains(event->pos())) {
+            mSelected[i] = !mSelected[i];
+            update();
+            emit selectedCountChanged(int(selectedCount()));
+            return;
         }
     }
 }
@@ -1,11 +1,9 @@
 #ifndef SWATCH_VECTOR_WIDGET_H
 #define SWATCH_VECTOR_WIDGET_H
 
-#include <QPushButton>
+#include <QColor>
 #include <QWidget>
 
-#include "cor/widgets/slider.h"
-
 /*!
  * \copyright
  * Copyright (C) 2015 - 2020.
@@ -13,9 +11,10 @@
  *
  *
  *
- * \brief The SwatchVectorWidget class is a widget that displays buttons that show solid colors. It
- * is used in the color scheme picker and the custom color picker to choose colors to change and
- * display the current settings.
+ * \brief The SwatchVectorWidget class is a widget that displays a grid of swatches that show solid
+ * colors. It is used in the color scheme picker and the custom color picker to choose colors to
+ * change and display the current settings. The swatches are painted by this widget, instead of
+ * each being a button, and are selected by clicking them when interaction is allowed.
  */
 class SwatchVectorWidget : public QWidget {
     Q_OBJECT
@@ -23,8 +22,8 @@ public:
     /// Constructor
     explicit SwatchVectorWidget(std::uint32_t width, uint32_t height, QWidget* parent);
     /*!
-     * \brief updateDevices update the devices in the cor::Button to show the exact routine.
-     * \param devices list of devices to display
+     * \brief updateColors update the colors shown by the swatches.
+     * \param colors colors to display, swatches without a color are shown as grey.
      */
     void updateColors(const std::vector<QColor>& colors);
 
@@ -34,22 +33,15 @@ public:
      */
     uint32_t selectedCount();
 
-    /// getter for the buttons used for the swatches
-    const std::vector<QPushButton*>& buttons() { return mSwatches; }
-
     /// getter for the colors displayed in the swatch vector widget
     const std::vector<QColor>& colors() { return mColors; }
 
     /// update the selected lights with the given color
     void updateSelected(const QColor& color);
 
-    /// true to allow interaction, false to not allow interaction
-    void allowInteraction(bool shouldAllowInteraction) {
-        mAllowInteraction = shouldAllowInteraction;
-        for (auto&& swatch : mSwatches) {
-            swatch->setCheckable(shouldAllowInteraction);
-        }
-    }
+    /// true to allow interaction, false to not allow interaction. Disallowing interaction
+    /// deselects all swatches.
+    void allowInteraction(bool shouldAllowInteraction);
 
 signals:
     /*!
@@ -58,14 +50,17 @@ signals:
      */
     void selectedCountChanged(int);
 
-private slots:
-    /*!
-     * \brief toggleArrayColor when called, the multi color array color at the given index is
-     * seletected or deselected, depending on its current state.
-     */
-    void toggleArrayColor();
+protected:
+    /// renders the swatches
+    void paintEvent(QPaintEvent*) override;
+
+    /// selects or deselects the swatch that was clicked
+    void mouseReleaseEvent(QMouseEvent*) override;
 
 private:
+    /// region of the widget covered by the swatch at the given index
+    QRect swatchRect(std::uint32_t i) const;
+
     /*!
      * \brief mMaximumSize size of the multi color array, used to initialize
      *        and access vectors throughout this page.
@@ -78,17 +73,12 @@ private:
     /// number of rows of palettes
     uint32_t mHeight;
 
-    /// vector pushbuttons used for the multi layout
-    std::vector<QPushButton*> mSwatches;
+    /// true for each swatch that is selected
+    std::vector<bool> mSelected;
 
     /// stores the current colors of the swatches
     std::vector<QColor> mColors;
 
-    /*!
-     * \brief mLayout layout used to arrange the slider and the buttons.
-     */
-    QGridLayout* mLayout;
-
     /// true to allow interaction, false to not allow interaction.
     bool mAllowInteraction;
 };
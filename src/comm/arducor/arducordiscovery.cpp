@@ -15,7 +15,17 @@
 #include "comm/commserial.h"
 #endif
 
+namespace {
+
+/// key of a controller in the discovery scheduler. The same name can be tried over HTTP and UDP.
+std::string schedulerKey(const cor::Controller& controller) {
+    return controller.name().toStdString() + "/" + std::to_string(int(controller.type()));
+}
+
+} // namespace
+
 ArduCorDiscovery::ArduCorDiscovery(QObject* parent,
+                                   cor::DiscoveryScheduler<std::string>* scheduler,
                                    CommHTTP* http,
                                    CommUDP* udp
 #ifdef USE_SERIAL
@@ -25,6 +35,7 @@ ArduCorDiscovery::ArduCorDiscovery(QObject* parent,
                                    )
     : QObject(parent),
       cor::JSONSaveData("arducor"),
+      mScheduler{scheduler},
       mHTTP(http),
       mUDP(udp),
 #ifdef USE_SERIAL
@@ -65,7 +76,27 @@ void ArduCorDiscovery::stopDiscovery() {
 }
 
 void ArduCorDiscovery::handleDiscovery() {
+    auto now = cor::DiscoveryScheduler<std::string>::steadyNow();
     for (const auto& notFoundController : mNotFoundControllers) {
+        auto key = schedulerKey(notFoundController);
+        mScheduler->track(int(EProtocolType::arduCor),
+                          key,
+                          mScheduler->lastSeen(int(EProtocolType::arduCor), key),
+                          now);
+    }
+
+    // only probe the controllers that are due, instead of every not found controller every tick.
+    for (const auto& key : mScheduler->takeDue(int(EProtocolType::arduCor), now)) {
+        auto result = std::find_if(mNotFoundControllers.begin(),
+                                   mNotFoundControllers.end(),
+                                   [&key](const cor::Controller& controller) {
+                                       return schedulerKey(controller) == key;
+                                   });
+        if (result == mNotFoundControllers.end()) {
+            mScheduler->remove(int(EProtocolType::arduCor), key);
+            continue;
+        }
+        const auto& notFoundController = *result;
         if (notFoundController.type() == ECommType::HTTP) {
             mHTTP->testForController(notFoundController);
         }
@@ -226,10 +257,13 @@ void ArduCorDiscovery::addManualIP(const QString& ip) {
         }
     }
     if (!IPAlreadyFound) {
+        auto now = cor::DiscoveryScheduler<std::string>::steadyNow();
         cor::Controller controller(ip, ECommType::HTTP);
         mNotFoundControllers.push_back(controller);
+        mScheduler->seen(int(EProtocolType::arduCor), schedulerKey(controller), now);
         cor::Controller controller2(ip, ECommType::UDP);
         mNotFoundControllers.push_back(controller2);
+        mScheduler->seen(int(EProtocolType::arduCor), schedulerKey(controller2), now);
     }
     // start discovery if its not already active
     startDiscovery();
@@ -247,6 +281,22 @@ void ArduCorDiscovery::addSerialPort(const QString& serial) {
     if (!serialAlreadyFound) {
         cor::Controller controller(serial, ECommType::serial);
         mNotFoundControllers.push_back(controller);
+        mScheduler->seen(int(EProtocolType::arduCor),
+                         schedulerKey(controller),
+                         cor::DiscoveryScheduler<std::string>::steadyNow());
+    }
+}
+
+void ArduCorDiscovery::removeSerialPort(const QString& serial) {
+    auto result = std::find_if(mNotFoundControllers.begin(),
+                               mNotFoundControllers.end(),
+                               [&serial](const cor::Controller& controller) {
+                                   return controller.type() == ECommType::serial
+                                          && controller.name() == serial;
+                               });
+    if (result != mNotFoundControllers.end()) {
+        mScheduler->remove(int(EProtocolType::arduCor), schedulerKey(*result));
+        mNotFoundControllers.erase(result);
     }
 }
 #endif
@@ -281,6 +331,9 @@ void ArduCorDiscovery::handleDiscoveredController(const cor::Controller& discove
         if (result != mNotFoundControllers.end()) {
             mNotFoundControllers.erase(result);
         }
+        mScheduler->found(int(EProtocolType::arduCor),
+                          schedulerKey(controller),
+                          cor::DiscoveryScheduler<std::string>::steadyNow());
     }
 
     // add to the found controllers
@@ -326,6 +379,7 @@ bool ArduCorDiscovery::removeController(const QString& controllerName) {
         }
     }
     if (shouldDeleteNotFound) {
+        mScheduler->remove(int(EProtocolType::arduCor), schedulerKey(controller));
         auto it = std::find(mNotFoundControllers.begin(), mNotFoundControllers.end(), controller);
         mNotFoundControllers.erase(it);
         qDebug() << "INFO: Deleting a controller that hasn't been fully discovered: "
@@ -8,6 +8,7 @@
 #include "comm/arducor/arducormetadata.h"
 #include "comm/arducor/controller.h"
 #include "cor/dictionary.h"
+#include "cor/discoveryscheduler.h"
 #include "cor/jsonsavedata.h"
 
 class CommUDP;
@@ -31,6 +32,7 @@ class ArduCorDiscovery : public QObject, public cor::JSONSaveData {
 public:
     /// constructor
     explicit ArduCorDiscovery(QObject* parent,
+                              cor::DiscoveryScheduler<std::string>* scheduler,
                               CommHTTP* http,
                               CommUDP* udp
 #ifdef USE_SERIAL
@@ -54,6 +56,10 @@ public:
 #ifdef USE_SERIAL
     /// adds a serial port to notFound list
     void addSerialPort(const QString& serialName);
+
+    /// removes a serial port that disappeared from the notFound list, so it is no longer probed.
+    /// A controller already found on the port is kept, so it is reconnected if the port returns.
+    void removeSerialPort(const QString& serialName);
 #endif
 
     /// handles an incoming packet and checks if its a discovery packet. If it is, it treats it as
@@ -138,6 +144,9 @@ private:
                                                                    const QString& discovery,
                                                                    const QString& controllerName);
 
+    /// decides when each not found controller is probed, keyed by name and comm type.
+    cor::DiscoveryScheduler<std::string>* mScheduler;
+
     /// pointer to object that handles the HTTP communication
     CommHTTP* mHTTP;
 
@@ -3,7 +3,7 @@
 
 #include <QColor>
 #include <QJsonObject>
-#include <QWidget>
+#include <QObject>
 
 #include "comm/arducor/arducormetadata.h"
 #include "cor/protocols.h"
@@ -0,0 +1,85 @@
+#ifndef ARDUCORPACKETVALUES_H
+#define ARDUCORPACKETVALUES_H
+
+#include <charconv>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "comm/arducor/crccalculator.h"
+#include "cor/tokenizer.h"
+
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+/*!
+ * \brief arduCorPacketValues splits a packet received from an ArduCor into its messages, and each
+ * message into its values. Messages are separated by '&' and values by ','. Empty messages and
+ * values are kept, like std::getline would, so the CRC of a packet stays the last message and the
+ * indices of values don't shift. Values that aren't numbers, such as the CRC, are 0.
+ *
+ * \param packet the packet to split
+ * \return a vector of values for each message
+ */
+inline std::vector<std::vector<int>> arduCorPacketValues(std::string_view packet) {
+    static const cor::Tokenizer<char> kMessageDelimiters("&", false);
+    static const cor::Tokenizer<char> kValueDelimiters(",", false);
+    std::vector<std::vector<int>> intVectors;
+    kMessageDelimiters.forEach(packet, [&intVectors](std::string_view message) {
+        std::vector<int> intVector;
+        kValueDelimiters.forEach(message, [&intVector](std::string_view number) {
+            int i = 0;
+            std::from_chars(number.data(), number.data() + number.size(), i);
+            intVector.push_back(i);
+        });
+        intVectors.push_back(std::move(intVector));
+    });
+    return intVectors;
+}
+
+/*!
+ * \brief The ArduCorPacket struct is a packet received from an ArduCor, split into its values and
+ * with its CRC checked. It only depends on the packet, so it is decoded on the comm thread, and
+ * only the values cross to the GUI thread.
+ */
+struct ArduCorPacket {
+    /// values of each message of the packet, as returned by arduCorPacketValues. If the packet
+    /// has a CRC, it is the last message.
+    std::vector<std::vector<int>> values;
+
+    /// true if the packet ends in a CRC, which follows a single '#'.
+    bool hasCRC = false;
+
+    /// true if the packet has a CRC, and it matches the rest of the packet.
+    bool isCRCValid = false;
+};
+
+/*!
+ * \brief decodeArduCorPacket splits a packet into its values and checks its CRC, if it has one.
+ * A CRC is the number between a single '#' and the last character of the packet.
+ */
+inline ArduCorPacket decodeArduCorPacket(std::string_view packet) {
+    ArduCorPacket result;
+    result.values = arduCorPacketValues(packet);
+    auto crcStart = packet.find('#');
+    if (crcStart == std::string_view::npos
+        || packet.find('#', crcStart + 1u) != std::string_view::npos) {
+        return result;
+    }
+    result.hasCRC = true;
+    auto crcString = packet.substr(crcStart + 1u);
+    if (!crcString.empty()) {
+        // drop the delimiter that ends the CRC message
+        crcString.remove_suffix(1u);
+    }
+    std::uint32_t givenCRC = 0u;
+    auto parsed = std::from_chars(crcString.data(), crcString.data() + crcString.size(), givenCRC);
+    result.isCRCValid = parsed.ptr == crcString.data() + crcString.size()
+                        && givenCRC == CRCCalculator().calculate(packet.data(), crcStart);
+    return result;
+}
+
+#endif // ARDUCORPACKETVALUES_H
@@ -1,8 +1,11 @@
 #ifndef CRCCALCULATOR_H
 #define CRCCALCULATOR_H
 
-#include <QString>
-#include <vector>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+class QString;
 
 /*!
  * \copyright
@@ -14,25 +17,54 @@
  * matches the one used by ArduCor: https://github.com/timsee/ArduCor . A CRC gets calculated based
  * off of the contents of a packet and then appended to the end of it. The CRC is used to check
  * packet integrity, so it gets used in streams like serial where data can be garbled.
+ *
+ * The byte version doesn't depend on Qt, so it can be benchmarked outside of the app.
  */
 class CRCCalculator {
 public:
-    /// constructor
-    CRCCalculator();
-
     /*!
      * \brief calculate takes string as input, gives CRC as output
      * \param input string to compute a CRC on
      * \return CRC value for given string
      */
-    uint32_t calculate(const QString& input);
+    std::uint32_t calculate(const QString& input) const;
+
+    /// computes the CRC of the given bytes.
+    std::uint32_t calculate(const char* data, std::size_t size) const noexcept {
+        auto crc = std::uint32_t(~0u);
+        for (std::size_t i = 0u; i < size; ++i) {
+            crc = update(crc, std::uint8_t(data[i]));
+        }
+        return ~crc;
+    }
 
 private:
     /// internal helper
-    uint32_t update(unsigned long crc, uint8_t data);
+    static std::uint32_t update(std::uint32_t crc, std::uint8_t data) noexcept {
+        auto tableIndex = std::uint8_t(crc ^ (data >> (0 * 4)));
+        crc = kCRCTable[tableIndex & 0x0f] ^ (crc >> 4);
+        tableIndex = std::uint8_t(crc ^ (data >> (1 * 4)));
+        crc = kCRCTable[tableIndex & 0x0f] ^ (crc >> 4);
+        return crc;
+    }
 
     /// table of CRC values
-    std::vector<std::uint32_t> mCRCTable;
+    static constexpr std::array<std::uint32_t, 16> kCRCTable = {0u,
+                                                                 498536548u,
+                                                                 997073096u,
+                                                                 651767980u,
+                                                                 1994146192u,
+                                                                 1802195444u,
+                                                                 1303535960u,
+                                                                 1342533948u,
+                                                                 3988292384u,
+                                                                 4027552580u,
+                                                                 3604390888u,
+                                                                 3412177804u,
+                                                                 2607071920u,
+                                                                 2262029012u,
+                                                                 2685067896u,
+                                                                 3183342108u};
 };
 
 #endif // CRCCALCULATOR_H
@@ -6,24 +6,29 @@
 
 #include "commarducor.h"
 
+#include <QDebug>
+
+#include "comm/arducor/arducorpacketvalues.h"
 #include "comm/commhttp.h"
 #include "comm/commudp.h"
 #include "utils/exception.h"
-#include "utils/qt.h"
 #ifdef USE_SERIAL
 #include "comm/commserial.h"
 #endif
 
 //#define DEBUG_INVALID_PACKET
 
-CommArduCor::CommArduCor(QObject* parent, PaletteData* palettes)
+CommArduCor::CommArduCor(QObject* parent,
+                         PaletteData* palettes,
+                         CommThread* thread,
+                         cor::DiscoveryScheduler<std::string>* scheduler)
     : QObject(parent),
       mPalettes{palettes} {
-    mUDP = std::make_shared<CommUDP>();
+    mUDP = std::make_shared<CommUDP>(thread);
     connect(mUDP.get(),
-            SIGNAL(packetReceived(QString, QString, ECommType)),
+            SIGNAL(packetReceived(QString, QString, ArduCorPacket, ECommType)),
             this,
-            SLOT(parsePacket(QString, QString, ECommType)));
+            SLOT(parsePacket(QString, QString, ArduCorPacket, ECommType)));
     connect(mUDP.get(), SIGNAL(updateReceived(ECommType)), this, SLOT(receivedUpdate(ECommType)));
     connect(mUDP.get(),
             SIGNAL(newLightsFound(ECommType, std::vector<cor::LightID>)),
@@ -34,11 +39,11 @@ CommArduCor::CommArduCor(QObject* parent, PaletteData* palettes)
             this,
             SLOT(deletedLights(ECommType, std::vector<cor::LightID>)));
 
-    mHTTP = std::make_shared<CommHTTP>();
+    mHTTP = std::make_shared<CommHTTP>(thread);
     connect(mHTTP.get(),
-            SIGNAL(packetReceived(QString, QString, ECommType)),
+            SIGNAL(packetReceived(QString, QString, ArduCorPacket, ECommType)),
             this,
-            SLOT(parsePacket(QString, QString, ECommType)));
+            SLOT(parsePacket(QString, QString, ArduCorPacket, ECommType)));
     connect(mHTTP.get(), SIGNAL(updateReceived(ECommType)), this, SLOT(receivedUpdate(ECommType)));
     connect(mHTTP.get(),
             SIGNAL(newLightsFound(ECommType, std::vector<cor::LightID>)),
@@ -50,11 +55,11 @@ CommArduCor::CommArduCor(QObject* parent, PaletteData* palettes)
             SLOT(deletedLights(ECommType, std::vector<cor::LightID>)));
 
 #ifdef USE_SERIAL
-    mSerial = std::make_shared<CommSerial>();
+    mSerial = std::make_shared<CommSerial>(thread);
     connect(mSerial.get(),
-            SIGNAL(packetReceived(QString, QString, ECommType)),
+            SIGNAL(packetReceived(QString, QString, ArduCorPacket, ECommType)),
             this,
-            SLOT(parsePacket(QString, QString, ECommType)));
+            SLOT(parsePacket(QString, QString, ArduCorPacket, ECommType)));
     connect(mSerial.get(),
             SIGNAL(updateReceived(ECommType)),
             this,
@@ -70,6 +75,7 @@ CommArduCor::CommArduCor(QObject* parent, PaletteData* palettes)
 #endif // MOBILE_BUILD
 
     mDiscovery = new ArduCorDiscovery(this,
+                                      scheduler,
                                       mHTTP.get(),
                                       mUDP.get()
 #ifdef USE_SERIAL
@@ -258,55 +264,28 @@ std::vector<cor::PaletteGroup> CommArduCor::palettes() {
         cor::PaletteGroup("ArduCor", mPalettes->reservedPalettes()));
 }
 
-void CommArduCor::parsePacket(const QString& sender, const QString& packet, ECommType type) {
-    // split into vector of strings
-    std::vector<std::string> packetVector;
-    std::istringstream input(packet.toStdString());
-    std::string parsedPacket;
-    while (std::getline(input, parsedPacket, '&')) {
-        packetVector.push_back(parsedPacket);
-    }
-
-    // Turn vector of strings into vector of vector of ints
-    std::vector<std::vector<int>> intVectors;
-    for (const auto& parsedPacket : packetVector) {
-        std::vector<int> intVector;
-        std::istringstream input(parsedPacket);
-        std::string number;
-        while (std::getline(input, number, ',')) {
-            std::istringstream iss(number);
-            int i;
-            iss >> i;
-            intVector.push_back(i);
-        }
-        intVectors.push_back(intVector);
-    }
+void CommArduCor::parsePacket(const QString& sender,
+                              const QString& packet,
+                              const ArduCorPacket& decodedPacket,
+                              ECommType type) {
+    // the packet was split into messages of ints, and its CRC was checked, on the comm thread.
+    auto intVectors = decodedPacket.values;
 
     //------------------
     // Check for CRC
     //------------------
     auto result = mDiscovery->findFoundControllerByControllerName(sender);
     auto controller = result.first;
-    if (result.second && (packet.length() > 0)) {
+    if (result.second && !intVectors.empty()) {
         // check if it should use CRC
         if (controller.isUsingCRC()) {
-            QStringList crcPacketList = packet.split("#");
-            if (crcPacketList.size() == 2) {
-                // compute CRC
-                uint32_t computedCRC = mCRC.calculate(crcPacketList[0]);
-                uint32_t givenCRC = crcPacketList[1].left(crcPacketList[1].length() - 1).toUInt();
-                if (givenCRC != computedCRC) {
-                    // qDebug() << "INFO: failed CRC check for" << controller.name << "string:" <<
-                    // crcPacketList[0] << "computed:" << QString::number(computedCRC) << "given:"
-                    // << QString::number(givenCRC);
-                    return;
-                }
-                // qDebug() << "INFO: CRC check passed!";
-                // pass the CRC check
-                intVectors.pop_back();
-            } else {
+            if (!decodedPacket.hasCRC || !decodedPacket.isCRCValid) {
+                // qDebug() << "INFO: failed CRC check for" << controller.name << "string:" <<
+                // packet;
                 return;
             }
+            // pass the CRC check
+            intVectors.pop_back();
         }
         // qDebug() << "the sender: " << sender << "packet:" << packet << "type:" <<
         // commTypeToString(type);
@@ -7,6 +7,7 @@
 #include "comm/arducor/arducordiscovery.h"
 #include "comm/arducor/arducormetadata.h"
 #include "comm/arducor/crccalculator.h"
+#include "comm/commthread.h"
 #include "comm/commtype.h"
 #include "cor/objects/palettegroup.h"
 #include "data/palettedata.h"
@@ -31,8 +32,12 @@ class CommSerial;
 class CommArduCor : public QObject {
     Q_OBJECT
 public:
-    /// constructor
-    explicit CommArduCor(QObject* parent, PaletteData* palettes);
+    /// constructor, UDP and HTTP I/O runs on the given thread. Saved controllers that are not
+    /// found are probed when the shared scheduler says they are due.
+    explicit CommArduCor(QObject* parent,
+                         PaletteData* palettes,
+                         CommThread* thread,
+                         cor::DiscoveryScheduler<std::string>* scheduler);
 
     /*!
      * \brief sendPacket sends a packet to the given controller
@@ -119,10 +124,10 @@ signals:
 public slots:
 
     /*!
-     * \brief parsePacket parses any packets sent from any of the commtypes. The
-     *        comm type that received the packet is given as an int
+     * \brief parsePacket parses any packets sent from any of the commtypes, after they were
+     *        decoded on the comm thread. The packet's text is only used for warnings.
      */
-    void parsePacket(const QString&, const QString&, ECommType);
+    void parsePacket(const QString&, const QString&, const ArduCorPacket&, ECommType);
 
 private slots:
 
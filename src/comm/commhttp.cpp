@@ -6,23 +6,88 @@
 
 #include "commhttp.h"
 
+#include <algorithm>
+
 #include "comm/arducor/arducordiscovery.h"
 
-CommHTTP::CommHTTP() : CommType(ECommType::HTTP), mDiscovery{nullptr} {
-    mStateUpdateInterval = 4850;
+namespace {
+
+/// msec a request can be in flight before its aborted and the next request is sent.
+const qint64 kRequestTimeout = 2000;
+
+/// space reserved in each packet for the CRC, matches the padding used by DataSyncArduino.
+const int kPacketPadding = 16;
+
+/// computes a key for a message that is shared with any message that would overwrite its
+/// changes. IE, two brightness changes for the same light index share a key, but a brightness
+/// change and an on/off change do not.
+QString supersedeKey(const QString& message) {
+    auto header = message.section(',', 0, 0);
+    auto index = message.section(',', 1, 1);
+    if (header.toInt() == int(EPacketHeader::customArrayColorChange)) {
+        // custom array colors are also keyed by the index of the color they change
+        return header + "," + index + "," + message.section(',', 2, 2);
+    }
+    return header + "," + index;
+}
+
+/// true if messages with the given supersede keys change the same setting of a light. Besides
+/// equal keys, this happens when one of them has the same header and targets every light, which
+/// is index 0.
+bool overlaps(const QString& a, const QString& b) {
+    if (a == b) {
+        return true;
+    }
+    if (a.section(',', 0, 0) != b.section(',', 0, 0)) {
+        return false;
+    }
+    return a.section(',', 1, 1) == "0" || b.section(',', 1, 1) == "0";
+}
+
+/// adds messages to a packet until the next message would exceed the max size, returns the
+/// number of messages added. At least one message is always added, even if it alone exceeds the
+/// max size.
+template <typename Messages>
+std::size_t appendMessages(const Messages& messages, int maxSize, QString& packet) {
+    auto i = 0u;
+    for (; i < messages.size(); ++i) {
+        if (!packet.isEmpty() && (packet.size() + messages[i].size() + 1) > maxSize) {
+            break;
+        }
+        packet += messages[i] + "&";
+    }
+    return i;
+}
 
-    mNetworkManager = new QNetworkAccessManager(this);
+/// decodes the packet in a reply on the comm thread. Discovery packets are left to the discovery
+/// object, which needs their text.
+QVariant decodePacket(const NetworkResponse& response) {
+    auto body = response.body.trimmed();
+    if (body.contains(ArduCorDiscovery::kDiscoveryPacketIdentifier.toUtf8())) {
+        return {};
+    }
+    return QVariant::fromValue(
+        decodeArduCorPacket(std::string_view(body.constData(), std::size_t(body.size()))));
+}
+
+} // namespace
+
+CommHTTP::CommHTTP(CommThread* thread)
+    : CommType(ECommType::HTTP),
+      mNetworkClient{new NetworkClient(thread, false, this, decodePacket)},
+      mDiscovery{nullptr},
+      mStallTimer{new QTimer(this)} {
+    mStateUpdateInterval = 4850;
 
-    connect(mNetworkManager,
-            SIGNAL(finished(QNetworkReply*)),
+    connect(mNetworkClient,
+            SIGNAL(finished(NetworkResponse)),
             this,
-            SLOT(replyFinished(QNetworkReply*)));
+            SLOT(replyFinished(NetworkResponse)));
     connect(mStateUpdateTimer, SIGNAL(timeout()), this, SLOT(stateUpdate()));
+    connect(mStallTimer, SIGNAL(timeout()), this, SLOT(checkForStalledRequests()));
 }
 
-CommHTTP::~CommHTTP() {
-    delete mNetworkManager;
-}
+CommHTTP::~CommHTTP() = default;
 
 void CommHTTP::startup() {}
 
@@ -30,14 +95,118 @@ void CommHTTP::shutdown() {
     if (mStateUpdateTimer->isActive()) {
         mStateUpdateTimer->stop();
     }
+    mStallTimer->stop();
+    for (auto&& queuePair : mQueues) {
+        queuePair.second.commands.clear();
+        queuePair.second.polls.clear();
+    }
+}
+
+void CommHTTP::traffic(cor::TrafficLog* log, cor::TrafficReplay* replay) {
+    CommType::traffic(log, replay);
+    mNetworkClient->traffic(log, replay, commTypeToString(mType));
 }
 
 void CommHTTP::sendPacket(const cor::Controller& controller, QString& packet) {
+    ++mStats.packetsQueued;
+    queueMessages(controller, packet, false);
+    auto result = mQueues.find(controller.name().toStdString());
+    if (result != mQueues.end()) {
+        flushQueue(result->second);
+    }
+}
+
+void CommHTTP::queueMessages(const cor::Controller& controller,
+                             const QString& packet,
+                             bool isPoll) {
+    auto key = controller.name().toStdString();
+    auto result = mQueues.find(key);
+    if (result == mQueues.end()) {
+        HTTPControllerQueue queue;
+        queue.controller = controller;
+        result = mQueues.emplace(key, queue).first;
+    }
+    auto& queue = result->second;
+    // controller settings such as CRC and packet size can change after rediscovery
+    queue.controller = controller;
+
+    // the CRC is recomputed when the messages are merged, so strip it from the incoming packet.
+    auto payload = packet.section('#', 0, 0);
+    for (const auto& message : payload.split('&')) {
+        if (message.isEmpty()) {
+            continue;
+        }
+        if (isPoll) {
+            // polls are identical each time, so there is never a reason to queue one twice.
+            if (std::find(queue.polls.begin(), queue.polls.end(), message) == queue.polls.end()) {
+                queue.polls.push_back(message);
+            } else {
+                ++mStats.messagesSuperseded;
+            }
+        } else {
+            if (queue.commands.push(supersedeKey(message), message, overlaps)) {
+                ++mStats.messagesSuperseded;
+            }
+        }
+    }
+}
+
+void CommHTTP::flushQueue(HTTPControllerQueue& queue) {
+    if (queue.requestID != 0u) {
+        return;
+    }
+
+    // commands take priority over polls, polls are only sent when theres no changes queued.
+    int maxSize = int(queue.controller.maxPacketSize()) - kPacketPadding;
+    QString packet;
+    if (!queue.commands.empty()) {
+        queue.commands.pop(appendMessages(queue.commands, maxSize, packet));
+    } else if (!queue.polls.empty()) {
+        auto count = appendMessages(queue.polls, maxSize, packet);
+        queue.polls.erase(queue.polls.begin(), queue.polls.begin() + int(count));
+    } else {
+        return;
+    }
+
+    if (queue.controller.isUsingCRC()) {
+        packet = packet + "#" + QString::number(mCRC.calculate(packet)) + "&";
+    }
+    queue.requestID = sendRequest(queue.controller, packet);
+    queue.replyTimer.start();
+    if (!mStallTimer->isActive()) {
+        mStallTimer->start(kRequestTimeout / 4);
+    }
+}
+
+std::uint64_t CommHTTP::sendRequest(const cor::Controller& controller, const QString& packet) {
     // send packet over HTTP
     QString urlString = "http://" + controller.name() + "/arduino/" + packet;
     QNetworkRequest request = QNetworkRequest(QUrl(urlString));
+    // ask the controller to keep the connection open for the next request.
+    request.setRawHeader("Connection", "Keep-Alive");
     // qDebug() << "sending" << urlString;
-    mNetworkManager->get(request);
+    ++mStats.requestsSent;
+    recordPacketSent(controller.name());
+    return mNetworkClient->get(request);
+}
+
+void CommHTTP::checkForStalledRequests() {
+    bool isAnyInFlight = false;
+    for (auto&& queuePair : mQueues) {
+        auto& queue = queuePair.second;
+        if (queue.requestID != 0u && queue.replyTimer.elapsed() > kRequestTimeout) {
+            ++mStats.requestsTimedOut;
+            // aborting emits finished, which frees up the queue for the next request. The abort
+            // happens on the comm thread, so restart the timer to not abort it twice.
+            mNetworkClient->abort(queue.requestID);
+            queue.replyTimer.restart();
+        }
+        isAnyInFlight = isAnyInFlight || queue.requestID != 0u;
+    }
+    // the timer only runs while something can stall, so an idle transport doesn't wake up.
+    if (!isAnyInFlight) {
+        mStallTimer->stop();
+    }
 }
 
 void CommHTTP::stateUpdate() {
@@ -45,24 +214,16 @@ void CommHTTP::stateUpdate() {
         for (const auto& controller : mDiscovery->controllers().items()) {
             QString packet =
                 QString("%1&").arg(QString::number(int(EPacketHeader::stateUpdateRequest)));
-            // add CRC, if in use
-            if (controller.isUsingCRC()) {
-                packet = packet + "#" + QString::number(mCRC.calculate(packet)) + "&";
-            }
-            sendPacket(controller, packet);
             if ((mStateUpdateCounter % mSecondaryUpdatesInterval) == 0) {
-                QString customArrayUpdateRequest = QString("%1&").arg(
+                packet += QString("%1&").arg(
                     QString::number(int(EPacketHeader::customArrayUpdateRequest)));
-                if (controller.isUsingCRC()) {
-                    customArrayUpdateRequest =
-                        customArrayUpdateRequest + "#"
-                        + QString::number(mCRC.calculate(customArrayUpdateRequest)) + "&";
-                }
-                sendPacket(controller, customArrayUpdateRequest);
             }
+            queueMessages(controller, packet, true);
+            flushQueue(mQueues[controller.name().toStdString()]);
         }
 
         mStateUpdateCounter++;
+        checkReachability();
     } else {
         stopStateUpdates();
     }
@@ -70,11 +231,7 @@ void CommHTTP::stateUpdate() {
 
 
 void CommHTTP::testForController(const cor::Controller& controller) {
-    QString urlString =
-        "http://" + controller.name() + "/arduino/" + ArduCorDiscovery::kDiscoveryPacketIdentifier;
-    QNetworkRequest request = QNetworkRequest(QUrl(urlString));
-    // qDebug() << "sending" << urlString;
-    mNetworkManager->get(request);
+    sendRequest(controller, ArduCorDiscovery::kDiscoveryPacketIdentifier);
 }
 
 
@@ -82,23 +239,41 @@ void CommHTTP::testForController(const cor::Controller& controller) {
 // Receiving
 //--------------------
 
-void CommHTTP::replyFinished(QNetworkReply* reply) {
-    QString fullURL = reply->url().toEncoded();
+void CommHTTP::replyFinished(NetworkResponse reply) {
+    QString fullURL = reply.url.toEncoded();
     if (fullURL.contains("http://")) {
         fullURL.remove("http://");
     }
     QStringList list = fullURL.split("/");
     QString IP = list[0];
-    if (reply->error() == QNetworkReply::NoError) {
-        QString payload = reply->readAll().trimmed();
-        // check if controller is already connected
-        auto result = mDiscovery->findFoundControllerByControllerName(IP);
-        bool isDiscovery = payload.contains(ArduCorDiscovery::kDiscoveryPacketIdentifier);
-        if (result.second && !isDiscovery) {
-            emit packetReceived(IP, payload, mType);
-        } else if (isDiscovery) {
+
+    // free up the controller's queue, if this reply was its request in flight.
+    auto queueResult = mQueues.find(IP.toStdString());
+    if (queueResult != mQueues.end() && queueResult->second.requestID == reply.requestID) {
+        auto& queue = queueResult->second;
+        queue.requestID = 0u;
+        ++mStats.repliesReceived;
+        mStats.totalLatency += std::uint64_t(queue.replyTimer.elapsed());
+    }
+
+    if (reply.error == QNetworkReply::NoError) {
+        recordPacketReceived(IP);
+        // the body is dropped once the packet is decoded, unless traffic is captured.
+        QString payload = QString(reply.body).trimmed();
+        if (reply.decoded.userType() == qMetaTypeId<ArduCorPacket>()) {
+            // check if controller is already connected
+            auto result = mDiscovery->findFoundControllerByControllerName(IP);
+            if (result.second) {
+                emit packetReceived(IP, payload, reply.decoded.value<ArduCorPacket>(), mType);
+            }
+        } else if (payload.contains(ArduCorDiscovery::kDiscoveryPacketIdentifier)) {
             mDiscovery->handleIncomingPacket(mType, IP, payload);
         }
     }
-    reply->deleteLater();
+
+    // look up the queue again, handling the packet may have queued more messages.
+    queueResult = mQueues.find(IP.toStdString());
+    if (queueResult != mQueues.end()) {
+        flushQueue(queueResult->second);
+    }
 }
@@ -1,24 +1,88 @@
 #ifndef COMMHTTP_H
 #define COMMHTTP_H
 
-#include <QNetworkAccessManager>
-#include <QNetworkReply>
-#include <QNetworkRequest>
+#include <QElapsedTimer>
 #include <QTimer>
+#include <unordered_map>
 
 #include "comm/arducor/arducordiscovery.h"
 #include "comm/arducor/crccalculator.h"
+#include "comm/commthread.h"
+#include "comm/networkclient.h"
 #include "commtype.h"
+#include "cor/commandqueue.h"
 
 /*!
  * \copyright
  * Copyright (C) 2015 - 2020.
  * Released under the GNU General Public License.
  *
+ * \brief The HTTPControllerQueue struct stores the messages waiting to be sent to a single
+ * controller, along with the request that is currently in flight for that controller. Messages are
+ * stored without their trailing '&' and without a CRC, so that they can be merged into a single
+ * request right before sending. Commands are keyed by the light and setting they change, so a
+ * newer command replaces an older one that it would overwrite.
+ */
+struct HTTPControllerQueue {
+    /// controller that the messages are sent to
+    cor::Controller controller;
+
+    /// messages that change the state of a light, in the order they are sent.
+    cor::CommandQueue<QString, QString> commands;
+
+    /// messages that request a state update from the controller.
+    std::vector<QString> polls;
+
+    /// ID of the request currently in flight, 0 if no request is in flight.
+    std::uint64_t requestID = 0u;
+
+    /// tracks how long the request in flight has been waiting for a response
+    QElapsedTimer replyTimer;
+};
+
+/*!
+ * \brief The HTTPTransportStats struct tracks the efficiency of the HTTP transport. Packets are
+ * the packets given to the transport, requests are the HTTP requests actually sent.
+ */
+struct HTTPTransportStats {
+    /// number of packets handed to sendPacket
+    std::uint64_t packetsQueued = 0u;
+
+    /// number of messages dropped because a newer message replaced them before sending.
+    std::uint64_t messagesSuperseded = 0u;
+
+    /// number of HTTP requests sent
+    std::uint64_t requestsSent = 0u;
+
+    /// number of HTTP requests that timed out and were aborted
+    std::uint64_t requestsTimedOut = 0u;
+
+    /// total msec spent waiting on replies, used to compute average latency
+    std::uint64_t totalLatency = 0u;
+
+    /// number of replies received
+    std::uint64_t repliesReceived = 0u;
+
+    /// average msec between sending a request and receiving its reply
+    double averageLatency() const noexcept {
+        if (repliesReceived == 0u) {
+            return 0.0;
+        }
+        return double(totalLatency) / double(repliesReceived);
+    }
+};
+
+/*!
  * \brief provides a HTTP communication stream, which is
  * similar to an IP Camera. Packets are sent as HTTP
  * requests by appending them to the end of the HTTP
  * request's link.
+ *
+ * Each controller has at most one request in flight at a time, which lets the
+ * QNetworkAccessManager reuse a single keep-alive connection per controller. While a request is in
+ * flight, new packets are queued. A queued message that targets the same light and setting as a
+ * newer message is dropped, and the remaining messages are merged into as few requests as the
+ * controller's max packet size allows.
  */
 class CommHTTP : public CommType {
     Q_OBJECT
@@ -26,7 +90,7 @@ public:
     /*!
      * \brief CommHTTP Constructor
      */
-    CommHTTP();
+    CommHTTP(CommThread* thread);
     /*!
      * \brief CommHTTP Deconstructor
      */
@@ -42,13 +106,18 @@ public:
      */
     void shutdown();
 
+    /// sets the traffic log and replay of this CommType and of its NetworkClient.
+    void traffic(cor::TrafficLog* log, cor::TrafficReplay* replay) override;
+
     /// connects discovery object
     void connectDiscovery(ArduCorDiscovery* discovery) { mDiscovery = discovery; }
 
     /*!
      * \brief sendPacket sends a packet in a way similar to am
      *        IP Camera: The packet is added to the end of the
-     *        web address, and sent as an HTTP request
+     *        web address, and sent as an HTTP request. If a request
+     *        is already in flight for the controller, the packet is
+     *        queued and merged with other queued packets.
      * \param packet the string to be sent over HTTP.
      */
     void sendPacket(const cor::Controller& controller, QString& packet);
@@ -59,19 +128,23 @@ public:
      */
     void testForController(const cor::Controller& controller);
 
+    /// getter for the stats on the HTTP transport.
+    const HTTPTransportStats& stats() const noexcept { return mStats; }
+
 signals:
     /*!
      * \brief packetReceived emitted whenever a packet that is not a discovery packet is received.
-     * Contains the full packet's contents as a QString.
+     * Contains the sender, the full packet's contents as a QString if it was kept, and its decoded
+     * values.
      */
-    void packetReceived(QString, QString, ECommType);
+    void packetReceived(QString, QString, ArduCorPacket, ECommType);
 
 private slots:
     /*!
-     * \brief replyFinished called by the mNetworkManager, receives HTTP replies to packets
+     * \brief replyFinished called by the mNetworkClient, receives HTTP replies to packets
      *        sent from other methods.
      */
-    void replyFinished(QNetworkReply*);
+    void replyFinished(NetworkResponse);
 
     /*!
      * \brief stateUpdate used by the mStateUpdateTimer to request new
@@ -79,11 +152,25 @@ private slots:
      */
     void stateUpdate();
 
+    /// aborts any request that has been in flight for longer than kRequestTimeout.
+    void checkForStalledRequests();
+
 private:
+    /// adds the messages in a packet to the queue of the controller, replacing any older messages
+    /// that it supersedes.
+    void queueMessages(const cor::Controller& controller, const QString& packet, bool isPoll);
+
+    /// sends the next request for a controller, if it has queued messages and nothing in flight.
+    void flushQueue(HTTPControllerQueue& queue);
+
+    /// sends a GET request with the given packet to the controller
+    std::uint64_t sendRequest(const cor::Controller& controller, const QString& packet);
+
+
     /*!
-     * \brief mNetworkManager Qt's HTTP connection object
+     * \brief mNetworkClient sends HTTP requests on the comm thread
      */
-    QNetworkAccessManager* mNetworkManager;
+    NetworkClient* mNetworkClient;
 
     /// used to check CRC on incoming packets.
     CRCCalculator mCRC;
@@ -91,6 +178,15 @@ private:
     /// discovery object for storing previous connections, saving new connections, parsing discovery
     /// packets
     ArduCorDiscovery* mDiscovery;
+
+    /// checks for stalled requests while any request is in flight.
+    QTimer* mStallTimer;
+
+    /// queues for each controller, the key is the controller's name.
+    std::unordered_map<std::string, HTTPControllerQueue> mQueues;
+
+    /// stats on the efficiency of the transport.
+    HTTPTransportStats mStats;
 };
 
 #endif // COMMHTTP_H
@@ -1,6 +1,7 @@
 #include "commhue.h"
 
 #include <QDateTime>
+#include <QDebug>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonValue>
@@ -9,13 +10,13 @@
 #include <QVariantMap>
 
 #include "comm/hue/bridge.h"
+#include "comm/hue/huelightparser.h"
 #include "comm/hue/hueprotocols.h"
 #include "cor/objects/light.h"
 #include "data/appdata.h"
 #include "utils/color.h"
 #include "utils/cormath.h"
 #include "utils/exception.h"
-#include "utils/qt.h"
 
 /*!
  * \copyright
@@ -23,20 +24,47 @@
  * Released under the GNU General Public License.
  */
 
+namespace {
 
-CommHue::CommHue(UPnPDiscovery* UPnP, AppData* appData)
+/// adds a fade to a light state change. hues take the fade in deciseconds, rounded up.
+void addTransition(QJsonObject& json, int transition) {
+    if (transition >= 0) {
+        json["transitiontime"] = (transition + 99) / 100;
+    }
+}
+
+/// decodes the lights in a reply on the comm thread, if the reply is a list of lights.
+QVariant decodeLightUpdates(const NetworkResponse& response) {
+    if (!response.json.isObject()) {
+        return {};
+    }
+    auto result = hue::parseLightUpdates(response.json.object());
+    if (!result.second) {
+        return {};
+    }
+    return QVariant::fromValue(result.first);
+}
+
+} // namespace
+
+
+CommHue::CommHue(UPnPDiscovery* UPnP,
+                 AppData* appData,
+                 CommThread* thread,
+                 cor::DiscoveryScheduler<std::string>* scheduler)
     : CommType(ECommType::hue),
       mAppData{appData},
       mScanIsActive{false} {
     mStateUpdateInterval = 1000;
 
-    mNetworkManager = new QNetworkAccessManager(this);
-    connect(mNetworkManager,
-            SIGNAL(finished(QNetworkReply*)),
+    qRegisterMetaType<std::vector<hue::LightUpdate>>();
+    mNetworkClient = new NetworkClient(thread, true, this, decodeLightUpdates);
+    connect(mNetworkClient,
+            SIGNAL(finished(NetworkResponse)),
             this,
-            SLOT(replyFinished(QNetworkReply*)));
+            SLOT(replyFinished(NetworkResponse)));
 
-    mDiscovery = new hue::BridgeDiscovery(this, UPnP, appData);
+    mDiscovery = new hue::BridgeDiscovery(this, UPnP, appData, scheduler);
     mDiscovery->loadJSON();
 
     // this avoids making a bunch of file writes when each light is found in the hue's save data.
@@ -68,6 +96,11 @@ void CommHue::shutdown() {
     }
 }
 
+void CommHue::traffic(cor::TrafficLog* log, cor::TrafficReplay* replay) {
+    CommType::traffic(log, replay);
+    mNetworkClient->traffic(log, replay, commTypeToString(mType));
+}
+
 
 void CommHue::sendPacket(const QJsonObject& object) {
     if (object["uniqueID"].isString()) {
@@ -77,6 +110,10 @@ void CommHue::sendPacket(const QJsonObject& object) {
 
         if (bridgeFound) {
             int index = int(object["index"].toDouble());
+            int transition = -1;
+            if (object["transition"].isDouble()) {
+                transition = object["transition"].toInt();
+            }
             if (object["isOn"].isBool()) {
                 turnOnOff(bridge, index, object["isOn"].toBool());
             }
@@ -85,20 +122,27 @@ void CommHue::sendPacket(const QJsonObject& object) {
                     changeColorCT(bridge,
                                   index,
                                   int(object["bri"].toDouble() * 100.0),
-                                  int(object["temperature"].toDouble()));
+                                  int(object["temperature"].toDouble()),
+                                  transition);
                 } else {
-                    brightnessChange(bridge, index, int(object["bri"].toDouble() * 100.0));
+                    brightnessChange(bridge,
+                                     index,
+                                     int(object["bri"].toDouble() * 100.0),
+                                     transition);
                 }
             }
             // send routine change
             if (object["routine"].isObject()) {
-                routineChange(bridge, index, object["routine"].toObject());
+                routineChange(bridge, index, object["routine"].toObject(), transition);
             }
         }
     }
 }
 
-void CommHue::changeColor(const hue::Bridge& bridge, int lightIndex, const QColor& color) {
+void CommHue::changeColor(const hue::Bridge& bridge,
+                          int lightIndex,
+                          const QColor& color,
+                          int transition) {
     // grab the matching hue
     HueMetadata light = mDiscovery->lightFromBridgeIDAndIndex(bridge.id(), lightIndex);
 
@@ -113,7 +157,7 @@ void CommHue::changeColor(const hue::Bridge& bridge, int lightIndex, const QColo
     // handle multicasting with light index 0
     if (lightIndex == 0) {
         for (int i = 1; i <= int(bridge.lights().size()); ++i) {
-            changeColor(bridge, i, color);
+            changeColor(bridge, i, color, transition);
         }
     }
 
@@ -123,6 +167,7 @@ void CommHue::changeColor(const hue::Bridge& bridge, int lightIndex, const QColo
         json["sat"] = saturation;
         json["bri"] = brightness;
         json["hue"] = hue;
+        addTransition(json, transition);
 
         resetBackgroundTimers();
         putJson(bridge, "/lights/" + QString::number(lightIndex) + "/state", json);
@@ -131,12 +176,16 @@ void CommHue::changeColor(const hue::Bridge& bridge, int lightIndex, const QColo
     }
 }
 
-void CommHue::changeColorCT(const hue::Bridge& bridge, int lightIndex, int brightness, int ct) {
+void CommHue::changeColorCT(const hue::Bridge& bridge,
+                            int lightIndex,
+                            int brightness,
+                            int ct,
+                            int transition) {
     HueMetadata light = mDiscovery->lightFromBridgeIDAndIndex(bridge.id(), lightIndex);
 
     if (lightIndex == 0) {
         for (int i = 1; i <= int(bridge.lights().size()); ++i) {
-            changeColorCT(bridge, i, brightness, ct);
+            changeColorCT(bridge, i, brightness, ct, transition);
         }
     }
 
@@ -152,6 +201,7 @@ void CommHue::changeColorCT(const hue::Bridge& bridge, int lightIndex, int brigh
         json["on"] = true;
         json["ct"] = ct;
         json["bri"] = brightness;
+        addTransition(json, transition);
 
         // qDebug() << "chagne color CT" << ct << " brightness " << brightness;
         resetBackgroundTimers();
@@ -234,18 +284,24 @@ QString CommHue::urlStart(const hue::Bridge& bridge) {
     return QString("http://" + bridge.IP() + "/api/" + bridge.username());
 }
 
-void CommHue::routineChange(const hue::Bridge& bridge, int deviceIndex, QJsonObject routineObject) {
+void CommHue::routineChange(const hue::Bridge& bridge,
+                            int deviceIndex,
+                            QJsonObject routineObject,
+                            int transition) {
     if (routineObject["hue"].isDouble() && routineObject["sat"].isDouble()
         && routineObject["bri"].isDouble()) {
         QColor color;
         color.setHsvF(routineObject["hue"].toDouble(),
                       routineObject["sat"].toDouble(),
                       routineObject["bri"].toDouble());
-        changeColor(bridge, deviceIndex, color);
+        changeColor(bridge, deviceIndex, color, transition);
     }
 }
 
-void CommHue::brightnessChange(const hue::Bridge& bridge, int deviceIndex, int brightness) {
+void CommHue::brightnessChange(const hue::Bridge& bridge,
+                               int deviceIndex,
+                               int brightness,
+                               int transition) {
     brightness = int(brightness * 2.5f);
     if (brightness > 254) {
         brightness = 254;
@@ -253,6 +309,7 @@ void CommHue::brightnessChange(const hue::Bridge& bridge, int deviceIndex, int b
 
     QJsonObject json;
     json["bri"] = brightness;
+    addTransition(json, transition);
     resetBackgroundTimers();
     putJson(bridge, "/lights/" + QString::number(deviceIndex) + "/state", json);
 }
@@ -280,13 +337,21 @@ std::pair<hue::Schedule, bool> CommHue::timeoutSchedule(const cor::Light& light)
 //--------------------
 // Receiving
 //--------------------
-void CommHue::replyFinished(QNetworkReply* reply) {
-    if (reply->error() == QNetworkReply::NoError) {
-        QString string = reply->readAll();
-        QString IP = hue::IPfromReplyIP(reply->url().toString());
+void CommHue::replyFinished(NetworkResponse reply) {
+    if (reply.error == QNetworkReply::NoError) {
+        QString IP = hue::IPfromReplyIP(reply.url.toString());
+        recordPacketReceived(IP);
         auto bridge = mDiscovery->bridgeFromIP(IP);
-        // qDebug() << "Response:" << string;
-        auto jsonResponse = QJsonDocument::fromJson(string.toUtf8());
+        // qDebug() << "Response:" << reply.body;
+        if (reply.decoded.userType() == qMetaTypeId<std::vector<hue::LightUpdate>>()) {
+            // the states of lights are decoded on the comm thread, only merging them is left.
+            for (const auto& update : reply.decoded.value<std::vector<hue::LightUpdate>>()) {
+                applyLightUpdate(bridge, update, false);
+            }
+            return;
+        }
+        // the JSON is decoded on the comm thread
+        const auto& jsonResponse = reply.json;
         // check validity of the document
         if (!jsonResponse.isNull()) {
             mLastResponse = jsonResponse;
@@ -299,7 +364,6 @@ void CommHue::replyFinished(QNetworkReply* reply) {
             qDebug() << "Invalid JSON...";
         }
     }
-    reply->deleteLater();
 }
 
 void CommHue::parseJSONObject(const hue::Bridge& bridge, const QJsonObject& object) {
@@ -588,116 +652,45 @@ std::pair<cor::Light, HueMetadata> CommHue::updateHueLightState(const hue::Bridg
                                                                 QJsonObject object,
                                                                 int i,
                                                                 bool skipAddOrUpdate) {
-    // check if valid packet
-    if (object["type"].isString() && object["name"].isString() && object["modelid"].isString()
-        && object["manufacturername"].isString() && object["uniqueid"].isString()
-        && object["swversion"].isString()) {
-        QJsonObject stateObject = object["state"].toObject();
-        if (stateObject["on"].isBool() && stateObject["reachable"].isBool()
-            && stateObject["bri"].isDouble()) {
-            HueMetadata metadata(object, bridge.id(), i);
-            HueLight hue(metadata);
-            bool wasDiscovered = fillLight(hue);
-
-            auto state = hue.state();
-            hue.isReachable(stateObject["reachable"].toBool());
-            state.isOn(stateObject["on"].toBool());
-
-            if (metadata.colorMode() == EColorMode::XY) {
-                bool isValid = false;
-                if (stateObject["xy"].isArray() && stateObject["bri"].isDouble()) {
-                    QJsonArray array = stateObject["xy"].toArray();
-                    if (array.size() == 2) {
-                        if (array.at(0).isDouble() && array.at(1).isDouble()) {
-                            isValid = true;
-                            // take from objC code from here:
-                            // https://developers.meethue.com/documentation/color-conversions-rgb-xy
-                            double x = array.at(0).toDouble();
-                            double y = array.at(1).toDouble();
-
-                            double z = 1.0 - x - y;
-                            double Y =
-                                stateObject["bri"].toDouble() / 254.0; // The given brightness value
-                            double X = (Y / y) * x;
-                            double Z = (Y / y) * z;
-
-                            // Convert to RGB using Wide RGB D65 conversion
-                            double r = X * 1.656492 - Y * 0.354851 - Z * 0.255038;
-                            double g = -X * 0.707196 + Y * 1.655397 + Z * 0.036152;
-                            double b = X * 0.051713 - Y * 0.121364 + Z * 1.011530;
-
-                            // Apply reverse gamma correction
-                            r = r <= 0.0031308 ? 12.92 * r
-                                               : (1.0 + 0.055) * std::pow(r, (1.0 / 2.4)) - 0.055;
-                            g = g <= 0.0031308 ? 12.92 * g
-                                               : (1.0 + 0.055) * std::pow(g, (1.0 / 2.4)) - 0.055;
-                            b = b <= 0.0031308 ? 12.92 * b
-                                               : (1.0 + 0.055) * std::pow(b, (1.0 / 2.4)) - 0.055;
-
-                            r = std::clamp(r, 0.0, 1.0);
-                            g = std::clamp(g, 0.0, 1.0);
-                            b = std::clamp(b, 0.0, 1.0);
-
-                            QColor color;
-                            color.setRgbF(r, g, b);
-                            state.color(color);
-                            metadata.colorMode(EColorMode::HSV);
-                        }
-                    }
-                }
-                if (!isValid) {
-                    qDebug() << "something went wrong with the hue xy";
-                    return {};
-                }
-            } else if (metadata.hueType() == EHueType::ambient) {
-                int ct = int(stateObject["ct"].toDouble());
-                state.color(cor::colorTemperatureToRGB(ct));
-                metadata.colorMode(EColorMode::CT);
-            } else if (metadata.hueType() == EHueType::extended
-                       || metadata.hueType() == EHueType::color) {
-                if (stateObject["hue"].isDouble() && stateObject["sat"].isDouble()) {
-                    double hueF = stateObject["hue"].toDouble() / 65535.0;
-                    double satF = stateObject["sat"].toDouble() / 254.0;
-                    double briF = stateObject["bri"].toDouble() / 254.0;
-                    QColor color;
-                    hueF = std::clamp(hueF, 0.0, 1.0);
-                    satF = std::clamp(satF, 0.0, 1.0);
-                    briF = std::clamp(briF, 0.0, 1.0);
-                    color.setHsvF(hueF, satF, briF);
-                    state.color(color);
-                    metadata.colorMode(EColorMode::HSV);
-                } else {
-                    qDebug() << "something went wrong with the hue parser";
-                    return {};
-                }
-            } else if (metadata.hueType() == EHueType::white) {
-                int brightness = int(stateObject["bri"].toDouble());
-                QColor white(255, 255, 255);
-                white = white.toHsv();
-                white.setHsv(white.hue(), white.saturation(), brightness);
-                state.color(white);
-            }
-            hue.state(state);
-            if (!skipAddOrUpdate) {
-                if (wasDiscovered) {
-                    updateLight(hue);
-                    mDiscovery->updateLight(bridge.id(), metadata);
-                } else {
-                    // next, add it to the discovery function, so that HueMetadata lookups will work
-                    mDiscovery->updateLight(bridge.id(), metadata);
-                    mDiscovery->updateJSON();
-                    // remove from new lights list, if it was discovered that way.
-                    removeFromNewLightsList(metadata.name());
-                    // finally, add it to the standard commtype dict, which will signal the light
-                    // exists to the rest of the app.
-                    addLights({hue});
-                }
-            }
-            return std::make_pair(cor::Light(hue), metadata);
+    auto result = hue::parseLightUpdate(object, i);
+    if (!result.second) {
+        qDebug() << "Invalid parameters...";
+        return {};
+    }
+    return applyLightUpdate(bridge, result.first, skipAddOrUpdate);
+}
+
+std::pair<cor::Light, HueMetadata> CommHue::applyLightUpdate(const hue::Bridge& bridge,
+                                                             hue::LightUpdate update,
+                                                             bool skipAddOrUpdate) {
+    auto& metadata = update.metadata;
+    metadata.bridgeID(bridge.id());
+    HueLight hue(metadata);
+    bool wasDiscovered = fillLight(hue);
+
+    auto state = hue.state();
+    hue.isReachable(update.isReachable);
+    state.isOn(update.isOn);
+    if (update.hasColor) {
+        state.color(update.color);
+    }
+    hue.state(state);
+    if (!skipAddOrUpdate) {
+        if (wasDiscovered) {
+            updateLight(hue);
+            mDiscovery->updateLight(bridge.id(), metadata);
+        } else {
+            // next, add it to the discovery function, so that HueMetadata lookups will work
+            mDiscovery->updateLight(bridge.id(), metadata);
+            mDiscovery->updateJSON();
+            // remove from new lights list, if it was discovered that way.
+            removeFromNewLightsList(metadata.name());
+            // finally, add it to the standard commtype dict, which will signal the light
+            // exists to the rest of the app.
+            addLights({hue});
         }
     }
-    qDebug() << "Invalid parameters...";
-    return {};
+    return std::make_pair(cor::Light(hue), metadata);
 }
 
 std::pair<cor::Group, bool> CommHue::jsonToGroup(QJsonObject object, std::uint32_t key) {
@@ -913,8 +906,9 @@ void CommHue::postJson(const hue::Bridge& bridge,
     QJsonDocument doc(object);
     QString strJson(doc.toJson(QJsonDocument::Compact));
     // qDebug() << strJson;
-    mNetworkManager->post(request, strJson.toUtf8());
+    mNetworkClient->post(request, strJson.toUtf8());
     mLastSendTime = QTime::currentTime();
+    recordPacketSent(bridge.IP());
     mLastRequestHeader = resource;
     mLastRequest = strJson;
 }
@@ -930,8 +924,9 @@ void CommHue::putJson(const hue::Bridge& bridge,
     request.setHeader(QNetworkRequest::ContentTypeHeader,
                       QStringLiteral("text/html; charset=utf-8"));
     // qDebug() << "request: " << urlString << "json" << strJson;
-    mNetworkManager->put(request, strJson.toUtf8());
+    mNetworkClient->put(request, strJson.toUtf8());
     mLastSendTime = QTime::currentTime();
+    recordPacketSent(bridge.IP());
     mLastRequestHeader = resource;
     mLastRequest = strJson;
 }
@@ -989,7 +984,7 @@ void CommHue::createGroup(const hue::Bridge& bridge,
         request.setHeader(QNetworkRequest::ContentTypeHeader,
                           QStringLiteral("text/html; charset=utf-8"));
         // qDebug() << " Create Group URL STRING" << urlString;
-        mNetworkManager->post(request, payload.toUtf8());
+        mNetworkClient->post(request, payload.toUtf8());
     }
 }
 
@@ -1017,7 +1012,7 @@ void CommHue::updateGroup(const hue::Bridge& bridge,
     request.setHeader(QNetworkRequest::ContentTypeHeader,
                       QStringLiteral("text/html; charset=utf-8"));
     // qDebug() << "URL STRING" << urlString;
-    mNetworkManager->put(request, payload.toUtf8());
+    mNetworkClient->put(request, payload.toUtf8());
 }
 
 
@@ -1025,7 +1020,7 @@ void CommHue::deleteGroup(const hue::Bridge& bridge, cor::Group group) {
     auto index = bridge.groupID(group);
 
     QString urlString = urlStart(bridge) + "/groups/" + QString::number(index);
-    mNetworkManager->deleteResource(QNetworkRequest(QUrl(urlString)));
+    mNetworkClient->deleteResource(QNetworkRequest(QUrl(urlString)));
 }
 
 
@@ -1037,13 +1032,14 @@ void CommHue::updateLightStates() {
             QNetworkRequest request = QNetworkRequest(QUrl(urlString));
             request.setHeader(QNetworkRequest::ContentTypeHeader,
                               QStringLiteral("text/html; charset=utf-8"));
-            mNetworkManager->get(request);
+            mNetworkClient->get(request);
             mLastSendTime = QTime::currentTime();
+            recordPacketSent(bridge.IP());
             mLastRequestHeader = header;
             mLastRequest = QString();
             mStateUpdateCounter++;
         }
-        // checkReachability();
+        checkReachability();
     } else {
         stopStateUpdates();
     }
@@ -1057,8 +1053,9 @@ void CommHue::getGroups() {
     for (const auto& bridge : mDiscovery->bridges().items()) {
         auto header = QString("/groups");
         QString urlString = urlStart(bridge) + header;
-        mNetworkManager->get(QNetworkRequest(QUrl(urlString)));
+        mNetworkClient->get(QNetworkRequest(QUrl(urlString)));
         mLastSendTime = QTime::currentTime();
+        recordPacketSent(bridge.IP());
         mLastRequestHeader = header;
         mLastRequest = QString();
     }
@@ -1072,8 +1069,9 @@ void CommHue::getSchedules() {
     for (const auto& bridge : mDiscovery->bridges().items()) {
         auto header = QString("/schedules");
         QString urlString = urlStart(bridge) + header;
-        mNetworkManager->get(QNetworkRequest(QUrl(urlString)));
+        mNetworkClient->get(QNetworkRequest(QUrl(urlString)));
         mLastSendTime = QTime::currentTime();
+        recordPacketSent(bridge.IP());
         mLastRequestHeader = header;
         mLastRequest = QString();
     }
@@ -1083,8 +1081,9 @@ void CommHue::deleteSchedule(hue::Schedule schedule) {
     for (const auto& bridge : mDiscovery->bridges().items()) {
         auto header = "/schedules/" + QString::number(schedule.index());
         QString urlString = urlStart(bridge) + header;
-        mNetworkManager->deleteResource(QNetworkRequest(QUrl(urlString)));
+        mNetworkClient->deleteResource(QNetworkRequest(QUrl(urlString)));
         mLastSendTime = QTime::currentTime();
+        recordPacketSent(bridge.IP());
         mLastRequestHeader = header;
         mLastRequest = QString();
     }
@@ -1101,8 +1100,9 @@ void CommHue::requestNewLights(const hue::Bridge& bridge) {
     QNetworkRequest request = QNetworkRequest(QUrl(urlString));
     request.setHeader(QNetworkRequest::ContentTypeHeader,
                       QStringLiteral("text/html; charset=utf-8"));
-    mNetworkManager->get(request);
+    mNetworkClient->get(request);
     mLastSendTime = QTime::currentTime();
+    recordPacketSent(bridge.IP());
     mLastRequestHeader = header;
     mLastRequest = QString();
 }
@@ -1124,7 +1124,7 @@ void CommHue::searchForNewLights(const hue::Bridge& bridge,
     QNetworkRequest request = QNetworkRequest(QUrl(urlString));
     request.setHeader(QNetworkRequest::ContentTypeHeader,
                       QStringLiteral("text/html; charset=utf-8"));
-    mNetworkManager->post(request, payload.toUtf8());
+    mNetworkClient->post(request, payload.toUtf8());
 }
 
 void CommHue::renameLight(HueMetadata light, const QString& newName) {
@@ -1139,14 +1139,14 @@ void CommHue::renameLight(HueMetadata light, const QString& newName) {
     QNetworkRequest request = QNetworkRequest(QUrl(urlString));
     request.setHeader(QNetworkRequest::ContentTypeHeader,
                       QStringLiteral("text/html; charset=utf-8"));
-    mNetworkManager->put(QNetworkRequest(QUrl(urlString)), payload.toUtf8());
+    mNetworkClient->put(QNetworkRequest(QUrl(urlString)), payload.toUtf8());
 }
 
 void CommHue::deleteLight(const cor::Light& light) {
     auto hueLight = metadataFromLight(light);
     auto bridge = mDiscovery->bridgeFromLight(hueLight);
     QString urlString = urlStart(bridge) + "/lights/" + QString::number(hueLight.index());
-    mNetworkManager->deleteResource(QNetworkRequest(QUrl(urlString)));
+    mNetworkClient->deleteResource(QNetworkRequest(QUrl(urlString)));
 }
 
 std::vector<hue::Schedule> CommHue::schedules(const hue::Bridge& bridge) {
@@ -3,14 +3,15 @@
 
 #include <QJsonDocument>
 #include <QJsonObject>
-#include <QNetworkAccessManager>
 #include <QNetworkRequest>
+#include <QColor>
 #include <QTimer>
-#include <QWidget>
 
 #include "comm/hue/bridgediscovery.h"
+#include "comm/hue/huelightparser.h"
 #include "comm/hue/huemetadata.h"
 #include "comm/hue/hueprotocols.h"
+#include "comm/networkclient.h"
 #include "commtype.h"
 #include "cor/objects/group.h"
 
@@ -33,9 +34,13 @@ class CommHue : public CommType {
     Q_OBJECT
 public:
     /*!
-     * \brief CommHue Constructor
+     * \brief CommHue Constructor, network I/O and JSON parsing runs on the given thread. Saved
+     * bridges that are not found are probed when the shared scheduler says they are due.
      */
-    CommHue(UPnPDiscovery* UPnP, AppData* appData);
+    CommHue(UPnPDiscovery* UPnP,
+            AppData* appData,
+            CommThread* thread,
+            cor::DiscoveryScheduler<std::string>* scheduler);
 
     /*!
      * \brief CommHue Destructor
@@ -52,12 +57,20 @@ public:
      */
     void shutdown();
 
+    /// sets the traffic log and replay of this CommType and of its NetworkClient.
+    void traffic(cor::TrafficLog* log, cor::TrafficReplay* replay) override;
+
     /*!
      * \brief changeColor send a packet to a hue bridge to change the color of a given hue light.
      * \param lightIndex the index of the hue being changed.
      * \param color color to change light into
+     * \param transition time for the light to fade to the color in msec, negative to use the
+     * light's default.
      */
-    void changeColor(const hue::Bridge& bridge, int lightIndex, const QColor& color);
+    void changeColor(const hue::Bridge& bridge,
+                     int lightIndex,
+                     const QColor& color,
+                     int transition);
 
     /*!
      * \brief changeAmbientLight changes the color of the bulb to match the color temperature given.
@@ -67,8 +80,14 @@ public:
      * \param brightness brightness between 0 and 100, with 100 being full brightness.
      * \param ct a new value for the color temperature, given in meriks. Must be between 153 and
      * 500.
+     * \param transition time for the light to fade to the color in msec, negative to use the
+     * light's default.
      */
-    void changeColorCT(const hue::Bridge& bridge, int lightIndex, int brightness, int ct);
+    void changeColorCT(const hue::Bridge& bridge,
+                       int lightIndex,
+                       int brightness,
+                       int ct,
+                       int transition);
 
     /// true to turn on, false to turn off
     void turnOnOff(const hue::Bridge& bridge, int index, bool shouldTurnOn);
@@ -270,14 +289,22 @@ public:
      * \param deviceIndex 0 for all indices, a specific index for a specific light.
      *        Will do nothing if index doesn't exist.
      * \param brightness a value between 0 and 100, 0 is off, 100 is full brightness
+     * \param transition time for the light to fade to the brightness in msec, negative to use the
+     * light's default.
      */
-    void brightnessChange(const hue::Bridge& bridge, int deviceIndex, int brightness);
+    void brightnessChange(const hue::Bridge& bridge,
+                          int deviceIndex,
+                          int brightness,
+                          int transition);
 
     /*!
      * \brief routineChange change the light state of the hue. This JSON object will contain a color
      * and other information about the light.
      */
-    void routineChange(const hue::Bridge& bridge, int deviceIndex, QJsonObject);
+    void routineChange(const hue::Bridge& bridge,
+                       int deviceIndex,
+                       QJsonObject routineObject,
+                       int transition);
 
     /*!
      * \brief connectionStatusHasChanged called by the HueBridgeDiscovery object whenever its
@@ -314,10 +341,10 @@ signals:
 private slots:
 
     /*!
-     * \brief replyFinished called whenever the mNetworkManager receives a response to its HTTP
+     * \brief replyFinished called whenever the mNetworkClient receives a response to its HTTP
      * requests.Used for parsing the responses.
      */
-    void replyFinished(QNetworkReply*);
+    void replyFinished(NetworkResponse);
 
     /*!
      * \brief updateLightStates called on a timer continually to poll the states of the Hue lights.
@@ -342,9 +369,9 @@ private:
     void resetBackgroundTimers();
 
     /*!
-     * \brief mNetworkManager Qt's HTTP connection object
+     * \brief mNetworkClient sends HTTP requests and parses their JSON on the comm thread
      */
-    QNetworkAccessManager* mNetworkManager;
+    NetworkClient* mNetworkClient;
 
     /*!
      * \brief mDiscovery object used to discover and connect to a Hue Bridge.
@@ -466,6 +493,18 @@ private:
                                                            int i,
                                                            bool skipAddOrUpdate);
 
+    /*!
+     * \brief applyLightUpdate merges the decoded state of a light into the light that is already
+     * known, and then updates the internal representations of the hue bridge and the light.
+     * \param bridge bridge that sent the update
+     * \param update the decoded state of the light
+     * \param skipAddOrUpdate true to only return the merged light, without storing it.
+     * \return the merged light and its metadata
+     */
+    std::pair<cor::Light, HueMetadata> applyLightUpdate(const hue::Bridge& bridge,
+                                                        hue::LightUpdate update,
+                                                        bool skipAddOrUpdate);
+
     /*!
      * \brief updateNewHueLight a new hue light was discovered from scanning, add the meta data to
      * the list of newly discovered lights
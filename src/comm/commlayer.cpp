@@ -8,11 +8,12 @@
 
 #include "comm/commarducor.h"
 #include "utils/exception.h"
-#include "utils/qt.h"
 #ifdef USE_SERIAL
 #include "comm/commserial.h"
 #endif // USE_SERIAL
 #include <QDebug>
+#include <algorithm>
+#include <fstream>
 #include <iostream>
 #include <ostream>
 #include <sstream>
@@ -21,14 +22,50 @@
 #include "comm/commhue.h"
 #include "comm/commnanoleaf.h"
 #include "comm/commudp.h"
+#include "comm/lightstateservice.h"
+#include "comm/networkmonitor.h"
 #include "comm/upnpdiscovery.h"
 
+namespace {
+
+/// msec between each measurement of the event loop's lag
+const int kEventLoopInterval = 100;
+
+/// msec between each drain of the light deltas, about once per frame at 60 fps
+const int kDeltaDrainInterval = 16;
+
+/// msec before the second probe of a device that is not found, doubled for each probe after.
+const std::int64_t kDiscoveryBaseInterval = 2500;
+
+/// longest msec between two probes of a device that is not found.
+const std::int64_t kDiscoveryMaxInterval = 300000;
+
+/// max number of discovery probes in flight across all protocols.
+const std::size_t kDiscoveryMaxProbes = 8u;
+
+/// msec that a discovery probe counts as in flight.
+const std::int64_t kDiscoveryProbeTimeout = 5000;
+
+} // namespace
+
 CommLayer::CommLayer(QObject* parent, AppData* parser, PaletteData* palettes)
     : QObject(parent),
-      mGroups(parser->groups()) {
+      mDiscoveryScheduler(kDiscoveryBaseInterval,
+                          kDiscoveryMaxInterval,
+                          kDiscoveryMaxProbes,
+                          kDiscoveryProbeTimeout),
+      mGroups(parser->groups()),
+      mMoods(parser->moods()),
+      mMoodPlanGroupRevision{0u},
+      mMoodPlanMoodRevision{0u},
+      mMoodPlanLightRevision{0u},
+      mLightRevision{0u},
+      mReplayTimer{nullptr},
+      mNetworkMonitor{new NetworkMonitor(this)} {
     mUPnP = new UPnPDiscovery(this);
+    mLightStates = new LightStateService(this, mGroups, this);
 
-    mArduCor = new CommArduCor(this, palettes);
+    mArduCor = new CommArduCor(this, palettes, &mCommThread, &mDiscoveryScheduler);
     connect(mArduCor, SIGNAL(updateReceived(ECommType)), this, SLOT(receivedUpdate(ECommType)));
     connect(mArduCor,
             SIGNAL(newLightsFound(ECommType, std::vector<cor::LightID>)),
@@ -39,7 +76,7 @@ CommLayer::CommLayer(QObject* parent, AppData* parser, PaletteData* palettes)
             this,
             SLOT(deletedLights(ECommType, std::vector<cor::LightID>)));
 
-    mNanoleaf = new CommNanoleaf();
+    mNanoleaf = new CommNanoleaf(&mCommThread, &mDiscoveryScheduler);
     connect(mNanoleaf, SIGNAL(updateReceived(ECommType)), this, SLOT(receivedUpdate(ECommType)));
     connect(mNanoleaf,
             SIGNAL(newLightsFound(ECommType, std::vector<cor::LightID>)),
@@ -52,7 +89,7 @@ CommLayer::CommLayer(QObject* parent, AppData* parser, PaletteData* palettes)
 
     mNanoleaf->discovery()->connectUPnP(mUPnP);
 
-    mHue = new CommHue(mUPnP, parser);
+    mHue = new CommHue(mUPnP, parser, &mCommThread, &mDiscoveryScheduler);
     connect(mHue, SIGNAL(updateReceived(ECommType)), this, SLOT(receivedUpdate(ECommType)));
     connect(mHue,
             SIGNAL(newLightsFound(ECommType, std::vector<cor::LightID>)),
@@ -67,6 +104,202 @@ CommLayer::CommLayer(QObject* parent, AppData* parser, PaletteData* palettes)
             SIGNAL(lightNameChanged(cor::LightID, QString)),
             this,
             SLOT(handleLightNameChanged(cor::LightID, QString)));
+
+    // the deltas are drained on the frame after the first update, so an idle app does not wake up
+    // every frame.
+    mDeltaTimer = new QTimer(this);
+    mDeltaTimer->setSingleShot(true);
+    mDeltaTimer->setInterval(kDeltaDrainInterval);
+    connect(mDeltaTimer, SIGNAL(timeout()), this, SLOT(drainLightDeltas()));
+
+    for (int i = 0; i < int(ECommType::MAX); ++i) {
+        commByType(ECommType(i))->metrics(&mMetrics);
+        auto name = commTypeToString(ECommType(i)).toLower().toStdString();
+        mDeltaMetrics[std::size_t(i)].coalesced =
+            &mMetrics.counter("comm." + name + ".deltas_coalesced");
+        mDeltaMetrics[std::size_t(i)].overflowed =
+            &mMetrics.counter("comm." + name + ".deltas_overflowed");
+        connect(commByType(ECommType(i)),
+                SIGNAL(deltasQueued()),
+                this,
+                SLOT(scheduleDeltaDrain()));
+    }
+    setupTraffic();
+
+    connect(mNetworkMonitor,
+            SIGNAL(availabilityChanged(bool)),
+            this,
+            SLOT(handleNetworkAvailability(bool)));
+
+    mEventLoopTimer = new QTimer(this);
+    mEventLoopTimer->setInterval(kEventLoopInterval);
+    connect(mEventLoopTimer, SIGNAL(timeout()), this, SLOT(measureEventLoopLag()));
+}
+
+void CommLayer::probeEventLoopLag(bool enable) {
+    if (enable && !mEventLoopTimer->isActive()) {
+        mEventLoopClock.start();
+        mEventLoopTimer->start();
+    } else if (!enable) {
+        mEventLoopTimer->stop();
+    }
+}
+
+void CommLayer::scheduleDeltaDrain() {
+    if (!mDeltaTimer->isActive()) {
+        mDeltaTimer->start();
+    }
+}
+
+void CommLayer::drainLightDeltas() {
+    std::vector<cor::LightID> changedLights;
+    for (int i = 0; i < int(ECommType::MAX); ++i) {
+        auto type = ECommType(i);
+        auto commType = commByType(type);
+        auto& deltas = commType->deltas();
+        auto previousStats = deltas.stats();
+        auto count = deltas.drain([&changedLights](const std::string& key, bool) {
+            changedLights.emplace_back(QString::fromStdString(key));
+        });
+        if (deltas.takeOverflow()) {
+            // some deltas were dropped, so treat every light of this type as changed.
+            for (const auto& key : commType->lightDict().keys()) {
+                changedLights.emplace_back(QString::fromStdString(key));
+            }
+            count += commType->lightDict().size();
+        }
+
+        auto stats = deltas.stats();
+        const auto& metrics = mDeltaMetrics[std::size_t(i)];
+        metrics.coalesced->add(stats.coalesced - previousStats.coalesced);
+        metrics.overflowed->add(stats.overflowed - previousStats.overflowed);
+        if (count > 0u) {
+            emit updateReceived(type);
+        }
+    }
+
+    if (!changedLights.empty()) {
+        // a light can appear twice if its comm type overflowed, so remove duplicates.
+        std::sort(changedLights.begin(),
+                  changedLights.end(),
+                  [](const cor::LightID& a, const cor::LightID& b) {
+                      return a.toString() < b.toString();
+                  });
+        changedLights.erase(std::unique(changedLights.begin(), changedLights.end()),
+                            changedLights.end());
+        emit lightsUpdated(changedLights);
+    }
+}
+
+CommLayer::~CommLayer() {
+    // the CommTypes are deleted while the comm thread still runs, so their workers are deleted on
+    // it, and before the metrics, scheduler, and traffic log that they point to.
+    delete mHue;
+    mHue = nullptr;
+    delete mNanoleaf;
+    mNanoleaf = nullptr;
+    delete mArduCor;
+    mArduCor = nullptr;
+}
+
+void CommLayer::setupTraffic() {
+    auto capturePath = qEnvironmentVariable("CORLUMA_CAPTURE_FILE");
+    if (!capturePath.isEmpty()) {
+        mTrafficLog = std::make_unique<cor::TrafficLog>(capturePath.toStdString());
+        if (mTrafficLog->isOpen()) {
+            qDebug() << "INFO: capturing device traffic to" << capturePath;
+        } else {
+            qDebug() << "WARNING: could not open traffic capture" << capturePath;
+            mTrafficLog.reset();
+        }
+    }
+
+    auto replayPath = qEnvironmentVariable("CORLUMA_REPLAY_FILE");
+    if (!replayPath.isEmpty()) {
+        std::ifstream file(replayPath.toStdString());
+        if (file.is_open()) {
+            bool isValidSpeed = false;
+            auto speed = qEnvironmentVariable("CORLUMA_REPLAY_SPEED").toDouble(&isValidSpeed);
+            mTrafficReplay = std::make_unique<cor::TrafficReplay>(cor::readTrafficLog(file),
+                                                                  isValidSpeed ? speed : 1.0);
+            qDebug() << "INFO: replaying device traffic from" << replayPath << "at speed"
+                     << mTrafficReplay->speed();
+            mReplayTimer = new QTimer(this);
+            mReplayTimer->setSingleShot(true);
+            connect(mReplayTimer, SIGNAL(timeout()), this, SLOT(replayTraffic()));
+        } else {
+            qDebug() << "WARNING: could not open traffic replay" << replayPath;
+        }
+    }
+
+    for (int i = 0; i < int(ECommType::MAX); ++i) {
+        commByType(ECommType(i))->traffic(mTrafficLog.get(), mTrafficReplay.get());
+    }
+    if (mTrafficReplay) {
+        mReplayClock.start();
+        mReplayTimer->start(0);
+    }
+}
+
+void CommLayer::replayTraffic() {
+    for (const auto& packet : mTrafficReplay->takePackets(mReplayClock.elapsed())) {
+        auto type = stringToCommType(QString::fromStdString(packet.source));
+        if (type == ECommType::MAX) {
+            continue;
+        }
+        commByType(type)->replayPacket(QString::fromStdString(packet.endpoint),
+                                       QString::fromStdString(packet.payload));
+        mMetrics.counter("replay.packets").add();
+    }
+    if (mTrafficReplay->isFinished()) {
+        qDebug() << "INFO: replay finished after" << mReplayClock.elapsed() << "msec,"
+                 << mTrafficReplay->missedRequests() << "requests had no captured response";
+    } else {
+        auto wait = mTrafficReplay->nextPacketTime() - mReplayClock.elapsed();
+        mReplayTimer->start(int(std::max<std::int64_t>(0, wait)));
+    }
+}
+
+bool CommLayer::isNetworkAvailable() const {
+    return mNetworkMonitor->isAvailable();
+}
+
+void CommLayer::handleNetworkAvailability(bool isAvailable) {
+    if (!isAvailable) {
+        // serial doesn't need the network, so it keeps running.
+        for (auto type : {ECommType::HTTP, ECommType::UDP, ECommType::hue, ECommType::nanoleaf}) {
+            auto commType = commByType(type);
+            if (commType->isActive()) {
+                commType->stopStateUpdates();
+                mPausedStateUpdates.push_back(type);
+            }
+        }
+        // arducor discovery also finds serial devices, so only hue and nanoleaf are paused.
+        if (mHue->discovery()->isRunning()) {
+            mHue->discovery()->stopDiscovery();
+            mPausedDiscovery.push_back(EProtocolType::hue);
+        }
+        if (mNanoleaf->discovery()->isRunning()) {
+            mNanoleaf->discovery()->stopDiscovery();
+            mPausedDiscovery.push_back(EProtocolType::nanoleaf);
+        }
+    } else {
+        for (auto type : mPausedStateUpdates) {
+            commByType(type)->resetStateUpdateTimeout();
+        }
+        for (auto type : mPausedDiscovery) {
+            startDiscovery(type);
+        }
+        mPausedStateUpdates.clear();
+        mPausedDiscovery.clear();
+    }
+    emit networkAvailabilityChanged(isAvailable);
+}
+
+void CommLayer::measureEventLoopLag() {
+    auto elapsed = mEventLoopClock.restart();
+    auto lag = std::max(qint64(0), elapsed - kEventLoopInterval);
+    mMetrics.histogram("ui.event_loop_lag_ms").record(std::uint64_t(lag));
 }
 
 bool CommLayer::discoveryErrorsExist(EProtocolType type) {
@@ -85,14 +318,17 @@ bool CommLayer::discoveryErrorsExist(EProtocolType type) {
 }
 
 void CommLayer::lightsFound(ECommType, std::vector<cor::LightID> uniqueIDs) {
+    ++mLightRevision;
     emit lightsAdded(uniqueIDs);
 }
 
 void CommLayer::deletedLights(ECommType, std::vector<cor::LightID> uniqueIDs) {
+    ++mLightRevision;
     emit lightsDeleted(uniqueIDs);
 }
 
 void CommLayer::handleLightNameChanged(cor::LightID uniqueID, QString newName) {
+    ++mLightRevision;
     emit lightNameChanged(uniqueID, newName);
 }
 
@@ -233,24 +469,18 @@ bool CommLayer::saveNewGroup(const cor::Group& group) {
 }
 
 
-cor::Dictionary<cor::Light> CommLayer::makeMood(const cor::Mood& mood) {
-    cor::Dictionary<cor::Light> moodDict;
-
+cor::MoodPlan CommLayer::compileMoodPlan(const cor::Mood& mood) {
     // split defaults into rooms and groups
     std::vector<std::pair<cor::Group, cor::LightState>> rooms;
     std::vector<std::pair<cor::Group, cor::LightState>> groups;
+    const auto& groupDict = mGroups->groupDict();
     for (const auto& defaultState : mood.defaults()) {
-        for (const auto& collection : mGroups->groups()) {
-            if (defaultState.uniqueID() == collection.uniqueID()) {
-                groups.emplace_back(collection, defaultState.state());
-            }
-        }
-    }
-
-    for (const auto& defaultState : mood.defaults()) {
-        for (const auto& collection : mGroups->rooms()) {
-            if (defaultState.uniqueID() == collection.uniqueID()) {
-                rooms.emplace_back(collection, defaultState.state());
+        const auto& result = groupDict.item(defaultState.uniqueID().toStdString());
+        if (result.second) {
+            if (result.first.type() == cor::EGroupType::room) {
+                rooms.emplace_back(result.first, defaultState.state());
+            } else if (result.first.type() == cor::EGroupType::group) {
+                groups.emplace_back(result.first, defaultState.state());
             }
         }
     }
@@ -259,75 +489,101 @@ cor::Dictionary<cor::Light> CommLayer::makeMood(const cor::Mood& mood) {
     std::sort(rooms.begin(), rooms.end(), sortListByGroupName);
     std::sort(groups.begin(), groups.end(), sortListByGroupName);
 
+    // later states override earlier states, so that the order of precedence is rooms, then
+    // groups, then the lights that are explicitly defined in the mood.
+    std::vector<cor::LightID> order;
+    std::unordered_map<cor::LightID, cor::LightState> states;
+    auto applyState = [&order, &states](const cor::LightID& lightID,
+                                        const cor::LightState& state) {
+        auto result = states.find(lightID);
+        if (result == states.end()) {
+            order.push_back(lightID);
+            states.emplace(lightID, state);
+        } else {
+            result->second = state;
+        }
+    };
+
     // first apply the room(s) ...
     for (const auto& room : rooms) {
         for (const auto& lightID : room.first.lights()) {
-            auto light = lightByID(lightID);
-            if (light.isValid()) {
-                light = addLightMetaData(light);
-                light.state(room.second);
-                const auto& key = light.uniqueID().toStdString();
-                // check if light exists in list already
-                const auto& result = moodDict.item(key);
-                if (result.second) {
-                    // update if it exists
-                    moodDict.update(key, light);
-                } else {
-                    // add if it doesnt
-                    moodDict.insert(key, light);
-                }
-            }
+            applyState(lightID, room.second);
         }
     }
 
     // ... then apply the group(s) ...
     for (const auto& group : groups) {
-        for (const auto& light : group.first.lights()) {
-            auto lightCopy = lightByID(light);
-            if (lightCopy.isValid()) {
-                lightCopy = addLightMetaData(lightCopy);
-                lightCopy.state(group.second);
-                const auto& key = lightCopy.uniqueID().toStdString();
-                // check if light exists in list already
-                const auto& result = moodDict.item(key);
-                if (result.second) {
-                    // update if it exists
-                    moodDict.update(key, lightCopy);
-                } else {
-                    // add if it doesnt
-                    moodDict.insert(key, lightCopy);
-                }
-            }
+        for (const auto& lightID : group.first.lights()) {
+            applyState(lightID, group.second);
         }
     }
 
-
-    // ... now check that all lights exist
-    std::vector<cor::Light> lightList;
+    // ... now apply the specific lights
     for (const auto& light : mood.lights()) {
-        auto lightInMemory = lightByID(light.uniqueID());
-        if (lightInMemory.isValid()) {
-            lightInMemory = addLightMetaData(lightInMemory);
-            lightInMemory.state(light.state());
-            lightList.push_back(lightInMemory);
+        applyState(light.uniqueID(), light.state());
+    }
+
+    // resolve the lights that exist
+    std::vector<cor::Light> lights;
+    lights.reserve(order.size());
+    for (const auto& lightID : order) {
+        auto light = lightByID(lightID);
+        if (light.isValid()) {
+            light.state(states[lightID]);
+            lights.push_back(light);
         }
     }
+    return cor::MoodPlan(mood.uniqueID(), lights);
+}
 
-    // ... now apply the specific lights
-    for (const auto& light : lightList) {
-        const auto& key = light.uniqueID().toStdString();
-        // check if light exists in list already
-        const auto& result = moodDict.item(key);
-        if (result.second) {
-            // update if it exists
-            moodDict.update(key, light);
-        } else {
-            // add if it doesnt
-            moodDict.insert(key, light);
+void CommLayer::checkMoodPlansAreCurrent() {
+    if (mMoodPlanGroupRevision != mGroups->revision()
+        || mMoodPlanMoodRevision != mMoods->revision()
+        || mMoodPlanLightRevision != mLightRevision) {
+        mMoodPlans.clear();
+        mMoodPlanGroupRevision = mGroups->revision();
+        mMoodPlanMoodRevision = mMoods->revision();
+        mMoodPlanLightRevision = mLightRevision;
+    }
+}
+
+cor::MoodPlan CommLayer::moodPlan(const cor::UUID& moodID) {
+    checkMoodPlansAreCurrent();
+    auto plan = mMoodPlans.plan(moodID);
+    if (plan != nullptr) {
+        return *plan;
+    }
+    const auto& result = mMoods->moods().item(moodID.toStdString());
+    if (!result.second) {
+        return {};
+    }
+    auto newPlan = compileMoodPlan(result.first);
+    mMoodPlans.insert(newPlan);
+    return newPlan;
+}
+
+const cor::MoodPlanIndex& CommLayer::moodPlans() {
+    checkMoodPlansAreCurrent();
+    if (mMoodPlans.size() != mMoods->moods().size()) {
+        for (const auto& mood : mMoods->moods().items()) {
+            if (mMoodPlans.plan(mood.uniqueID()) == nullptr) {
+                mMoodPlans.insert(compileMoodPlan(mood));
+            }
         }
     }
+    return mMoodPlans;
+}
 
-    return moodDict;
+std::vector<cor::Light> CommLayer::lightsFromMoodPlan(const cor::MoodPlan& plan) const {
+    std::vector<cor::Light> lights;
+    lights.reserve(plan.lights().size());
+    for (auto light : plan.lights()) {
+        const auto& result =
+            commByType(light.commType())->lightDict().item(light.uniqueID().toStdString());
+        light.isReachable(result.second && result.first.isReachable());
+        lights.push_back(light);
+    }
+    return lights;
 }
 
 EColorPickerType CommLayer::bestColorPickerType(const std::vector<cor::Light>& lights) {
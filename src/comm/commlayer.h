@@ -3,23 +3,31 @@
 #define COMMLAYER_H
 
 #include <QColor>
-#include <QWidget>
+#include <QObject>
+#include <array>
 
+#include <memory>
 #include <unordered_set>
-#include "colorpicker/colorpicker.h"
 #include "comm/arducor/arducordiscovery.h"
+#include "comm/commthread.h"
 #include "comm/commtype.h"
 #include "comm/hue/huemetadata.h"
 #include "comm/hue/hueprotocols.h"
+#include "cor/discoveryscheduler.h"
 #include "cor/objects/group.h"
 #include "cor/objects/light.h"
 #include "cor/objects/mood.h"
+#include "cor/objects/moodplan.h"
 #include "cor/objects/palettegroup.h"
 #include "cor/protocols.h"
+#include "cor/trafficlog.h"
+#include "cor/trafficreplay.h"
 #include "data/appdata.h"
 #include "data/palettedata.h"
 
 class UPnPDiscovery;
+class NetworkMonitor;
+class LightStateService;
 class CommArduCor;
 class CommHue;
 class CommNanoleaf;
@@ -48,6 +56,12 @@ class CommNanoleaf;
  * A UPnP discovery object is also wrapped by CommLayer, which is used to discover lights that give
  * their discovery information over UPnP. Since UPnP requires binding to a socket, all discovery
  * objects share the same UPnPDiscovery object, and subscribe/unsubscribe to listening to it.
+ *
+ * The traffic of every CommType can be captured to a file and replayed later without the devices,
+ * so that problems that need a specific set of devices can be reproduced and measured. Setting the
+ * environment variable CORLUMA_CAPTURE_FILE to a path captures to that file. Setting
+ * CORLUMA_REPLAY_FILE to a capture replays it in place of the devices, and
+ * CORLUMA_REPLAY_SPEED speeds up the replay, such as 10 for ten times faster.
  */
 class CommLayer : public QObject {
     Q_OBJECT
@@ -57,6 +71,9 @@ public:
      */
     CommLayer(QObject* parent, AppData* appData, PaletteData* palettes);
 
+    /// destructor
+    ~CommLayer();
+
     /*!
      * \brief resetStateUpdates reset the state updates timeouts for specified commtypes. If it
      * isn't on already, it gets turned on.
@@ -151,8 +168,26 @@ public:
      */
     bool saveNewGroup(const cor::Group& group);
 
-    /// makes a dictionary of lights based off of the formula provided by a mood object.
-    cor::Dictionary<cor::Light> makeMood(const cor::Mood& mood);
+    /// makes a vector of lights based off of the formula provided by a mood object. The mood does
+    /// not need to be saved, so this always compiles a fresh plan.
+    std::vector<cor::Light> makeMood(const cor::Mood& mood) {
+        return lightsFromMoodPlan(compileMoodPlan(mood));
+    }
+
+    /// resolves the states of all lights in a mood, including the default states of its groups
+    /// and rooms, into a plan of each light's target state and a content hash of the result.
+    cor::MoodPlan compileMoodPlan(const cor::Mood& mood);
+
+    /// getter for the plan of a saved mood. Plans are cached and only recompiled if the moods,
+    /// groups, or lights change. Returns an invalid plan if the mood is not saved.
+    cor::MoodPlan moodPlan(const cor::UUID& moodID);
+
+    /// plans for all saved moods, used to find which mood matches the current state of lights.
+    const cor::MoodPlanIndex& moodPlans();
+
+    /// converts a plan into a vector of lights, updating their reachability to match their
+    /// current state.
+    std::vector<cor::Light> lightsFromMoodPlan(const cor::MoodPlan& plan) const;
 
     /// list of all devices from all comm types
     std::vector<cor::Light> allLights();
@@ -215,8 +250,31 @@ public:
 
     /// getter for UPnP object
     UPnPDiscovery* UPnP() { return mUPnP; }
+
+    /// registry of packet counts, latencies, and sync retries for all comm types
+    cor::MetricsRegistry& metrics() { return mMetrics; }
+
+    /*!
+     * \brief probeEventLoopLag starts or stops recording the lag of the GUI thread's event loop in
+     * the metrics. The probe wakes the app up ten times a second, so it only runs while something
+     * reads the metrics.
+     */
+    void probeEventLoopLag(bool enable);
+
+    /// true if the local network is available
+    bool isNetworkAvailable() const;
+
+    /// running totals of the states of the selected lights and of each group
+    LightStateService* lightStates() { return mLightStates; }
 signals:
 
+    /*!
+     * \brief networkAvailabilityChanged emitted when the local network becomes available or
+     * unavailable. While it is unavailable, state updates and discovery over the network are
+     * paused.
+     */
+    void networkAvailabilityChanged(bool);
+
     /*!
      * \brief packetReceived anotification that a packet was receieved by one of the commtypes.
      */
@@ -237,11 +295,32 @@ signals:
     /// emits when a light changes its name
     void lightNameChanged(cor::LightID, QString);
 
+    /// emits at most once per frame with every light whose state changed since the last frame.
+    void lightsUpdated(std::vector<cor::LightID>);
+
 private slots:
 
     /// forwards slots from internal connection objects to anything listening to CommLayer
     void receivedPacket(EProtocolType type) { emit packetReceived(type); }
 
+    /// records how late the event loop was in running mEventLoopTimer
+    void measureEventLoopLag();
+
+    /// hands the packets that are due in the replay to their CommTypes.
+    void replayTraffic();
+
+    /// pauses network state updates and discovery when the network is lost, resumes them after.
+    void handleNetworkAvailability(bool isAvailable);
+
+    /*!
+     * \brief drainLightDeltas drains the light updates queued by each comm type since the last
+     * frame, and signals each comm type and light that changed once.
+     */
+    void drainLightDeltas();
+
+    /// starts mDeltaTimer, if it is not already running, after a comm type queues a delta.
+    void scheduleDeltaDrain();
+
     /*!
      * \brief receivedUpdate Each CommType signals out where it receives an update. This slot
      * combines and forwards these signals into its own updateReceived signal.
@@ -264,6 +343,10 @@ private slots:
     void deletedLights(ECommType, std::vector<cor::LightID>);
 
 private:
+    /// thread that device I/O and the first pass of parsing runs on. It is destroyed after the
+    /// CommTypes, which are deleted explicitly by the destructor.
+    CommThread mCommThread;
+
     /*!
      * \brief mArduCor ArudCor connection object
      */
@@ -282,9 +365,90 @@ private:
     /// Handles discovery of devices over UPnP
     UPnPDiscovery* mUPnP;
 
+    /// decides when saved devices that are not found are probed, shared by all protocols so that
+    /// the number of probes in flight is capped globally.
+    cor::DiscoveryScheduler<std::string> mDiscoveryScheduler;
+
     /// saved group data, persistent between reloading the app
     GroupData* mGroups;
 
+    /// saved mood data, persistent between reloading the app
+    MoodData* mMoods;
+
+    /// compiled plans for saved moods.
+    cor::MoodPlanIndex mMoodPlans;
+
+    /// revision of the groups used to compile mMoodPlans
+    std::uint64_t mMoodPlanGroupRevision;
+
+    /// revision of the moods used to compile mMoodPlans
+    std::uint64_t mMoodPlanMoodRevision;
+
+    /// revision of the lights used to compile mMoodPlans
+    std::uint64_t mMoodPlanLightRevision;
+
+    /// incremented whenever lights are added, removed, or renamed.
+    std::uint64_t mLightRevision;
+
+    /// registry of packet counts, latencies, and sync retries for all comm types
+    cor::MetricsRegistry mMetrics;
+
+    /*!
+     * \brief mEventLoopTimer fires on a fixed interval while probeEventLoopLag() is enabled, so
+     * that the lag of the GUI thread's event loop can be recorded in the metrics. Lag that grows
+     * with device traffic means device I/O is blocking the GUI thread.
+     */
+    QTimer* mEventLoopTimer;
+
+    /// measures the time between each timeout of mEventLoopTimer
+    QElapsedTimer mEventLoopClock;
+
+    /// single shot timer that drains the light deltas of each comm type on the frame after the
+    /// first delta is queued.
+    QTimer* mDeltaTimer;
+
+    /// counters of the deltas of a comm type, looked up once since they are recorded every drain.
+    struct DeltaMetrics {
+        /// deltas merged into a delta that was already queued
+        cor::MetricCounter* coalesced = nullptr;
+
+        /// deltas dropped because the queue was full
+        cor::MetricCounter* overflowed = nullptr;
+    };
+
+    /// counters of the deltas of each comm type, indexed by ECommType.
+    std::array<DeltaMetrics, std::size_t(ECommType::MAX)> mDeltaMetrics;
+
+    /// log that device traffic is captured to, nullptr if traffic is not captured.
+    std::unique_ptr<cor::TrafficLog> mTrafficLog;
+
+    /// replay that stands in for the devices, nullptr if traffic is not replayed.
+    std::unique_ptr<cor::TrafficReplay> mTrafficReplay;
+
+    /// fires when the next packet of the replay is due.
+    QTimer* mReplayTimer;
+
+    /// measures the time since the replay started
+    QElapsedTimer mReplayClock;
+
+    /// starts capturing or replaying traffic, if the environment asks for it.
+    void setupTraffic();
+
+    /// signals when the local network becomes available or unavailable.
+    NetworkMonitor* mNetworkMonitor;
+
+    /// running totals of the states of the selected lights and of each group
+    LightStateService* mLightStates;
+
+    /// comm types whose state updates were paused when the network was lost.
+    std::vector<ECommType> mPausedStateUpdates;
+
+    /// protocols whose discovery was paused when the network was lost.
+    std::vector<EProtocolType> mPausedDiscovery;
+
+    /// clears mMoodPlans if any of the data used to compile them has changed.
+    void checkMoodPlansAreCurrent();
+
     /*!
      * \brief commByType returns the raw CommPtr based off the given commType
      * \param type the comm type to get a pointer to
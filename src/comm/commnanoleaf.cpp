@@ -22,16 +22,34 @@
 //#define DEBUG_LEAF_SCHEDULES
 //#define DEBUG_LEAF_TOUCHY
 
+namespace {
 
-CommNanoleaf::CommNanoleaf()
+/// decodes state update packets on the comm thread, other packets are left to the GUI thread.
+QVariant decodeStateUpdate(const NetworkResponse& response) {
+    if (!response.json.isObject()) {
+        return {};
+    }
+    auto object = response.json.object();
+    // a panel layout without a layout cannot be decoded.
+    if (!nano::LeafMetadata::isValidJson(object)
+        || !object["panelLayout"].toObject()["layout"].isObject()) {
+        return {};
+    }
+    return QVariant::fromValue(nano::LeafStateUpdate(object));
+}
+
+} // namespace
+
+CommNanoleaf::CommNanoleaf(CommThread* thread, cor::DiscoveryScheduler<std::string>* scheduler)
     : CommType(ECommType::nanoleaf),
       mUPnP{nullptr},
       mPacketParser{},
+      mScheduleRevision{0u},
       mScheduleTimer{new QTimer(this)},
       mEffectTimer{new QTimer(this)} {
     mStateUpdateInterval = 1000;
 
-    mDiscovery = new nano::LeafDiscovery(this, 4000);
+    mDiscovery = new nano::LeafDiscovery(this, 4000, scheduler);
     mDiscovery->loadJSON();
     // make list of not found devices
     std::vector<cor::Light> lights;
@@ -40,11 +58,12 @@ CommNanoleaf::CommNanoleaf()
     }
     addLights(lights);
 
-    mNetworkManager = new QNetworkAccessManager(this);
-    connect(mNetworkManager,
-            SIGNAL(finished(QNetworkReply*)),
+    qRegisterMetaType<nano::LeafStateUpdate>();
+    mNetworkClient = new NetworkClient(thread, true, this, decodeStateUpdate);
+    connect(mNetworkClient,
+            SIGNAL(finished(NetworkResponse)),
             this,
-            SLOT(replyFinished(QNetworkReply*)));
+            SLOT(replyFinished(NetworkResponse)));
 
     connect(mStateUpdateTimer, SIGNAL(timeout()), this, SLOT(stateUpdate()));
 
@@ -59,7 +78,8 @@ void CommNanoleaf::getSchedules() {
 #ifdef DEBUG_LEAF_SCHEDULES
             qDebug() << __func__ << " get schedule for " << light.name();
 #endif
-            mNetworkManager->get(request);
+            mNetworkClient->get(request);
+            recordPacketSent(request.url().host());
             mLastSendTime = QTime::currentTime();
         }
     } else {
@@ -72,6 +92,9 @@ void CommNanoleaf::getSchedules() {
 void CommNanoleaf::getEffects() {
     if (shouldContinueStateUpdate()) {
         for (const auto& light : mDiscovery->foundLights().items()) {
+            if (!mEffectCaches[light.serialNumber().toStdString()].shouldFetch()) {
+                continue;
+            }
             QNetworkRequest request = networkRequest(light, "effects");
 
             QJsonObject effectObject;
@@ -102,6 +125,9 @@ void CommNanoleaf::updateSchedule(const nano::LeafMetadata& light,
         const auto& existingSchedule =
             scheduleDict.item(QString::number(schedule.ID()).toStdString());
         if (existingSchedule.second) { // found in schedule
+            if (existingSchedule.first.isIdentical(schedule)) {
+                return;
+            }
 #ifdef DEBUG_LEAF_SCHEDULES
             qDebug() << " updating existing schedule: " << schedule.ID() << " for "
                      << light.serialNumber() << "time for schedule"
@@ -117,6 +143,7 @@ void CommNanoleaf::updateSchedule(const nano::LeafMetadata& light,
         }
         // update the unorded map
         result->second = scheduleDict;
+        ++mScheduleRevision;
     } else {
         // no schedules for this light found, create a dictionary
         cor::Dictionary<nano::LeafSchedule> schedules;
@@ -126,6 +153,7 @@ void CommNanoleaf::updateSchedule(const nano::LeafMetadata& light,
                  << " for light: " << light.serialNumber();
 #endif
         mSchedules.insert(std::make_pair(light.serialNumber().toStdString(), schedules));
+        ++mScheduleRevision;
     }
 }
 
@@ -255,6 +283,11 @@ void CommNanoleaf::shutdown() {
     }
 }
 
+void CommNanoleaf::traffic(cor::TrafficLog* log, cor::TrafficReplay* replay) {
+    CommType::traffic(log, replay);
+    mNetworkClient->traffic(log, replay, commTypeToString(mType));
+}
+
 const QString CommNanoleaf::packetHeader(const nano::LeafMetadata& light) {
     return QString(light.IP() + "/api/v1/" + light.authToken() + "/");
 }
@@ -278,7 +311,8 @@ void CommNanoleaf::putJSON(const QNetworkRequest& request, const QJsonObject& js
 #ifdef DEBUG_LEAF_TOUCHY
     qDebug() << "sending" << request.url() << " JSON: " << strJson;
 #endif
-    mNetworkManager->put(request, strJson.toUtf8());
+    mNetworkClient->put(request, strJson.toUtf8());
+    recordPacketSent(request.url().host());
     mLastSendTime = QTime::currentTime();
 }
 
@@ -295,7 +329,8 @@ void CommNanoleaf::testIP(const nano::LeafMetadata& light) {
     QJsonDocument doc(json);
     QString strJson(doc.toJson(QJsonDocument::Compact));
     // qDebug() << "sending" << urlString << "port" << light.port();
-    mNetworkManager->post(request, strJson.toUtf8());
+    mNetworkClient->post(request, strJson.toUtf8());
+    recordPacketSent(request.url().host());
     mLastSendTime = QTime::currentTime();
 }
 
@@ -311,7 +346,8 @@ void CommNanoleaf::testAuth(const nano::LeafMetadata& light) {
 #ifdef DEBUG_LEAF_TOUCHY
     qDebug() << " test Auth token of " << url;
 #endif
-    mNetworkManager->get(request);
+    mNetworkClient->get(request);
+    recordPacketSent(request.url().host());
     mLastSendTime = QTime::currentTime();
 }
 
@@ -321,7 +357,8 @@ void CommNanoleaf::stateUpdate() {
             /// request the general state of the light. if the current effect is *Dynamic*, this
             /// will require a second request.
             QNetworkRequest request = networkRequest(light, "");
-            mNetworkManager->get(request);
+            mNetworkClient->get(request);
+            recordPacketSent(request.url().host());
             mLastSendTime = QTime::currentTime();
 
             //  requestEffectUpdate(light, light.currentEffectName());
@@ -335,6 +372,7 @@ void CommNanoleaf::stateUpdate() {
 
             mStateUpdateCounter++;
         }
+        checkReachability();
     } else {
         stopStateUpdates();
     }
@@ -382,12 +420,13 @@ std::pair<nano::LeafLight, bool> CommNanoleaf::lightFromMetadata(
     return std::make_pair(light, result);
 }
 
-void CommNanoleaf::handleInitialDiscovery(const nano::LeafMetadata& light, const QString& payload) {
+void CommNanoleaf::handleInitialDiscovery(const nano::LeafMetadata& light,
+                                          const QString& payload,
+                                          const QJsonDocument& jsonResponse) {
     // adds light if it can be fully discovered
     auto result = mDiscovery->handleUndiscoveredLight(light, payload);
     // if light is fully discovered, we still need to add it to the comm layer
     if (result.second) {
-        QJsonDocument jsonResponse = QJsonDocument::fromJson(payload.toUtf8());
         nano::LeafLight light(result.first);
         light.isReachable(false);
         addLights({light});
@@ -397,8 +436,21 @@ void CommNanoleaf::handleInitialDiscovery(const nano::LeafMetadata& light, const
     }
 }
 
-void CommNanoleaf::handleNetworkPacket(const nano::LeafMetadata& light, const QString& payload) {
-    QJsonDocument jsonResponse = QJsonDocument::fromJson(payload.toUtf8());
+void CommNanoleaf::handleInitialDiscovery(const nano::LeafMetadata& light,
+                                          const nano::LeafStateUpdate& stateUpdate) {
+    auto result = mDiscovery->handleUndiscoveredLight(light, stateUpdate);
+    if (result.second) {
+        nano::LeafLight leafLight(result.first);
+        leafLight.isReachable(false);
+        addLights({leafLight});
+        parseStateUpdatePacket(result.first, stateUpdate);
+        getEffects();
+        getSchedules();
+    }
+}
+
+void CommNanoleaf::handleNetworkPacket(const nano::LeafMetadata& light,
+                                       const QJsonDocument& jsonResponse) {
     if (!jsonResponse.isNull()) {
         if (jsonResponse.isObject()) {
             QJsonObject object = jsonResponse.object();
@@ -422,42 +474,51 @@ void CommNanoleaf::handleNetworkPacket(const nano::LeafMetadata& light, const QS
         }
     }
 }
-void CommNanoleaf::replyFinished(QNetworkReply* reply) {
-    // qDebug() << reply->error() << " from " << reply->url();
-    if (reply->error() == QNetworkReply::NoError) {
-        QString payload = reply->readAll().trimmed();
-        QString IP = reply->url().toString();
+void CommNanoleaf::replyFinished(NetworkResponse reply) {
+    // qDebug() << reply.error << " from " << reply.url;
+    if (reply.error == QNetworkReply::NoError) {
+        QString payload = QString(reply.body).trimmed();
+        QString IP = reply.url.toString();
+        recordPacketReceived(reply.url.host());
         auto light = mDiscovery->findLightByIP(IP);
         // if light is not connected, handle as a special case
         bool isConnected = mDiscovery->isLightConnected(light);
+        if (reply.decoded.userType() == qMetaTypeId<nano::LeafStateUpdate>()) {
+            auto stateUpdate = reply.decoded.value<nano::LeafStateUpdate>();
+            if (isConnected) {
+                parseStateUpdatePacket(light, stateUpdate);
+            } else {
+                handleInitialDiscovery(light, stateUpdate);
+            }
+            return;
+        }
         if (!isConnected) {
-            handleInitialDiscovery(light, payload);
+            handleInitialDiscovery(light, payload, reply.json);
         } else {
             if (IP.contains("panelLayout/globalOrientation")) {
                 // TODO: why is this empty?
             } else {
-                handleNetworkPacket(light, payload);
+                handleNetworkPacket(light, reply.json);
             }
         }
-    } else if (reply->error() == QNetworkReply::ConnectionRefusedError) {
+    } else if (reply.error == QNetworkReply::ConnectionRefusedError) {
 #ifdef DEBUG_LEAF_TOUCHY
         qDebug() << "Nanoleaf connection refused from "
-                 << reply->url()
+                 << reply.url
                         .toString()
 #endif
                     // TODO: is there a more elegant way to check if the IP address contains a
                     // nanoleaf without NUPnP or an auth token?
-                    mDiscovery->verifyIP(reply->url().toString());
-    } else if (reply->errorString() == "Forbidden") {
+                    mDiscovery->verifyIP(reply.url.toString());
+    } else if (reply.errorString == "Forbidden") {
 #ifdef DEBUG_LEAF_TOUCHY
-        qDebug() << "Nanoleaf connection forbidden from " << reply->url().toString();
+        qDebug() << "Nanoleaf connection forbidden from " << reply.url.toString();
 #endif
     } else {
 #ifdef DEBUG_LEAF_TOUCHY
-        qDebug() << " unknown error from " << reply->url().toString() << reply->errorString();
+        qDebug() << " unknown error from " << reply.url.toString() << reply.errorString;
 #endif
     }
-    reply->deleteLater();
 }
 
 
@@ -515,16 +576,25 @@ void CommNanoleaf::parseEffectUpdate(const nano::LeafMetadata& leafLight,
 
 void CommNanoleaf::parseRequestAllUpdate(const nano::LeafMetadata& light,
                                          const QJsonArray& requestArray) {
+    std::vector<QJsonObject> changedEffects;
+    std::vector<QString> removedEffects;
+    auto& cache = mEffectCaches[light.serialNumber().toStdString()];
+    if (cache.isEmpty()) {
+        cache.seed(light.effects().keys());
+    }
+    if (!cache.update(requestArray, changedEffects, removedEffects)) {
+        return;
+    }
+
     std::vector<nano::LeafEffect> leafEffects;
-    for (auto object : requestArray) {
-        const auto& animationObject = object.toObject();
+    for (const auto& animationObject : changedEffects) {
         if (nano::LeafEffect::isValidJson(animationObject)) {
             leafEffects.push_back(nano::LeafEffect(animationObject));
         } else {
             qDebug() << " invalid object for effect: " << animationObject;
         }
     }
-    mDiscovery->updateStoredEffects(light, leafEffects);
+    mDiscovery->updateStoredEffects(light, leafEffects, removedEffects);
 }
 
 
@@ -545,55 +615,60 @@ void CommNanoleaf::parseScheduleUpdatePacket(const nano::LeafMetadata& light,
 void CommNanoleaf::parseStateUpdatePacket(const nano::LeafMetadata& nanoLight,
                                           const QJsonObject& stateUpdate) {
     if (nano::LeafMetadata::isValidJson(stateUpdate)) {
-        // qDebug() << " state update " << stateUpdate;
-        auto leafLight = nanoLight;
-        auto lastEffectName = leafLight.currentEffectName();
-        leafLight.updateMetadata(stateUpdate);
-
-        // move metadata for name to light, in case network packets dont contain it
-        auto result = mDiscovery->nameFromSerial(leafLight.serialNumber());
-        if (result.second) {
-            leafLight.name(result.first);
-        }
-        mDiscovery->updateFoundLight(leafLight);
+        parseStateUpdatePacket(nanoLight, nano::LeafStateUpdate(stateUpdate));
+    } else {
+        qDebug() << "Did not recognize state update:" << stateUpdate;
+    }
+}
 
-        auto light = nano::LeafLight(leafLight);
-        fillLight(light);
-
-        // check if we have enough information to determine the current state of the light. If a
-        // known effect, we can. if its a dynamic effect or another temporary effect, the best we
-        // can do is assume the previous state has not changed and send another request.
-        auto storedEffect = leafLight.effects().item(leafLight.currentEffectName().toStdString());
-        if (storedEffect.second) {
-            auto effect = storedEffect.first;
-            auto modifiedState = effect.lightState(light.state());
-            modifiedState.effect(leafLight.currentEffectName());
-            light.state(modifiedState);
-            updateLight(light);
-        } else if (!nano::isReservedEffect(leafLight.currentEffectName())) {
-            // qDebug() << " did not find a stored effect for " << leafLight.currentEffectName();
-        }
+void CommNanoleaf::parseStateUpdatePacket(const nano::LeafMetadata& nanoLight,
+                                          const nano::LeafStateUpdate& stateUpdate) {
+    auto leafLight = nanoLight;
+    auto lastEffectName = leafLight.currentEffectName();
+    leafLight.updateMetadata(stateUpdate);
+    mEffectCaches[leafLight.serialNumber().toStdString()].indicator(stateUpdate.indicator);
+
+    // move metadata for name to light, in case network packets dont contain it
+    auto result = mDiscovery->nameFromSerial(leafLight.serialNumber());
+    if (result.second) {
+        leafLight.name(result.first);
+    }
+    mDiscovery->updateFoundLight(leafLight);
+
+    auto light = nano::LeafLight(leafLight);
+    fillLight(light);
+
+    // check if we have enough information to determine the current state of the light. If a
+    // known effect, we can. if its a dynamic effect or another temporary effect, the best we
+    // can do is assume the previous state has not changed and send another request.
+    auto storedEffect = leafLight.effects().item(leafLight.currentEffectName().toStdString());
+    if (storedEffect.second) {
+        auto effect = storedEffect.first;
+        auto modifiedState = effect.lightState(light.state());
+        modifiedState.effect(leafLight.currentEffectName());
+        light.state(modifiedState);
+        updateLight(light);
+    } else if (!nano::isReservedEffect(leafLight.currentEffectName())) {
+        // qDebug() << " did not find a stored effect for " << leafLight.currentEffectName();
+    }
 
-        // request the effect if its a temporary effect, or if its a new effect, just to make sure
-        // we have the right data.
-        if (lastEffectName != leafLight.currentEffectName()
-            || nano::isReservedEffect(leafLight.currentEffectName())) {
-            requestEffectUpdate(leafLight, leafLight.currentEffectName());
-        }
+    // request the effect if its a temporary effect, or if its a new effect, just to make sure
+    // we have the right data.
+    if (lastEffectName != leafLight.currentEffectName()
+        || nano::isReservedEffect(leafLight.currentEffectName())) {
+        requestEffectUpdate(leafLight, leafLight.currentEffectName());
+    }
 
-        QJsonObject stateObject = stateUpdate["state"].toObject();
-        if (mPacketParser.hasValidState(stateObject)) {
-            light.hardwareType(leafLight.hardwareType());
-            // a valid packet has been received, mark the light as reachable.
-            light.isReachable(true);
-            auto state = mPacketParser.jsonToLighState(leafLight, light.state(), stateObject);
-            light.state(state);
-            updateLight(light);
-        } else {
-            qDebug() << "Could not parse state update packet: " << stateUpdate;
-        }
+    const auto& stateObject = stateUpdate.stateObject;
+    if (mPacketParser.hasValidState(stateObject)) {
+        light.hardwareType(leafLight.hardwareType());
+        // a valid packet has been received, mark the light as reachable.
+        light.isReachable(true);
+        auto state = mPacketParser.jsonToLighState(leafLight, light.state(), stateObject);
+        light.state(state);
+        updateLight(light);
     } else {
-        qDebug() << "Did not recognize state update:" << stateUpdate;
+        qDebug() << "Could not parse state update packet: " << stateObject;
     }
 }
 
@@ -686,11 +761,16 @@ void CommNanoleaf::routineChange(const nano::LeafMetadata& leafLight,
     putJSON(request, writeObject);
 }
 
-void CommNanoleaf::brightnessChange(const nano::LeafMetadata& leafLight, int brightness) {
+void CommNanoleaf::brightnessChange(const nano::LeafMetadata& leafLight,
+                                    int brightness,
+                                    int transition) {
     QNetworkRequest request = networkRequest(leafLight, "state");
     QJsonObject json;
     QJsonObject brightObject;
     brightObject["value"] = brightness;
+    if (transition > 0) {
+        brightObject["duration"] = (transition + 999) / 1000;
+    }
     json["brightness"] = brightObject;
     putJSON(request, json);
 }
@@ -701,6 +781,7 @@ bool CommNanoleaf::deleteNanoleaf(const cor::LightID& serialNumber, const QStrin
 
     // remove from comm data
     removeLights({serialNumber});
+    mEffectCaches.erase(serialNumber.toStdString());
 
     // remove from saved data
     return mDiscovery->removeNanoleaf(leafMetadata);
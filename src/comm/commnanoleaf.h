@@ -2,14 +2,14 @@
 #define COMMNANOLEAF_H
 
 #include <QJsonArray>
-#include <QNetworkAccessManager>
-#include <QNetworkReply>
 #include <QNetworkRequest>
 
 #include "comm/nanoleaf/leafdiscovery.h"
+#include "comm/nanoleaf/leafeffectcache.h"
 #include "comm/nanoleaf/leafmetadata.h"
 #include "comm/nanoleaf/leafpacketparser.h"
 #include "comm/nanoleaf/leafschedule.h"
+#include "comm/networkclient.h"
 #include "comm/upnpdiscovery.h"
 #include "commtype.h"
 #include "cor/objects/palettegroup.h"
@@ -29,8 +29,9 @@
 class CommNanoleaf : public CommType {
     Q_OBJECT
 public:
-    /// constructor
-    CommNanoleaf();
+    /// constructor, network I/O and JSON parsing runs on the given thread. Saved nanoleafs that
+    /// are not found are probed when the shared scheduler says they are due.
+    CommNanoleaf(CommThread* thread, cor::DiscoveryScheduler<std::string>* scheduler);
 
     /// destructor
     ~CommNanoleaf() = default;
@@ -45,6 +46,9 @@ public:
      */
     void shutdown();
 
+    /// sets the traffic log and replay of this CommType and of its NetworkClient.
+    void traffic(cor::TrafficLog* log, cor::TrafficReplay* replay) override;
+
     /*!
      * \brief sendPacket send a packet based off of a JSON object containing all
      *        relevant information about the packet
@@ -91,6 +95,9 @@ public:
      */
     std::pair<cor::Dictionary<nano::LeafSchedule>, bool> findSchedules(const cor::LightID& serial);
 
+    /// incremented whenever the schedules of any nanoleaf change.
+    std::uint64_t scheduleRevision() const noexcept { return mScheduleRevision; }
+
     /*!
      * \brief sendTimeout sends a timeout schedule to the provided light.
      * \param light light to send a tiemout to
@@ -108,8 +115,10 @@ public:
      * \param deviceIndex 0 for all indices, a specific index for a specific light.
      *        Will do nothing if index doesn't exist.
      * \param brightness a value between 0 and 100, 0 is off, 100 is full brightness
+     * \param transition time for the light to fade to the brightness in msec, 0 to change it
+     *        immediately. Nanoleafs fade in whole seconds, so this is rounded up.
      */
-    void brightnessChange(const nano::LeafMetadata& light, int brightness);
+    void brightnessChange(const nano::LeafMetadata& light, int brightness, int transition);
 
     /// changes the main color of a nanoleaf
     void singleSolidColorChange(const nano::LeafMetadata& light, const QColor& color);
@@ -133,10 +142,10 @@ public:
 
 private slots:
     /*!
-     * \brief replyFinished called by the mNetworkManager, receives HTTP replies to packets
+     * \brief replyFinished called by the mNetworkClient, receives HTTP replies to packets
      *        sent from other methods.
      */
-    void replyFinished(QNetworkReply*);
+    void replyFinished(NetworkResponse);
 
     /*!
      * \brief routineChange change the light state of the nanoleaf. This JSON object will contain a
@@ -152,7 +161,8 @@ private slots:
      */
     void getSchedules();
 
-    /// requests all effects stored on the nanoleaf.
+    /// requests all effects stored on each nanoleaf, skipping nanoleafs whose effects have not
+    /// changed.
     void getEffects();
 
 private:
@@ -185,10 +195,16 @@ private:
 
     /// handles undiscovered packaets and routes the correct information to the the discovery
     /// object, if necessary
-    void handleInitialDiscovery(const nano::LeafMetadata& light, const QString& payload);
+    void handleInitialDiscovery(const nano::LeafMetadata& light,
+                                const QString& payload,
+                                const QJsonDocument& jsonResponse);
+
+    /// handles a state update from an undiscovered light that was decoded on the comm thread.
+    void handleInitialDiscovery(const nano::LeafMetadata& light,
+                                const nano::LeafStateUpdate& stateUpdate);
 
     /// handles a standard packet from discovered nanoleaf.
-    void handleNetworkPacket(const nano::LeafMetadata& light, const QString& payload);
+    void handleNetworkPacket(const nano::LeafMetadata& light, const QJsonDocument& jsonResponse);
 
     /// creates a network request based on a QString providing the endpoint.
     QNetworkRequest networkRequest(const nano::LeafMetadata& light, const QString& endpoint);
@@ -201,6 +217,10 @@ private:
      */
     void parseStateUpdatePacket(const nano::LeafMetadata& light, const QJsonObject& stateUpdate);
 
+    /// parses a state update packet that was decoded on the comm thread.
+    void parseStateUpdatePacket(const nano::LeafMetadata& light,
+                                const nano::LeafStateUpdate& stateUpdate);
+
     /*!
      * \brief parseStaticStateUpdatePacket when a static routine is ran, a partial packet is sent
      * back. this parses the partial packet.
@@ -226,13 +246,13 @@ private:
      */
     void parseEffectUpdate(const nano::LeafMetadata& light, const QJsonObject& effectPacket);
 
-    /// requests all effects stored on a nanoleaf.
+    /// parses all effects stored on a nanoleaf. Only effects that changed are parsed and stored.
     void parseRequestAllUpdate(const nano::LeafMetadata& light, const QJsonArray& requestArray);
 
     /*!
-     * \brief mNetworkManager Qt's HTTP connection object
+     * \brief mNetworkClient sends HTTP requests and parses their JSON on the comm thread
      */
-    QNetworkAccessManager* mNetworkManager;
+    NetworkClient* mNetworkClient;
 
     /// pointer to the UPnPDiscovery object.
     UPnPDiscovery* mUPnP;
@@ -272,6 +292,12 @@ private:
     /// stores the schedules for each nanoleaf.
     std::unordered_map<std::string, cor::Dictionary<nano::LeafSchedule>> mSchedules;
 
+    /// caches the effects of each nanoleaf, keyed by serial number.
+    std::unordered_map<std::string, nano::LeafEffectCache> mEffectCaches;
+
+    /// incremented whenever the schedules of any nanoleaf change.
+    std::uint64_t mScheduleRevision;
+
     /*!
      * \brief createTimeoutSchedule helper that generates a schedule that times out the light based
      * off of the minute param provided
@@ -7,22 +7,75 @@
 #include "commserial.h"
 
 #include <QDebug>
+#include <algorithm>
 
 #include "comm/arducor/arducordiscovery.h"
 
-CommSerial::CommSerial()
+namespace {
+
+/// directory that serial ports appear in
+const char* kDeviceDirectory = "/dev";
+
+/// prefixes of the names of the serial ports that are watched for in kDeviceDirectory
+const std::vector<std::string> kWatchedPortPrefixes = {"ttyUSB", "ttyACM"};
+
+/// ports that are never connected to, since they are built in and are never a controller.
+const std::unordered_set<std::string> kIgnoredPorts = {"Bluetooth-Incoming-Port",
+                                                       "tty.Bluetooth-Incoming-Port",
+                                                       "cu.Bluetooth-Incoming-Port",
+                                                       "COM1",
+                                                       "ttyS0"};
+
+} // namespace
+
+CommSerial::CommSerial(CommThread* thread)
     : CommType(ECommType::serial),
       mDiscovery{nullptr},
+      mWorker{new SerialWorker()},
+      mPortWatcher(kDeviceDirectory, kWatchedPortPrefixes),
+      mPortNotifier{nullptr},
       mSerialPortFailed{false} {
     mStateUpdateInterval = 500;
     mLookingForActivePorts = false;
 
+    qRegisterMetaType<ArduCorPacket>("ArduCorPacket");
+    if (thread != nullptr) {
+        thread->moveToThread(mWorker);
+    }
+    connect(mWorker,
+            SIGNAL(packetReceived(QString, QString, ArduCorPacket)),
+            this,
+            SLOT(handlePacket(QString, QString, ArduCorPacket)));
+    connect(mWorker, SIGNAL(portOpened(QString)), this, SLOT(handlePortOpened(QString)));
+    connect(mWorker,
+            SIGNAL(portFailed(QString, QString)),
+            this,
+            SLOT(handlePortFailed(QString, QString)));
+
+    if (mPortWatcher.isValid()) {
+        // disabled until the ports that already exist are enumerated by the first discovery.
+        mPortNotifier = new QSocketNotifier(mPortWatcher.fd(), QSocketNotifier::Read, this);
+        mPortNotifier->setEnabled(false);
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+        connect(mPortNotifier, SIGNAL(activated(int)), this, SLOT(handlePortChanges()));
+#else
+        connect(mPortNotifier,
+                SIGNAL(activated(QSocketDescriptor, QSocketNotifier::Type)),
+                this,
+                SLOT(handlePortChanges()));
+#endif
+    }
+
     connect(mStateUpdateTimer, SIGNAL(timeout()), this, SLOT(stateUpdate()));
 }
 
 
 CommSerial::~CommSerial() {
     shutdown();
+    // deleting the worker closes its ports
+    if (!mWorker.isNull()) {
+        mWorker->deleteLater();
+    }
 }
 
 void CommSerial::startup() {}
@@ -32,28 +85,41 @@ void CommSerial::shutdown() {
     if (mStateUpdateTimer->isActive()) {
         mStateUpdateTimer->stop();
     }
-    for (auto&& serial : mSerialPorts) {
-        if (serial.first->isOpen()) {
-            serial.first->clear();
-            serial.first->close();
-        }
+    if (!mWorker.isNull()) {
+        SerialWorker* worker = mWorker;
+        QMetaObject::invokeMethod(
+            worker, [worker]() { worker->closeAll(); }, Qt::QueuedConnection);
+    }
+    mOpenPorts.clear();
+    mKnownPorts.clear();
+    if (mPortNotifier != nullptr) {
+        // enumerate again on the next discovery, then resume watching.
+        mPortNotifier->setEnabled(false);
+        mPortWatcher.readChanges();
     }
-    mSerialPorts.clear();
-    mSerialInfoList.clear();
 }
 
 void CommSerial::sendPacket(const cor::Controller& controller, QString& packet) {
-    QSerialPort* serial = serialPortByName(controller.name());
-    if (serial != nullptr) {
-        if (serial->isOpen()) {
-            // add ; to end of serial packet as delimiter
-            packet += ";";
-
-            // send packet over serial
-            // qDebug() << "sending" << packet << "to" <<  serial->portName();
-            serial->write(packet.toStdString().c_str());
-        }
+    if (mTrafficReplay == nullptr && !isPortOpen(controller.name())) {
+        return;
+    }
+    // add ; to end of serial packet as delimiter
+    packet += ";";
+
+    // there are no serial ports in a replay, so the packet is only captured.
+    if (mTrafficReplay == nullptr) {
+        // send packet over serial
+        // qDebug() << "sending" << packet << "to" <<  controller.name();
+        writeToPort(controller.name(), packet.toUtf8());
     }
+    captureTraffic(cor::ETrafficDirection::sent, controller.name(), packet.toUtf8());
+    recordPacketSent(controller.name());
+}
+
+void CommSerial::writeToPort(const QString& name, const QByteArray& bytes) {
+    SerialWorker* worker = mWorker;
+    QMetaObject::invokeMethod(
+        worker, [worker, name, bytes]() { worker->write(name, bytes); }, Qt::QueuedConnection);
 }
 
 void CommSerial::stateUpdate() {
@@ -80,22 +146,12 @@ void CommSerial::stateUpdate() {
 
 
         mStateUpdateCounter++;
+        checkReachability();
     } else {
         stopStateUpdates();
     }
 }
 
-QSerialPort* CommSerial::serialPortByName(const QString& name) {
-    QSerialPort* serial = nullptr;
-    for (const auto& serialPorts : mSerialPorts) {
-        if (serialPorts.first->portName() == name) {
-            serial = serialPorts.first;
-        }
-    }
-    return serial;
-}
-
-
 //--------------------
 // Discovery and Connecting
 //--------------------
@@ -103,12 +159,12 @@ QSerialPort* CommSerial::serialPortByName(const QString& name) {
 void CommSerial::testForController(const cor::Controller& controller) {
     QString discoveryPacket = ArduCorDiscovery::kDiscoveryPacketIdentifier + ";";
     bool runningDiscoveryOnSomething = false;
-    QSerialPort* serial = serialPortByName(controller.name());
-    if (serial != nullptr) {
+    if (isPortOpen(controller.name())) {
         runningDiscoveryOnSomething = true;
         // write to device
         // qDebug() << "discovery packet to " << controller.name << "payload" << discoveryPacket;
-        serial->write(discoveryPacket.toStdString().c_str());
+        writeToPort(controller.name(), discoveryPacket.toUtf8());
+        captureTraffic(cor::ETrafficDirection::sent, controller.name(), discoveryPacket.toUtf8());
     }
     if (!runningDiscoveryOnSomething) {
         mLookingForActivePorts = false;
@@ -117,111 +173,110 @@ void CommSerial::testForController(const cor::Controller& controller) {
 
 
 void CommSerial::discoverSerialPorts() {
-    for (const QSerialPortInfo& info : QSerialPortInfo::availablePorts()) {
-        bool serialPortFound = false;
-        for (const auto& savedInfo : mSerialInfoList) {
-            if (!QString::compare(info.portName(), savedInfo.portName())) {
-                serialPortFound = true;
-            }
+    if (mTrafficReplay != nullptr) {
+        // a replay stands in for the serial ports, so real ones are not opened.
+        return;
+    }
+    if (mPortNotifier != nullptr) {
+        // the watcher signals when ports appear or disappear, so there is nothing to poll.
+        if (!mPortNotifier->isEnabled()) {
+            enumerateSerialPorts();
+            mPortNotifier->setEnabled(true);
         }
+        return;
+    }
+    enumerateSerialPorts();
+}
 
-        bool isSpecialCase = false;
-        if (!serialPortFound) {
-            if (!QString::compare(info.portName(), QString("Bluetooth-Incoming-Port"))) {
-                isSpecialCase = true;
-            }
-            if (!QString::compare(info.portName(), QString("tty.Bluetooth-Incoming-Port"))) {
-                isSpecialCase = true;
-            }
-            if (!QString::compare(info.portName(), QString("cu.Bluetooth-Incoming-Port"))) {
-                isSpecialCase = true;
-            }
-            if (!QString::compare(info.portName(), QString("COM1"))) {
-                isSpecialCase = true;
-            }
-            if (!QString::compare(info.portName(), QString("ttyS0"))) {
-                isSpecialCase = true;
-            }
+void CommSerial::enumerateSerialPorts() {
+    std::vector<std::string> currentPorts;
+    for (const QSerialPortInfo& info : QSerialPortInfo::availablePorts()) {
+        currentPorts.push_back(info.portName().toStdString());
+    }
+    handleDeviceChanges(cor::diffDevices(mKnownPorts, currentPorts));
+}
 
+void CommSerial::handlePortChanges() {
+    auto changes = mPortWatcher.readChanges();
+    if (changes.rescan) {
+        enumerateSerialPorts();
+        return;
+    }
+    handleDeviceChanges(changes);
+}
 
-            if (!isSpecialCase) {
-                //                 qDebug() << "Name : " << info.portName();
-                //                 qDebug() << "Description : " << info.description();
-                //                 qDebug() << "Manufacturer: " << info.manufacturer();
-                connectSerialPort(info);
-                mDiscovery->addSerialPort(info.portName());
-                mSerialInfoList.push_back(info);
-                mLookingForActivePorts = true;
-            }
-        }
+void CommSerial::handleDeviceChanges(const cor::DeviceChanges& changes) {
+    for (const auto& name : changes.removed) {
+        removeSerialPort(QString::fromStdString(name));
+    }
+    for (const auto& name : changes.added) {
+        // ports are added again when their permissions change, since udev may only make a new
+        // port readable after it appears.
+        addSerialPort(QSerialPortInfo(QString::fromStdString(name)));
     }
 }
 
-bool CommSerial::connectSerialPort(const QSerialPortInfo& info) {
-    for (const auto& serialPorts : mSerialPorts) {
-        if (serialPorts.first->portName() == info.portName()) {
-            // its already connected, no need to connect again
-            return true;
-        }
+void CommSerial::addSerialPort(const QSerialPortInfo& info) {
+    auto name = info.portName().toStdString();
+    if (kIgnoredPorts.count(name) != 0u) {
+        return;
     }
+    if (mKnownPorts.insert(name).second) {
+        mDiscovery->addSerialPort(info.portName());
+        mLookingForActivePorts = true;
+    }
+    connectSerialPort(info);
+}
 
-    auto serial = new QSerialPort(this);
-    serial->setPort(info);
-    if (serial->open(QIODevice::ReadWrite)) {
-        serial->setBaudRate(QSerialPort::Baud9600);
-        serial->setStopBits(QSerialPort::OneStop);
-        serial->setParity(QSerialPort::NoParity);
-        serial->setDataBits(QSerialPort::Data8);
-        serial->setFlowControl(QSerialPort::NoFlowControl);
-        qDebug() << "INFO: Serial Port Connected!" << info.portName();
-
-        mSerialPorts.push_back(std::make_pair(serial, QString()));
-        connect(serial, SIGNAL(readyRead()), this, SLOT(handleReadyRead()));
-        connect(serial,
-                SIGNAL(error(QSerialPort::SerialPortError)),
-                this,
-                SLOT(handleError(QSerialPort::SerialPortError)));
+void CommSerial::removeSerialPort(const QString& name) {
+    if (mKnownPorts.erase(name.toStdString()) > 0u) {
+        mDiscovery->removeSerialPort(name);
+    }
+    if (mOpenPorts.erase(name.toStdString()) > 0u) {
+        qDebug() << "INFO: Serial Port Disconnected!" << name;
+    }
+    // the port may still be opening, so the worker is always told to close it.
+    SerialWorker* worker = mWorker;
+    QMetaObject::invokeMethod(
+        worker, [worker, name]() { worker->close(name); }, Qt::QueuedConnection);
+}
 
-        return true;
+void CommSerial::connectSerialPort(const QSerialPortInfo& info) {
+    if (isPortOpen(info.portName())) {
+        // its already connected, no need to connect again
+        return;
     }
-    qDebug() << "WARNING: serial port failed" << info.portName() << serial->errorString();
-    delete serial;
-    return false;
+    SerialWorker* worker = mWorker;
+    auto name = info.portName();
+    QMetaObject::invokeMethod(
+        worker, [worker, name]() { worker->open(name); }, Qt::QueuedConnection);
+}
+
+void CommSerial::handlePortOpened(QString portName) {
+    if (mKnownPorts.count(portName.toStdString()) == 0u) {
+        // the port was removed while it was opening
+        removeSerialPort(portName);
+        return;
+    }
+    qDebug() << "INFO: Serial Port Connected!" << portName;
+    mOpenPorts.insert(portName.toStdString());
+}
+
+void CommSerial::handlePortFailed(QString portName, QString error) {
+    qDebug() << "WARNING: serial port failed" << portName << error;
 }
 
 //--------------------
 // Receiving
 //--------------------
 
-void CommSerial::handleReadyRead() {
-    for (auto&& serial : mSerialPorts) {
-        bool validPacket = false;
-        while (serial.first->bytesAvailable()) {
-            QByteArray packet;
-            packet.append(serial.first->readAll());
-            QString payload = QString::fromUtf8(packet.trimmed());
-            serial.second += payload;
-            if (serial.second.size() > 0) {
-                if (serial.second.at(serial.second.length() - 1) == ';') {
-                    validPacket = true;
-                }
-            }
-        }
-        if (validPacket) {
-            // remove the ; from the end of the packet
-            QString payload = serial.second.mid(0, serial.second.length() - 1);
-            // qDebug() << "serial" << serial.first->portName() << "received payload" <<
-            // serial.second << "size" << serial.second.size();
-            mDiscovery->handleIncomingPacket(mType, serial.first->portName(), payload);
-            emit packetReceived(serial.first->portName(), payload, mType);
-
-            // empty buffer
-            serial.second = "";
-        }
-    }
+void CommSerial::replayPacket(const QString& device, const QString& payload) {
+    handlePacket(device, payload, decodeArduCorPacket(payload.toStdString()));
 }
 
-
-void CommSerial::handleError(QSerialPort::SerialPortError error) {
-    qDebug() << "Serial Port Error!" << error;
+void CommSerial::handlePacket(QString portName, QString payload, ArduCorPacket packet) {
+    captureTraffic(cor::ETrafficDirection::received, portName, payload.toUtf8());
+    recordPacketReceived(portName);
+    mDiscovery->handleIncomingPacket(mType, portName, payload);
+    emit packetReceived(portName, payload, packet, mType);
 }
@@ -1,14 +1,19 @@
 #ifndef SERIALCOMM_H
 #define SERIALCOMM_H
 
+#include <QPointer>
+#include <QSocketNotifier>
 #include <QTimer>
-#include <QtSerialPort/QSerialPort>
 #include <QtSerialPort/QSerialPortInfo>
 #include <memory>
+#include <string>
+#include <unordered_set>
 
 #include "comm/arducor/arducordiscovery.h"
 #include "comm/arducor/crccalculator.h"
+#include "comm/serialworker.h"
 #include "commtype.h"
+#include "cor/devicewatcher.h"
 
 /*!
  * \copyright
@@ -20,6 +25,9 @@
  * will not work in mobile devices since QSerialPort is
  * unimplemented (for pretty obvious reasons :P). It is the
  * fastest and most stable connection on PCs.
+ *
+ * The serial ports are owned by a SerialWorker on the comm thread, which reads and decodes their
+ * packets. Discovery of ports stays on the GUI thread.
  */
 
 class CommSerial : public CommType {
@@ -27,8 +35,9 @@ class CommSerial : public CommType {
 public:
     /*!
      * \brief CommSerial Constructor
+     * \param thread thread that the ports run on, nullptr to run them on the calling thread.
      */
-    CommSerial();
+    CommSerial(CommThread* thread);
     /*!
      * \brief CommSerial Deconstructor
      */
@@ -36,7 +45,8 @@ public:
 
     /*!
      * \brief discoverSerialPorts looks for new serial ports and adds it them to
-     *        the connections page, if they are found.
+     *        the connections page, if they are found. Where ports can be watched, this only
+     *        enumerates the ports once, and the watcher reports the ports that are hotplugged.
      */
     void discoverSerialPorts();
 
@@ -74,24 +84,28 @@ public:
      */
     void testForController(const cor::Controller& controller);
 
+    /// handles a packet played back by a replay, as if it was read from a serial port.
+    void replayPacket(const QString& device, const QString& payload) override;
+
 signals:
     /*!
      * \brief packetReceived emitted whenever a packet that is not a discovery packet is received.
-     * Contains
-     *        the full packet's contents as a QString.
+     * Contains the port, the full packet's contents as a QString, and its decoded values.
      */
-    void packetReceived(QString, QString, ECommType);
+    void packetReceived(QString, QString, ArduCorPacket, ECommType);
 
 private slots:
+    /// handles a complete packet read and decoded by the SerialWorker.
+    void handlePacket(QString portName, QString payload, ArduCorPacket packet);
 
-    /*!
-     * \brief handleReadyRead parses incoming packets
-     */
-    void handleReadyRead();
-    /*!
-     * \brief handleError handles errors from the QSerialPort.
-     */
-    void handleError(QSerialPort::SerialPortError);
+    /// handles a port that the SerialWorker opened
+    void handlePortOpened(QString portName);
+
+    /// handles a port that the SerialWorker could not open
+    void handlePortFailed(QString portName, QString error);
+
+    /// handles serial ports that appeared or disappeared, as reported by mPortWatcher.
+    void handlePortChanges();
 
     /*!
      * \brief stateUpdate used by the mStateUpdateTimer to request new
@@ -108,32 +122,46 @@ private:
     CRCCalculator mCRC;
 
     /*!
-     * \brief connectSerialPort connect to a specific serial port, if possible.
-     * \param serialPortName The name of the serial port that you want
-     *        to connect to.
-     * \return true if connection is successful, false otherwise.
+     * \brief connectSerialPort connect to a specific serial port, if possible. The port is opened
+     * on the comm thread, and can be used once the worker signals that it is open.
+     * \param info the serial port that you want to connect to.
      */
-    bool connectSerialPort(const QSerialPortInfo& info);
+    void connectSerialPort(const QSerialPortInfo& info);
 
-    /*!
-     * \brief serialPortByName pointer to QSerialPort instance that is connectd
-     *        to the given serial port. Gives back a nullptr if no QSerialPort is found
-     * \param name name fo QSerialPort
-     * \return pointer to QSerialPort
-     */
-    QSerialPort* serialPortByName(const QString& name);
+    /// connects to every serial port that is not known, and removes known ports that are gone.
+    void enumerateSerialPorts();
 
-    /*!
-     * \brief mSerialList list of possible serial ports
-     *        for connection
-     */
-    std::vector<QSerialPortInfo> mSerialInfoList;
+    /// removes the ports that disappeared, then adds the ports that appeared.
+    void handleDeviceChanges(const cor::DeviceChanges& changes);
 
-    /*!
-     * \brief mSerialPorts list of serial ports in use. The second element in the pair is a buffer
-     * that contains the most recent characters sent by the serial port.
-     */
-    std::vector<std::pair<QSerialPort*, QString>> mSerialPorts;
+    /// adds a port to discovery the first time it is seen, and connects to it if it is not.
+    void addSerialPort(const QSerialPortInfo& info);
+
+    /// disconnects from a port that disappeared, and stops discovery from probing it.
+    void removeSerialPort(const QString& name);
+
+    /// true if the serial port with the given name is open.
+    bool isPortOpen(const QString& name) const {
+        return mOpenPorts.count(name.toStdString()) != 0u;
+    }
+
+    /// writes bytes to a serial port through the worker
+    void writeToPort(const QString& name, const QByteArray& bytes);
+
+    /// owns the serial ports, lives on the comm thread.
+    QPointer<SerialWorker> mWorker;
+
+    /// watches for serial ports that are hotplugged, not valid on platforms without inotify.
+    cor::DeviceWatcher mPortWatcher;
+
+    /// wakes up when mPortWatcher has changes, nullptr if ports are enumerated on every discovery.
+    QSocketNotifier* mPortNotifier;
+
+    /// names of the serial ports that have been seen, whether or not they could be connected.
+    std::unordered_set<std::string> mKnownPorts;
+
+    /// names of the serial ports that the worker has open.
+    std::unordered_set<std::string> mOpenPorts;
 
     /// set to true when looking for active ports, used on discovery page.
     bool mLookingForActivePorts;
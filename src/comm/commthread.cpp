@@ -0,0 +1,23 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include "commthread.h"
+
+CommThread::CommThread() {
+    mThread.setObjectName("CommThread");
+    mThread.start();
+}
+
+void CommThread::moveToThread(QObject* object) {
+    object->moveToThread(&mThread);
+    // finished is emitted on the thread, and deferred deletes are still processed after it.
+    QObject::connect(&mThread, &QThread::finished, object, &QObject::deleteLater);
+}
+
+CommThread::~CommThread() {
+    mThread.quit();
+    mThread.wait();
+}
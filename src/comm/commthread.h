@@ -0,0 +1,49 @@
+#ifndef COMMTHREAD_H
+#define COMMTHREAD_H
+
+#include <QMetaType>
+#include <QObject>
+#include <QThread>
+
+#include "comm/arducor/arducorpacketvalues.h"
+
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ *
+ * \brief The CommThread class owns the thread that device I/O runs on. Sockets, network access
+ * managers, and the first pass of parsing replies (such as decoding JSON) live on this thread, so
+ * that bursts of traffic from devices do not block painting and input on the GUI thread. Only
+ * immutable results, such as a NetworkResponse or a single packet, are sent back to the CommTypes,
+ * which still own all light state and live on the GUI thread.
+ *
+ * The thread owns the objects moved to it. Their owners normally delete them with deleteLater()
+ * while the thread runs, and any that remain when the thread stops are deleted on the thread
+ * before it finishes, so no socket or network access manager outlives it.
+ */
+class CommThread {
+public:
+    /// constructor, starts the thread.
+    CommThread();
+
+    /// destructor, stops the thread and waits for it to finish.
+    ~CommThread();
+
+    /*!
+     * \brief moveToThread moves an object to the comm thread. The object must not have a parent,
+     * and should be deleted with deleteLater(). If it still exists when the thread stops, it is
+     * deleted then.
+     * \param object object to move to the comm thread.
+     */
+    void moveToThread(QObject* object);
+
+private:
+    /// thread that device I/O runs on
+    QThread mThread;
+};
+
+/// ArduCor packets are decoded on the comm thread, and sent to the CommArduCor on the GUI thread.
+Q_DECLARE_METATYPE(ArduCorPacket)
+
+#endif // COMMTHREAD_H
@@ -6,15 +6,39 @@
 
 #include "commtype.h"
 
+#include <QDebug>
+
 #include "cor/objects/light.h"
-#include "utils/qt.h"
 
-CommType::CommType(ECommType type) : mStateUpdateInterval{1000}, mType(type) {
+namespace {
+
+/*!
+ * msec before a packet without a response is considered lost. A response that arrives later is
+ * not timed, and the next packet sent starts a new measurement.
+ */
+const qint64 kPendingSendTimeout = 10000;
+
+} // namespace
+
+CommType::CommType(ECommType type)
+    : mReachabilityThreshold{15000},
+      mStateUpdateInterval{1000},
+      mType(type),
+      mTrafficLog{nullptr},
+      mTrafficReplay{nullptr},
+      mReachabilityDeadlines(100, 256u),
+      mReachabilityGracePeriod{0},
+      mDeltas(1024u),
+      mMetrics{nullptr},
+      mPacketsSent{nullptr},
+      mPacketsReceived{nullptr},
+      mLatency{nullptr} {
     mUpdateTimeoutInterval = 15000;
     mStateUpdateCounter = 0;
     mSecondaryUpdatesInterval = 10;
 
     mElapsedTimer.start();
+    mMetricsTimer.start();
 
     mStateUpdateTimer = new QTimer(this);
 }
@@ -24,7 +48,8 @@ void CommType::addLights(const std::vector<cor::Light>& lights) {
     for (const auto& light : lights) {
         uniqueIDs.push_back(light.uniqueID());
         mLightDict.insert(light.uniqueID().toStdString(), light);
-        mUpdateTime.insert(light.uniqueID().toStdString(), 0);
+        mReachabilityDeadlines.schedule(light.uniqueID().toStdString(),
+                                        mElapsedTimer.elapsed() + mReachabilityThreshold);
     }
 
     resetStateUpdateTimeout();
@@ -37,6 +62,7 @@ bool CommType::removeLights(const std::vector<cor::LightID>& uniqueIDs) {
     for (const auto& uniqueID : uniqueIDs) {
         auto result = mLightDict.removeKey(uniqueID.toStdString());
         if (result) {
+            mReachabilityDeadlines.cancel(uniqueID.toStdString());
             removedLights.push_back(uniqueID);
         }
     }
@@ -49,10 +75,19 @@ bool CommType::removeLights(const std::vector<cor::LightID>& uniqueIDs) {
 void CommType::updateLight(const cor::Light& light) {
     auto dictResult = mLightDict.item(light.uniqueID().toStdString());
     if (dictResult.second) {
-        mUpdateTime.update(light.uniqueID().toStdString(), mElapsedTimer.elapsed());
+        mReachabilityDeadlines.schedule(light.uniqueID().toStdString(),
+                                        mElapsedTimer.elapsed() + mReachabilityThreshold);
         mLightDict.update(light.uniqueID().toStdString(), light);
         mLastReceiveTime = QTime::currentTime();
-        emit updateReceived(mType);
+        queueDelta(light.uniqueID().toStdString());
+    }
+}
+
+void CommType::queueDelta(const std::string& key) {
+    bool wasEmpty = mDeltas.empty();
+    mDeltas.push(key, true);
+    if (wasEmpty) {
+        emit deltasQueued();
     }
 }
 
@@ -69,11 +104,8 @@ bool CommType::fillLight(cor::Light& light) {
 void CommType::resetStateUpdateTimeout() {
     // if (!mStateUpdateTimer->isActive()) {
     mStateUpdateTimer->start(mStateUpdateInterval);
-    for (const auto& light : mLightDict.items()) {
-        mUpdateTime.insert(light.uniqueID().toStdString(), 0);
-        mLightDict.update(light.uniqueID().toStdString(), light);
-    }
-    mElapsedTimer.restart();
+    // instead of resetting every light's deadline, delay any light that expires before then.
+    mReachabilityGracePeriod = mElapsedTimer.elapsed() + mReachabilityThreshold;
     // }
     mLastSendTime = QTime::currentTime();
 }
@@ -96,14 +128,93 @@ bool CommType::shouldContinueStateUpdate() const noexcept {
 
 void CommType::checkReachability() {
     auto elapsedTime = mElapsedTimer.elapsed();
-    const int kThreshold = 15000;
-    for (auto light : mLightDict.items()) {
-        auto updateTime = mUpdateTime.item(light.uniqueID().toStdString());
-        auto state = light.state();
-        if (light.isReachable() && (updateTime.first < (elapsedTime - kThreshold))) {
+    mReachabilityDeadlines.advance(elapsedTime, [this, elapsedTime](const std::string& key) {
+        if (elapsedTime < mReachabilityGracePeriod) {
+            mReachabilityDeadlines.schedule(key, mReachabilityGracePeriod);
+            return;
+        }
+        auto lightResult = mLightDict.item(key);
+        if (lightResult.second && lightResult.first.isReachable()) {
+            auto light = lightResult.first;
+            auto state = light.state();
             light.isReachable(false);
             light.state(state);
-            mLightDict.update(light.uniqueID().toStdString(), light);
+            mLightDict.update(key, light);
+            queueDelta(key);
         }
+    });
+}
+
+void CommType::metrics(cor::MetricsRegistry* metrics) {
+    mMetrics = metrics;
+    mDeviceMetrics.clear();
+    if (mMetrics == nullptr) {
+        mPacketsSent = nullptr;
+        mPacketsReceived = nullptr;
+        mLatency = nullptr;
+        return;
+    }
+    auto type = commTypeToString(mType).toLower().toStdString();
+    mPacketsSent = &mMetrics->counter("comm." + type + ".packets_sent");
+    mPacketsReceived = &mMetrics->counter("comm." + type + ".packets_received");
+    mLatency = &mMetrics->histogram("comm." + type + ".latency_ms");
+}
+
+CommType::DeviceMetrics& CommType::deviceMetrics(const QString& device) {
+    auto result = mDeviceMetrics.find(device);
+    if (result != mDeviceMetrics.end()) {
+        return result->second;
+    }
+    auto name = "device." + device.toStdString();
+    DeviceMetrics metrics{&mMetrics->counter(name + ".packets_sent"),
+                          &mMetrics->counter(name + ".packets_received"),
+                          &mMetrics->histogram(name + ".latency_ms"),
+                          -1};
+    return mDeviceMetrics.emplace(device, metrics).first->second;
+}
+
+void CommType::recordPacketSent(const QString& device) {
+    if (mMetrics == nullptr) {
+        return;
+    }
+    auto& metrics = deviceMetrics(device);
+    mPacketsSent->add();
+    metrics.packetsSent->add();
+    // only the oldest unanswered packet is timed, so a device that stops responding doesn't
+    // reset its own latency measurement. Once that packet is considered lost, a new one is timed.
+    auto now = mMetricsTimer.elapsed();
+    if (metrics.pendingSendTime < 0 || now - metrics.pendingSendTime > kPendingSendTimeout) {
+        metrics.pendingSendTime = now;
+    }
+}
+
+void CommType::recordPacketReceived(const QString& device) {
+    if (mMetrics == nullptr) {
+        return;
+    }
+    auto& metrics = deviceMetrics(device);
+    mPacketsReceived->add();
+    metrics.packetsReceived->add();
+    if (metrics.pendingSendTime >= 0) {
+        auto latency = mMetricsTimer.elapsed() - metrics.pendingSendTime;
+        if (latency <= kPendingSendTimeout) {
+            mLatency->record(std::uint64_t(latency));
+            metrics.latency->record(std::uint64_t(latency));
+        }
+        metrics.pendingSendTime = -1;
+    }
+}
+
+void CommType::captureTraffic(cor::ETrafficDirection direction,
+                              const QString& device,
+                              const QByteArray& payload) {
+    if (mTrafficLog == nullptr) {
+        return;
     }
+    cor::TrafficEvent event;
+    event.source = commTypeToString(mType).toStdString();
+    event.direction = direction;
+    event.endpoint = device.toStdString();
+    event.payload = payload.toStdString();
+    mTrafficLog->record(std::move(event));
 }
@@ -2,15 +2,21 @@
 #ifndef COMMTYPE_H
 #define COMMTYPE_H
 
+#include <QByteArray>
 #include <QElapsedTimer>
 #include <QString>
 #include <QTime>
 #include <QTimer>
+#include <map>
 #include <memory>
-#include <unordered_map>
 
+#include "cor/deltaqueue.h"
 #include "cor/dictionary.h"
+#include "cor/metrics.h"
 #include "cor/objects/light.h"
+#include "cor/timingwheel.h"
+#include "cor/trafficlog.h"
+#include "cor/trafficreplay.h"
 
 /*!
  * \copyright
@@ -95,6 +101,8 @@ public:
     /*!
      * \brief updateLight update all the data in the light device that matches the same controller
      * and index. if a light device doesn't exist with these properties, then it creates a new one.
+     * The light's key is also pushed to deltas() instead of signaling immediately, so that many
+     * updates to the same light between frames are only handled once.
      * \param light the new data for the light device.
      */
     void updateLight(const cor::Light& light);
@@ -113,8 +121,50 @@ public:
      */
     const cor::Dictionary<cor::Light>& lightDict() const noexcept { return mLightDict; }
 
-    /// checks programmatically if there are any lights that are not responding to packets
+    /*!
+     * \brief checkReachability marks lights that have not been heard from within the
+     * reachability threshold as unreachable, and queues them to deltas(). Only the lights that
+     * time out are visited. Each CommType calls this on every tick of its state updates.
+     */
     void checkReachability();
+
+    /// msec without an update before a light is considered unreachable
+    int reachabilityThreshold() const noexcept { return mReachabilityThreshold; }
+
+    /*!
+     * \brief metrics set the registry that packet counts and latencies are recorded to. If no
+     * registry is set, nothing is recorded.
+     */
+    void metrics(cor::MetricsRegistry* metrics);
+
+    /*!
+     * \brief traffic sets the log that the traffic of this CommType is captured to, and the replay
+     * that stands in for its devices. Either can be nullptr. While a replay is set, nothing is sent
+     * to real devices.
+     */
+    virtual void traffic(cor::TrafficLog* log, cor::TrafficReplay* replay) {
+        mTrafficLog = log;
+        mTrafficReplay = replay;
+    }
+
+    /*!
+     * \brief replayPacket handles a packet played back by a replay as if it was received from a
+     * device. CommTypes that do not receive packets ignore it.
+     * \param device name of the device, such as its IP address or serial port
+     * \param payload the packet
+     */
+    virtual void replayPacket(const QString& device, const QString& payload) {
+        Q_UNUSED(device)
+        Q_UNUSED(payload)
+    }
+
+    /*!
+     * \brief deltas queue of the unique IDs of lights updated since it was last drained. Only the
+     * keys are queued, the values are unused and the lights are read from lightDict(), which is
+     * still up to date if the queue overflows. CommLayer drains this on the frame after
+     * deltasQueued() is emitted.
+     */
+    cor::DeltaQueue<std::string, bool>& deltas() noexcept { return mDeltas; }
 signals:
 
     /*!
@@ -128,6 +178,9 @@ signals:
     /// signals when an existing light is deleted
     void lightsDeleted(ECommType, std::vector<cor::LightID>);
 
+    /// signals when a light's key is pushed to an empty deltas() queue.
+    void deltasQueued();
+
 protected:
     /*!
      * \brief shouldContinueStateUpdate checks internal states and determines if it should still
@@ -136,6 +189,31 @@ protected:
      */
     bool shouldContinueStateUpdate() const noexcept;
 
+    /*!
+     * \brief recordPacketSent records a packet sent to a device, and starts timing the latency
+     * until the device responds.
+     * \param device name of the device, such as its IP address or serial port
+     */
+    void recordPacketSent(const QString& device);
+
+    /*!
+     * \brief recordPacketReceived records a packet received from a device. If a packet was sent to
+     * the device and not yet responded to, the latency of the response is recorded.
+     * \param device name of the device, such as its IP address or serial port
+     */
+    void recordPacketReceived(const QString& device);
+
+    /*!
+     * \brief captureTraffic records a packet sent to or received from a device in the traffic
+     * log. Does nothing if no log is set.
+     * \param direction whether the packet was sent or received
+     * \param device name of the device, such as its IP address or serial port
+     * \param payload raw bytes of the packet
+     */
+    void captureTraffic(cor::ETrafficDirection direction,
+                        const QString& device,
+                        const QByteArray& payload);
+
     /*!
      * \brief mLastSendTime the last time a message was sent to the commtype. This is tracked to
      * detect when the device is no longer being actively used, so it can slow down or shut off
@@ -150,9 +228,12 @@ protected:
     QTime mLastReceiveTime;
 
 
-    /// checks how long the app has been alive for reachability tests
+    /// checks how long the app has been alive for reachability tests. This is never restarted.
     QElapsedTimer mElapsedTimer;
 
+    /// msec without an update before a light is considered unreachable
+    int mReachabilityThreshold;
+
     /// number of state updates sent out
     std::uint32_t mStateUpdateCounter;
 
@@ -185,14 +266,68 @@ protected:
      */
     ECommType mType;
 
+    /// log that traffic is captured to, nullptr if traffic is not captured.
+    cor::TrafficLog* mTrafficLog;
+
+    /// replay that stands in for the devices, nullptr if traffic is not replayed.
+    cor::TrafficReplay* mTrafficReplay;
+
 private:
+    /// queues a light to deltas(), signaling deltasQueued() if the queue was empty.
+    void queueDelta(const std::string& key);
+
     /*!
      * \brief mLightDict dictionary of all available lights. the hash key is the light's unique ID.
      */
     cor::Dictionary<cor::Light> mLightDict;
 
-    /// dictionary for last time a light was updated.
-    cor::Dictionary<qint64> mUpdateTime;
+    /// time each light becomes unreachable if it is not heard from, keyed by unique ID.
+    cor::TimingWheel<std::string> mReachabilityDeadlines;
+
+    /*!
+     * \brief mReachabilityGracePeriod lights do not become unreachable before this time. State
+     * updates restart after a timeout, so this gives every light a chance to respond again.
+     */
+    qint64 mReachabilityGracePeriod;
+
+    /// unique IDs of updated lights that have not been drained yet.
+    cor::DeltaQueue<std::string, bool> mDeltas;
+
+    /// registry for metrics, nullptr if metrics are not recorded.
+    cor::MetricsRegistry* mMetrics;
+
+    /// timer for measuring latencies.
+    QElapsedTimer mMetricsTimer;
+
+    /// metrics of a single device, looked up once so packets don't lock the registry.
+    struct DeviceMetrics {
+        /// packets sent to the device
+        cor::MetricCounter* packetsSent;
+
+        /// packets received from the device
+        cor::MetricCounter* packetsReceived;
+
+        /// msec between a packet sent to the device and its response
+        cor::MetricHistogram* latency;
+
+        /// time the device was sent a packet that it has not responded to, -1 if there is none.
+        qint64 pendingSendTime;
+    };
+
+    /// returns the metrics of a device, looking them up in the registry on first use.
+    DeviceMetrics& deviceMetrics(const QString& device);
+
+    /// packets sent by this CommType, nullptr if metrics are not recorded.
+    cor::MetricCounter* mPacketsSent;
+
+    /// packets received by this CommType, nullptr if metrics are not recorded.
+    cor::MetricCounter* mPacketsReceived;
+
+    /// msec between a packet sent by this CommType and its response
+    cor::MetricHistogram* mLatency;
+
+    /// metrics of each device that has sent or received a packet, keyed by device name.
+    std::map<QString, DeviceMetrics> mDeviceMetrics;
 };
 
 #endif // COMMTYPE_H
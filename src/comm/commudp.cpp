@@ -10,19 +10,27 @@
 #include <QDebug>
 #include <QNetworkInterface>
 #include <algorithm>
-#include "utils/qt.h"
 
 #include "comm/arducor/arducordiscovery.h"
+#include "comm/commthread.h"
 
 // preffered port used by the server
 #define PORT 10008
 
-CommUDP::CommUDP() : CommType(ECommType::UDP), mDiscovery{nullptr} {
+CommUDP::CommUDP(CommThread* thread)
+    : CommType(ECommType::UDP),
+      mDiscovery{nullptr},
+      mWorker{new UDPWorker()} {
     mStateUpdateInterval = 500;
 
-    mSocket = new QUdpSocket(this);
-
-    connect(mSocket, SIGNAL(readyRead()), this, SLOT(readPendingDatagrams()));
+    qRegisterMetaType<ArduCorPacket>("ArduCorPacket");
+    if (thread != nullptr) {
+        thread->moveToThread(mWorker);
+    }
+    connect(mWorker,
+            SIGNAL(packetReceived(QString, QString, ArduCorPacket)),
+            this,
+            SLOT(handlePacket(QString, QString, ArduCorPacket)));
     connect(mStateUpdateTimer, SIGNAL(timeout()), this, SLOT(stateUpdate()));
 
     mBound = false;
@@ -30,8 +38,9 @@ CommUDP::CommUDP() : CommType(ECommType::UDP), mDiscovery{nullptr} {
 
 
 CommUDP::~CommUDP() {
-    if (mSocket->isOpen()) {
-        mSocket->close();
+    // deleting the worker closes the socket
+    if (!mWorker.isNull()) {
+        mWorker->deleteLater();
     }
 }
 
@@ -54,8 +63,20 @@ void CommUDP::startup() {
     }
     if (mBound) {
         // qDebug() << "WARNING: UDP already bound!";
+    } else if (mTrafficReplay != nullptr) {
+        // a replay stands in for the socket
+        mBound = true;
     } else {
-        mBound = mSocket->bind(QHostAddress(localIP), PORT);
+        // binding is rare and its result is needed immediately, so wait on the comm thread.
+        UDPWorker* worker = mWorker;
+        bool bound = false;
+        auto connection = (worker->thread() == thread()) ? Qt::DirectConnection
+                                                         : Qt::BlockingQueuedConnection;
+        QMetaObject::invokeMethod(
+            worker,
+            [worker, localIP, &bound]() { bound = worker->bind(QHostAddress(localIP), PORT); },
+            connection);
+        mBound = bound;
         if (!mBound) {
             qDebug() << "binding to UDP discovery server failed";
         }
@@ -67,7 +88,8 @@ void CommUDP::shutdown() {
     if (mStateUpdateTimer->isActive()) {
         mStateUpdateTimer->stop();
     }
-    mSocket->close();
+    UDPWorker* worker = mWorker;
+    QMetaObject::invokeMethod(worker, [worker]() { worker->close(); }, Qt::QueuedConnection);
     mBound = false;
 }
 
@@ -75,7 +97,8 @@ void CommUDP::sendPacket(const cor::Controller& controller, QString& packet) {
     if (mBound) {
         // send packet over UDP
         // qDebug() << "sending udp" << packet << "to " << controller.name();
-        mSocket->writeDatagram(packet.toUtf8().data(), QHostAddress(controller.name()), PORT);
+        sendDatagram(packet.toUtf8(), controller.name());
+        recordPacketSent(controller.name());
     } else {
         qDebug() << "WARNING: UDP port not bound";
     }
@@ -109,6 +132,7 @@ void CommUDP::stateUpdate() {
         }
 
         mStateUpdateCounter++;
+        checkReachability();
     } else {
         stopStateUpdates();
     }
@@ -120,9 +144,7 @@ void CommUDP::testForController(const cor::Controller& controller) {
     if (mBound) {
         //         qDebug() << "discovery packet to " << controller.name << " " <<
         //         ArduCorDiscovery::kDiscoveryPacketIdentifier;
-        mSocket->writeDatagram(ArduCorDiscovery::kDiscoveryPacketIdentifier.toUtf8().data(),
-                               QHostAddress(controller.name()),
-                               PORT);
+        sendDatagram(ArduCorDiscovery::kDiscoveryPacketIdentifier.toUtf8(), controller.name());
     } else {
         // qDebug() << "INFO: discovery when not bound";
     }
@@ -133,26 +155,26 @@ void CommUDP::testForController(const cor::Controller& controller) {
 // Receiving
 //--------------------
 
-void CommUDP::readPendingDatagrams() {
-    while (mSocket->hasPendingDatagrams()) {
-        QByteArray datagram;
-        datagram.resize(int(mSocket->pendingDatagramSize()));
-        QHostAddress sender;
-        quint16 senderPort;
-        mSocket->readDatagram(datagram.data(), datagram.size(), &sender, &senderPort);
-        QString payload = QString::fromUtf8(datagram);
-        // qDebug() << "UDP payload" << payload << payload.size() << "from" << sender.toString();
-        if (payload.contains(";")) {
-            // this may contain multiple packets in a single packet, split and handle as separate
-            // messages.
-            auto payloads = cor::regexSplit(payload, "(\\;)");
-            for (const auto& payload : payloads) {
-                mDiscovery->handleIncomingPacket(mType, sender.toString(), payload);
-                emit packetReceived(sender.toString(), payload, mType);
-            }
-        } else {
-            mDiscovery->handleIncomingPacket(mType, sender.toString(), payload);
-            emit packetReceived(sender.toString(), payload, mType);
-        }
+void CommUDP::sendDatagram(const QByteArray& datagram, const QString& IP) {
+    captureTraffic(cor::ETrafficDirection::sent, IP, datagram);
+    if (mTrafficReplay != nullptr) {
+        return;
     }
+    UDPWorker* worker = mWorker;
+    QMetaObject::invokeMethod(
+        worker,
+        [worker, datagram, IP]() { worker->send(datagram, QHostAddress(IP), PORT); },
+        Qt::QueuedConnection);
+}
+
+void CommUDP::handlePacket(QString sender, QString payload, ArduCorPacket packet) {
+    // qDebug() << "UDP payload" << payload << payload.size() << "from" << sender;
+    captureTraffic(cor::ETrafficDirection::received, sender, payload.toUtf8());
+    recordPacketReceived(sender);
+    mDiscovery->handleIncomingPacket(mType, sender, payload);
+    emit packetReceived(sender, payload, packet, mType);
+}
+
+void CommUDP::replayPacket(const QString& device, const QString& payload) {
+    handlePacket(device, payload, decodeArduCorPacket(payload.toStdString()));
 }
@@ -1,13 +1,16 @@
 #ifndef COMMUDP_H
 #define COMMUDP_H
 
+#include <QPointer>
 #include <QTimer>
-#include <QUdpSocket>
 
 #include "comm/arducor/arducordiscovery.h"
 #include "comm/arducor/crccalculator.h"
+#include "comm/udpworker.h"
 #include "commtype.h"
 
+class CommThread;
+
 /*!
  * \copyright
  * Copyright (C) 2015 - 2020.
@@ -15,7 +18,7 @@
  *
  * \brief Provides a UDP communication stream which allows
  * the sending of UDP datagrams to a specific IP Address
- * and port.
+ * and port. The socket is owned by a UDPWorker on the comm thread.
  */
 
 class CommUDP : public CommType {
@@ -23,8 +26,9 @@ class CommUDP : public CommType {
 public:
     /*!
      * \brief CommUDP Constructor
+     * \param thread thread that the socket runs on, nullptr to run it on the calling thread.
      */
-    CommUDP();
+    CommUDP(CommThread* thread);
     /*!
      * \brief CommUDP Deconstructor
      */
@@ -60,20 +64,22 @@ public:
      */
     void testForController(const cor::Controller& controller);
 
+    /// handles a packet played back by a replay, as if it was received by the UDPWorker.
+    void replayPacket(const QString& device, const QString& payload) override;
+
 signals:
     /*!
      * \brief packetReceived emitted whenever a packet that is not a discovery packet is received.
-     * Contains
-     *        the full packet's contents as a QString.
+     * Contains the sender, the full packet's contents as a QString, and its decoded values.
      */
-    void packetReceived(QString, QString, ECommType);
+    void packetReceived(QString, QString, ArduCorPacket, ECommType);
 
 
 private slots:
     /*!
-     * \brief readPendingDatagrams reads and parses incoming data packets.
+     * \brief handlePacket handles a single packet received and decoded by the UDPWorker.
      */
-    void readPendingDatagrams();
+    void handlePacket(QString sender, QString payload, ArduCorPacket packet);
 
     /*!
      * \brief stateUpdate used by the mStateUpdateTimer to request new
@@ -89,10 +95,11 @@ private:
     /// used to check CRC on incoming packets.
     CRCCalculator mCRC;
 
-    /*!
-     * \brief mSocket Qt's UDP object
-     */
-    QUdpSocket* mSocket;
+    /// owns the UDP socket, lives on the comm thread.
+    QPointer<UDPWorker> mWorker;
+
+    /// sends a datagram to an IP address through the worker
+    void sendDatagram(const QByteArray& datagram, const QString& IP);
 
     /*!
      * \brief mBound true if already bound, false otherwise.
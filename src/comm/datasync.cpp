@@ -8,6 +8,29 @@
 
 #include <cmath>
 
+#include "comm/commlayer.h"
+
+namespace {
+
+/// name used for a datasync type in metrics
+std::string syncTypeName(EDataSyncType type) {
+    switch (type) {
+        case EDataSyncType::arducor:
+            return "arducor";
+        case EDataSyncType::hue:
+            return "hue";
+        case EDataSyncType::nanoleaf:
+            return "nanoleaf";
+        case EDataSyncType::timeout:
+            return "timeout";
+        case EDataSyncType::settings:
+            return "settings";
+    }
+    return "unknown";
+}
+
+} // namespace
+
 bool DataSync::appendToPacket(QString& currentPacket,
                               const QString& newAddition,
                               uint32_t maxPacketSize) {
@@ -83,3 +106,60 @@ float DataSync::ctDifference(float first, float second) {
 bool DataSync::sync(const cor::Light&, const cor::Light&) {
     return false;
 }
+
+DataSync::SyncMetrics& DataSync::syncMetrics() {
+    if (mSyncMetrics.passes == nullptr) {
+        auto& metrics = mComm->metrics();
+        auto prefix = "sync." + syncTypeName(mType);
+        mSyncMetrics.passes = &metrics.counter(prefix + ".passes");
+        mSyncMetrics.retries = &metrics.counter(prefix + ".retries");
+        mSyncMetrics.passesToConverge = &metrics.histogram(prefix + ".passes_to_converge");
+        mSyncMetrics.timeouts = &metrics.counter(prefix + ".timeouts");
+        mSyncMetrics.commands = &metrics.counter(prefix + ".commands");
+        mSyncMetrics.fadeMsec = &metrics.histogram(prefix + ".fade_msec");
+    }
+    return mSyncMetrics;
+}
+
+void DataSync::recordSyncPass(bool inSync) {
+    auto& metrics = syncMetrics();
+    ++mSyncPasses;
+    metrics.passes->add();
+    if (inSync) {
+        metrics.passesToConverge->record(mSyncPasses);
+        mSyncPasses = 0u;
+    } else {
+        metrics.retries->add();
+    }
+}
+
+void DataSync::recordSyncTimeout() {
+    syncMetrics().timeouts->add();
+    mSyncPasses = 0u;
+}
+
+cor::TransitionStep DataSync::planTransition(const QString& key,
+                                             const cor::TransitionCapability& capability) {
+    if (!mTransitionClock.isValid()) {
+        mTransitionClock.start();
+    }
+    return mTransitions.plan(key.toStdString(), capability, mTransitionClock.elapsed());
+}
+
+void DataSync::recordCommand(const QString& key, std::uint32_t fade) {
+    if (!mTransitionClock.isValid()) {
+        mTransitionClock.start();
+    }
+    mTransitions.sent(key.toStdString(), mTransitionClock.elapsed());
+    auto& metrics = syncMetrics();
+    metrics.commands->add();
+    if (fade > 0u) {
+        metrics.fadeMsec->record(fade);
+    }
+}
+
+void DataSync::removeTransitions(const std::vector<cor::LightID>& lightIDs) {
+    for (const auto& lightID : lightIDs) {
+        mTransitions.remove(lightID.toStdString());
+    }
+}
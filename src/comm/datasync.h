@@ -3,6 +3,8 @@
 
 
 #include "cor/lightlist.h"
+#include "cor/metrics.h"
+#include "cor/transitionplanner.h"
 
 /*!
  * \copyright
@@ -149,6 +151,74 @@ protected:
      */
     int mUpdateInterval;
 
+    /// number of sync passes since the data was last in sync
+    std::uint32_t mSyncPasses = 0u;
+
+    /// when each device was last sent a planned command
+    cor::TransitionPlanner<std::string> mTransitions;
+
+    /// measures time for mTransitions, never restarted.
+    QElapsedTimer mTransitionClock;
+
+    /// metrics of this DataSync, looked up once so each pass and command doesn't build their names.
+    struct SyncMetrics {
+        /// sync passes
+        cor::MetricCounter* passes = nullptr;
+
+        /// sync passes that left the data out of sync
+        cor::MetricCounter* retries = nullptr;
+
+        /// passes it took for the data to come back in sync
+        cor::MetricHistogram* passesToConverge = nullptr;
+
+        /// syncs that gave up before the data came back in sync
+        cor::MetricCounter* timeouts = nullptr;
+
+        /// planned commands sent to devices
+        cor::MetricCounter* commands = nullptr;
+
+        /// fades sent with planned commands, in msec.
+        cor::MetricHistogram* fadeMsec = nullptr;
+    };
+
+    /// metrics of this DataSync, empty until syncMetrics() is first called.
+    SyncMetrics mSyncMetrics;
+
+    /// returns the metrics of this DataSync, looking them up in the registry on first use.
+    SyncMetrics& syncMetrics();
+
+    /*!
+     * \brief recordSyncPass records a pass of the sync routine in the CommLayer's metrics. Passes
+     * that leave data out of sync count as retries. When the data comes back in sync, the number
+     * of passes it took is recorded.
+     * \param inSync true if the data is in sync after this pass, false otherwise.
+     */
+    void recordSyncPass(bool inSync);
+
+    /// records that the sync routine gave up before the data came back in sync.
+    void recordSyncTimeout();
+
+    /*!
+     * \brief planTransition checks if a device that is out of sync should be sent a command on
+     * this pass, and how long it should fade to its new state. Devices with native transitions
+     * are sent fewer commands while their state keeps changing, such as during a slider drag.
+     * \param key unique ID of the device
+     * \param capability how the device handles transitions
+     * \return whether to send a command now, and the fade to send with it.
+     */
+    cor::TransitionStep planTransition(const QString& key,
+                                       const cor::TransitionCapability& capability);
+
+    /*!
+     * \brief recordCommand should be called after sending a planned command to a device.
+     * \param key unique ID of the device
+     * \param fade fade that was sent with the command, in msec.
+     */
+    void recordCommand(const QString& key, std::uint32_t fade);
+
+    /// forgets when deleted lights were last sent a planned command.
+    void removeTransitions(const std::vector<cor::LightID>& lightIDs);
+
     /*!
      * \brief sync checks if the light device of a comm layer and a data layer are in sync.
      * \param dataDevice device from the data layer
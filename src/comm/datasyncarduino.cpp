@@ -102,13 +102,17 @@ void DataSyncArduino::syncData() {
             // create the message to send based off of the simplified packets
             QString finalPacket = createPacket(controller, allMessages);
 
+            // the ArduCor protocol has no fades, so every state in between is still sent, limited
+            // by the throttle.
             mComm->arducor()->sendPacket(controller, finalPacket);
+            recordCommand(controller.name(), 0u);
             for (const auto& name : controller.names()) {
                 resetThrottle(name, controller.type());
             }
         }
 
         mDataIsInSync = (countOutOfSync == 0);
+        recordSyncPass(mDataIsInSync);
         if (!mDataIsInSync) {
             emit statusChanged(mType, false);
         }
@@ -120,6 +124,9 @@ void DataSyncArduino::syncData() {
     } else if (mStartTime.elapsed() < 30000) {
         mSyncTimer->setInterval(2000);
     } else {
+        if (!mDataIsInSync) {
+            recordSyncTimeout();
+        }
         mDataIsInSync = true;
     }
 
@@ -10,6 +10,16 @@
 #include "comm/commlayer.h"
 #include "utils/color.h"
 
+namespace {
+
+/*!
+ * hue lights fade by themselves, so while their state keeps changing they are sent a command at
+ * most every 400 msec, and fade over that time. The fade is sent in deciseconds.
+ */
+const cor::TransitionCapability kHueTransition{true, 400u, 100u};
+
+} // namespace
+
 DataSyncHue::DataSyncHue(cor::LightList* data, CommLayer* comm, AppSettings* appSettings)
     : mAppSettings(appSettings) {
     mData = data;
@@ -20,6 +30,10 @@ DataSyncHue::DataSyncHue(cor::LightList* data, CommLayer* comm, AppSettings* app
             SIGNAL(packetReceived(EProtocolType)),
             this,
             SLOT(commPacketReceived(EProtocolType)));
+    connect(mComm,
+            SIGNAL(lightsDeleted(std::vector<cor::LightID>)),
+            this,
+            SLOT(handleLightsDeleted(std::vector<cor::LightID>)));
     connect(mData, SIGNAL(dataUpdate()), this, SLOT(resetSync()));
 
     mSyncTimer = new QTimer(this);
@@ -85,6 +99,8 @@ void DataSyncHue::syncData() {
                         // for a single message, just send right away.
                         auto message = messages.front();
                         mComm->hue()->sendPacket(message.message());
+                        recordCommand(message.ID().toString(),
+                                      std::uint32_t(message.message()["transition"].toInt()));
                         resetThrottle(key, ECommType::hue);
                     } else {
 #ifndef MOBILE_BUILD
@@ -102,6 +118,8 @@ void DataSyncHue::syncData() {
                             // TODO: take the combined equivalent messages and see if we can send to
                             // larger groups instead
                             mComm->hue()->sendPacket(message.message());
+                            recordCommand(message.ID().toString(),
+                                          std::uint32_t(message.message()["transition"].toInt()));
                             resetThrottle(key, ECommType::hue);
                         }
                     }
@@ -114,6 +132,7 @@ void DataSyncHue::syncData() {
         mMessages.clear();
 
         mDataIsInSync = (countOutOfSync == 0);
+        recordSyncPass(mDataIsInSync);
         if (!mDataIsInSync) {
             emit statusChanged(mType, false);
         }
@@ -125,6 +144,9 @@ void DataSyncHue::syncData() {
     } else if (mStartTime.elapsed() < 30000) {
         mSyncTimer->setInterval(2000);
     } else {
+        if (!mDataIsInSync) {
+            recordSyncTimeout();
+        }
         mDataIsInSync = true;
     }
 
@@ -212,6 +234,15 @@ bool DataSyncHue::sync(const cor::Light& dataDevice, const cor::Light& commDevic
     }
 
     if (countOutOfSync) {
+        // while the state keeps changing, wait for the light's next transition instead of sending
+        // every value in between. turning on or off is never held back.
+        auto step = planTransition(hueLight.uniqueID().toString(), kHueTransition);
+        if (!step.shouldSend && !object.contains("isOn")) {
+            return false;
+        }
+        if (step.shouldSend) {
+            object["transition"] = int(step.fade);
+        }
         auto key = bridge.id().toStdString();
         auto result = mMessages.find(key);
         HueMessage message(hueLight.uniqueID(), bridge.id(), object);
@@ -232,3 +263,7 @@ void DataSyncHue::cleanupSync() {
         mCleanupTimer->stop();
     }
 }
+
+void DataSyncHue::handleLightsDeleted(std::vector<cor::LightID> lightIDs) {
+    removeTransitions(lightIDs);
+}
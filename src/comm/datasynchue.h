@@ -101,6 +101,9 @@ private slots:
      */
     void cleanupSync() override;
 
+    /// forgets the planned transitions of lights that were deleted.
+    void handleLightsDeleted(std::vector<cor::LightID> lightIDs);
+
 private:
     /*!
      * \brief sync checks if the light device of a comm layer and a data layer are in sync.
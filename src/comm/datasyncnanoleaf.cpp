@@ -17,6 +17,16 @@ bool checkIfInSyncByOne(int goal, int value) {
     return ((goal == value) || (goal == (value - 1)) || (goal == (value + 1)));
 }
 
+namespace {
+
+/*!
+ * nanoleafs can fade to a new brightness by themselves, but only in whole seconds. While the
+ * brightness keeps changing, it is sent at most once a second and fades over that second.
+ */
+const cor::TransitionCapability kBrightnessTransition{true, 1000u, 1000u};
+
+} // namespace
+
 DataSyncNanoLeaf::DataSyncNanoLeaf(cor::LightList* data,
                                    CommLayer* comm,
                                    AppSettings* appSettings) {
@@ -30,6 +40,10 @@ DataSyncNanoLeaf::DataSyncNanoLeaf(cor::LightList* data,
             SIGNAL(packetReceived(EProtocolType)),
             this,
             SLOT(commPacketReceived(EProtocolType)));
+    connect(mComm,
+            SIGNAL(lightsDeleted(std::vector<cor::LightID>)),
+            this,
+            SLOT(handleLightsDeleted(std::vector<cor::LightID>)));
     connect(mData, SIGNAL(dataUpdate()), this, SLOT(resetSync()));
 
     mSyncTimer = new QTimer(this);
@@ -98,6 +112,7 @@ void DataSyncNanoLeaf::syncData() {
             }
         }
         mDataIsInSync = (countOutOfSync == 0);
+        recordSyncPass(mDataIsInSync);
 #ifdef DEBUG_DATA_SYNC_NANOLEAF
         qDebug() << " data is in sync? " << mDataIsInSync;
 #endif
@@ -112,6 +127,9 @@ void DataSyncNanoLeaf::syncData() {
     } else if (mStartTime.elapsed() < 30000) {
         mSyncTimer->setInterval(2000);
     } else {
+        if (!mDataIsInSync) {
+            recordSyncTimeout();
+        }
         mDataIsInSync = true;
     }
 
@@ -133,37 +151,15 @@ void DataSyncNanoLeaf::cleanupSync() {
     }
 }
 
+void DataSyncNanoLeaf::handleLightsDeleted(std::vector<cor::LightID> lightIDs) {
+    removeTransitions(lightIDs);
+}
+
 namespace {
 
 bool compareTwoPalettes(const cor::Palette& commPalette, const cor::Palette& dataPalette) {
-    if (dataPalette.colors().size() == commPalette.colors().size()) {
-        auto lambda = [](const QColor& a, const QColor& b) -> bool {
-            // account for -1 hues that are sometimes returned, sort at top
-            if (!b.isValid()) {
-                return a.hueF();
-            }
-            if (!a.isValid()) {
-                return b.hueF();
-            }
-            return a.hueF() < b.hueF();
-        };
-        auto sortedDataColors = dataPalette.colors();
-        std::sort(sortedDataColors.begin(), sortedDataColors.end(), lambda);
-        auto sortedCommColors = commPalette.colors();
-        std::sort(sortedCommColors.begin(), sortedCommColors.end(), lambda);
-
-        bool palettesAreClose = true;
-        std::uint32_t i = 0;
-        for (auto color : sortedDataColors) {
-            auto commColor = sortedCommColors[i];
-            if (cor::colorDifference(color, commColor) > 0.28f && (color.value() != 0u)) {
-                palettesAreClose = false;
-            }
-            ++i;
-        }
-        return palettesAreClose;
-    }
-    return false;
+    // the nanoleaf may return the colors in a different order, and slightly off from what was sent
+    return dataPalette.colorsMatch(commPalette, 0.28f);
 }
 
 } // namespace
@@ -179,8 +175,9 @@ bool DataSyncNanoLeaf::sync(const cor::Light& dataDevice, const cor::Light& comm
     auto dataState = dataDevice.state();
     auto commState = commDevice.state();
     auto allInSync = true;
+    auto onOffInSync = (dataState.isOn() == commState.isOn());
     // first check what type of sync this is
-    if (dataState.isOn() != commState.isOn()) {
+    if (!onOffInSync) {
 #ifdef DEBUG_DATA_SYNC_NANOLEAF
         qDebug() << "nanoleaf ON/OFF not in sync" << dataState.isOn();
 #endif
@@ -223,8 +220,19 @@ bool DataSyncNanoLeaf::sync(const cor::Light& dataDevice, const cor::Light& comm
             brightness = dataState.color().valueF() * 100.0;
         }
         if (!brightnessInSync) {
+            if (onOffInSync && allInSync) {
+                // only the brightness changed, so the nanoleaf can fade to it. while it keeps
+                // changing, wait for the current fade instead of sending every value in between.
+                auto key = dataDevice.uniqueID().toString();
+                auto step = planTransition(key, kBrightnessTransition);
+                if (step.shouldSend) {
+                    mComm->nanoleaf()->brightnessChange(metadata, int(brightness), int(step.fade));
+                    recordCommand(key, step.fade);
+                }
+            } else {
+                mComm->nanoleaf()->brightnessChange(metadata, int(brightness), 0);
+            }
             allInSync = false;
-            mComm->nanoleaf()->brightnessChange(metadata, brightness);
         }
     }
 
@@ -242,7 +250,13 @@ bool DataSyncNanoLeaf::sync(const cor::Light& dataDevice, const cor::Light& comm
 bool DataSyncNanoLeaf::syncStaticColor(const nano::LeafMetadata& metadata,
                                        const cor::LightState& dataState,
                                        const cor::LightState& commState) {
-    if (cor::colorDifference(dataState.color(), commState.color()) > 0.02f) {
+    // brightness is synced on its own so that it can fade, so compare the colors at the same
+    // brightness.
+    QColor commColor;
+    commColor.setHsvF(commState.color().hueF(),
+                      commState.color().saturationF(),
+                      dataState.color().valueF());
+    if (cor::colorDifference(dataState.color(), commColor) > 0.02f) {
 #ifdef DEBUG_DATA_SYNC_NANOLEAF
         qDebug() << " color difference is "
                  << cor::colorDifference(dataState.color(), commState.color())
@@ -6,6 +6,7 @@
 
 #include "datasynctimeout.h"
 #include "comm/commarducor.h"
+#include "comm/commhue.h"
 #include "comm/commlayer.h"
 #include "comm/commnanoleaf.h"
 
@@ -14,7 +15,9 @@ DataSyncTimeout::DataSyncTimeout(cor::LightList* data,
                                  AppSettings* appSettings,
                                  QObject* parent)
     : QObject(parent),
-      mAppSettings(appSettings) {
+      mAppSettings(appSettings),
+      mHueScheduleRevision{0u},
+      mNanoleafScheduleRevision{0u} {
     mData = data;
     mComm = comm;
     mArduCorParser = new ArduCorPacketParser(this, nullptr);
@@ -24,8 +27,9 @@ DataSyncTimeout::DataSyncTimeout(cor::LightList* data,
             SIGNAL(packetReceived(EProtocolType)),
             this,
             SLOT(commPacketReceived(EProtocolType)));
-    connect(mData, SIGNAL(dataUpdate()), this, SLOT(resetSync()));
-    connect(appSettings, SIGNAL(timeoutUpdate()), this, SLOT(resetSync()));
+    connect(mData, SIGNAL(dataUpdate()), this, SLOT(lightsChanged()));
+    connect(appSettings, SIGNAL(timeoutUpdate()), this, SLOT(timeoutSettingsChanged()));
+    mClock.start();
 
     mSyncTimer = new QTimer(this);
     connect(mSyncTimer, SIGNAL(timeout()), this, SLOT(syncData()));
@@ -53,12 +57,52 @@ void DataSyncTimeout::commPacketReceived(EProtocolType type) {
     }
 }
 
+void DataSyncTimeout::lightsChanged() {
+    updateTimeoutTable();
+    mTimeouts.activity(mClock.elapsed());
+    resetSync();
+}
+
+void DataSyncTimeout::timeoutSettingsChanged() {
+    updateTimeoutTable();
+    resetSync();
+}
+
+void DataSyncTimeout::updateTimeoutTable() {
+    int minutes = 0;
+    if (mAppSettings->timeoutEnabled() && (mAppSettings->timeout() > 0)) {
+        minutes = mAppSettings->timeout();
+    }
+    for (const auto& light : mData->lights()) {
+        // arducors count down their timeouts on their own, hues and nanoleafs use schedules that
+        // need to be pushed back whenever the lights are used.
+        mTimeouts.desiredTimeout(light.uniqueID().toStdString(),
+                                 minutes,
+                                 int(light.protocol()),
+                                 light.protocol() != EProtocolType::arduCor);
+    }
+}
+
+void DataSyncTimeout::checkScheduleRevisions() {
+    auto hueRevision = mComm->hue()->discovery()->scheduleRevision();
+    if (hueRevision != mHueScheduleRevision) {
+        mHueScheduleRevision = hueRevision;
+        mTimeouts.markGroupDirty(int(EProtocolType::hue));
+    }
+    auto nanoleafRevision = mComm->nanoleaf()->scheduleRevision();
+    if (nanoleafRevision != mNanoleafScheduleRevision) {
+        mNanoleafScheduleRevision = nanoleafRevision;
+        mTimeouts.markGroupDirty(int(EProtocolType::nanoleaf));
+    }
+}
+
 void DataSyncTimeout::resetSync() {
     if (mCleanupTimer->isActive()) {
         mCleanupTimer->stop();
     }
     if (!mData->empty()) {
         mDataIsInSync = false;
+        mTimeouts.retryUnavailable();
         if (!mSyncTimer->isActive()) {
             mStartTime = QElapsedTimer();
             mStartTime.start();
@@ -73,13 +117,27 @@ void DataSyncTimeout::syncData() {
     mDataIsInSync = true;
 #endif
     if (!mDataIsInSync) {
+        checkScheduleRevisions();
         int countOutOfSync = 0;
-        for (const auto& light : mData->lights()) {
-            cor::Light commLight = light;
-            if (mComm->fillLight(commLight)) {
-                if (!sync(light, commLight)) {
-                    countOutOfSync++;
-                }
+        auto now = mClock.elapsed();
+        for (const auto& key : mTimeouts.takeDirty()) {
+            auto lightResult = mData->lightFromID(cor::LightID(QString::fromStdString(key)));
+            if (!lightResult.second) {
+                // the light is no longer selected, so its timeout is no longer managed.
+                mTimeouts.remove(key);
+                continue;
+            }
+            cor::Light commLight = lightResult.first;
+            if (!mComm->fillLight(commLight)) {
+                // the comm layer doesn't know the light yet, so skip it until the next sync.
+                mTimeouts.unavailable(key);
+                continue;
+            }
+            if (sync(lightResult.first, commLight)) {
+                mTimeouts.synced(key, now);
+            } else {
+                mTimeouts.markDirty(key);
+                countOutOfSync++;
             }
         }
 
@@ -3,6 +3,7 @@
 
 #include <QObject>
 #include "comm/arducor/arducorpacketparser.h"
+#include "cor/timeouttable.h"
 #include "datasync.h"
 
 class CommLayer;
@@ -17,6 +18,10 @@ class CommLayer;
  * support timeouts out of the box, and some need to mock the functionality with a schedule that
  * runs an action that turns the light off. This DataSync runs slower than other data syncs, and
  * does not need to be in sync for widgets to show that everything is in sync.
+ *
+ * Lights are tracked in a cor::TimeoutTable, so each sync only checks the lights whose timeout
+ * settings changed, whose device schedules changed, or whose schedules are due for a refresh
+ * after the lights were used, instead of looking up the schedules of every light.
  */
 class DataSyncTimeout : public QObject, public DataSync {
     Q_OBJECT
@@ -50,6 +55,12 @@ public slots:
      */
     void commPacketReceived(EProtocolType) override;
 
+    /// called when the state of the lights changes, refreshes timeouts that count down from use.
+    void lightsChanged();
+
+    /// called when the timeout settings change, every light's timeout needs to be reconciled.
+    void timeoutSettingsChanged();
+
 private slots:
     /*!
      * \brief syncData called by the SyncTimer. Runs the sync routine, which checks
@@ -85,6 +96,12 @@ private:
     /// handle an arducor's timeout. This is done by sending a timeout packet.
     bool handleArduCorTimeout(const cor::Light& light);
 
+    /// adds every light in the data layer to mTimeouts with the current timeout settings.
+    void updateTimeoutTable();
+
+    /// marks lights whose device schedules have changed since the last sync as dirty.
+    void checkScheduleRevisions();
+
     /*!
      * \brief endOfSync end the sync thread and start the cleanup thread.
      */
@@ -95,6 +112,18 @@ private:
 
     /// parses variables for a packet and turns it into ArduCor compatible packets
     ArduCorPacketParser* mArduCorParser;
+
+    /// timeout settings of each light, and which lights need reconciling.
+    cor::TimeoutTable<std::string> mTimeouts;
+
+    /// measures time for mTimeouts, never restarted.
+    QElapsedTimer mClock;
+
+    /// revision of the hue schedules when they were last checked
+    std::uint64_t mHueScheduleRevision;
+
+    /// revision of the nanoleaf schedules when they were last checked
+    std::uint64_t mNanoleafScheduleRevision;
 };
 
 #endif // DATASYNCTIMEOUT_H
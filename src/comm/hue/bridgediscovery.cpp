@@ -6,30 +6,45 @@
 
 #include "comm/hue/bridgediscovery.h"
 
+#include <QDebug>
 #include <QDir>
 #include <QFileInfo>
 #include <QStandardPaths>
 
 #include "comm/commhue.h"
 #include "data/appdata.h"
-#include "utils/qt.h"
 
 //#define DEBUG_BRIDGE_DISCOVERY
 
 namespace hue {
 
-BridgeDiscovery::BridgeDiscovery(QObject* parent, UPnPDiscovery* UPnP, AppData* appData)
+namespace {
+
+/// true if two schedules would fire at the same time with the same settings.
+bool schedulesMatch(const hue::Schedule& a, const hue::Schedule& b) {
+    return a == b && a.localtime() == b.localtime() && a.status() == b.status()
+           && a.autodelete() == b.autodelete();
+}
+
+} // namespace
+
+BridgeDiscovery::BridgeDiscovery(QObject* parent,
+                                 UPnPDiscovery* UPnP,
+                                 AppData* appData,
+                                 cor::DiscoveryScheduler<std::string>* scheduler)
     : QObject(parent),
       cor::JSONSaveData("hue"),
       mUPnP{UPnP},
+      mScheduler{scheduler},
       mLastTime{0},
       mAppData{appData},
-      mReceivedNUPnPTraffic{false} {
+      mReceivedNUPnPTraffic{false},
+      mScheduleRevision{0u} {
     mHue = qobject_cast<CommHue*>(parent);
     connect(UPnP,
-            SIGNAL(UPnPPacketReceived(QHostAddress, QString)),
+            SIGNAL(UPnPPacketReceived(QHostAddress, cor::SSDPMessage)),
             this,
-            SLOT(receivedUPnP(QHostAddress, QString)));
+            SLOT(receivedUPnP(QHostAddress, cor::SSDPMessage)));
 
     mNetworkManager = new QNetworkAccessManager(this);
     connect(mNetworkManager,
@@ -101,10 +116,14 @@ void BridgeDiscovery::updateSchedule(const hue::Bridge& bridge, const hue::Sched
         auto scheduleDict = foundBridge.schedules();
         auto scheduleResult = scheduleDict.item(schedule.name().toStdString());
         if (scheduleResult.second) {
+            if (schedulesMatch(scheduleResult.first, schedule)) {
+                return;
+            }
             scheduleDict.update(schedule.name().toStdString(), schedule);
         } else {
             scheduleDict.insert(schedule.name().toStdString(), schedule);
         }
+        ++mScheduleRevision;
         foundBridge.schedules(scheduleDict);
         mFoundBridges.update(bridge.id().toStdString(), foundBridge);
     } else {
@@ -135,10 +154,20 @@ void BridgeDiscovery::updateSchedules(const hue::Bridge& bridge,
     const auto& bridgeResult = mFoundBridges.item(bridge.id().toStdString());
     if (bridgeResult.second) {
         auto foundBridge = bridgeResult.first;
+        // only count the list as changed if a schedule was added, removed, or modified.
+        const auto& oldSchedules = foundBridge.schedules();
+        bool changed = (oldSchedules.size() != schedules.size());
         std::vector<std::pair<std::string, hue::Schedule>> scheduleList;
         for (const auto& schedule : schedules) {
+            if (!changed) {
+                auto oldSchedule = oldSchedules.item(schedule.name().toStdString());
+                changed = !oldSchedule.second || !schedulesMatch(oldSchedule.first, schedule);
+            }
             scheduleList.emplace_back(schedule.name().toStdString(), schedule);
         }
+        if (changed) {
+            ++mScheduleRevision;
+        }
         cor::Dictionary<hue::Schedule> scheduleDict(scheduleList);
         foundBridge.schedules(scheduleDict);
         mFoundBridges.update(foundBridge.id().toStdString(), foundBridge);
@@ -164,23 +193,42 @@ void BridgeDiscovery::reloadGroupData() {
 }
 
 void BridgeDiscovery::handleDiscovery() {
-    for (auto notFoundBridge : mNotFoundBridges) {
+    auto now = cor::DiscoveryScheduler<std::string>::steadyNow();
+    for (const auto& notFoundBridge : mNotFoundBridges) {
         if (!notFoundBridge.IP().isEmpty()) {
-            if (notFoundBridge.username().isEmpty()) {
-                requestUsername(notFoundBridge);
-                // IP addresses can change, if a username exists for a previous IP but not a new
-                // one, test it on new IP
-                for (const auto& innerBridge : mNotFoundBridges) {
-                    if (notFoundBridge.IP() != innerBridge.IP()
-                        && !innerBridge.username().isEmpty()) {
-                        notFoundBridge.username(innerBridge.username());
-                        attemptFinalCheck(notFoundBridge);
-                    }
+            auto IP = notFoundBridge.IP().toStdString();
+            mScheduler->track(int(EProtocolType::hue),
+                              IP,
+                              mScheduler->lastSeen(int(EProtocolType::hue), IP),
+                              now);
+        }
+    }
+
+    // only probe the bridges that are due, instead of every not found bridge on every tick.
+    for (const auto& IP : mScheduler->takeDue(int(EProtocolType::hue), now)) {
+        auto result = std::find_if(mNotFoundBridges.begin(),
+                                   mNotFoundBridges.end(),
+                                   [&IP](const hue::Bridge& bridge) {
+                                       return bridge.IP().toStdString() == IP;
+                                   });
+        if (result == mNotFoundBridges.end()) {
+            mScheduler->remove(int(EProtocolType::hue), IP);
+            continue;
+        }
+        auto notFoundBridge = *result;
+        if (notFoundBridge.username().isEmpty()) {
+            requestUsername(notFoundBridge);
+            // IP addresses can change, if a username exists for a previous IP but not a new
+            // one, test it on new IP
+            for (const auto& innerBridge : mNotFoundBridges) {
+                if (notFoundBridge.IP() != innerBridge.IP() && !innerBridge.username().isEmpty()) {
+                    notFoundBridge.username(innerBridge.username());
+                    attemptFinalCheck(notFoundBridge);
                 }
-            } else {
-                // it has a username, test actual connection
-                attemptFinalCheck(notFoundBridge);
             }
+        } else {
+            // it has a username, test actual connection
+            attemptFinalCheck(notFoundBridge);
         }
     }
 
@@ -224,6 +272,9 @@ void BridgeDiscovery::addManualIP(const QString& ip) {
     if (!doesIPExist(ip)) {
         hue::Bridge bridge(ip, generateUniqueName());
         mNotFoundBridges.push_back(bridge);
+        mScheduler->seen(int(EProtocolType::hue),
+                         ip.toStdString(),
+                         cor::DiscoveryScheduler<std::string>::steadyNow());
     }
 }
 
@@ -430,10 +481,14 @@ void BridgeDiscovery::handleInitialDiscoveryPacket(const QString& fullIP,
             bridgeToMove.id(id);
             bridgeToMove.username(username);
 
-            // remove the examples from not found
+            // remove the examples from not found, this also cancels their probes if they were
+            // found by UPnP or NUPnP instead.
             for (const auto& bridge : bridgesToDelete) {
                 auto it = std::find(mNotFoundBridges.begin(), mNotFoundBridges.end(), bridge);
                 mNotFoundBridges.erase(it);
+                mScheduler->found(int(EProtocolType::hue),
+                                  bridge.IP().toStdString(),
+                                  cor::DiscoveryScheduler<std::string>::steadyNow());
             }
 #ifdef DEBUG_BRIDGE_DISCOVERY
             qDebug() << __func__
@@ -565,21 +620,15 @@ bool BridgeDiscovery::deleteLight(const hue::Bridge& bridge, const QString& uniq
     return true;
 }
 
-void BridgeDiscovery::receivedUPnP(const QHostAddress& sender, const QString& payload) {
-    if (payload.contains(QString("IpBridge"))) {
+void BridgeDiscovery::receivedUPnP(const QHostAddress& sender, const cor::SSDPMessage& message) {
+    if (message.server().find("IpBridge") != std::string::npos) {
 #ifdef DEBUG_BRIDGE_DISCOVERY
-        qDebug() << __func__ << "UPnP payload:" << payload;
+        qDebug() << __func__ << "UPnP USN:" << QString::fromStdString(message.usn());
 #endif
 
         // get ID from UPnP
         auto IP = sender.toString();
-        QString id;
-        auto paramArray = cor::regexSplit(payload, "[\r\n]");
-        for (auto param : paramArray) {
-            if (param.contains("hue-bridgeid: ")) {
-                id = param.remove("hue-bridgeid: ").toLower();
-            }
-        }
+        auto id = QString::fromStdString(message.header("hue-bridgeid")).toLower();
         hue::Bridge bridge(IP, generateUniqueName(), id);
         testNewlyDiscoveredBridge(bridge);
     }
@@ -613,6 +662,10 @@ void BridgeDiscovery::testNewlyDiscoveredBridge(const hue::Bridge& bridge) {
     if (!foundIP) {
         mNotFoundBridges.push_back(bridge);
     }
+    // the bridge was just heard from, so probe it immediately even if it was backing off.
+    mScheduler->seen(int(EProtocolType::hue),
+                     bridge.IP().toStdString(),
+                     cor::DiscoveryScheduler<std::string>::steadyNow());
 }
 
 
@@ -792,6 +845,7 @@ bool BridgeDiscovery::deleteBridge(const hue::Bridge& bridge) {
     bool foundBridgeToRemove = false;
     for (const auto& notFoundBridge : mNotFoundBridges) {
         if (bridge.id() == notFoundBridge.id()) {
+            mScheduler->remove(int(EProtocolType::hue), notFoundBridge.IP().toStdString());
             auto it = std::find(mNotFoundBridges.begin(), mNotFoundBridges.end(), notFoundBridge);
             mNotFoundBridges.erase(it);
             foundBridgeToRemove = true;
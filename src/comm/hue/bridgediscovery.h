@@ -13,6 +13,7 @@
 #include "comm/hue/hueprotocols.h"
 #include "comm/upnpdiscovery.h"
 #include "cor/dictionary.h"
+#include "cor/discoveryscheduler.h"
 #include "cor/jsonsavedata.h"
 #include "huemetadata.h"
 
@@ -43,7 +44,10 @@ public:
     /*!
      * \brief BridgeDiscovery Constructor
      */
-    explicit BridgeDiscovery(QObject* parent, UPnPDiscovery* UPnP, AppData* appData);
+    explicit BridgeDiscovery(QObject* parent,
+                             UPnPDiscovery* UPnP,
+                             AppData* appData,
+                             cor::DiscoveryScheduler<std::string>* scheduler);
 
     /// destructor
     ~BridgeDiscovery();
@@ -54,6 +58,9 @@ public:
     /// turns the discovery object off
     void stopDiscovery();
 
+    /// true if discovery is running
+    bool isRunning() const { return mRoutineTimer->isActive(); }
+
     /// getter for discovery state
     EHueDiscoveryState state();
 
@@ -63,6 +70,9 @@ public:
     /// update an individual schedule stored in a bridge
     void updateSchedule(const hue::Bridge& bridge, const hue::Schedule& schedule);
 
+    /// incremented whenever the schedules of any bridge change.
+    std::uint64_t scheduleRevision() const noexcept { return mScheduleRevision; }
+
     /// returns a schedule based off of a bridge and index. the pair's bool is whether or not the
     /// operation was successful.
     std::pair<hue::Schedule, bool> scheduleByBridgeAndIndex(const hue::Bridge& bridge, int index);
@@ -175,7 +185,7 @@ private slots:
     void handleDiscovery();
 
     /// called when a UPnP packet is received
-    void receivedUPnP(const QHostAddress&, const QString&);
+    void receivedUPnP(const QHostAddress&, const cor::SSDPMessage&);
 
     /// slot for when the startup timer times out
     void startupTimerTimeout();
@@ -209,6 +219,9 @@ private:
     /// pointer to the UPnP object
     UPnPDiscovery* mUPnP;
 
+    /// decides when each not found bridge is probed, keyed by IP address.
+    cor::DiscoveryScheduler<std::string>* mScheduler;
+
     /*!
      * \brief mRoutineTimer single shot timer that determines when a discovery method is timing out.
      */
@@ -255,6 +268,9 @@ private:
     /// list of all controllers that have been verified and can be communicated with
     cor::Dictionary<hue::Bridge> mFoundBridges;
 
+    /// incremented whenever the schedules of any bridge change.
+    std::uint64_t mScheduleRevision;
+
     /// parses the initial full packet from a Bridge, which contains all its lights, schedules, and
     /// groups info.
     hue::Bridge parseInitialUpdate(hue::Bridge bridge, const QJsonObject& json);
@@ -0,0 +1,166 @@
+#ifndef HUE_HUELIGHTPARSER_H
+#define HUE_HUELIGHTPARSER_H
+
+#include <QColor>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QMetaType>
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "comm/hue/huemetadata.h"
+#include "utils/color.h"
+
+namespace hue {
+
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ *
+ * \brief The LightUpdate struct is the state of a single light, decoded from a light object sent
+ * by a bridge. It only depends on the JSON, so it is decoded on the comm thread, and the CommHue
+ * merges it into the light it already knows about on the GUI thread.
+ */
+struct LightUpdate {
+    /// metadata of the light. Its bridge ID is empty, since the JSON does not contain it.
+    HueMetadata metadata;
+
+    /// true if the bridge can reach the light
+    bool isReachable = false;
+
+    /// true if the light is on
+    bool isOn = false;
+
+    /// true if the color of the light was decoded
+    bool hasColor = false;
+
+    /// color of the light, only valid if hasColor is true.
+    QColor color;
+};
+
+/// true if a JSON object sent by a bridge is a light, as opposed to a group or schedule.
+inline bool isLightObject(const QJsonObject& object) {
+    return object["name"].isString() && object["uniqueid"].isString()
+           && object["modelid"].isString();
+}
+
+/// converts a hue's xy color and brightness to RGB. Returns an invalid color if y is 0.
+inline QColor xyToColor(double x, double y, double brightness) {
+    if (y == 0.0) {
+        return {};
+    }
+    // take from objC code from here:
+    // https://developers.meethue.com/documentation/color-conversions-rgb-xy
+    double z = 1.0 - x - y;
+    double Y = brightness / 254.0; // The given brightness value
+    double X = (Y / y) * x;
+    double Z = (Y / y) * z;
+
+    // Convert to RGB using Wide RGB D65 conversion
+    double r = X * 1.656492 - Y * 0.354851 - Z * 0.255038;
+    double g = -X * 0.707196 + Y * 1.655397 + Z * 0.036152;
+    double b = X * 0.051713 - Y * 0.121364 + Z * 1.011530;
+
+    // Apply reverse gamma correction
+    r = r <= 0.0031308 ? 12.92 * r : (1.0 + 0.055) * std::pow(r, (1.0 / 2.4)) - 0.055;
+    g = g <= 0.0031308 ? 12.92 * g : (1.0 + 0.055) * std::pow(g, (1.0 / 2.4)) - 0.055;
+    b = b <= 0.0031308 ? 12.92 * b : (1.0 + 0.055) * std::pow(b, (1.0 / 2.4)) - 0.055;
+
+    QColor color;
+    color.setRgbF(std::clamp(r, 0.0, 1.0), std::clamp(g, 0.0, 1.0), std::clamp(b, 0.0, 1.0));
+    return color;
+}
+
+/*!
+ * \brief parseLightUpdate decodes a light object sent by a bridge.
+ * \param object the light object
+ * \param index the bridge's index of the light
+ * \return the decoded state of the light, and true if the object is a valid light.
+ */
+inline std::pair<LightUpdate, bool> parseLightUpdate(const QJsonObject& object, int index) {
+    if (!(object["type"].isString() && object["name"].isString() && object["modelid"].isString()
+          && object["manufacturername"].isString() && object["uniqueid"].isString()
+          && object["swversion"].isString())) {
+        return {};
+    }
+    QJsonObject stateObject = object["state"].toObject();
+    if (!(stateObject["on"].isBool() && stateObject["reachable"].isBool()
+          && stateObject["bri"].isDouble())) {
+        return {};
+    }
+    LightUpdate update;
+    update.metadata = HueMetadata(object, QString(), index);
+    update.isReachable = stateObject["reachable"].toBool();
+    update.isOn = stateObject["on"].toBool();
+
+    if (update.metadata.colorMode() == EColorMode::XY) {
+        QJsonArray array = stateObject["xy"].toArray();
+        if (array.size() != 2 || !array.at(0).isDouble() || !array.at(1).isDouble()) {
+            return {};
+        }
+        update.color = xyToColor(array.at(0).toDouble(),
+                                 array.at(1).toDouble(),
+                                 stateObject["bri"].toDouble());
+        if (!update.color.isValid()) {
+            return {};
+        }
+        update.hasColor = true;
+        update.metadata.colorMode(EColorMode::HSV);
+    } else if (update.metadata.hueType() == EHueType::ambient) {
+        update.color = cor::colorTemperatureToRGB(int(stateObject["ct"].toDouble()));
+        update.hasColor = true;
+        update.metadata.colorMode(EColorMode::CT);
+    } else if (update.metadata.hueType() == EHueType::extended
+               || update.metadata.hueType() == EHueType::color) {
+        if (!stateObject["hue"].isDouble() || !stateObject["sat"].isDouble()) {
+            return {};
+        }
+        double hueF = std::clamp(stateObject["hue"].toDouble() / 65535.0, 0.0, 1.0);
+        double satF = std::clamp(stateObject["sat"].toDouble() / 254.0, 0.0, 1.0);
+        double briF = std::clamp(stateObject["bri"].toDouble() / 254.0, 0.0, 1.0);
+        update.color.setHsvF(hueF, satF, briF);
+        update.hasColor = true;
+        update.metadata.colorMode(EColorMode::HSV);
+    } else if (update.metadata.hueType() == EHueType::white) {
+        update.color.setHsv(-1, 0, int(stateObject["bri"].toDouble()));
+        update.hasColor = true;
+    }
+    return std::make_pair(update, true);
+}
+
+/*!
+ * \brief parseLightUpdates decodes the reply to a request for every light of a bridge.
+ * \param object the reply, with each light keyed by its index.
+ * \return the lights that could be decoded, and true if every value of the reply is a light. If
+ *         it is false, the reply is something else, such as a list of groups.
+ */
+inline std::pair<std::vector<LightUpdate>, bool> parseLightUpdates(const QJsonObject& object) {
+    std::vector<LightUpdate> updates;
+    if (object.isEmpty()) {
+        return std::make_pair(updates, false);
+    }
+    updates.reserve(std::size_t(object.size()));
+    for (auto it = object.begin(); it != object.end(); ++it) {
+        if (!it.value().isObject()) {
+            return std::make_pair(std::vector<LightUpdate>(), false);
+        }
+        auto lightObject = it.value().toObject();
+        if (!isLightObject(lightObject)) {
+            return std::make_pair(std::vector<LightUpdate>(), false);
+        }
+        auto result = parseLightUpdate(lightObject, it.key().toInt());
+        if (result.second) {
+            updates.push_back(result.first);
+        }
+    }
+    return std::make_pair(updates, true);
+}
+
+} // namespace hue
+
+Q_DECLARE_METATYPE(std::vector<hue::LightUpdate>)
+
+#endif // HUE_HUELIGHTPARSER_H
@@ -57,6 +57,9 @@ public:
     /// getter for bridge ID
     const QString& bridgeID() const noexcept { return mBridgeID; }
 
+    /// setter for bridge ID
+    void bridgeID(const QString& bridgeID) { mBridgeID = bridgeID; }
+
     /// getter for unique ID
     const cor::LightID& uniqueID() const noexcept { return mUniqueID; }
 
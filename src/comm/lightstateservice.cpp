@@ -0,0 +1,186 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include "lightstateservice.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "comm/commlayer.h"
+#include "data/groupdata.h"
+
+namespace {
+
+/// the parts of a light's state that are totaled
+cor::LightContribution contributionFromLight(const cor::Light& light) {
+    cor::LightContribution contribution;
+    contribution.isOn = light.state().isOn();
+    contribution.isReachable = light.isReachable();
+    contribution.brightness =
+        std::uint32_t(std::max(std::int64_t(0), cor::lightBrightness(light.state())));
+    return contribution;
+}
+
+} // namespace
+
+LightStateService::LightStateService(CommLayer* comm, GroupData* groups, QObject* parent)
+    : QObject(parent),
+      mComm{comm},
+      mGroups{groups},
+      mSelection{nullptr},
+      mGroupRevision{std::numeric_limits<std::uint64_t>::max()},
+      mSelectionPending{false},
+      mSelectionTimer{new QTimer(this)} {
+    mSelectionTimer->setSingleShot(true);
+    mSelectionTimer->setInterval(0);
+    connect(mSelectionTimer, SIGNAL(timeout()), this, SLOT(selectionTimeout()));
+    connect(mComm,
+            SIGNAL(lightsUpdated(std::vector<cor::LightID>)),
+            this,
+            SLOT(handleLightsUpdated(std::vector<cor::LightID>)));
+    connect(mComm,
+            SIGNAL(lightsAdded(std::vector<cor::LightID>)),
+            this,
+            SLOT(handleLightsUpdated(std::vector<cor::LightID>)));
+    connect(mComm,
+            SIGNAL(lightsDeleted(std::vector<cor::LightID>)),
+            this,
+            SLOT(handleLightsDeleted(std::vector<cor::LightID>)));
+    connect(mGroups, SIGNAL(groupAdded(QString)), this, SLOT(handleGroupChanged()));
+    connect(mGroups, SIGNAL(groupDeleted(QString)), this, SLOT(handleGroupChanged()));
+    syncGroups();
+}
+
+void LightStateService::trackSelection(cor::LightList* selection) {
+    if (mSelection != nullptr) {
+        disconnect(mSelection, SIGNAL(lightCountChanged()), this, SLOT(handleSelectionChanged()));
+    }
+    mSelection = selection;
+    connect(mSelection, SIGNAL(lightCountChanged()), this, SLOT(handleSelectionChanged()));
+    handleSelectionChanged();
+}
+
+std::pair<cor::StateCounts, bool> LightStateService::group(const cor::UUID& ID) {
+    syncGroups();
+    return mAggregate.group(ID.toStdString());
+}
+
+void LightStateService::handleLightsUpdated(std::vector<cor::LightID> lightIDs) {
+    syncGroups();
+    applySelection();
+    cor::StateChanges changes;
+    for (const auto& lightID : lightIDs) {
+        auto key = lightID.toStdString();
+        auto light = mComm->lightByID(lightID);
+        if (light.isValid()) {
+            mAggregate.updateLight(key, contributionFromLight(light), changes);
+            // a selected light that only changed its color, palette, or routine leaves the totals
+            // as they were, but widgets that show the selection still need to update.
+            if (mAggregate.isSelected(key)) {
+                auto result = mSelectedStates.find(key);
+                if (result == mSelectedStates.end() || result->second != light.state()) {
+                    mSelectedStates[key] = light.state();
+                    changes.selection = true;
+                }
+            }
+        } else {
+            mAggregate.removeLight(key, changes);
+            mSelectedStates.erase(key);
+        }
+    }
+    emitChanges(changes);
+}
+
+void LightStateService::handleLightsDeleted(std::vector<cor::LightID> lightIDs) {
+    syncGroups();
+    applySelection();
+    cor::StateChanges changes;
+    for (const auto& lightID : lightIDs) {
+        mAggregate.removeLight(lightID.toStdString(), changes);
+        mSelectedStates.erase(lightID.toStdString());
+    }
+    emitChanges(changes);
+}
+
+void LightStateService::handleSelectionChanged() {
+    // LightList signals each light it adds, so wait until the whole batch is added.
+    mSelectionPending = true;
+    if (!mSelectionTimer->isActive()) {
+        mSelectionTimer->start();
+    }
+}
+
+void LightStateService::selectionTimeout() {
+    applySelection();
+    // the selected lights changed even if their totals did not.
+    emit selectionUpdated();
+}
+
+void LightStateService::applySelection() {
+    if (!mSelectionPending || mSelection == nullptr) {
+        return;
+    }
+    mSelectionPending = false;
+    std::vector<std::string> keys;
+    keys.reserve(mSelection->lights().size());
+    std::unordered_map<std::string, cor::LightState> selectedStates;
+    for (const auto& light : mSelection->lights()) {
+        auto key = light.uniqueID().toStdString();
+        auto result = mSelectedStates.find(key);
+        if (result != mSelectedStates.end()) {
+            selectedStates.emplace(key, std::move(result->second));
+        }
+        keys.push_back(std::move(key));
+    }
+    mAggregate.setSelection(keys);
+    mSelectedStates = std::move(selectedStates);
+}
+
+void LightStateService::handleGroupChanged() {
+    syncGroups();
+}
+
+void LightStateService::syncGroups() {
+    if (mGroups->revision() == mGroupRevision) {
+        return;
+    }
+    mGroupRevision = mGroups->revision();
+
+    std::vector<cor::UUID> changedGroups;
+    auto staleKeys = mAggregate.groupKeys();
+    for (const auto& group : mGroups->groupDict().items()) {
+        auto key = group.uniqueID().toStdString();
+        staleKeys.erase(std::remove(staleKeys.begin(), staleKeys.end(), key), staleKeys.end());
+        std::vector<std::string> lightKeys;
+        lightKeys.reserve(group.lights().size());
+        for (const auto& lightID : group.lights()) {
+            lightKeys.push_back(lightID.toStdString());
+        }
+        if (mAggregate.setGroup(key, lightKeys)) {
+            changedGroups.push_back(group.uniqueID());
+        }
+    }
+    for (const auto& key : staleKeys) {
+        mAggregate.removeGroup(key);
+    }
+    if (!changedGroups.empty()) {
+        emit groupsUpdated(changedGroups);
+    }
+}
+
+void LightStateService::emitChanges(const cor::StateChanges& changes) {
+    if (changes.selection) {
+        emit selectionUpdated();
+    }
+    if (!changes.groups.empty()) {
+        std::vector<cor::UUID> groupIDs;
+        groupIDs.reserve(changes.groups.size());
+        for (const auto& key : changes.groups) {
+            groupIDs.emplace_back(QString::fromStdString(key));
+        }
+        emit groupsUpdated(groupIDs);
+    }
+}
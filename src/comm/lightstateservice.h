@@ -0,0 +1,109 @@
+#ifndef LIGHTSTATESERVICE_H
+#define LIGHTSTATESERVICE_H
+
+#include <QObject>
+#include <QTimer>
+#include <string>
+#include <unordered_map>
+
+#include "cor/lightlist.h"
+#include "cor/objects/uuid.h"
+#include "cor/stateaggregate.h"
+
+class CommLayer;
+class GroupData;
+
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ *
+ * \brief The LightStateService class keeps on/off counts, reachable counts, and brightness sums of
+ * the selected lights and of each group, as the CommLayer reports them. The totals are updated as
+ * light updates arrive, so widgets can subscribe to selectionUpdated() instead of polling the
+ * CommLayer for every selected light, and asking whether any selected light is on is constant
+ * time.
+ *
+ * The totals reflect the state the lights report, not the state the user wants them to be, which
+ * is tracked by cor::LightList. Changes to the tracked LightList are applied once per turn of the
+ * event loop, so loading a mood or group that adds many lights resyncs the selection once.
+ */
+class LightStateService : public QObject {
+    Q_OBJECT
+public:
+    /// constructor
+    LightStateService(CommLayer* comm, GroupData* groups, QObject* parent);
+
+    /// keeps the selection in sync with the lights of a LightList.
+    void trackSelection(cor::LightList* selection);
+
+    /// totals of the selected lights
+    const cor::StateCounts& selection() {
+        applySelection();
+        return mAggregate.selection();
+    }
+
+    /// totals of a group, false if the group is unknown.
+    std::pair<cor::StateCounts, bool> group(const cor::UUID& ID);
+
+signals:
+    /// emitted when the selection changes, or any selected light reports a new state. This includes
+    /// changes that do not affect the totals, such as a new color, palette, or routine.
+    void selectionUpdated();
+
+    /// emitted when any light in the given groups reports a new state.
+    void groupsUpdated(std::vector<cor::UUID>);
+
+private slots:
+    /// handles lights that reported new states
+    void handleLightsUpdated(std::vector<cor::LightID>);
+
+    /// handles lights that were deleted
+    void handleLightsDeleted(std::vector<cor::LightID>);
+
+    /// handles when the lights of the tracked LightList change
+    void handleSelectionChanged();
+
+    /// applies the changes to the tracked LightList and signals them
+    void selectionTimeout();
+
+    /// handles when a group is added or deleted
+    void handleGroupChanged();
+
+private:
+    /// updates the groups of the aggregate if they changed since they were last synced.
+    void syncGroups();
+
+    /// updates the selection of the aggregate if the tracked LightList changed since it was last
+    /// applied.
+    void applySelection();
+
+    /// signals the totals that changed
+    void emitChanges(const cor::StateChanges& changes);
+
+    /// comm layer, used to look up the state of updated lights.
+    CommLayer* mComm;
+
+    /// group data, used to look up the lights of each group.
+    GroupData* mGroups;
+
+    /// tracked selection, nullptr if not tracking.
+    cor::LightList* mSelection;
+
+    /// revision of the groups when they were last synced
+    std::uint64_t mGroupRevision;
+
+    /// true if the tracked LightList changed since the selection was last applied
+    bool mSelectionPending;
+
+    /// coalesces the changes to the tracked LightList into one resync
+    QTimer* mSelectionTimer;
+
+    /// running totals
+    cor::StateAggregate mAggregate;
+
+    /// last reported state of each selected light, to find updates that leave the totals as is.
+    std::unordered_map<std::string, cor::LightState> mSelectedStates;
+};
+
+#endif // LIGHTSTATESERVICE_H
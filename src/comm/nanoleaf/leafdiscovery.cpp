@@ -6,23 +6,35 @@
 
 #include "leafdiscovery.h"
 
+#include <QDebug>
 #include <QDir>
 #include <QFileInfo>
 #include <QStandardPaths>
+#include <charconv>
 
 #include "comm/commnanoleaf.h"
-#include "utils/qt.h"
+#include "cor/tokenizer.h"
 #include "utils/reachability.h"
 
 //#define DEBUG_LEAF_DISCOVERY
 
+namespace {
+
+/// splits a location such as "http://192.168.0.10:16021" into its scheme, host, and port.
+const cor::Tokenizer<char> kLocationDelimiters(":");
+
+} // namespace
+
 namespace nano {
 
-LeafDiscovery::LeafDiscovery(QObject* parent, uint32_t interval)
+LeafDiscovery::LeafDiscovery(QObject* parent,
+                             uint32_t interval,
+                             cor::DiscoveryScheduler<std::string>* scheduler)
     : QObject(parent),
       cor::JSONSaveData("Nanoleaf"),
       mDiscoveryInterval(interval),
-      mUPnP{nullptr} {
+      mUPnP{nullptr},
+      mScheduler{scheduler} {
     mNanoleaf = dynamic_cast<CommNanoleaf*>(parent);
 
     mDiscoveryTimer = new QTimer(this);
@@ -70,6 +82,10 @@ void LeafDiscovery::foundNewLight(nano::LeafMetadata newLight) {
     for (const auto& notFoundController : mNotFoundLights) {
         if (notFoundController.authToken() == newLight.authToken()) {
             newLight.name(notFoundController.name());
+            // cancels its probes, in case it was found through UPnP.
+            mScheduler->found(int(EProtocolType::nanoleaf),
+                              notFoundController.serialNumber().toStdString(),
+                              cor::DiscoveryScheduler<std::string>::steadyNow());
             auto it = std::find(mNotFoundLights.begin(), mNotFoundLights.end(), notFoundController);
             mNotFoundLights.erase(it);
             break;
@@ -105,6 +121,8 @@ bool LeafDiscovery::removeNanoleaf(const nano::LeafMetadata& controllerToRemove)
     // check if the controlle exists in the not found group, delete if found
     for (const auto& notFoundController : mNotFoundLights) {
         if (notFoundController.authToken() == controllerToRemove.authToken()) {
+            mScheduler->remove(int(EProtocolType::nanoleaf),
+                               notFoundController.serialNumber().toStdString());
             auto it = std::find(mNotFoundLights.begin(), mNotFoundLights.end(), notFoundController);
             mNotFoundLights.erase(it);
             foundLight = true;
@@ -145,32 +163,26 @@ bool LeafDiscovery::removeNanoleaf(const nano::LeafMetadata& controllerToRemove)
     return foundLight;
 }
 
-void LeafDiscovery::receivedUPnP(const QHostAddress&, const QString& payload) {
-    if (payload.contains("nanoleaf") || payload.contains("Nanoleaf_aurora")) {
+void LeafDiscovery::receivedUPnP(const QHostAddress&, const cor::SSDPMessage& message) {
+    const auto& target = message.target();
+    if (target.find("nanoleaf") != std::string::npos
+        || target.find("Nanoleaf_aurora") != std::string::npos) {
 #ifdef DEBUG_LEAF_DISCOVERY
-        qDebug() << __func__ << payload;
+        qDebug() << __func__ << QString::fromStdString(message.usn());
 #endif
-        // qDebug() << payload;
-        auto paramArray = cor::regexSplit(payload, "[\r\n]");
-        // parse param array for parameters about the nanoleaf
+        // parse the headers for parameters about the nanoleaf
         QString ip;
         int port = -1;
-        QString deviceName;
-        for (auto param : paramArray) {
-            if (param.contains("Location: ")) {
-                QString location = param.remove("Location: ");
-                auto locationArray = cor::regexSplit(location, ":");
-                if (locationArray.size() == 3) {
-                    ip = locationArray[0] + ":" + locationArray[1];
-                    bool ok;
-                    port = locationArray[2].toInt(&ok, 10);
-                }
-            }
-            if (param.contains("nl-devicename: ")) {
-                auto paramCopy = param;
-                deviceName = paramCopy.remove("nl-devicename: ");
-            }
+        auto locationArray = kLocationDelimiters.split(message.location());
+        if (locationArray.size() == 3) {
+            ip = QString::fromUtf8(locationArray[0].data(), int(locationArray[0].size())) + ":"
+                 + QString::fromUtf8(locationArray[1].data(), int(locationArray[1].size()));
+            port = 0;
+            std::from_chars(locationArray[2].data(),
+                            locationArray[2].data() + locationArray[2].size(),
+                            port);
         }
+        auto deviceName = QString::fromStdString(message.header("nl-devicename"));
         nano::LeafMetadata light("Unknown--" + ip, deviceName);
         light.addConnectionInfo(ip, port);
         light.IPVerified(true);
@@ -244,9 +256,27 @@ void LeafDiscovery::discoveryRoutine() {
              << " unknown lights: " << mUnknownLights.size()
              << " found lights: " << mFoundLights.size();
 #endif
-    // loop through all the of the not found controllers
+    // loop through the not found controllers that are due for a probe
     if (!mNotFoundLights.empty()) {
+        auto now = cor::DiscoveryScheduler<std::string>::steadyNow();
         for (const auto& controller : mNotFoundLights) {
+            auto key = controller.serialNumber().toStdString();
+            mScheduler->track(int(EProtocolType::nanoleaf),
+                              key,
+                              mScheduler->lastSeen(int(EProtocolType::nanoleaf), key),
+                              now);
+        }
+        for (const auto& serial : mScheduler->takeDue(int(EProtocolType::nanoleaf), now)) {
+            auto result = std::find_if(mNotFoundLights.begin(),
+                                       mNotFoundLights.end(),
+                                       [&serial](const nano::LeafMetadata& light) {
+                                           return light.serialNumber().toStdString() == serial;
+                                       });
+            if (result == mNotFoundLights.end()) {
+                mScheduler->remove(int(EProtocolType::nanoleaf), serial);
+                continue;
+            }
+            const auto& controller = *result;
 #ifdef DEBUG_LEAF_DISCOVERY
             qDebug() << __func__ << " testing auth of " << controller.hardwareName()
                      << " auth token: " << controller.authToken();
@@ -311,34 +341,39 @@ std::pair<nano::LeafMetadata, bool> LeafDiscovery::handleUndiscoveredLight(
     } else {
         auto object = jsonResponse.object();
         // get connection unique keys used as connection info for the light
-        QString serialNumber;
-        QString name;
         if (object["serialNo"].isString() && object["name"].isString()) {
-            serialNumber = object["serialNo"].toString();
-            name = object["name"].toString();
-        } else {
-            // error out, this is not the packet we're looking for
-            return std::make_pair(light, false);
-        }
-        // make a copy of the light to reference as we build a complete light
-        auto lightCopy = light;
-        nano::LeafMetadata completeLight(serialNumber, name);
-        lightCopy.updateMetadata(jsonResponse.object());
-        // update all possible variables of light
-        completeLight.addConnectionInfo(lightCopy.IP(), lightCopy.port());
-        completeLight.authToken(lightCopy.authToken());
-        // look in not found lights for a better name, apply if found
-        for (const auto& notFoundLight : mNotFoundLights) {
-            if (notFoundLight.hardwareName() == completeLight.hardwareName()) {
-                name = notFoundLight.hardwareName();
-            }
+            return handleUndiscoveredLight(light, nano::LeafStateUpdate(object));
         }
-        completeLight.name(name);
+        // error out, this is not the packet we're looking for
+        return std::make_pair(light, false);
+    }
+}
 
-        // add complete light to discovery buffers
-        foundNewLight(completeLight);
-        return std::make_pair(completeLight, true);
+std::pair<nano::LeafMetadata, bool> LeafDiscovery::handleUndiscoveredLight(
+    const nano::LeafMetadata& light,
+    const nano::LeafStateUpdate& update) {
+    if (light.authToken() == "") {
+        return std::make_pair(light, false);
     }
+    QString name = update.hardwareName;
+    // make a copy of the light to reference as we build a complete light
+    auto lightCopy = light;
+    nano::LeafMetadata completeLight(update.serialNumber, name);
+    lightCopy.updateMetadata(update);
+    // update all possible variables of light
+    completeLight.addConnectionInfo(lightCopy.IP(), lightCopy.port());
+    completeLight.authToken(lightCopy.authToken());
+    // look in not found lights for a better name, apply if found
+    for (const auto& notFoundLight : mNotFoundLights) {
+        if (notFoundLight.hardwareName() == completeLight.hardwareName()) {
+            name = notFoundLight.hardwareName();
+        }
+    }
+    completeLight.name(name);
+
+    // add complete light to discovery buffers
+    foundNewLight(completeLight);
+    return std::make_pair(completeLight, true);
 }
 
 void LeafDiscovery::addIP(const QString& ip) {
@@ -465,19 +500,27 @@ void LeafDiscovery::updateFoundLight(const nano::LeafMetadata& controller) {
 }
 
 void LeafDiscovery::updateStoredEffects(const nano::LeafMetadata& light,
-                                        const std::vector<nano::LeafEffect>& effects) {
+                                        const std::vector<nano::LeafEffect>& changedEffects,
+                                        const std::vector<QString>& removedEffects) {
 #ifdef DEBUG_LEAF_DISCOVERY
     qDebug() << __func__ << controller.hardwareName();
 #endif
     auto result = mFoundLights.item(light.serialNumber().toStdString());
     if (result.second) {
-        std::vector<std::pair<std::string, nano::LeafEffect>> effectVector;
-        for (auto effect : effects) {
-            effectVector.push_back(std::make_pair(effect.name().toStdString(), effect));
+        auto effectDict = result.first.effects();
+        for (const auto& effect : changedEffects) {
+            auto key = effect.name().toStdString();
+            if (effectDict.item(key).second) {
+                effectDict.update(key, effect);
+            } else {
+                effectDict.insert(key, effect);
+            }
+        }
+        for (const auto& effectName : removedEffects) {
+            effectDict.removeKey(effectName.toStdString());
         }
-        cor::Dictionary<nano::LeafEffect> effectDict(effectVector);
         auto light = result.first;
-        light.effects(effectVector);
+        light.effects(effectDict);
         mFoundLights.update(light.serialNumber().toStdString(), light);
     }
 }
@@ -517,9 +560,9 @@ ENanoleafDiscoveryState LeafDiscovery::state() {
 void LeafDiscovery::connectUPnP(UPnPDiscovery* upnp) {
     mUPnP = upnp;
     connect(mUPnP,
-            SIGNAL(UPnPPacketReceived(QHostAddress, QString)),
+            SIGNAL(UPnPPacketReceived(QHostAddress, cor::SSDPMessage)),
             this,
-            SLOT(receivedUPnP(QHostAddress, QString)));
+            SLOT(receivedUPnP(QHostAddress, cor::SSDPMessage)));
 }
 
 bool LeafDiscovery::isLightConnected(const nano::LeafMetadata& controller) {
@@ -8,6 +8,7 @@
 #include "comm/nanoleaf/leafmetadata.h"
 #include "comm/upnpdiscovery.h"
 #include "cor/dictionary.h"
+#include "cor/discoveryscheduler.h"
 #include "cor/jsonsavedata.h"
 
 /// discovery state for a nanoleaf
@@ -42,7 +43,9 @@ class LeafDiscovery : public QObject, public cor::JSONSaveData {
     Q_OBJECT
 public:
     /// constructor
-    explicit LeafDiscovery(QObject* parent, uint32_t discoveryInterval);
+    explicit LeafDiscovery(QObject* parent,
+                           uint32_t discoveryInterval,
+                           cor::DiscoveryScheduler<std::string>* scheduler);
 
     /// start discovery
     void startDiscovery();
@@ -50,6 +53,9 @@ public:
     /// stop discovery
     void stopDiscovery();
 
+    /// true if discovery is running
+    bool isRunning() const { return mDiscoveryTimer->isActive(); }
+
     /// true if the provided light is fully connected, false otherwise
     bool isLightConnected(const nano::LeafMetadata& light);
 
@@ -101,6 +107,17 @@ public:
     std::pair<nano::LeafMetadata, bool> handleUndiscoveredLight(const nano::LeafMetadata& light,
                                                                 const QString& payload);
 
+    /*!
+     * \brief handleUndiscoveredLight handles a partial LeafMetadata thats received a state update
+     * that was decoded on the comm thread.
+     * \param light a LeafMetadata filled with all known infomation about the light
+     * \param update the decoded state update
+     * \return the current state of the LeafMetadata after parsing the update, and a bool thats
+     * true if the light is fully discovered
+     */
+    std::pair<nano::LeafMetadata, bool> handleUndiscoveredLight(const nano::LeafMetadata& light,
+                                                                const nano::LeafStateUpdate& update);
+
     /*!
      * \brief foundNewAuthToken a nano::LeafLight has found a new auth token packet, combine
      * them and spur on testing that auth token
@@ -116,9 +133,10 @@ public:
     /// update stored data about a found device
     void updateFoundLight(const nano::LeafMetadata& light);
 
-    /// updates the stored effects on a nanoleaf.
+    /// updates the stored effects on a nanoleaf. Effects that are not changed or removed are kept.
     void updateStoredEffects(const nano::LeafMetadata&,
-                             const std::vector<nano::LeafEffect>& effects);
+                             const std::vector<nano::LeafEffect>& changedEffects,
+                             const std::vector<QString>& removedEffects);
 
     /// getter for state
     ENanoleafDiscoveryState state();
@@ -147,7 +165,7 @@ public:
 
 private slots:
     /// all received UPnP packets are piped here to detect if they nanoleaf related
-    void receivedUPnP(const QHostAddress& sender, const QString& payload);
+    void receivedUPnP(const QHostAddress& sender, const cor::SSDPMessage& message);
 
     /// runs discovery routines on unknown and not found light lists
     void discoveryRoutine();
@@ -191,6 +209,9 @@ private:
 
     /// used to listen to the UPnP packets for packets from a nanoleaf
     UPnPDiscovery* mUPnP;
+
+    /// decides when each not found light is probed, keyed by serial number.
+    cor::DiscoveryScheduler<std::string>* mScheduler;
 };
 
 } // namespace nano
@@ -53,7 +53,7 @@ public:
     cor::Palette palette() const {
         // UUIDs on the stored for the effects aren't unique, they seem to map to... something...
         // but not a 1 per effect... wtf?
-        auto palette = cor::Palette(cor::UUID::makeNew(), mName, mColors);
+        auto palette = cor::Palette::unshared(cor::UUID::makeNew(), mName, mColors);
         return palette;
     }
 
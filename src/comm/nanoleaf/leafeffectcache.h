@@ -0,0 +1,144 @@
+#ifndef LEAFEFFECTCACHE_H
+#define LEAFEFFECTCACHE_H
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QString>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace nano {
+
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+
+/*!
+ * \brief The LeafEffectCache class caches the effects JSON of a single nanoleaf, so that unchanged
+ * effects are not downloaded, parsed, or stored again.
+ *
+ * Every state update from a nanoleaf contains the names of its effects, the selected effect, and
+ * its panel layout. These are combined into a change indicator, and the full list of effects is
+ * only requested when the indicator changes. Since editing an effect in the Nanoleaf app doesn't
+ * change the indicator, the full list is still requested every kFullRefreshInterval checks. When
+ * a full list is received, it is compared against the cached JSON so that only the effects that
+ * were added, changed, or removed are parsed. Before the first full list, the cache is seeded with
+ * the names of the stored effects, so that effects deleted while the app was closed are removed.
+ */
+class LeafEffectCache {
+public:
+    /// number of skipped requests before the full list of effects is requested anyway.
+    static constexpr int kFullRefreshInterval = 10;
+
+    /// constructor
+    LeafEffectCache()
+        : mIndicator{0u},
+          mFetchedIndicator{0u},
+          mSkippedFetches{0},
+          mIsEmpty{true} {}
+
+    /// computes the change indicator from a nanoleaf state update packet.
+    static std::size_t indicatorFromStateUpdate(const QJsonObject& stateUpdate) {
+        QJsonObject indicatorObject;
+        indicatorObject["effects"] = stateUpdate["effects"];
+        indicatorObject["layout"] = stateUpdate["panelLayout"].toObject()["layout"];
+        return std::size_t(qHash(QJsonDocument(indicatorObject).toJson(QJsonDocument::Compact)));
+    }
+
+    /// true if the full list of effects has never been received.
+    bool isEmpty() const noexcept { return mIsEmpty; }
+
+    /*!
+     * \brief seed adds the names of the effects that are already stored for the nanoleaf, before
+     * the first full list is received. Any of them missing from the first full list are reported
+     * as removed, and any that are in it are reported as changed.
+     */
+    void seed(const std::vector<std::string>& storedEffects) {
+        for (const auto& name : storedEffects) {
+            mEffects.emplace(name, QJsonObject());
+        }
+    }
+
+    /// updates the change indicator from the latest state update.
+    void indicator(std::size_t indicator) { mIndicator = indicator; }
+
+    /*!
+     * \brief shouldFetch true if the full list of effects should be requested. Counts the
+     * request as skipped if it returns false.
+     */
+    bool shouldFetch() {
+        if (mIsEmpty || mIndicator != mFetchedIndicator
+            || mSkippedFetches >= kFullRefreshInterval) {
+            return true;
+        }
+        ++mSkippedFetches;
+        return false;
+    }
+
+    /*!
+     * \brief update compares a full list of effects against the cache, and updates the cache.
+     * \param animations the full list of effects, as received from the nanoleaf.
+     * \param changedEffects filled with the JSON of each effect that was added or changed.
+     * \param removedEffects filled with the name of each effect that was removed.
+     * \return true if any effect was added, changed, or removed.
+     */
+    bool update(const QJsonArray& animations,
+                std::vector<QJsonObject>& changedEffects,
+                std::vector<QString>& removedEffects) {
+        mFetchedIndicator = mIndicator;
+        mSkippedFetches = 0;
+        mIsEmpty = false;
+
+        if (animations == mAnimations) {
+            return false;
+        }
+        mAnimations = animations;
+
+        std::unordered_map<std::string, QJsonObject> effects;
+        for (const auto& animation : animations) {
+            auto object = animation.toObject();
+            auto name = object["animName"].toString().toStdString();
+            auto result = mEffects.find(name);
+            if (result == mEffects.end() || result->second != object) {
+                changedEffects.push_back(object);
+            }
+            effects.emplace(name, object);
+        }
+        for (const auto& effect : mEffects) {
+            if (effects.find(effect.first) == effects.end()) {
+                removedEffects.push_back(QString::fromStdString(effect.first));
+            }
+        }
+        mEffects = std::move(effects);
+        return !changedEffects.empty() || !removedEffects.empty();
+    }
+
+private:
+    /// the change indicator from the latest state update.
+    std::size_t mIndicator;
+
+    /// the change indicator when the full list of effects was last received.
+    std::size_t mFetchedIndicator;
+
+    /// number of times the full list was not requested since it was last received.
+    int mSkippedFetches;
+
+    /// true if the full list of effects has never been received.
+    bool mIsEmpty;
+
+    /// the last full list of effects received.
+    QJsonArray mAnimations;
+
+    /// the JSON of each effect, keyed by its name.
+    std::unordered_map<std::string, QJsonObject> mEffects;
+};
+
+} // namespace nano
+
+#endif // LEAFEFFECTCACHE_H
@@ -9,6 +9,7 @@
 
 #include "comm/nanoleaf/leafeffect.h"
 #include "comm/nanoleaf/leafprotocols.h"
+#include "comm/nanoleaf/leafstateupdate.h"
 #include "cor/dictionary.h"
 #include "cor/objects/light.h"
 #include "cor/range.h"
@@ -200,36 +201,31 @@ public:
     }
 
     /// updates the meatadata based off of JSON
-    void updateMetadata(const QJsonObject& object) {
-        mManufacturer = object["manufacturer"].toString();
-        mFirmware = object["firmwareVersion"].toString();
-        mModel = object["model"].toString();
-        mHardwareName = object["name"].toString();
-        mSerialNumber = object["serialNo"].toString();
-        mHardwareVersion = object["hardwareVersion"].toString();
-
-        const auto& effectsObject = object["effects"].toObject();
-        if (effectsObject["select"].isString()) {
-            mCurrentEffectName = effectsObject["select"].toString();
+    void updateMetadata(const QJsonObject& object) { updateMetadata(LeafStateUpdate(object)); }
+
+    /// updates the metadata based off of a decoded state update
+    void updateMetadata(const LeafStateUpdate& update) {
+        mManufacturer = update.manufacturer;
+        mFirmware = update.firmwareVersion;
+        mModel = update.model;
+        mHardwareName = update.hardwareName;
+        mSerialNumber = update.serialNumber;
+        mHardwareVersion = update.hardwareVersion;
+
+        if (update.hasEffectName) {
+            mCurrentEffectName = update.effectName;
         }
 
-        if (effectsObject["effectsList"].isArray()) {
-            QJsonArray effectsJSON = effectsObject["effectsList"].toArray();
-            for (auto effect : effectsJSON) {
-                if (effect.isString()) {
-                    QString effectString = effect.toString();
-                    auto result =
-                        std::find(effectsList().begin(), effectsList().end(), effectString);
-                    if (result == effectsList().end()) {
-                        mEffectsList.push_back(effectString);
-                    }
-                }
+        for (const auto& effect : update.effectsList) {
+            auto result = std::find(effectsList().begin(), effectsList().end(), effect);
+            if (result == effectsList().end()) {
+                mEffectsList.push_back(effect);
             }
         }
 
-        mPanelLayout = Panels(object["panelLayout"].toObject());
-        if (object["rhythm"].isObject()) {
-            mRhythm = RhythmController(object["rhythm"].toObject());
+        mPanelLayout = update.panelLayout;
+        if (update.hasRhythm) {
+            mRhythm = update.rhythm;
         }
     }
 
@@ -113,6 +113,15 @@ public:
         return std::difftime(std::mktime(&executionTime), std::mktime(&curTime));
     }
 
+    /// true if every field of both schedules is the same, unlike operator== which only checks IDs.
+    bool isIdentical(const LeafSchedule& rhs) const {
+        return mID == rhs.mID && mIsEnabled == rhs.mIsEnabled && mRepeatType == rhs.mRepeatType
+               && mRepeatValue == rhs.mRepeatValue && mSetID == rhs.mSetID
+               && mStartDate.toString() == rhs.mStartDate.toString()
+               && mEndDate.toString() == rhs.mEndDate.toString()
+               && mAction.toJSON() == rhs.mAction.toJSON();
+    }
+
     bool operator==(const LeafSchedule& rhs) const {
         bool result = true;
         if (mID != rhs.ID()) {
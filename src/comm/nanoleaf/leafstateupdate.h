@@ -0,0 +1,103 @@
+#ifndef LEAFSTATEUPDATE_H
+#define LEAFSTATEUPDATE_H
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QMetaType>
+#include <QString>
+#include <cstddef>
+#include <vector>
+
+#include "comm/nanoleaf/leafeffectcache.h"
+#include "panels.h"
+#include "rhythmcontroller.h"
+
+namespace nano {
+
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ *
+ * \brief The LeafStateUpdate struct is a decoded state update packet from a nanoleaf. Decoding
+ * the panel layout and computing the change indicator of the effects are the expensive parts of
+ * handling the packet, and they only depend on the packet, so they are done on the comm thread.
+ * Only merging the update into the stored metadata is left to the GUI thread.
+ */
+struct LeafStateUpdate {
+    /// default constructor
+    LeafStateUpdate() = default;
+
+    /// decodes a state update packet, which must have a panel layout.
+    explicit LeafStateUpdate(const QJsonObject& object)
+        : manufacturer{object["manufacturer"].toString()},
+          firmwareVersion{object["firmwareVersion"].toString()},
+          model{object["model"].toString()},
+          hardwareName{object["name"].toString()},
+          serialNumber{object["serialNo"].toString()},
+          hardwareVersion{object["hardwareVersion"].toString()},
+          panelLayout{object["panelLayout"].toObject()},
+          hasRhythm{object["rhythm"].isObject()},
+          stateObject{object["state"].toObject()},
+          indicator{LeafEffectCache::indicatorFromStateUpdate(object)} {
+        const auto& effectsObject = object["effects"].toObject();
+        hasEffectName = effectsObject["select"].isString();
+        effectName = effectsObject["select"].toString();
+        for (auto effect : effectsObject["effectsList"].toArray()) {
+            if (effect.isString()) {
+                effectsList.push_back(effect.toString());
+            }
+        }
+        if (hasRhythm) {
+            rhythm = RhythmController(object["rhythm"].toObject());
+        }
+    }
+
+    /// manufacturer of the nanoleaf
+    QString manufacturer;
+
+    /// firmware version of the nanoleaf
+    QString firmwareVersion;
+
+    /// model of the nanoleaf
+    QString model;
+
+    /// name that the nanoleaf gives itself
+    QString hardwareName;
+
+    /// serial number of the nanoleaf
+    QString serialNumber;
+
+    /// hardware version of the nanoleaf
+    QString hardwareVersion;
+
+    /// true if the packet contains the selected effect
+    bool hasEffectName = false;
+
+    /// name of the selected effect
+    QString effectName;
+
+    /// names of the effects stored on the nanoleaf
+    std::vector<QString> effectsList;
+
+    /// layout of the panels
+    Panels panelLayout;
+
+    /// true if the packet contains a rhythm controller
+    bool hasRhythm = false;
+
+    /// the rhythm controller, only valid if hasRhythm is true.
+    RhythmController rhythm;
+
+    /// state of the light, as sent by the nanoleaf. It is small, so it is not decoded further.
+    QJsonObject stateObject;
+
+    /// change indicator of the effects, see LeafEffectCache::indicatorFromStateUpdate
+    std::size_t indicator = 0u;
+};
+
+} // namespace nano
+
+Q_DECLARE_METATYPE(nano::LeafStateUpdate)
+
+#endif // LEAFSTATEUPDATE_H
@@ -0,0 +1,243 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include "networkclient.h"
+
+#include <QTimer>
+
+#include "comm/commthread.h"
+
+namespace {
+
+/// name of the HTTP method of an operation, as it is stored in a traffic log.
+std::string methodName(ENetworkOperation operation) {
+    switch (operation) {
+        case ENetworkOperation::get:
+            return "GET";
+        case ENetworkOperation::put:
+            return "PUT";
+        case ENetworkOperation::post:
+            return "POST";
+        case ENetworkOperation::deleteResource:
+            return "DELETE";
+    }
+    return "GET";
+}
+
+} // namespace
+
+NetworkWorker::NetworkWorker(bool parseJSON, NetworkDecoder decoder)
+    : QObject(nullptr),
+      mParseJSON{parseJSON},
+      mDecoder{std::move(decoder)},
+      mKeepRaw{false},
+      mNetworkManager{nullptr} {}
+
+void NetworkWorker::send(std::uint64_t requestID,
+                         ENetworkOperation operation,
+                         const QNetworkRequest& request,
+                         const QByteArray& body) {
+    if (mNetworkManager == nullptr) {
+        mNetworkManager = new QNetworkAccessManager(this);
+        connect(mNetworkManager,
+                SIGNAL(finished(QNetworkReply*)),
+                this,
+                SLOT(replyFinished(QNetworkReply*)));
+    }
+
+    QNetworkReply* reply = nullptr;
+    switch (operation) {
+        case ENetworkOperation::get:
+            reply = mNetworkManager->get(request);
+            break;
+        case ENetworkOperation::put:
+            reply = mNetworkManager->put(request, body);
+            break;
+        case ENetworkOperation::post:
+            reply = mNetworkManager->post(request, body);
+            break;
+        case ENetworkOperation::deleteResource:
+            reply = mNetworkManager->deleteResource(request);
+            break;
+    }
+    reply->setProperty("requestID", QVariant::fromValue(qulonglong(requestID)));
+    mReplies[requestID] = reply;
+}
+
+void NetworkWorker::abort(std::uint64_t requestID) {
+    auto result = mReplies.find(requestID);
+    if (result != mReplies.end()) {
+        // aborting emits finished, which cleans up the reply.
+        result->second->abort();
+    }
+}
+
+void NetworkWorker::replyFinished(QNetworkReply* reply) {
+    NetworkResponse response;
+    response.requestID = std::uint64_t(reply->property("requestID").toULongLong());
+    response.url = reply->url();
+    response.error = reply->error();
+    response.errorString = reply->errorString();
+    response.body = reply->readAll();
+    if (mParseJSON && response.error == QNetworkReply::NoError && !response.body.isEmpty()) {
+        // decoding is the expensive part of handling a reply, so do it before leaving the thread.
+        response.json = QJsonDocument::fromJson(response.body);
+    }
+    if (mDecoder && response.error == QNetworkReply::NoError) {
+        response.decoded = mDecoder(response);
+        if (response.decoded.isValid() && !mKeepRaw) {
+            // the GUI thread only needs the decoded result
+            response.body.clear();
+            response.json = QJsonDocument();
+        }
+    }
+    mReplies.erase(response.requestID);
+    reply->deleteLater();
+    emit finished(response);
+}
+
+NetworkClient::NetworkClient(CommThread* thread,
+                             bool parseJSON,
+                             QObject* parent,
+                             NetworkDecoder decoder)
+    : QObject(parent),
+      mWorker{new NetworkWorker(parseJSON, decoder)},
+      mNextRequestID{1u},
+      mParseJSON{parseJSON},
+      mDecoder{decoder},
+      mTrafficLog{nullptr},
+      mTrafficReplay{nullptr} {
+    qRegisterMetaType<NetworkResponse>("NetworkResponse");
+    if (thread != nullptr) {
+        thread->moveToThread(mWorker);
+    }
+    connect(mWorker,
+            SIGNAL(finished(NetworkResponse)),
+            this,
+            SLOT(handleFinished(NetworkResponse)));
+}
+
+NetworkClient::~NetworkClient() {
+    if (!mWorker.isNull()) {
+        mWorker->deleteLater();
+    }
+}
+
+std::uint64_t NetworkClient::send(ENetworkOperation operation,
+                                  const QNetworkRequest& request,
+                                  const QByteArray& body) {
+    auto requestID = mNextRequestID++;
+    if (mTrafficLog != nullptr) {
+        cor::TrafficEvent event;
+        event.source = mTrafficSource;
+        event.direction = cor::ETrafficDirection::sent;
+        event.endpoint = request.url().toString().toStdString();
+        event.method = methodName(operation);
+        event.requestID = requestID;
+        event.payload = body.toStdString();
+        mCapturedRequests.emplace(requestID, std::make_pair(event.method, event.endpoint));
+        mTrafficLog->record(std::move(event));
+    }
+    if (mTrafficReplay != nullptr) {
+        replayRequest(requestID, methodName(operation), request.url(), body);
+        return requestID;
+    }
+
+    NetworkWorker* worker = mWorker;
+    QMetaObject::invokeMethod(
+        worker,
+        [worker, requestID, operation, request, body]() {
+            worker->send(requestID, operation, request, body);
+        },
+        Qt::QueuedConnection);
+    return requestID;
+}
+
+void NetworkClient::abort(std::uint64_t requestID) {
+    if (mReplayedRequests.erase(requestID) > 0u) {
+        NetworkResponse response;
+        response.requestID = requestID;
+        response.error = QNetworkReply::OperationCanceledError;
+        response.errorString = "Operation canceled";
+        // signal asynchronously, the same as an aborted request of the worker.
+        QTimer::singleShot(0, this, [this, response]() { handleFinished(response); });
+        return;
+    }
+    NetworkWorker* worker = mWorker;
+    QMetaObject::invokeMethod(
+        worker, [worker, requestID]() { worker->abort(requestID); }, Qt::QueuedConnection);
+}
+
+void NetworkClient::traffic(cor::TrafficLog* log,
+                            cor::TrafficReplay* replay,
+                            const QString& source) {
+    mTrafficLog = log;
+    mTrafficReplay = replay;
+    mTrafficSource = source.toStdString();
+    NetworkWorker* worker = mWorker;
+    auto keepRaw = (log != nullptr);
+    QMetaObject::invokeMethod(
+        worker, [worker, keepRaw]() { worker->keepRaw(keepRaw); }, Qt::QueuedConnection);
+}
+
+void NetworkClient::handleFinished(NetworkResponse response) {
+    auto request = mCapturedRequests.find(response.requestID);
+    if (mTrafficLog != nullptr && request != mCapturedRequests.end()) {
+        cor::TrafficEvent event;
+        event.source = mTrafficSource;
+        event.direction = cor::ETrafficDirection::received;
+        // the request's URL, so the response can be paired with it even if it was redirected.
+        event.method = request->second.first;
+        event.endpoint = request->second.second;
+        event.requestID = response.requestID;
+        event.status = int(response.error);
+        event.payload = response.body.toStdString();
+        mTrafficLog->record(std::move(event));
+    }
+    if (request != mCapturedRequests.end()) {
+        mCapturedRequests.erase(request);
+    }
+    emit finished(response);
+}
+
+void NetworkClient::replayRequest(std::uint64_t requestID,
+                                  const std::string& method,
+                                  const QUrl& url,
+                                  const QByteArray& body) {
+    NetworkResponse response;
+    response.requestID = requestID;
+    response.url = url;
+    auto result = mTrafficReplay->respond(mTrafficSource,
+                                          method,
+                                          url.toString().toStdString(),
+                                          body.toStdString());
+    int latency = 0;
+    if (result.second) {
+        latency = int(result.first.time);
+        response.error = QNetworkReply::NetworkError(result.first.status);
+        response.body = QByteArray::fromStdString(result.first.payload);
+        if (response.error != QNetworkReply::NoError) {
+            response.errorString = "Replayed error";
+        } else {
+            if (mParseJSON && !response.body.isEmpty()) {
+                response.json = QJsonDocument::fromJson(response.body);
+            }
+            if (mDecoder) {
+                response.decoded = mDecoder(response);
+            }
+        }
+    } else {
+        response.error = QNetworkReply::HostNotFoundError;
+        response.errorString = "No response was captured for this request";
+    }
+    mReplayedRequests.insert(requestID);
+    QTimer::singleShot(latency, this, [this, response]() {
+        // skip requests that were aborted while they waited
+        if (mReplayedRequests.erase(response.requestID) > 0u) {
+            handleFinished(response);
+        }
+    });
+}
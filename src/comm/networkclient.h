@@ -0,0 +1,227 @@
+#ifndef NETWORKCLIENT_H
+#define NETWORKCLIENT_H
+
+#include <QByteArray>
+#include <QJsonDocument>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QObject>
+#include <QPointer>
+#include <QUrl>
+#include <QVariant>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include "cor/trafficlog.h"
+#include "cor/trafficreplay.h"
+
+class CommThread;
+
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ *
+ * \brief The NetworkResponse struct is an immutable copy of a finished QNetworkReply. It is built
+ * on the comm thread and handed to the GUI thread, so it contains everything the CommTypes need
+ * from the reply, including the decoded JSON if the NetworkClient was asked to parse it.
+ *
+ * If the NetworkClient has a decoder that understands the reply, the result of the decoder is
+ * stored in decoded, and the body and JSON are dropped, so only the decoded result crosses
+ * threads. They are kept while traffic is captured, since the log records the raw body.
+ */
+struct NetworkResponse {
+    /// ID of the request this responds to, as returned by NetworkClient.
+    std::uint64_t requestID = 0u;
+
+    /// URL the request was sent to
+    QUrl url;
+
+    /// error of the reply, QNetworkReply::NoError if the request succeeded.
+    QNetworkReply::NetworkError error = QNetworkReply::NoError;
+
+    /// human readable description of the error
+    QString errorString;
+
+    /// raw body of the reply
+    QByteArray body;
+
+    /// body decoded as JSON, null if it is not JSON or JSON parsing is not enabled.
+    QJsonDocument json;
+
+    /// result of the NetworkClient's decoder, invalid if there is no decoder or it did not apply.
+    QVariant decoded;
+};
+Q_DECLARE_METATYPE(NetworkResponse)
+
+/*!
+ * decodes a successful reply into the compact result a CommType needs, or returns an invalid
+ * QVariant if the reply is not one it understands. It runs on the comm thread, so it must only
+ * depend on the reply.
+ */
+using NetworkDecoder = std::function<QVariant(const NetworkResponse&)>;
+
+/// HTTP operations supported by the NetworkClient
+enum class ENetworkOperation { get, put, post, deleteResource };
+
+/*!
+ * \brief The NetworkWorker class owns a QNetworkAccessManager and lives on the comm thread. It
+ * should only be used through a NetworkClient.
+ */
+class NetworkWorker : public QObject {
+    Q_OBJECT
+public:
+    /// constructor
+    NetworkWorker(bool parseJSON, NetworkDecoder decoder);
+
+    /// sends a request, the response is signaled by finished()
+    void send(std::uint64_t requestID,
+              ENetworkOperation operation,
+              const QNetworkRequest& request,
+              const QByteArray& body);
+
+    /// aborts a request if it is still in flight. An aborted request still signals finished().
+    void abort(std::uint64_t requestID);
+
+    /// true to keep the raw body and JSON of replies that are decoded, such as for capturing them.
+    void keepRaw(bool keepRaw) { mKeepRaw = keepRaw; }
+
+signals:
+    /// emitted when a request finishes, fails, or is aborted.
+    void finished(NetworkResponse);
+
+private slots:
+    /// converts a reply into a NetworkResponse
+    void replyFinished(QNetworkReply* reply);
+
+private:
+    /// true if the bodies of replies should be decoded as JSON.
+    bool mParseJSON;
+
+    /// decodes successful replies, may be empty.
+    NetworkDecoder mDecoder;
+
+    /// true if the raw body and JSON of decoded replies are kept.
+    bool mKeepRaw;
+
+    /// Qt's HTTP connection object, created on the first request so it is created on the thread
+    /// that uses it.
+    QNetworkAccessManager* mNetworkManager;
+
+    /// requests in flight, keyed by their request ID.
+    std::unordered_map<std::uint64_t, QNetworkReply*> mReplies;
+};
+
+/*!
+ * \brief The NetworkClient class sends HTTP requests from the GUI thread through a NetworkWorker
+ * on the comm thread. Requests return immediately with an ID, and the response is signaled by
+ * finished() on the GUI thread. If no CommThread is given, the worker runs on the calling thread.
+ *
+ * Requests and responses can be captured to a TrafficLog. While a TrafficReplay is set, requests
+ * are not sent, and are instead answered with their captured responses.
+ */
+class NetworkClient : public QObject {
+    Q_OBJECT
+public:
+    /*!
+     * \brief NetworkClient constructor
+     * \param thread thread the worker runs on, nullptr to run it on the calling thread.
+     * \param parseJSON true to decode the bodies of replies as JSON on the comm thread.
+     * \param parent parent of the client
+     * \param decoder decodes successful replies on the comm thread, may be empty.
+     */
+    NetworkClient(CommThread* thread,
+                  bool parseJSON,
+                  QObject* parent,
+                  NetworkDecoder decoder = NetworkDecoder());
+
+    /// destructor, deletes the worker on its own thread.
+    ~NetworkClient();
+
+    /// sends a GET request, returns the ID of the request.
+    std::uint64_t get(const QNetworkRequest& request) {
+        return send(ENetworkOperation::get, request, QByteArray());
+    }
+
+    /// sends a PUT request, returns the ID of the request.
+    std::uint64_t put(const QNetworkRequest& request, const QByteArray& body) {
+        return send(ENetworkOperation::put, request, body);
+    }
+
+    /// sends a POST request, returns the ID of the request.
+    std::uint64_t post(const QNetworkRequest& request, const QByteArray& body) {
+        return send(ENetworkOperation::post, request, body);
+    }
+
+    /// sends a DELETE request, returns the ID of the request.
+    std::uint64_t deleteResource(const QNetworkRequest& request) {
+        return send(ENetworkOperation::deleteResource, request, QByteArray());
+    }
+
+    /// aborts a request if it is still in flight. An aborted request still signals finished().
+    void abort(std::uint64_t requestID);
+
+    /*!
+     * \brief traffic sets the log that requests and responses are captured to, and the replay
+     * that answers requests in place of the network. Either can be nullptr.
+     * \param log log to capture to
+     * \param replay replay to answer requests from
+     * \param source name of the CommType that owns the client, used to tell clients apart.
+     */
+    void traffic(cor::TrafficLog* log, cor::TrafficReplay* replay, const QString& source);
+
+signals:
+    /// emitted on the GUI thread when a request finishes, fails, or is aborted.
+    void finished(NetworkResponse);
+
+private slots:
+    /// captures a response, if capturing, and signals it.
+    void handleFinished(NetworkResponse response);
+
+private:
+    /// sends a request to the worker, returns the ID of the request.
+    std::uint64_t send(ENetworkOperation operation,
+                       const QNetworkRequest& request,
+                       const QByteArray& body);
+
+    /// worker that sends the requests, lives on the comm thread. The comm thread deletes it if it
+    /// stops before the client is deleted.
+    QPointer<NetworkWorker> mWorker;
+
+    /// answers a request from the replay after its captured latency.
+    void replayRequest(std::uint64_t requestID,
+                       const std::string& method,
+                       const QUrl& url,
+                       const QByteArray& body);
+
+    /// ID given to the next request. IDs start at 1, so 0 can be used for "no request".
+    std::uint64_t mNextRequestID;
+
+    /// true if the bodies of replies are decoded as JSON.
+    bool mParseJSON;
+
+    /// decodes replies answered by the replay
+    NetworkDecoder mDecoder;
+
+    /// log that traffic is captured to, nullptr if traffic is not captured.
+    cor::TrafficLog* mTrafficLog;
+
+    /// replay that answers requests, nullptr if requests are sent to the network.
+    cor::TrafficReplay* mTrafficReplay;
+
+    /// name of the CommType that owns the client
+    std::string mTrafficSource;
+
+    /// method and URL of each captured request that has not been responded to, keyed by its ID.
+    std::unordered_map<std::uint64_t, std::pair<std::string, std::string>> mCapturedRequests;
+
+    /// IDs of requests that are waiting on a response from the replay.
+    std::unordered_set<std::uint64_t> mReplayedRequests;
+};
+
+#endif // NETWORKCLIENT_H
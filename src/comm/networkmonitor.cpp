@@ -0,0 +1,79 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include "networkmonitor.h"
+
+#include <QDebug>
+#include <QNetworkInterface>
+
+namespace {
+
+/// msec between checks of the network interfaces, when events are not available.
+const int kPollInterval = 2500;
+
+/// msec to wait after an event before checking, so a burst of events is checked once.
+const int kSettleInterval = 250;
+
+/// the state of the platform's network interfaces
+std::vector<cor::NetworkInterfaceState> platformInterfaces() {
+    std::vector<cor::NetworkInterfaceState> interfaces;
+    for (const QNetworkInterface& iface : QNetworkInterface::allInterfaces()) {
+        cor::NetworkInterfaceState state;
+        state.name = iface.humanReadableName().toStdString();
+        state.isLAN = iface.type() == QNetworkInterface::Wifi
+                      || iface.type() == QNetworkInterface::Ethernet;
+        state.isUp = iface.flags().testFlag(QNetworkInterface::IsUp);
+        state.isRunning = iface.flags().testFlag(QNetworkInterface::IsRunning);
+        interfaces.push_back(state);
+    }
+#ifdef Q_OS_WIN
+    // the interface checks don't work on windows, so assume it has a network.
+    interfaces.push_back(cor::NetworkInterfaceState{"windows", true, true, true});
+#endif
+    return interfaces;
+}
+
+} // namespace
+
+NetworkMonitor::NetworkMonitor(QObject* parent) : NetworkMonitor(platformInterfaces, parent) {}
+
+NetworkMonitor::NetworkMonitor(cor::NetworkAvailability::Provider provider, QObject* parent)
+    : QObject(parent),
+      mAvailability(std::move(provider)),
+      mNotifier{nullptr},
+      mCheckTimer{new QTimer(this)} {
+    connect(mCheckTimer, SIGNAL(timeout()), this, SLOT(checkInterfaces()));
+    if (mWatcher.isValid()) {
+        mCheckTimer->setSingleShot(true);
+        mNotifier = new QSocketNotifier(mWatcher.fd(), QSocketNotifier::Read, this);
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+        connect(mNotifier, SIGNAL(activated(int)), this, SLOT(handleNetlinkEvents()));
+#else
+        connect(mNotifier,
+                SIGNAL(activated(QSocketDescriptor, QSocketNotifier::Type)),
+                this,
+                SLOT(handleNetlinkEvents()));
+#endif
+    } else {
+#ifndef Q_OS_WIN
+        // windows is always treated as available, so there is nothing to poll.
+        mCheckTimer->start(kPollInterval);
+#endif
+    }
+}
+
+void NetworkMonitor::handleNetlinkEvents() {
+    if (mWatcher.readEvents() && !mCheckTimer->isActive()) {
+        mCheckTimer->start(kSettleInterval);
+    }
+}
+
+void NetworkMonitor::checkInterfaces() {
+    if (mAvailability.refresh()) {
+        qDebug() << "INFO: network" << (mAvailability.isAvailable() ? "available" : "unavailable");
+        emit availabilityChanged(mAvailability.isAvailable());
+    }
+}
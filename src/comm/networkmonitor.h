@@ -0,0 +1,58 @@
+#ifndef NETWORKMONITOR_H
+#define NETWORKMONITOR_H
+
+#include <QObject>
+#include <QSocketNotifier>
+#include <QTimer>
+
+#include "cor/networkavailability.h"
+
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ *
+ * \brief The NetworkMonitor class signals when the local network becomes available or unavailable.
+ * On Linux, it listens to the kernel's netlink events and only checks the network interfaces
+ * after one of them changes, so an idle network costs nothing. On other platforms it falls back
+ * to polling the interfaces.
+ */
+class NetworkMonitor : public QObject {
+    Q_OBJECT
+public:
+    /// constructor, checks the network interfaces of the platform.
+    explicit NetworkMonitor(QObject* parent);
+
+    /// constructor, checks the interfaces given by a provider.
+    NetworkMonitor(cor::NetworkAvailability::Provider provider, QObject* parent);
+
+    /// true if the local network is available
+    bool isAvailable() const noexcept { return mAvailability.isAvailable(); }
+
+signals:
+    /// emitted when the local network becomes available or unavailable.
+    void availabilityChanged(bool);
+
+private slots:
+    /// reads the pending netlink events, and checks the interfaces soon if any changed.
+    void handleNetlinkEvents();
+
+    /// checks the network interfaces, and signals if the availability changed.
+    void checkInterfaces();
+
+private:
+    /// tracks whether the network is available
+    cor::NetworkAvailability mAvailability;
+
+    /// receives link and address events, not valid on platforms without netlink.
+    cor::NetlinkWatcher mWatcher;
+
+    /// wakes up when mWatcher has events, nullptr when polling.
+    QSocketNotifier* mNotifier;
+
+    /// when watching, delays checking until a burst of events settles. When polling, fires on an
+    /// interval.
+    QTimer* mCheckTimer;
+};
+
+#endif // NETWORKMONITOR_H
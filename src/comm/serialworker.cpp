@@ -0,0 +1,110 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include "serialworker.h"
+
+#include <QDebug>
+#include <algorithm>
+
+SerialWorker::SerialWorker() : QObject(nullptr) {}
+
+std::vector<std::pair<QSerialPort*, QByteArray>>::iterator SerialWorker::findPort(
+    const QString& name) {
+    return std::find_if(mPorts.begin(),
+                        mPorts.end(),
+                        [&name](const std::pair<QSerialPort*, QByteArray>& port) {
+                            return port.first->portName() == name;
+                        });
+}
+
+void SerialWorker::open(const QString& name) {
+    if (findPort(name) != mPorts.end()) {
+        // its already connected, no need to connect again
+        emit portOpened(name);
+        return;
+    }
+
+    auto serial = new QSerialPort(this);
+    serial->setPortName(name);
+    if (serial->open(QIODevice::ReadWrite)) {
+        serial->setBaudRate(QSerialPort::Baud9600);
+        serial->setStopBits(QSerialPort::OneStop);
+        serial->setParity(QSerialPort::NoParity);
+        serial->setDataBits(QSerialPort::Data8);
+        serial->setFlowControl(QSerialPort::NoFlowControl);
+
+        mPorts.emplace_back(serial, QByteArray());
+        connect(serial, SIGNAL(readyRead()), this, SLOT(readPort()));
+        connect(serial,
+                SIGNAL(error(QSerialPort::SerialPortError)),
+                this,
+                SLOT(handleError(QSerialPort::SerialPortError)));
+        emit portOpened(name);
+        return;
+    }
+    emit portFailed(name, serial->errorString());
+    delete serial;
+}
+
+void SerialWorker::close(const QString& name) {
+    auto result = findPort(name);
+    if (result != mPorts.end()) {
+        result->first->close();
+        result->first->deleteLater();
+        mPorts.erase(result);
+    }
+}
+
+void SerialWorker::closeAll() {
+    for (auto&& port : mPorts) {
+        if (port.first->isOpen()) {
+            port.first->clear();
+            port.first->close();
+        }
+        port.first->deleteLater();
+    }
+    mPorts.clear();
+}
+
+void SerialWorker::write(const QString& name, const QByteArray& bytes) {
+    auto result = findPort(name);
+    if (result != mPorts.end() && result->first->isOpen()) {
+        result->first->write(bytes);
+    }
+}
+
+void SerialWorker::readPort() {
+    auto serial = qobject_cast<QSerialPort*>(sender());
+    if (serial == nullptr) {
+        return;
+    }
+    auto result = findPort(serial->portName());
+    if (result == mPorts.end()) {
+        return;
+    }
+    auto& buffer = result->second;
+    buffer += serial->readAll();
+    // packets end in a ;, and a read may contain several packets or only part of one.
+    auto end = buffer.indexOf(';');
+    while (end >= 0) {
+        auto packet = buffer.left(end).trimmed();
+        buffer.remove(0, end + 1);
+        if (!packet.isEmpty()) {
+            emit packetReceived(serial->portName(),
+                                QString::fromUtf8(packet),
+                                decodeArduCorPacket(
+                                    std::string_view(packet.constData(),
+                                                     std::size_t(packet.size()))));
+        }
+        end = buffer.indexOf(';');
+    }
+}
+
+void SerialWorker::handleError(QSerialPort::SerialPortError error) {
+    if (error != QSerialPort::NoError) {
+        qDebug() << "Serial Port Error!" << error;
+    }
+}
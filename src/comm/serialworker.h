@@ -0,0 +1,67 @@
+#ifndef SERIALWORKER_H
+#define SERIALWORKER_H
+
+#include <QByteArray>
+#include <QObject>
+#include <QString>
+#include <QtSerialPort/QSerialPort>
+#include <utility>
+#include <vector>
+
+#include "comm/commthread.h"
+
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ *
+ * \brief The SerialWorker class owns the serial ports used by CommSerial and lives on the comm
+ * thread. It opens and closes ports, writes to them, and buffers what they send until a packet is
+ * complete. Each complete packet is decoded into its values before it is signaled. Its functions
+ * should be invoked from other threads with queued calls.
+ */
+class SerialWorker : public QObject {
+    Q_OBJECT
+public:
+    /// constructor
+    SerialWorker();
+
+    /// opens a port, signals portOpened() if successful and portFailed() otherwise.
+    void open(const QString& name);
+
+    /// closes a port, if it is open.
+    void close(const QString& name);
+
+    /// closes every port
+    void closeAll();
+
+    /// writes bytes to a port, if it is open.
+    void write(const QString& name, const QByteArray& bytes);
+
+signals:
+    /// emitted when a port is opened
+    void portOpened(QString);
+
+    /// emitted when a port fails to open, with the name of the port and the error.
+    void portFailed(QString, QString);
+
+    /// emitted for every packet received, with the name of the port, the packet without its
+    /// ending ;, and its values.
+    void packetReceived(QString, QString, ArduCorPacket);
+
+private slots:
+    /// reads from the port that is ready, and signals every complete packet.
+    void readPort();
+
+    /// handles errors from a port
+    void handleError(QSerialPort::SerialPortError);
+
+private:
+    /// returns the port with the given name and its buffer, or end() if it is not open.
+    std::vector<std::pair<QSerialPort*, QByteArray>>::iterator findPort(const QString& name);
+
+    /// open ports, and the characters they have sent since their last complete packet.
+    std::vector<std::pair<QSerialPort*, QByteArray>> mPorts;
+};
+
+#endif // SERIALWORKER_H
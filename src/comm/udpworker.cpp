@@ -0,0 +1,58 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include "udpworker.h"
+
+#include "cor/tokenizer.h"
+
+namespace {
+
+/// a datagram may contain multiple packets, separated by semicolons.
+const cor::Tokenizer<char> kPacketDelimiters(";");
+
+} // namespace
+
+UDPWorker::UDPWorker() : QObject(nullptr), mSocket{nullptr} {}
+
+bool UDPWorker::bind(const QHostAddress& address, quint16 port) {
+    if (mSocket == nullptr) {
+        mSocket = new QUdpSocket(this);
+        connect(mSocket, SIGNAL(readyRead()), this, SLOT(readPendingDatagrams()));
+    }
+    return mSocket->bind(address, port);
+}
+
+void UDPWorker::close() {
+    if (mSocket != nullptr) {
+        mSocket->close();
+    }
+}
+
+void UDPWorker::send(const QByteArray& datagram, const QHostAddress& address, quint16 port) {
+    if (mSocket != nullptr) {
+        mSocket->writeDatagram(datagram, address, port);
+    }
+}
+
+void UDPWorker::readPendingDatagrams() {
+    while (mSocket->hasPendingDatagrams()) {
+        QByteArray datagram;
+        datagram.resize(int(mSocket->pendingDatagramSize()));
+        QHostAddress sender;
+        quint16 senderPort;
+        mSocket->readDatagram(datagram.data(), datagram.size(), &sender, &senderPort);
+        auto senderName = sender.toString();
+        // this may contain multiple packets in a single packet, split the bytes and handle each
+        // as a separate message.
+        kPacketDelimiters.forEach(
+            std::string_view(datagram.constData(), std::size_t(datagram.size())),
+            [this, &senderName](std::string_view packet) {
+                emit packetReceived(senderName,
+                                    QString::fromUtf8(packet.data(), int(packet.size())),
+                                    decodeArduCorPacket(packet));
+            });
+    }
+}
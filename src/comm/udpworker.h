@@ -0,0 +1,48 @@
+#ifndef UDPWORKER_H
+#define UDPWORKER_H
+
+#include <QHostAddress>
+#include <QObject>
+#include <QUdpSocket>
+
+#include "comm/commthread.h"
+
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ *
+ * \brief The UDPWorker class owns the UDP socket used by CommUDP and lives on the comm thread.
+ * It reads incoming datagrams, splits datagrams that contain multiple packets, and decodes each
+ * packet into its values before signaling it. Its functions should be invoked from other threads
+ * with queued calls.
+ */
+class UDPWorker : public QObject {
+    Q_OBJECT
+public:
+    /// constructor
+    UDPWorker();
+
+    /// binds the socket, returns true if successful.
+    bool bind(const QHostAddress& address, quint16 port);
+
+    /// closes the socket
+    void close();
+
+    /// sends a datagram
+    void send(const QByteArray& datagram, const QHostAddress& address, quint16 port);
+
+signals:
+    /// emitted for every packet received, with the sender's address, the packet, and its values.
+    void packetReceived(QString, QString, ArduCorPacket);
+
+private slots:
+    /// reads and splits all pending datagrams
+    void readPendingDatagrams();
+
+private:
+    /// Qt's UDP object, created on the first bind so it is created on the thread that uses it.
+    QUdpSocket* mSocket;
+};
+
+#endif // UDPWORKER_H
@@ -8,11 +8,24 @@
 
 //#define DEBUG_UPNP
 
+namespace {
+
+/// shortest time a repeat announcement is dropped for, in msec
+const std::int64_t kMinAnnouncementTTL = 10000;
+
+/// longest time a repeat announcement is dropped for, in msec. Devices often announce a max-age of
+/// 30 minutes, so this is capped to still give listeners a device they missed every minute.
+const std::int64_t kMaxAnnouncementTTL = 60000;
+
+} // namespace
+
 UPnPDiscovery::UPnPDiscovery(QObject* parent)
     : QObject(parent),
       mSocket{new QUdpSocket(this)},
       mListenerCount{0},
-      mHasReceivedTraffic{false} {
+      mHasReceivedTraffic{false},
+      mCache(kMinAnnouncementTTL, kMaxAnnouncementTTL) {
+    mClock.start();
     connect(mSocket, SIGNAL(readyRead()), this, SLOT(readPendingUPnPDatagrams()));
 }
 
@@ -30,11 +43,17 @@ void UPnPDiscovery::readPendingUPnPDatagrams() {
         QHostAddress sender;
         quint16 senderPort;
         mSocket->readDatagram(datagram.data(), datagram.size(), &sender, &senderPort);
-        QString payload = QString::fromUtf8(datagram);
+        auto result = cor::SSDPMessage::parse(datagram.toStdString());
+        if (!result.second) {
+            continue;
+        }
+        if (!mCache.shouldPass(sender.toString().toStdString(), result.first, mClock.elapsed())) {
+            continue;
+        }
 #ifdef DEBUG_UPNP
-        qDebug() << __func__ << sender << ":" << payload;
+        qDebug() << __func__ << sender << ":" << QString::fromStdString(result.first.usn());
 #endif
-        emit UPnPPacketReceived(sender, payload);
+        emit UPnPPacketReceived(sender, result.first);
     }
 }
 
@@ -68,6 +87,8 @@ void UPnPDiscovery::shutdown() {
 
 
 void UPnPDiscovery::addListener() {
+    // a new listener hasn't heard any announcements yet, so pass along the next one of each device
+    mCache.clear();
     if (mListenerCount == 0) {
         startup();
     }
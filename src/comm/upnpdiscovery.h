@@ -1,9 +1,13 @@
 #ifndef UPNPDISCOVERY_H
 #define UPNPDISCOVERY_H
 
+#include <QElapsedTimer>
 #include <QObject>
 #include <QUdpSocket>
 
+#include "cor/ssdpcache.h"
+#include "cor/ssdpmessage.h"
+
 /*!
  * \copyright
  * Copyright (C) 2015 - 2020.
@@ -14,6 +18,9 @@
  * received. Rather than using the standard startup/shutdown methods that most of the backend
  * classes use in this app, this object automatically turns on and off its socket based on how many
  * listeners are requesting that it sends UPnP packets.
+ *
+ * Packets are parsed into a cor::SSDPMessage once, and repeat announcements from devices that were
+ * already heard from are dropped by a cor::SSDPCache before they reach the listeners.
  */
 class UPnPDiscovery : public QObject {
     Q_OBJECT
@@ -45,10 +52,10 @@ public:
 
 signals:
     /*!
-     * \brief UPnPPacketReceived sends ouit the QHostAddress and the payload associated
-     *        with the UPnP packet received.
+     * \brief UPnPPacketReceived sends out the QHostAddress and the parsed message associated
+     *        with the UPnP packet received. Repeat announcements are not sent.
      */
-    void UPnPPacketReceived(QHostAddress, QString);
+    void UPnPPacketReceived(QHostAddress, cor::SSDPMessage);
 
 private slots:
 
@@ -75,6 +82,12 @@ private:
 
     /// true if it has received any traffic
     bool mHasReceivedTraffic;
+
+    /// drops repeat announcements
+    cor::SSDPCache mCache;
+
+    /// clock for the cache
+    QElapsedTimer mClock;
 };
 
 #endif // UPNPDISCOVERY_H
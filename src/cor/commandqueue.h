@@ -0,0 +1,88 @@
+#ifndef COR_COMMANDQUEUE_H
+#define COR_COMMANDQUEUE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace cor {
+
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ *
+ * \brief The CommandQueue class stores the commands waiting to be sent to a single device, in the
+ * order they are sent. Each command has a key, and commands with the same key change the same
+ * setting of the same lights, so a newer command supersedes an older one with its key.
+ *
+ * A superseding command takes the place of the command it replaces, so it keeps its order
+ * relative to the commands for other keys. The exception is when a command queued after the
+ * replaced one overlaps the new command, such as a command for a single light queued after a
+ * command for all lights. Sending the new command in the old place would let the overlapping
+ * command undo part of it, so the new command is moved to the end of the queue instead, which
+ * matches the order the commands were given in.
+ */
+template <typename Key, typename Message>
+class CommandQueue {
+public:
+    /// number of queued commands
+    std::size_t size() const noexcept { return mCommands.size(); }
+
+    /// true if no commands are queued
+    bool empty() const noexcept { return mCommands.empty(); }
+
+    /// the message of a queued command, 0 is the next command to send.
+    const Message& operator[](std::size_t i) const { return mCommands[i].second; }
+
+    /*!
+     * \brief push queues a command, superseding any queued command with the same key.
+     * \param key key of the command
+     * \param message message of the command
+     * \param overlaps called as overlaps(const Key& a, const Key& b). Returns true if commands
+     *        with different keys a and b change the same setting of at least one light.
+     * \return true if a queued command was superseded, false otherwise.
+     */
+    template <typename Overlaps>
+    bool push(const Key& key, Message message, Overlaps overlaps) {
+        auto result = std::find_if(mCommands.begin(),
+                                   mCommands.end(),
+                                   [&key](const std::pair<Key, Message>& command) {
+                                       return command.first == key;
+                                   });
+        if (result == mCommands.end()) {
+            mCommands.emplace_back(key, std::move(message));
+            return false;
+        }
+        auto isOverlapped = std::any_of(result + 1,
+                                        mCommands.end(),
+                                        [&key, &overlaps](const std::pair<Key, Message>& command) {
+                                            return overlaps(command.first, key);
+                                        });
+        if (isOverlapped) {
+            mCommands.erase(result);
+            mCommands.emplace_back(key, std::move(message));
+        } else {
+            result->second = std::move(message);
+        }
+        return true;
+    }
+
+    /// removes the first count commands, after they have been sent.
+    void pop(std::size_t count) {
+        count = std::min(count, mCommands.size());
+        mCommands.erase(mCommands.begin(), mCommands.begin() + std::ptrdiff_t(count));
+    }
+
+    /// removes every queued command
+    void clear() { mCommands.clear(); }
+
+private:
+    /// queued commands and their keys, in the order they are sent.
+    std::vector<std::pair<Key, Message>> mCommands;
+};
+
+} // namespace cor
+
+#endif // COR_COMMANDQUEUE_H
@@ -0,0 +1,93 @@
+#ifndef COR_CONTENTHASH_H
+#define COR_CONTENTHASH_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace cor {
+
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ *
+ * \brief The ContentHash class builds a 64 bit hash from the values that determine how something
+ * is rendered, so that a rendered image can be cached and reused by anything that would render
+ * the same content. Unlike PaletteSignature, nothing is quantized or sorted: the same values in
+ * the same order give the same hash, and any difference is expected to change it.
+ */
+class ContentHash {
+public:
+    /// constructor, the seed separates the hashes of different kinds of content.
+    explicit ContentHash(std::uint64_t seed = 0u) : mHash{mix(seed + kGolden)} {}
+
+    /// adds an unsigned value
+    ContentHash& add(std::uint64_t value) noexcept {
+        mHash = mix(mHash ^ (value + kGolden + (mHash << 6u) + (mHash >> 2u)));
+        return *this;
+    }
+
+    /// adds a signed value
+    ContentHash& add(std::int64_t value) noexcept { return add(std::uint64_t(value)); }
+
+    /// adds an unsigned int
+    ContentHash& add(std::uint32_t value) noexcept { return add(std::uint64_t(value)); }
+
+    /// adds an int
+    ContentHash& add(int value) noexcept { return add(std::int64_t(value)); }
+
+    /// adds a flag
+    ContentHash& add(bool value) noexcept { return add(std::uint64_t(value ? 1u : 0u)); }
+
+    /// adds a floating point value. 0.0 and -0.0 hash the same, since they render the same.
+    ContentHash& add(double value) noexcept {
+        if (value == 0.0) {
+            value = 0.0;
+        }
+        std::uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return add(bits);
+    }
+
+    /// adds a string, including its length so that consecutive strings can't run together.
+    ContentHash& add(const std::string& value) noexcept {
+        add(std::uint64_t(value.size()));
+        std::uint64_t word = 0u;
+        auto shift = 0u;
+        for (auto character : value) {
+            word |= std::uint64_t(std::uint8_t(character)) << shift;
+            shift += 8u;
+            if (shift == 64u) {
+                add(word);
+                word = 0u;
+                shift = 0u;
+            }
+        }
+        if (shift > 0u) {
+            add(word);
+        }
+        return *this;
+    }
+
+    /// the hash of everything added so far
+    std::uint64_t value() const noexcept { return mHash; }
+
+private:
+    /// fractional part of the golden ratio, used to spread out small values.
+    static constexpr std::uint64_t kGolden = 0x9e3779b97f4a7c15ULL;
+
+    /// splitmix64 finalizer
+    static std::uint64_t mix(std::uint64_t value) noexcept {
+        value = (value ^ (value >> 30u)) * 0xbf58476d1ce4e5b9ULL;
+        value = (value ^ (value >> 27u)) * 0x94d049bb133111ebULL;
+        return value ^ (value >> 31u);
+    }
+
+    /// the hash of everything added so far
+    std::uint64_t mHash;
+};
+
+} // namespace cor
+
+#endif // COR_CONTENTHASH_H
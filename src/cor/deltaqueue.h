@@ -0,0 +1,177 @@
+#ifndef COR_DELTAQUEUE_H
+#define COR_DELTAQUEUE_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace cor {
+
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ *
+ * \brief The DeltaQueueStats struct contains statistics on a DeltaQueue since it was created.
+ */
+struct DeltaQueueStats {
+    /// number of deltas pushed successfully
+    std::uint64_t pushed = 0u;
+
+    /// number of deltas that could not be pushed because the queue was full.
+    std::uint64_t overflowed = 0u;
+
+    /// number of deltas handed to the consumer after coalescing
+    std::uint64_t delivered = 0u;
+
+    /// number of deltas dropped because a newer delta for the same key was drained alongside it.
+    std::uint64_t coalesced = 0u;
+};
+
+/*!
+ * \brief The DeltaQueue class is a bounded, lock-free queue of deltas between a single producer
+ * thread and a single consumer thread. Each delta is a key and the latest value for that key. The
+ * producer pushes a delta for every update, and the consumer drains the queue once per frame.
+ * When draining, deltas with the same key are coalesced so the consumer only sees the newest
+ * value of each key, in the order that the keys were first pushed.
+ *
+ * The queue never blocks the producer. If it is full, the delta is dropped and the queue is
+ * flagged as overflowed. The producer is expected to still hold the full state, so the consumer
+ * should respond to an overflow by resyncing everything instead of relying on the deltas.
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class DeltaQueue {
+public:
+    /// constructor, the capacity is rounded up to a power of two.
+    explicit DeltaQueue(std::size_t capacity = 1024u) : mHead{0u}, mTail{0u}, mOverflowed{false} {
+        std::size_t size = 1u;
+        while (size < capacity) {
+            size <<= 1u;
+        }
+        mSlots.resize(size);
+        mMask = size - 1u;
+    }
+
+    /// max number of deltas that can be queued at once
+    std::size_t capacity() const noexcept { return mSlots.size(); }
+
+    /// true if no deltas are queued. Exact on the producer and consumer threads only.
+    bool empty() const noexcept {
+        return mHead.load(std::memory_order_acquire) == mTail.load(std::memory_order_acquire);
+    }
+
+    /*!
+     * \brief push adds a delta to the queue. Must only be called from the producer thread.
+     * \return true if the delta was queued, false if the queue was full.
+     */
+    bool push(const Key& key, const Value& value) {
+        auto head = mHead.load(std::memory_order_relaxed);
+        if (head - mTail.load(std::memory_order_acquire) >= mSlots.size()) {
+            mOverflowed.store(true, std::memory_order_release);
+            mOverflowCount.fetch_add(1u, std::memory_order_relaxed);
+            return false;
+        }
+        auto& slot = mSlots[head & mMask];
+        slot.first = key;
+        slot.second = value;
+        mHead.store(head + 1u, std::memory_order_release);
+        mPushCount.fetch_add(1u, std::memory_order_relaxed);
+        return true;
+    }
+
+    /*!
+     * \brief drain removes all queued deltas, coalesces them, and calls the function once for
+     * each key with its newest value. Must only be called from the consumer thread.
+     * \param function called as function(const Key&, const Value&)
+     * \return the number of deltas handed to the function
+     */
+    template <typename Function>
+    std::size_t drain(Function&& function) {
+        const auto start = mTail.load(std::memory_order_relaxed);
+        const auto head = mHead.load(std::memory_order_acquire);
+        if (start == head) {
+            return 0u;
+        }
+
+        // the scratch buffers are reused between drains, so a steady state drain doesn't allocate.
+        mCoalesced.clear();
+        mIndices.clear();
+        for (auto tail = start; tail != head; ++tail) {
+            auto& slot = mSlots[tail & mMask];
+            auto result = mIndices.find(slot.first);
+            if (result == mIndices.end()) {
+                mIndices.emplace(slot.first, mCoalesced.size());
+                mCoalesced.emplace_back(std::move(slot.first), std::move(slot.second));
+            } else {
+                mCoalesced[result->second].second = std::move(slot.second);
+            }
+        }
+        auto drained = std::uint64_t(head - start);
+        // release the slots before calling the function, so the producer can refill them.
+        mTail.store(head, std::memory_order_release);
+
+        for (const auto& delta : mCoalesced) {
+            function(delta.first, delta.second);
+        }
+        mDeliverCount.fetch_add(mCoalesced.size(), std::memory_order_relaxed);
+        mCoalesceCount.fetch_add(drained - mCoalesced.size(), std::memory_order_relaxed);
+        return mCoalesced.size();
+    }
+
+    /*!
+     * \brief takeOverflow returns true if any deltas were dropped since the last call, and clears
+     * the flag. Should be called by the consumer after draining.
+     */
+    bool takeOverflow() noexcept { return mOverflowed.exchange(false, std::memory_order_acq_rel); }
+
+    /// statistics on the queue. Safe to call from any thread.
+    DeltaQueueStats stats() const noexcept {
+        DeltaQueueStats stats;
+        stats.pushed = mPushCount.load(std::memory_order_relaxed);
+        stats.overflowed = mOverflowCount.load(std::memory_order_relaxed);
+        stats.delivered = mDeliverCount.load(std::memory_order_relaxed);
+        stats.coalesced = mCoalesceCount.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+private:
+    /// storage for the ring, its size is always a power of two.
+    std::vector<std::pair<Key, Value>> mSlots;
+
+    /// mask to convert a position to an index in mSlots.
+    std::size_t mMask;
+
+    /// position the producer writes next. Only written by the producer.
+    alignas(64) std::atomic<std::size_t> mHead;
+
+    /// position the consumer reads next. Only written by the consumer.
+    alignas(64) std::atomic<std::size_t> mTail;
+
+    /// true if a delta was dropped since the consumer last checked.
+    alignas(64) std::atomic<bool> mOverflowed;
+
+    /// number of deltas pushed
+    std::atomic<std::uint64_t> mPushCount{0u};
+
+    /// number of deltas dropped
+    std::atomic<std::uint64_t> mOverflowCount{0u};
+
+    /// number of deltas delivered
+    std::atomic<std::uint64_t> mDeliverCount{0u};
+
+    /// number of deltas coalesced
+    std::atomic<std::uint64_t> mCoalesceCount{0u};
+
+    /// coalesced deltas of the current drain, only used by the consumer.
+    std::vector<std::pair<Key, Value>> mCoalesced;
+
+    /// index of each key in mCoalesced, only used by the consumer.
+    std::unordered_map<Key, std::size_t, Hash> mIndices;
+};
+
+} // namespace cor
+
+#endif // COR_DELTAQUEUE_H
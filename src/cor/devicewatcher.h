@@ -0,0 +1,186 @@
+#ifndef COR_DEVICEWATCHER_H
+#define COR_DEVICEWATCHER_H
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif // __linux__
+
+namespace cor {
+
+/// device names that appeared and disappeared since they were last checked.
+struct DeviceChanges {
+    /// devices that appeared, or whose permissions changed so they may now be opened.
+    std::vector<std::string> added;
+
+    /// devices that disappeared. Handled before added, since a device can be replaced.
+    std::vector<std::string> removed;
+
+    /// true if changes were lost, so every device should be enumerated again.
+    bool rescan = false;
+
+    /// true if nothing changed
+    bool empty() const noexcept { return added.empty() && removed.empty() && !rescan; }
+};
+
+/// compares the devices that are known to the devices that exist now.
+inline DeviceChanges diffDevices(const std::unordered_set<std::string>& known,
+                                 const std::vector<std::string>& current) {
+    DeviceChanges changes;
+    std::unordered_set<std::string> currentSet(current.begin(), current.end());
+    for (const auto& name : current) {
+        if (known.count(name) == 0u) {
+            changes.added.push_back(name);
+        }
+    }
+    for (const auto& name : known) {
+        if (currentSet.count(name) == 0u) {
+            changes.removed.push_back(name);
+        }
+    }
+    return changes;
+}
+
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ *
+ * \brief The DeviceWatcher class reports devices as they appear in and disappear from a directory
+ * such as /dev, so that hotplugged serial ports can be found without enumerating and probing
+ * every port on a timer. Only the devices whose names start with one of the given prefixes are
+ * reported.
+ *
+ * On Linux it is backed by inotify. fd() is readable when changes are pending, so it can be
+ * watched by an event loop, and readChanges() never blocks. On other platforms, or if inotify
+ * cannot watch the directory, isValid() is false and the caller should fall back to enumerating.
+ */
+class DeviceWatcher {
+public:
+    /// constructor, starts watching the directory.
+    DeviceWatcher(std::string directory, std::vector<std::string> prefixes)
+        : mDirectory{std::move(directory)},
+          mPrefixes{std::move(prefixes)},
+          mFD{-1} {
+#ifdef __linux__
+        mFD = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (mFD >= 0
+            && inotify_add_watch(mFD,
+                                 mDirectory.c_str(),
+                                 IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ATTRIB)
+                   < 0) {
+            close(mFD);
+            mFD = -1;
+        }
+#endif // __linux__
+    }
+
+    /// destructor, stops watching.
+    ~DeviceWatcher() {
+#ifdef __linux__
+        if (mFD >= 0) {
+            close(mFD);
+        }
+#endif // __linux__
+    }
+
+    DeviceWatcher(const DeviceWatcher&) = delete;
+    DeviceWatcher& operator=(const DeviceWatcher&) = delete;
+
+    /// true if the directory is being watched
+    bool isValid() const noexcept { return mFD >= 0; }
+
+    /// file descriptor that is readable when changes are pending, -1 if not valid.
+    int fd() const noexcept { return mFD; }
+
+    /// directory that is watched
+    const std::string& directory() const noexcept { return mDirectory; }
+
+    /// true if a device name starts with one of the prefixes.
+    bool matches(std::string_view name) const {
+        return std::any_of(mPrefixes.begin(), mPrefixes.end(), [name](const std::string& prefix) {
+            return name.substr(0u, prefix.size()) == prefix;
+        });
+    }
+
+    /// lists the matching devices that are in the directory now, sorted by name.
+    std::vector<std::string> list() const {
+        std::vector<std::string> names;
+#ifdef __linux__
+        auto directory = opendir(mDirectory.c_str());
+        if (directory == nullptr) {
+            return names;
+        }
+        while (auto entry = readdir(directory)) {
+            if (matches(entry->d_name)) {
+                names.emplace_back(entry->d_name);
+            }
+        }
+        closedir(directory);
+        std::sort(names.begin(), names.end());
+#endif // __linux__
+        return names;
+    }
+
+    /// reads the changes that are pending, without blocking.
+    DeviceChanges readChanges() {
+        DeviceChanges changes;
+#ifdef __linux__
+        if (mFD < 0) {
+            return changes;
+        }
+        alignas(inotify_event) char buffer[4096];
+        ssize_t length;
+        while ((length = read(mFD, buffer, sizeof(buffer))) > 0) {
+            for (auto i = 0; i < length;) {
+                const auto* event = reinterpret_cast<const inotify_event*>(buffer + i);
+                i += int(sizeof(inotify_event) + event->len);
+                if ((event->mask & IN_Q_OVERFLOW) != 0u) {
+                    changes.rescan = true;
+                    continue;
+                }
+                if (event->len == 0u || !matches(event->name)) {
+                    continue;
+                }
+                std::string name(event->name);
+                auto added = std::find(changes.added.begin(), changes.added.end(), name);
+                if ((event->mask & (IN_DELETE | IN_MOVED_FROM)) != 0u) {
+                    if (added != changes.added.end()) {
+                        changes.added.erase(added);
+                    }
+                    if (std::find(changes.removed.begin(), changes.removed.end(), name)
+                        == changes.removed.end()) {
+                        changes.removed.push_back(std::move(name));
+                    }
+                } else if (added == changes.added.end()) {
+                    changes.added.push_back(std::move(name));
+                }
+            }
+        }
+#endif // __linux__
+        return changes;
+    }
+
+private:
+    /// directory that is watched
+    std::string mDirectory;
+
+    /// prefixes of the names of the devices that are reported
+    std::vector<std::string> mPrefixes;
+
+    /// inotify file descriptor, -1 if not valid.
+    int mFD;
+};
+
+} // namespace cor
+
+#endif // COR_DEVICEWATCHER_H
@@ -0,0 +1,248 @@
+#ifndef COR_DISCOVERYSCHEDULER_H
+#define COR_DISCOVERYSCHEDULER_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace cor {
+
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ *
+ * \brief The DiscoveryScheduler class decides when discovery should probe devices that were saved
+ * from a previous session but have not been found yet. It is shared between the discovery objects
+ * of each protocol, which each probe their devices from their own timer.
+ *
+ * Each device is retried with exponential backoff, so a device that was unplugged months ago is
+ * probed a handful of times per hour instead of on every discovery tick. The backoff has jitter,
+ * so devices saved at the same time do not get probed in the same tick forever. A global cap
+ * limits how many probes can be in flight across all protocols, and when more devices are due
+ * than the cap allows, the devices that were seen most recently are probed first. A probe counts
+ * against the cap until the device is removed or the probe timeout passes.
+ *
+ * Devices found by another path, such as UPnP, should be removed, which cancels their probes.
+ * Devices that are heard from but not yet found can be marked as seen, which resets their backoff.
+ * The last time each device was seen is kept after it is removed, so a device that is lost again
+ * can be tracked with lastSeen().
+ */
+template <typename Key, typename Hash = std::hash<Key>>
+class DiscoveryScheduler {
+public:
+    /*!
+     * \brief DiscoveryScheduler constructor, all times are in msec.
+     * \param baseInterval delay before the second probe of a device, doubled for each probe after.
+     * \param maxInterval longest delay between two probes of a device.
+     * \param maxInFlight max number of probes in flight across all groups.
+     * \param probeTimeout how long a probe counts as in flight.
+     * \param seed seed for the jitter.
+     */
+    DiscoveryScheduler(std::int64_t baseInterval,
+                       std::int64_t maxInterval,
+                       std::size_t maxInFlight,
+                       std::int64_t probeTimeout,
+                       std::uint32_t seed = std::random_device{}())
+        : mBaseInterval{baseInterval},
+          mMaxInterval{maxInterval},
+          mMaxInFlight{maxInFlight},
+          mProbeTimeout{probeTimeout},
+          mRandom{seed} {}
+
+    /// fraction of the backoff delay that is randomized in both directions.
+    static constexpr double kJitter = 0.2;
+
+    /// monotonic time in msec, shared by all discovery objects so that their times compare.
+    static std::int64_t steadyNow() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    /// number of devices tracked in a group
+    std::size_t size(int group) const {
+        auto result = mGroups.find(group);
+        if (result == mGroups.end()) {
+            return 0u;
+        }
+        return result->second.size();
+    }
+
+    /*!
+     * \brief track starts probing a device, if it is not already tracked. New devices are due
+     * immediately.
+     * \param group group of the device, such as its protocol
+     * \param key unique key of the device within its group
+     * \param lastSeen last time the device was seen, or 0 if unknown. Higher is probed first.
+     * \param now current time
+     */
+    void track(int group, const Key& key, std::int64_t lastSeen, std::int64_t now) {
+        auto& devices = mGroups[group];
+        if (devices.find(key) == devices.end()) {
+            devices.emplace(key, Entry{now, 0, lastSeen, 0u});
+        }
+    }
+
+    /// last time a device was seen, even if it is no longer tracked, or 0 if it was never seen.
+    std::int64_t lastSeen(int group, const Key& key) const {
+        auto groupResult = mLastSeen.find(group);
+        if (groupResult == mLastSeen.end()) {
+            return 0;
+        }
+        auto result = groupResult->second.find(key);
+        if (result == groupResult->second.end()) {
+            return 0;
+        }
+        return result->second;
+    }
+
+    /// the device was heard from, so its backoff is reset and it is due immediately.
+    void seen(int group, const Key& key, std::int64_t now) {
+        mLastSeen[group][key] = now;
+        auto& devices = mGroups[group];
+        auto result = devices.find(key);
+        if (result == devices.end()) {
+            devices.emplace(key, Entry{now, 0, now, 0u});
+        } else {
+            result->second.nextProbe = now;
+            result->second.inFlightUntil = 0;
+            result->second.lastSeen = now;
+            result->second.attempts = 0u;
+        }
+    }
+
+    /// stops probing a device that was found, and records that it was seen.
+    void found(int group, const Key& key, std::int64_t now) {
+        mLastSeen[group][key] = now;
+        remove(group, key);
+    }
+
+    /// stops probing a device, used when it is found or deleted. Returns true if it was tracked.
+    bool remove(int group, const Key& key) {
+        auto result = mGroups.find(group);
+        if (result == mGroups.end()) {
+            return false;
+        }
+        return result->second.erase(key) > 0u;
+    }
+
+    /// number of probes in flight across all groups
+    std::size_t inFlight(std::int64_t now) const {
+        std::size_t count = 0u;
+        for (const auto& group : mGroups) {
+            for (const auto& device : group.second) {
+                if (device.second.inFlightUntil > now) {
+                    ++count;
+                }
+            }
+        }
+        return count;
+    }
+
+    /*!
+     * \brief takeDue returns the devices of a group that should be probed now, and schedules their
+     * next probe. No more devices are returned than the global cap allows.
+     * \param group group to get devices for
+     * \param now current time
+     * \return the devices to probe, most recently seen first.
+     */
+    std::vector<Key> takeDue(int group, std::int64_t now) {
+        std::vector<Key> keys;
+        auto inFlightCount = inFlight(now);
+        if (inFlightCount >= mMaxInFlight) {
+            return keys;
+        }
+        auto result = mGroups.find(group);
+        if (result == mGroups.end()) {
+            return keys;
+        }
+        auto& devices = result->second;
+
+        std::vector<typename Devices::iterator> due;
+        for (auto it = devices.begin(); it != devices.end(); ++it) {
+            if (it->second.nextProbe <= now && it->second.inFlightUntil <= now) {
+                due.push_back(it);
+            }
+        }
+        auto count = std::min(due.size(), mMaxInFlight - inFlightCount);
+        std::partial_sort(due.begin(),
+                          due.begin() + std::ptrdiff_t(count),
+                          due.end(),
+                          [](const auto& a, const auto& b) {
+                              if (a->second.lastSeen != b->second.lastSeen) {
+                                  return a->second.lastSeen > b->second.lastSeen;
+                              }
+                              return a->second.nextProbe < b->second.nextProbe;
+                          });
+
+        keys.reserve(count);
+        for (std::size_t i = 0u; i < count; ++i) {
+            auto& entry = due[i]->second;
+            entry.inFlightUntil = now + mProbeTimeout;
+            entry.nextProbe = now + backoff(entry.attempts);
+            ++entry.attempts;
+            keys.push_back(due[i]->first);
+        }
+        return keys;
+    }
+
+private:
+    /// the probe state of a device
+    struct Entry {
+        /// earliest time of the next probe
+        std::int64_t nextProbe;
+
+        /// time the current probe stops counting as in flight, or 0 if none is in flight.
+        std::int64_t inFlightUntil;
+
+        /// last time the device was seen, or 0 if unknown
+        std::int64_t lastSeen;
+
+        /// number of probes since the device was last seen
+        std::uint32_t attempts;
+    };
+
+    /// devices of a group, keyed by device
+    using Devices = std::unordered_map<Key, Entry, Hash>;
+
+    /// computes the delay after a probe, with jitter.
+    std::int64_t backoff(std::uint32_t attempts) {
+        auto delay = mBaseInterval;
+        for (std::uint32_t i = 0u; i < attempts && delay < mMaxInterval; ++i) {
+            delay *= 2;
+        }
+        delay = std::min(delay, mMaxInterval);
+        std::uniform_real_distribution<double> jitter(1.0 - kJitter, 1.0 + kJitter);
+        return std::int64_t(double(delay) * jitter(mRandom));
+    }
+
+    /// delay before the second probe of a device
+    std::int64_t mBaseInterval;
+
+    /// longest delay between two probes of a device
+    std::int64_t mMaxInterval;
+
+    /// max number of probes in flight across all groups
+    std::size_t mMaxInFlight;
+
+    /// how long a probe counts as in flight
+    std::int64_t mProbeTimeout;
+
+    /// random number generator for jitter
+    std::minstd_rand mRandom;
+
+    /// devices of each group
+    std::unordered_map<int, Devices> mGroups;
+
+    /// last time each device of each group was seen, kept after the device is removed
+    std::unordered_map<int, std::unordered_map<Key, std::int64_t, Hash>> mLastSeen;
+};
+
+} // namespace cor
+
+#endif // COR_DISCOVERYSCHEDULER_H
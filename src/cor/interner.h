@@ -0,0 +1,96 @@
+#ifndef COR_INTERNER_H
+#define COR_INTERNER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace cor {
+
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ *
+ * \brief The Interner class deduplicates immutable values by their contents. Interning a value
+ * returns a shared handle to it, and interning an equal value while the first handle is alive
+ * returns the same handle. Copying a handle is a reference count increment instead of a deep copy,
+ * and two handles from the same interner are equal if and only if they point to the same value.
+ *
+ * The interner only holds weak references, so a value is freed once the last handle to it is
+ * destroyed. Expired entries are swept when the table has grown to twice its size at the previous
+ * sweep. Interning is thread safe.
+ */
+template <typename T, typename Hash = std::hash<T>, typename Equal = std::equal_to<T>>
+class Interner {
+public:
+    /// constructor
+    Interner() : mSweepSize{16u} {}
+
+    /// returns the shared handle for a value, creating it if no equal value is alive.
+    std::shared_ptr<const T> intern(T value) {
+        auto hash = Hash{}(value);
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto range = mValues.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it) {
+            auto existing = it->second.lock();
+            if (existing && Equal{}(*existing, value)) {
+                return existing;
+            }
+        }
+
+        auto handle = std::make_shared<const T>(std::move(value));
+        mValues.emplace(hash, handle);
+        if (mValues.size() >= mSweepSize) {
+            sweep();
+        }
+        return handle;
+    }
+
+    /// number of entries in the table, including expired entries that have not been swept.
+    std::size_t size() const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mValues.size();
+    }
+
+    /// number of values that are alive.
+    std::size_t liveCount() const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        std::size_t count = 0u;
+        for (const auto& value : mValues) {
+            if (!value.second.expired()) {
+                ++count;
+            }
+        }
+        return count;
+    }
+
+private:
+    /// removes expired entries, and sets the size of the next sweep.
+    void sweep() {
+        for (auto it = mValues.begin(); it != mValues.end();) {
+            if (it->second.expired()) {
+                it = mValues.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        mSweepSize = std::max<std::size_t>(16u, mValues.size() * 2u);
+    }
+
+    /// guards mValues and mSweepSize
+    mutable std::mutex mMutex;
+
+    /// size of the table that triggers the next sweep
+    std::size_t mSweepSize;
+
+    /// the interned values, keyed by their hash
+    std::unordered_multimap<std::size_t, std::weak_ptr<const T>> mValues;
+};
+
+} // namespace cor
+
+#endif // COR_INTERNER_H
@@ -18,12 +18,62 @@
 
 namespace cor {
 
+std::int64_t lightBrightness(const cor::LightState& state) {
+    if (state.routine() <= cor::ERoutineSingleColorEnd) {
+        return std::int64_t(state.color().valueF() * 100.0);
+    }
+    return state.paletteBrightness();
+}
+
+void LightListAggregate::apply(const cor::Light& light, int sign) {
+    const auto& state = light.state();
+    if (state.isOn()) {
+        onCount += sign;
+    }
+    brightnessSum += sign * lightBrightness(state);
+    protocolCounts[std::size_t(light.protocol())] += sign;
+    if (light.isReachable()) {
+        reachableCount += sign;
+        speedSum += sign * state.speed();
+        if (int(state.routine()) <= int(cor::ERoutineSingleColorEnd)
+            || light.protocol() == EProtocolType::hue) {
+            redSum += sign * state.color().red();
+            greenSum += sign * state.color().green();
+            blueSum += sign * state.color().blue();
+            colorCount += sign;
+        } else {
+            for (const auto& color : state.palette().colors()) {
+                redSum += sign * color.red();
+                greenSum += sign * color.green();
+                blueSum += sign * color.blue();
+                colorCount += sign;
+            }
+        }
+    }
+}
+
 LightList::LightList(QObject* parent) : QObject(parent) {}
 
+void LightList::changeLightState(std::size_t index, const cor::LightState& state) {
+    auto& light = mLights[index];
+    mAggregate.apply(light, -1);
+    light.state(state);
+    mAggregate.apply(light, 1);
+}
+
+void LightList::rebuildIndices() {
+    mLightIndices.clear();
+    mLightIndices.reserve(mLights.size());
+    for (auto i = 0u; i < mLights.size(); ++i) {
+        mLightIndices.emplace(mLights[i].uniqueID(), i);
+    }
+}
+
 
 void LightList::updateState(const cor::LightState& newState) {
     std::uint32_t hueCount = 0u;
-    for (auto&& light : mLights) {
+    for (auto i = 0u; i < mLights.size(); ++i) {
+        const auto& light = mLights[i];
         auto stateCopy = newState;
 
         if (light.protocol() == EProtocolType::nanoleaf) {
@@ -63,47 +113,25 @@ void LightList::updateState(const cor::LightState& newState) {
             }
         }
 
-        light.state(stateCopy);
+        changeLightState(i, stateCopy);
     }
     emit dataUpdate();
 }
 
 QColor LightList::mainColor() {
-    int r = 0;
-    int g = 0;
-    int b = 0;
-    int deviceCount = 0;
-    for (const auto& light : mLights) {
-        const auto& state = light.state();
-        if (light.isReachable()) {
-            if (int(state.routine()) <= int(cor::ERoutineSingleColorEnd)
-                || light.protocol() == EProtocolType::hue) {
-                r = r + state.color().red();
-                g = g + state.color().green();
-                b = b + state.color().blue();
-                deviceCount++;
-            } else {
-                for (const auto& color : state.palette().colors()) {
-                    r = r + color.red();
-                    g = g + color.green();
-                    b = b + color.blue();
-                    deviceCount++;
-                }
-            }
-        }
-    }
-    if (deviceCount > 0) {
-        r = r / deviceCount;
-        g = g / deviceCount;
-        b = b / deviceCount;
+    if (mAggregate.colorCount > 0) {
+        return QColor(int(mAggregate.redSum / mAggregate.colorCount),
+                      int(mAggregate.greenSum / mAggregate.colorCount),
+                      int(mAggregate.blueSum / mAggregate.colorCount));
     }
-    return QColor(r, g, b);
+    return QColor(0, 0, 0);
 }
 
 
 void LightList::updateBrightness(std::uint32_t brightness) {
     std::uint32_t huePaletteCount = 0u;
-    for (auto&& light : mLights) {
+    for (auto i = 0u; i < mLights.size(); ++i) {
+        const auto& light = mLights[i];
         auto state = light.state();
         if (state.routine() <= cor::ERoutineSingleColorEnd) {
             QColor color;
@@ -124,30 +152,22 @@ void LightList::updateBrightness(std::uint32_t brightness) {
             }
         }
         state.isOn(bool(brightness));
-        light.state(state);
+        changeLightState(i, state);
     }
     emit dataUpdate();
 }
 
 std::uint32_t LightList::brightness() {
-    std::uint32_t brightnessSum = 0u;
-    for (const auto& light : mLights) {
-        const auto& state = light.state();
-        if (state.routine() <= cor::ERoutineSingleColorEnd) {
-            brightnessSum += std::uint32_t(state.color().valueF() * 100.0);
-        } else {
-            brightnessSum += state.paletteBrightness();
-        }
+    if (empty() || mAggregate.brightnessSum <= 0) {
+        return 0u;
     }
-    if (!empty()) {
-        brightnessSum = brightnessSum / mLights.size();
-    }
-    return brightnessSum;
+    return std::uint32_t(mAggregate.brightnessSum / std::int64_t(mLights.size()));
 }
 
 
 void LightList::updateSpeed(int speed) {
-    for (auto&& light : mLights) {
+    for (auto i = 0u; i < mLights.size(); ++i) {
+        const auto& light = mLights[i];
         int finalSpeed = 0;
         if (light.protocol() == EProtocolType::arduCor) {
             finalSpeed = speed;
@@ -156,26 +176,16 @@ void LightList::updateSpeed(int speed) {
         }
         auto state = light.state();
         state.speed(finalSpeed);
-        light.state(state);
+        changeLightState(i, state);
     }
     emit dataUpdate();
 }
 
 int LightList::speed() {
-    int speed = 0;
-    int deviceCount = 0;
-    for (const auto& light : mLights) {
-        const auto& state = light.state();
-        if (light.isReachable()) {
-            speed = speed + state.speed();
-            deviceCount++;
-        }
-    }
-    if (deviceCount > 0) {
-        speed = speed / deviceCount;
+    if (mAggregate.reachableCount > 0) {
+        return int(mAggregate.speedSum / std::int64_t(mAggregate.reachableCount));
     }
-
-    return speed;
+    return 0;
 }
 
 std::pair<ERoutine, int> LightList::routineAndParam() {
@@ -195,19 +205,14 @@ std::pair<ERoutine, int> LightList::routineAndParam() {
 
 bool LightList::isOn() {
     // if any is on, return true
-    for (const auto& light : mLights) {
-        if (light.state().isOn()) {
-            return true;
-        }
-    }
-    return false;
+    return mAggregate.onCount > 0;
 }
 
 void LightList::isOn(bool on) {
-    for (auto&& light : mLights) {
-        auto state = light.state();
+    for (auto i = 0u; i < mLights.size(); ++i) {
+        auto state = mLights[i].state();
         state.isOn(on);
-        light.state(state);
+        changeLightState(i, state);
     }
     emit dataUpdate();
 }
@@ -218,7 +223,8 @@ void LightList::updateColorScheme(std::vector<QColor> colors) {
     // however, sending tons of custom color updates to arducor ends up spamming the lights comm
     // channels and only seems to reliably work on serial communication. So for now, I'm falling
     // back to treating arducor during color schemes as single color lights.
-    for (auto&& light : mLights) {
+    for (auto index = 0u; index < mLights.size(); ++index) {
+        const auto& light = mLights[index];
         auto state = light.state();
         if (light.protocol() == EProtocolType::hue || light.protocol() == EProtocolType::arduCor) {
             state.color(colors[i]);
@@ -240,7 +246,7 @@ void LightList::updateColorScheme(std::vector<QColor> colors) {
             }
             state.palette(state.customPalette());
         }
-        light.state(state);
+        changeLightState(index, state);
     }
     emit dataUpdate();
 }
@@ -328,38 +334,57 @@ std::vector<QColor> LightList::multiColorScheme() {
 bool LightList::clearLights() {
     if (!mLights.empty()) {
         mLights.clear();
+        mLightIndices.clear();
+        mAggregate = LightListAggregate();
+        emit lightCountChanged();
     }
     return true;
 }
 
 bool LightList::removeLight(const cor::Light& removingLight) {
-    for (auto i = 0u; i < mLights.size(); ++i) {
-        if (removingLight.uniqueID() == mLights[i].uniqueID()) {
-            auto it = mLights.begin() + i;
-            if (it != mLights.end()) {
-                mLights.erase(it);
-                emit lightCountChanged();
-                return true;
-            }
-        }
+    if (removeLightSet({removingLight.uniqueID()})) {
+        emit lightCountChanged();
+        return true;
     }
     return false;
 }
 
+bool LightList::removeLightSet(const std::unordered_set<cor::LightID>& lightIDs) {
+    auto iterator = std::remove_if(mLights.begin(),
+                                   mLights.end(),
+                                   [this, &lightIDs](const cor::Light& light) {
+                                       if (lightIDs.find(light.uniqueID()) != lightIDs.end()) {
+                                           mAggregate.apply(light, -1);
+                                           return true;
+                                       }
+                                       return false;
+                                   });
+    if (iterator == mLights.end()) {
+        return false;
+    }
+    mLights.erase(iterator, mLights.end());
+    rebuildIndices();
+    return true;
+}
+
 
 
 
 bool LightList::addLight(cor::Light light) {
     if (light.isReachable()) {
-        for (auto i = 0u; i < mLights.size(); ++i) {
+        auto result = mLightIndices.find(light.uniqueID());
+        if (result != mLightIndices.end()) {
             // light already exists, update it
-            if (mLights[i].uniqueID() == light.uniqueID()) {
-                mLights[i] = light;
-                emit lightCountChanged();
-                return true;
-            }
+            auto& storedLight = mLights[result->second];
+            mAggregate.apply(storedLight, -1);
+            storedLight = light;
+            mAggregate.apply(storedLight, 1);
+            emit lightCountChanged();
+            return true;
         }
         // device doesn't exist, add it to the device
+        mLightIndices.emplace(light.uniqueID(), mLights.size());
+        mAggregate.apply(light, 1);
         mLights.push_back(light);
         emit lightCountChanged();
     } else {
@@ -390,73 +415,59 @@ bool LightList::addEffect(const cor::Light& light) {
 }
 
 bool LightList::removeLights(const std::vector<cor::Light>& list) {
+    std::unordered_set<cor::LightID> lightIDs;
     for (const auto& device : list) {
-        removeLight(device);
+        lightIDs.insert(device.uniqueID());
+    }
+    if (removeLightSet(lightIDs)) {
+        emit lightCountChanged();
     }
     return true;
 }
 
 bool LightList::removeByIDs(const std::vector<cor::LightID>& lightIDs) {
-    std::vector<cor::Light> lightsToRemove;
-    for (const auto& lightID : lightIDs) {
-        for (const auto& storedLight : mLights) {
-            if (lightID == storedLight.uniqueID()) {
-                lightsToRemove.push_back(storedLight);
-            }
-        }
-    }
-    if (!lightsToRemove.empty()) {
-        for (const auto& lightToRemove : lightsToRemove) {
-            auto result = std::find(mLights.begin(), mLights.end(), lightToRemove);
-            if (result != mLights.end()) {
-                mLights.erase(result);
-            }
-        }
+    if (removeLightSet(std::unordered_set<cor::LightID>(lightIDs.begin(), lightIDs.end()))) {
+        emit lightCountChanged();
         return true;
     }
     return false;
 }
 
 int LightList::removeLightOfType(EProtocolType type) {
-    std::vector<cor::Light> removeList;
-    for (const auto& light : mLights) {
-        if (type == light.protocol()) {
-            removeList.push_back(light);
+    if (hasLightWithProtocol(type)) {
+        std::unordered_set<cor::LightID> removeList;
+        for (const auto& light : mLights) {
+            if (type == light.protocol()) {
+                removeList.insert(light.uniqueID());
+            }
         }
-    }
-    for (auto&& device : removeList) {
-        removeLight(device);
+        removeLightSet(removeList);
+        emit lightCountChanged();
     }
     return int(mLights.size());
 }
 
 bool LightList::doesLightExist(const cor::LightID& uniqueID) {
-    for (const auto& storedLight : mLights) {
-        if (uniqueID == storedLight.uniqueID()) {
-            return true;
-        }
+    return mLightIndices.find(uniqueID) != mLightIndices.end();
+}
+
+
+std::pair<cor::Light, bool> LightList::lightFromID(const cor::LightID& uniqueID) const {
+    auto result = mLightIndices.find(uniqueID);
+    if (result == mLightIndices.end()) {
+        return std::make_pair(cor::Light{}, false);
     }
-    return false;
+    return std::make_pair(mLights[result->second], true);
 }
 
 
 bool LightList::doesLightExist(const cor::Light& device) {
-    for (const auto& storedDevice : mLights) {
-        if (device.uniqueID() == storedDevice.uniqueID()) {
-            return true;
-        }
-    }
-    return false;
+    return doesLightExist(device.uniqueID());
 }
 
 
 bool LightList::hasLightWithProtocol(EProtocolType protocol) const noexcept {
-    for (const auto& light : mLights) {
-        if (light.protocol() == protocol) {
-            return true;
-        }
-    }
-    return false;
+    return mAggregate.protocolCounts[std::size_t(protocol)] > 0u;
 }
 
 EProtocolType LightList::mostFeaturedProtocolType() const noexcept {
@@ -470,22 +481,12 @@ EProtocolType LightList::mostFeaturedProtocolType() const noexcept {
 }
 
 bool LightList::onlyLightsWithProtocol(EProtocolType protocol) const noexcept {
-    for (const auto& light : mLights) {
-        if (light.protocol() != protocol) {
-            return false;
-        }
-    }
-    return true;
+    return mAggregate.protocolCounts[std::size_t(protocol)] == mLights.size();
 }
 
 bool LightList::supportsRoutines() {
-    for (const auto& light : mLights) {
-        if (light.protocol() == EProtocolType::arduCor
-            || light.protocol() == EProtocolType::nanoleaf) {
-            return true;
-        }
-    }
-    return false;
+    return hasLightWithProtocol(EProtocolType::arduCor)
+           || hasLightWithProtocol(EProtocolType::nanoleaf);
 }
 
 cor::Group LightList::findCurrentGroup(const std::vector<cor::Group>& groups) {
@@ -493,11 +494,9 @@ cor::Group LightList::findCurrentGroup(const std::vector<cor::Group>& groups) {
     std::vector<std::uint32_t> lightCount(groups.size(), 0);
     auto index = 0u;
     for (const auto& collection : groups) {
-        for (const auto& device : mLights) {
-            for (const auto& collectionID : collection.lights()) {
-                if (collectionID == device.uniqueID()) {
-                    ++lightCount[index];
-                }
+        for (const auto& collectionID : collection.lights()) {
+            if (doesLightExist(collectionID)) {
+                ++lightCount[index];
             }
         }
         ++index;
@@ -556,51 +555,24 @@ cor::Group LightList::findCurrentGroup(const std::vector<cor::Group>& groups) {
 std::uint32_t LightList::countNumberOfLights(const std::vector<QString>& lightIDs) {
     std::uint32_t selectedCount = 0u;
     for (const auto& light : lightIDs) {
-        for (const auto& storedLight : mLights) {
-            if (storedLight.uniqueID() == light) {
-                selectedCount++;
-            }
+        if (doesLightExist(cor::LightID(light))) {
+            selectedCount++;
         }
     }
     return selectedCount;
 }
 
-cor::UUID LightList::findCurrentMood(const cor::Dictionary<cor::Mood>& moods) {
-    for (const auto& mood : moods.items()) {
-        if (mLights == mood.lights()) {
-            return mood.uniqueID();
-        }
-    }
-    return cor::UUID::invalidID();
+cor::UUID LightList::findCurrentMood(const cor::MoodPlanIndex& moodPlans) {
+    return moodPlans.findMood(mLights);
 }
 
 
 std::size_t LightList::lightCount() {
-    std::size_t count = 0u;
-    for (const auto& light : mLights) {
-        if (light.protocol() == EProtocolType::hue) {
-            count += 1;
-        } else if (light.protocol() == EProtocolType::arduCor) {
-            /// TODO: these are all assumptions
-            //            if (light.hardwareType == ELightHardwareType::cube) {
-            //                count += 64;
-            //            } else if (light.hardwareType == ELightHardwareType::lightStrip) {
-            //                count += 32;
-            //            } else if (light.hardwareType == ELightHardwareType::ring) {
-            //                count += 16;
-            //            } else if (light.hardwareType == ELightHardwareType::rectangle) {
-            //                count += 32;
-            //            } else if (light.hardwareType == ELightHardwareType::singleLED) {
-            //                count += 1;
-            //            }
-            // arducor don't update well when we're changing a bunch of them at once, for now, treat
-            // like a single light
-            count += 1;
-        } else if (light.protocol() == EProtocolType::nanoleaf) {
-            count += 6;
-        }
-    }
-    return count;
+    const auto& counts = mAggregate.protocolCounts;
+    // arducor don't update well when we're changing a bunch of them at once, for now, treat
+    // like a single light. nanoleafs are treated as six lights.
+    return counts[std::size_t(EProtocolType::hue)] + counts[std::size_t(EProtocolType::arduCor)]
+           + counts[std::size_t(EProtocolType::nanoleaf)] * 6;
 }
 
 
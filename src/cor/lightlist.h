@@ -3,17 +3,63 @@
 #define DATALAYER_H
 
 #include <QColor>
-#include <QWidget>
+#include <QObject>
+#include <array>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "appsettings.h"
 #include "comm/commhue.h"
 #include "cor/objects/mood.h"
+#include "cor/objects/moodplan.h"
 #include "cor/objects/palette.h"
 #include "cor/protocols.h"
 #include "data/palettedata.h"
 
 namespace cor {
 
+/// brightness of a light's state, as used by LightList::brightness()
+std::int64_t lightBrightness(const cor::LightState& state);
+
+/*!
+ * \brief The LightListAggregate struct stores running totals of the lights in a LightList. Each
+ * light contributes to the totals when its added or its state changes, and its contribution is
+ * removed when its removed or before its state changes. This allows the LightList to answer
+ * questions like "are any lights on?" or "what is the average brightness?" without scanning every
+ * light.
+ */
+struct LightListAggregate {
+    /// number of lights that are on
+    std::uint32_t onCount = 0u;
+
+    /// number of lights that are reachable
+    std::uint32_t reachableCount = 0u;
+
+    /// sum of the brightness of all lights
+    std::int64_t brightnessSum = 0;
+
+    /// sum of the red values used for the main color of reachable lights
+    std::int64_t redSum = 0;
+
+    /// sum of the green values used for the main color of reachable lights
+    std::int64_t greenSum = 0;
+
+    /// sum of the blue values used for the main color of reachable lights
+    std::int64_t blueSum = 0;
+
+    /// number of colors contributing to the color sums
+    std::int64_t colorCount = 0;
+
+    /// sum of the speed of reachable lights
+    std::int64_t speedSum = 0;
+
+    /// number of lights of each EProtocolType
+    std::array<std::uint32_t, std::size_t(EProtocolType::MAX)> protocolCounts{};
+
+    /// adds (sign = 1) or removes (sign = -1) a light's contribution to the totals.
+    void apply(const cor::Light& light, int sign);
+};
+
 /*!
  * \copyright
  * Copyright (C) 2015 - 2020.
@@ -38,6 +84,9 @@ public:
     /// true if no lights are stoerd, false if any lights are stored
     bool empty() const noexcept { return lights().empty(); }
 
+    /// getter for the running totals of the lights.
+    const LightListAggregate& aggregate() const noexcept { return mAggregate; }
+
     /*!
      * \brief mainColor getter for mainColor, used for single color routines.
      * \return the mainColor, used for single color routines.
@@ -110,6 +159,9 @@ public:
      */
     bool doesLightExist(const cor::LightID& uniqueID);
 
+    /// finds a light by its unique ID. The bool in the pair is whether or not the light was found.
+    std::pair<cor::Light, bool> lightFromID(const cor::LightID& uniqueID) const;
+
     /// returns a count of how many lights from the input vector are contained in the light list.
     std::uint32_t countNumberOfLights(const std::vector<QString>& lightIDs);
 
@@ -196,8 +248,9 @@ public:
     /// compute the best candidate for a collection based on the current lights.
     cor::Group findCurrentGroup(const std::vector<cor::Group>& collections);
 
-    /// compute the best candidate for a mood based on the current lights
-    cor::UUID findCurrentMood(const cor::Dictionary<cor::Mood>& moods);
+    /// finds the mood that exactly matches the current lights and their states, using the hashes
+    /// of compiled mood plans. Returns an invalid ID if no mood matches.
+    cor::UUID findCurrentMood(const cor::MoodPlanIndex& moodPlans);
 
     /*!
      * \brief lightCount getter for count of LEDs associated with a single light. IE, a light cube
@@ -225,13 +278,26 @@ signals:
     void lightCountChanged();
 
 private:
+    /// changes the state of the light at the given index, keeping the aggregate in sync.
+    void changeLightState(std::size_t index, const cor::LightState& state);
+
+    /// removes all lights whose IDs are in the given set, returns true if any are removed.
+    bool removeLightSet(const std::unordered_set<cor::LightID>& lightIDs);
+
+    /// rebuilds mLightIndices, used after lights are removed from mLights.
+    void rebuildIndices();
+
     /*!
-     * \brief mLights list of current lights in data layer
-     * \todo complete support of multiple lights in datalayer. currently this is a vector of
-     *       size 1 in preparation.
+     * \brief mLights list of current lights in data layer, in the order they were added.
      */
     std::vector<cor::Light> mLights;
 
+    /// index of each light in mLights, keyed by the light's unique ID.
+    std::unordered_map<cor::LightID, std::size_t> mLightIndices;
+
+    /// running totals for all lights in mLights.
+    LightListAggregate mAggregate;
+
     /// class used to verify if palettes are reserved or not.
     PaletteData mPalettes;
 };
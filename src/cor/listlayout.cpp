@@ -1,9 +1,9 @@
 #include "listlayout.h"
 
 #include <QDebug>
+#include <algorithm>
 
 #include "cor/widgets/listitemwidget.h"
-#include "listlightwidget.h"
 #include "utils/exception.h"
 
 namespace cor {
@@ -107,26 +107,6 @@ QSize ListLayout::widgetSize(QSize parentSize) {
 
 
 
-void ListLayout::sortDeviceWidgets() {
-    std::sort(mWidgets.begin(), mWidgets.end(), [](cor::ListItemWidget* a, cor::ListItemWidget* b) {
-        auto aDeviceWidget = qobject_cast<ListLightWidget*>(a);
-        Q_ASSERT(aDeviceWidget);
-        auto bDeviceWidget = qobject_cast<ListLightWidget*>(b);
-        Q_ASSERT(bDeviceWidget);
-        if (!aDeviceWidget->isReachable() && bDeviceWidget->isReachable()) {
-            return false;
-        } else if (aDeviceWidget->isReachable() && !bDeviceWidget->isReachable()) {
-            return true;
-        } else {
-            // Hue is hidden from display, hide it in comparison here too.
-            auto nameA = aDeviceWidget->name();
-            auto nameB = bDeviceWidget->name();
-            return (nameA < nameB);
-        }
-    });
-}
-
-
 QSize ListLayout::overallSize() {
     int height = 0;
     auto i = int(mWidgets.size());
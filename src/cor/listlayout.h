@@ -80,10 +80,6 @@ public:
     /// getter for widget size
     QSize widgetSize(QSize parentSize);
 
-    /// sort widgets IFF they are device widgets
-    /// TODO: this is totally an antipattern...
-    void sortDeviceWidgets();
-
     /// number of widgets in the scroll area.
     std::size_t count() { return mWidgetDictionary.size(); }
 
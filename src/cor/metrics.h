@@ -0,0 +1,256 @@
+#ifndef COR_METRICS_H
+#define COR_METRICS_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+
+namespace cor {
+
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ *
+ * \brief The MetricCounter class is a counter that can be incremented from any thread without
+ * locking.
+ */
+class MetricCounter {
+public:
+    /// adds to the counter
+    void add(std::uint64_t value = 1u) noexcept {
+        mValue.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    /// current value of the counter
+    std::uint64_t value() const noexcept { return mValue.load(std::memory_order_relaxed); }
+
+    /// resets the counter to 0
+    void reset() noexcept { mValue.store(0u, std::memory_order_relaxed); }
+
+private:
+    /// value of the counter
+    std::atomic<std::uint64_t> mValue{0u};
+};
+
+/*!
+ * \brief The MetricHistogram class counts values in fixed buckets. The buckets grow roughly
+ * exponentially, so the same histogram works for msec latencies and for small counts like retries.
+ * Recording a value never locks or allocates.
+ */
+class MetricHistogram {
+public:
+    /// inclusive upper bound of each bucket. Values above the last bound go in an overflow bucket.
+    static constexpr std::array<std::uint64_t, 13> kBucketBounds =
+        {{1u, 2u, 5u, 10u, 25u, 50u, 100u, 250u, 500u, 1000u, 2500u, 5000u, 10000u}};
+
+    /// number of buckets, including the overflow bucket.
+    static constexpr std::size_t kBucketCount = kBucketBounds.size() + 1u;
+
+    /// records a value
+    void record(std::uint64_t value) noexcept {
+        auto bucket = 0u;
+        while (bucket < kBucketBounds.size() && value > kBucketBounds[bucket]) {
+            ++bucket;
+        }
+        mBuckets[bucket].fetch_add(1u, std::memory_order_relaxed);
+        mCount.fetch_add(1u, std::memory_order_relaxed);
+        mSum.fetch_add(value, std::memory_order_relaxed);
+        auto max = mMax.load(std::memory_order_relaxed);
+        while (value > max && !mMax.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    /// number of values recorded
+    std::uint64_t count() const noexcept { return mCount.load(std::memory_order_relaxed); }
+
+    /// sum of all values recorded
+    std::uint64_t sum() const noexcept { return mSum.load(std::memory_order_relaxed); }
+
+    /// largest value recorded
+    std::uint64_t max() const noexcept { return mMax.load(std::memory_order_relaxed); }
+
+    /// number of values in a bucket
+    std::uint64_t bucket(std::size_t index) const noexcept {
+        return mBuckets[index].load(std::memory_order_relaxed);
+    }
+
+    /// mean of all values recorded, 0 if no values have been recorded.
+    double mean() const noexcept {
+        auto total = count();
+        if (total == 0u) {
+            return 0.0;
+        }
+        return double(sum()) / double(total);
+    }
+
+    /*!
+     * \brief percentile estimates a percentile from the buckets. Returns the upper bound of the
+     * bucket that contains the percentile, or max() if it falls in the overflow bucket.
+     *
+     * \param percentile percentile to estimate, between 0 and 100.
+     */
+    std::uint64_t percentile(double percentile) const noexcept {
+        auto total = count();
+        if (total == 0u) {
+            return 0u;
+        }
+        auto target = std::uint64_t(double(total) * percentile / 100.0 + 0.5);
+        if (target == 0u) {
+            target = 1u;
+        }
+        std::uint64_t seen = 0u;
+        for (auto i = 0u; i < kBucketBounds.size(); ++i) {
+            seen += bucket(i);
+            if (seen >= target) {
+                return kBucketBounds[i];
+            }
+        }
+        return max();
+    }
+
+    /// resets the histogram
+    void reset() noexcept {
+        for (auto&& bucket : mBuckets) {
+            bucket.store(0u, std::memory_order_relaxed);
+        }
+        mCount.store(0u, std::memory_order_relaxed);
+        mSum.store(0u, std::memory_order_relaxed);
+        mMax.store(0u, std::memory_order_relaxed);
+    }
+
+private:
+    /// number of values in each bucket
+    std::array<std::atomic<std::uint64_t>, kBucketCount> mBuckets{};
+
+    /// number of values recorded
+    std::atomic<std::uint64_t> mCount{0u};
+
+    /// sum of the values recorded
+    std::atomic<std::uint64_t> mSum{0u};
+
+    /// largest value recorded
+    std::atomic<std::uint64_t> mMax{0u};
+};
+
+/*!
+ * \brief The MetricsRegistry class owns named counters and histograms. Looking up a metric by
+ * name takes a lock, but the returned reference stays valid for the life of the registry, so hot
+ * paths can look a metric up once and update it without locking. Snapshots can be exported as
+ * text or JSON, with metrics sorted by name.
+ */
+class MetricsRegistry {
+public:
+    /// returns the counter with the given name, creating it if it doesn't exist.
+    MetricCounter& counter(const std::string& name) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto& counter = mCounters[name];
+        if (!counter) {
+            counter.reset(new MetricCounter());
+        }
+        return *counter;
+    }
+
+    /// returns the histogram with the given name, creating it if it doesn't exist.
+    MetricHistogram& histogram(const std::string& name) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto& histogram = mHistograms[name];
+        if (!histogram) {
+            histogram.reset(new MetricHistogram());
+        }
+        return *histogram;
+    }
+
+    /// resets the values of all metrics. Metrics are not removed, so references stay valid.
+    void reset() {
+        std::lock_guard<std::mutex> lock(mMutex);
+        for (auto&& counter : mCounters) {
+            counter.second->reset();
+        }
+        for (auto&& histogram : mHistograms) {
+            histogram.second->reset();
+        }
+    }
+
+    /// snapshot of all metrics as human readable text, one metric per line.
+    std::string snapshotText() const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        std::ostringstream stream;
+        for (const auto& counter : mCounters) {
+            stream << counter.first << " " << counter.second->value() << "\n";
+        }
+        for (const auto& entry : mHistograms) {
+            const auto& histogram = *entry.second;
+            stream << entry.first << " count=" << histogram.count()
+                   << " mean=" << histogram.mean() << " p50=" << histogram.percentile(50.0)
+                   << " p90=" << histogram.percentile(90.0) << " p99=" << histogram.percentile(99.0)
+                   << " max=" << histogram.max() << "\n";
+        }
+        return stream.str();
+    }
+
+    /// snapshot of all metrics as a JSON object, with "counters" and "histograms" keys.
+    std::string snapshotJSON() const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        std::ostringstream stream;
+        stream << "{\"counters\":{";
+        auto first = true;
+        for (const auto& counter : mCounters) {
+            stream << (first ? "" : ",") << "\"" << escape(counter.first)
+                   << "\":" << counter.second->value();
+            first = false;
+        }
+        stream << "},\"histograms\":{";
+        first = true;
+        for (const auto& entry : mHistograms) {
+            const auto& histogram = *entry.second;
+            stream << (first ? "" : ",") << "\"" << escape(entry.first) << "\":{"
+                   << "\"count\":" << histogram.count() << ",\"sum\":" << histogram.sum()
+                   << ",\"max\":" << histogram.max() << ",\"p50\":" << histogram.percentile(50.0)
+                   << ",\"p90\":" << histogram.percentile(90.0)
+                   << ",\"p99\":" << histogram.percentile(99.0) << ",\"buckets\":[";
+            for (auto i = 0u; i < MetricHistogram::kBucketCount; ++i) {
+                stream << (i == 0u ? "" : ",") << histogram.bucket(i);
+            }
+            stream << "]}";
+            first = false;
+        }
+        stream << "}}";
+        return stream.str();
+    }
+
+private:
+    /// escapes a string for use as a JSON key
+    static std::string escape(const std::string& string) {
+        std::string escaped;
+        for (auto character : string) {
+            if (character == '"' || character == '\\') {
+                escaped += '\\';
+                escaped += character;
+            } else if (static_cast<unsigned char>(character) < 0x20) {
+                escaped += ' ';
+            } else {
+                escaped += character;
+            }
+        }
+        return escaped;
+    }
+
+    /// guards creating metrics and taking snapshots
+    mutable std::mutex mMutex;
+
+    /// counters, sorted by name
+    std::map<std::string, std::unique_ptr<MetricCounter>> mCounters;
+
+    /// histograms, sorted by name
+    std::map<std::string, std::unique_ptr<MetricHistogram>> mHistograms;
+};
+
+} // namespace cor
+
+#endif // COR_METRICS_H
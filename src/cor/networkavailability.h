@@ -0,0 +1,168 @@
+#ifndef COR_NETWORKAVAILABILITY_H
+#define COR_NETWORKAVAILABILITY_H
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <errno.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif // __linux__
+
+namespace cor {
+
+/// the state of a network interface that matters for whether lights can be reached.
+struct NetworkInterfaceState {
+    /// human readable name of the interface
+    std::string name;
+
+    /// true if the interface is wifi or ethernet
+    bool isLAN = false;
+
+    /// true if the interface is up
+    bool isUp = false;
+
+    /// true if the interface is running
+    bool isRunning = false;
+};
+
+/// true if any interface can reach lights on the local network.
+inline bool isNetworkAvailable(const std::vector<NetworkInterfaceState>& interfaces) {
+    return std::any_of(interfaces.begin(),
+                       interfaces.end(),
+                       [](const NetworkInterfaceState& state) {
+                           return state.isLAN && state.isUp && state.isRunning
+                                  && state.name.find("dummy") == std::string::npos;
+                       });
+}
+
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ *
+ * \brief The NetworkAvailability class tracks whether the local network is available. The state
+ * of the interfaces comes from a provider, so that the platform's interfaces can be swapped out
+ * for tests. The provider is only asked when refresh() is called, which should be when the
+ * interfaces are known to have changed.
+ */
+class NetworkAvailability {
+public:
+    /// provides the current state of every network interface
+    using Provider = std::function<std::vector<NetworkInterfaceState>()>;
+
+    /// constructor, checks the interfaces once.
+    explicit NetworkAvailability(Provider provider)
+        : mProvider(std::move(provider)),
+          mIsAvailable{isNetworkAvailable(mProvider())} {}
+
+    /// true if the network was available when last checked
+    bool isAvailable() const noexcept { return mIsAvailable; }
+
+    /// checks the interfaces again, returns true if the availability changed.
+    bool refresh() {
+        auto isAvailable = isNetworkAvailable(mProvider());
+        auto changed = isAvailable != mIsAvailable;
+        mIsAvailable = isAvailable;
+        return changed;
+    }
+
+private:
+    /// provides the current state of every network interface
+    Provider mProvider;
+
+    /// true if the network was available when last checked
+    bool mIsAvailable;
+};
+
+/*!
+ * \brief The NetlinkWatcher class listens to the Linux kernel's link and address events, so the
+ * network interfaces only need to be checked when one of them changes. fd() is readable when
+ * events are pending, so it can be watched by an event loop, and readEvents() never blocks. On
+ * other platforms, isValid() is false and the caller should fall back to polling.
+ */
+class NetlinkWatcher {
+public:
+    /// constructor, subscribes to link and address events.
+    NetlinkWatcher() : mFD{-1} {
+#ifdef __linux__
+        mFD = socket(AF_NETLINK, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_ROUTE);
+        if (mFD < 0) {
+            return;
+        }
+        sockaddr_nl address{};
+        address.nl_family = AF_NETLINK;
+        address.nl_groups = RTMGRP_LINK | RTMGRP_IPV4_IFADDR | RTMGRP_IPV6_IFADDR;
+        if (bind(mFD, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+            close(mFD);
+            mFD = -1;
+        }
+#endif // __linux__
+    }
+
+    /// destructor, unsubscribes.
+    ~NetlinkWatcher() {
+#ifdef __linux__
+        if (mFD >= 0) {
+            close(mFD);
+        }
+#endif // __linux__
+    }
+
+    NetlinkWatcher(const NetlinkWatcher&) = delete;
+    NetlinkWatcher& operator=(const NetlinkWatcher&) = delete;
+
+    /// true if events are being received
+    bool isValid() const noexcept { return mFD >= 0; }
+
+    /// file descriptor that is readable when events are pending, -1 if not valid.
+    int fd() const noexcept { return mFD; }
+
+    /// reads the pending events without blocking, returns true if an interface may have changed.
+    bool readEvents() {
+        auto changed = false;
+#ifdef __linux__
+        if (mFD < 0) {
+            return changed;
+        }
+        alignas(nlmsghdr) char buffer[8192];
+        ssize_t length;
+        while ((length = recv(mFD, buffer, sizeof(buffer), 0)) > 0) {
+            auto remaining = int(length);
+            for (auto header = reinterpret_cast<const nlmsghdr*>(buffer);
+                 NLMSG_OK(header, remaining);
+                 header = NLMSG_NEXT(header, remaining)) {
+                switch (header->nlmsg_type) {
+                    case RTM_NEWLINK:
+                    case RTM_DELLINK:
+                    case RTM_NEWADDR:
+                    case RTM_DELADDR:
+                        changed = true;
+                        break;
+                    default:
+                        break;
+                }
+            }
+        }
+        if (length < 0 && errno == ENOBUFS) {
+            // events were dropped, so anything may have changed.
+            changed = true;
+        }
+#endif // __linux__
+        return changed;
+    }
+
+private:
+    /// netlink socket, -1 if not valid.
+    int mFD;
+};
+
+} // namespace cor
+
+#endif // COR_NETWORKAVAILABILITY_H
@@ -29,7 +29,7 @@ public:
         : mIsOn{false},
           mRoutine{ERoutine::singleSolid},
           mColor(0, 0, 0),
-          mCustomPalette(cor::Palette::CustomPalette(cor::defaultCustomColors())),
+          mCustomPalette(defaultCustomPalette()),
           mPaletteBrightness{-1},
           mCustomCount{5},
           mEffect{"Default"},
@@ -270,6 +270,12 @@ public:
     }
 
 private:
+    /// the custom palette of a default state, created once and shared by every default state.
+    static const cor::Palette& defaultCustomPalette() {
+        static const auto kPalette = cor::Palette::CustomPalette(cor::defaultCustomColors());
+        return kPalette;
+    }
+
     /*!
      * \brief isOn true if the light is shining any color, false if turned
      *        off by software. By using a combination of isReachable and isOn
@@ -0,0 +1,208 @@
+#ifndef COR_MOOD_PLAN_H
+#define COR_MOOD_PLAN_H
+
+#include <unordered_map>
+#include <vector>
+
+#include "cor/objects/light.h"
+#include "cor/objects/uuid.h"
+
+namespace cor {
+
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+namespace plan {
+
+/// scrambles the bits of a 64 bit value, used to combine hashes without obvious collisions.
+inline std::uint64_t mix(std::uint64_t value) {
+    value ^= value >> 30;
+    value *= 0xbf58476d1ce4e5b9ULL;
+    value ^= value >> 27;
+    value *= 0x94d049bb133111ebULL;
+    value ^= value >> 31;
+    return value;
+}
+
+/// combines a hash into an existing hash, order dependent.
+inline void combine(std::uint64_t& seed, std::uint64_t value) {
+    seed = mix(seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2)));
+}
+
+} // namespace plan
+
+/*!
+ * \brief lightStateHash hashes a light state. Two states that are equal according to
+ * cor::LightState's equal operator always have the same hash.
+ */
+inline std::uint64_t lightStateHash(const cor::LightState& state) {
+    std::uint64_t hash = 0u;
+    plan::combine(hash, std::uint64_t(state.isOn()));
+    plan::combine(hash, std::uint64_t(state.routine()));
+    plan::combine(hash, std::uint64_t(state.color().rgba()));
+    plan::combine(hash, std::uint64_t(qHash(state.effect())));
+    plan::combine(hash, std::uint64_t(qHash(state.palette().uniqueID().toString())));
+    plan::combine(hash, std::uint64_t(qHash(state.palette().name())));
+    // equal colors always have equal signatures, so this avoids hashing each color.
+    plan::combine(hash, state.palette().signature().hash());
+    plan::combine(hash, std::uint64_t(state.paletteBrightness()));
+    plan::combine(hash, std::uint64_t(state.speed()));
+    plan::combine(hash, std::uint64_t(state.transitionSpeed()));
+    return hash;
+}
+
+/*!
+ * \brief lightsContentHash hashes the unique IDs and states of a vector of lights. The hash does not
+ * depend on the order of the lights, and it ignores metadata such as names and reachability, so
+ * the same set of lights in the same states always gives the same hash.
+ */
+inline std::uint64_t lightsContentHash(const std::vector<cor::Light>& lights) {
+    std::uint64_t hash = plan::mix(lights.size());
+    for (const auto& light : lights) {
+        std::uint64_t lightHash = std::uint64_t(qHash(light.uniqueID().toString()));
+        plan::combine(lightHash, lightStateHash(light.state()));
+        // addition keeps the hash independent of the order of the lights
+        hash += plan::mix(lightHash);
+    }
+    return hash;
+}
+
+/*!
+ * \brief The MoodPlan class is a compiled version of a cor::Mood. A mood stores individual light
+ * states and default states for groups and rooms. A MoodPlan resolves all of these into the final
+ * state of each light and stores a hash of the result. Compiling a mood requires searching groups
+ * and the comm layer, but once its compiled, applying the mood only requires the plan, and checking
+ * if a set of lights matches the mood only requires comparing hashes. The DataSync engines batch
+ * the states of the plan by the controller they are sent to.
+ */
+class MoodPlan {
+public:
+    /// default constructor
+    MoodPlan() : MoodPlan(cor::UUID::invalidID(), {}) {}
+
+    /// constructor
+    MoodPlan(const cor::UUID& moodID, const std::vector<cor::Light>& lights)
+        : mMoodID{moodID},
+          mLights{lights} {
+        for (const auto& light : mLights) {
+            mStates.emplace(light.uniqueID(), light.state());
+        }
+        mHash = lightsContentHash(mLights);
+    }
+
+    /// getter for the unique ID of the mood the plan is compiled from.
+    const cor::UUID& moodID() const noexcept { return mMoodID; }
+
+    /// getter for all lights in the plan, with their target states.
+    const std::vector<cor::Light>& lights() const noexcept { return mLights; }
+
+    /// hash of the resolved lights and states, computed with lightsContentHash.
+    std::uint64_t hash() const noexcept { return mHash; }
+
+    /// true if the lights provided are exactly the lights in the plan, in the same states.
+    bool matches(const std::vector<cor::Light>& lights) const {
+        if (lights.size() != mStates.size()) {
+            return false;
+        }
+        for (const auto& light : lights) {
+            auto result = mStates.find(light.uniqueID());
+            if (result == mStates.end() || result->second != light.state()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    /// unique ID of the mood
+    cor::UUID mMoodID;
+
+    /// lights with their target states
+    std::vector<cor::Light> mLights;
+
+    /// target state for each light, used for verifying matches
+    std::unordered_map<cor::LightID, cor::LightState> mStates;
+
+    /// content hash of the plan
+    std::uint64_t mHash;
+};
+
+/*!
+ * \brief The MoodPlanIndex class stores compiled MoodPlans, and can look them up either by the mood
+ * they were compiled from, or by the lights and states they produce.
+ */
+class MoodPlanIndex {
+public:
+    /// adds a plan, replacing any plan previously compiled for the same mood.
+    void insert(const MoodPlan& plan) {
+        remove(plan.moodID());
+        const auto& key = plan.moodID().toStdString();
+        mPlans.emplace(key, plan);
+        mIDsByHash.emplace(plan.hash(), key);
+    }
+
+    /// removes the plan for a mood, if it exists.
+    void remove(const cor::UUID& moodID) {
+        auto result = mPlans.find(moodID.toStdString());
+        if (result == mPlans.end()) {
+            return;
+        }
+        auto range = mIDsByHash.equal_range(result->second.hash());
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second == result->first) {
+                mIDsByHash.erase(it);
+                break;
+            }
+        }
+        mPlans.erase(result);
+    }
+
+    /// returns a pointer to the plan for the given mood, or nullptr if it has not been compiled.
+    const MoodPlan* plan(const cor::UUID& moodID) const {
+        auto result = mPlans.find(moodID.toStdString());
+        if (result == mPlans.end()) {
+            return nullptr;
+        }
+        return &result->second;
+    }
+
+    /// finds the mood that produces exactly the given lights and states. Returns an invalid ID if
+    /// no mood matches.
+    cor::UUID findMood(const std::vector<cor::Light>& lights) const {
+        if (lights.empty()) {
+            return cor::UUID::invalidID();
+        }
+        auto range = mIDsByHash.equal_range(lightsContentHash(lights));
+        for (auto it = range.first; it != range.second; ++it) {
+            // verify the match, in case of a hash collision
+            const auto& plan = mPlans.at(it->second);
+            if (plan.matches(lights)) {
+                return plan.moodID();
+            }
+        }
+        return cor::UUID::invalidID();
+    }
+
+    /// removes all plans
+    void clear() {
+        mPlans.clear();
+        mIDsByHash.clear();
+    }
+
+    /// number of compiled plans
+    std::size_t size() const noexcept { return mPlans.size(); }
+
+private:
+    /// plans, keyed by the mood's unique ID.
+    std::unordered_map<std::string, MoodPlan> mPlans;
+
+    /// mood unique IDs, keyed by the hash of their plans.
+    std::unordered_multimap<std::uint64_t, std::string> mIDsByHash;
+};
+
+} // namespace cor
+
+#endif // COR_MOOD_PLAN_H
@@ -4,10 +4,13 @@
 #include <QColor>
 #include <QJsonArray>
 #include <QJsonObject>
+#include <memory>
 #include <sstream>
 #include <vector>
 
+#include "cor/interner.h"
 #include "cor/objects/uuid.h"
+#include "cor/palettesignature.h"
 #include "cor/protocols.h"
 #include "utils/color.h"
 #include "utils/cormath.h"
@@ -31,14 +34,22 @@ const QString kCustomPaletteName = "*Custom*";
  * palette maintains a JSON representation and a standard representation of
  * all of its data. The enum will be defined as "custom" if it doesn't match a known palette
  * for Corluma.
+ *
+ * A Palette is an immutable handle to data that is interned by its contents, so palettes with
+ * the same ID, name, and colors share one copy of their colors. Copying a palette is a reference
+ * count increment, and comparing two interned palettes compares pointers. Every light state holds
+ * two palettes, so this keeps copies of lights, moods, and snapshots from copying color vectors.
+ *
+ * Interning takes a lock and hashes the palette, so default palettes share one static instance,
+ * and palettes that are discarded soon or can never equal another palette can be made with
+ * unshared(), which skips the interner.
  */
 class Palette {
 public:
     /// json constructor
-    Palette(const QJsonObject& object)
-        : mUniqueID{object["uniqueID"].toString()},
-          mName{object["name"].toString()},
-          mColors{std::vector<QColor>(std::size_t(object["count"].toDouble()), QColor(0, 0, 0))} {
+    Palette(const QJsonObject& object) {
+        auto colors =
+            std::vector<QColor>(std::size_t(object["count"].toDouble()), QColor(0, 0, 0));
         auto array = object["colors"].toArray();
         for (auto color : qAsConst(array)) {
             auto object = color.toObject();
@@ -48,66 +59,88 @@ public:
                 int red = int(object["red"].toDouble());
                 int green = int(object["green"].toDouble());
                 int blue = int(object["blue"].toDouble());
-                mColors[index] = QColor(red, green, blue);
+                colors[index] = QColor(red, green, blue);
             } else if (object["hue"].isDouble()) {
                 double hue = object["hue"].toDouble();
                 double sat = object["sat"].toDouble();
                 double bri = object["bri"].toDouble();
                 QColor color;
                 color.setHsvF(hue, sat, bri);
-                mColors[index] = color;
+                colors[index] = color;
             } else {
                 qDebug() << "WARN: improperly formatted color json daata in a cor::Palette";
             }
         }
-        checkIfValid();
+        mData = intern(object["uniqueID"].toString(), object["name"].toString(), colors);
     }
 
     /// app data constructor
     Palette(const cor::UUID& uniqueID, const QString& name, const std::vector<QColor>& colors)
-        : mUniqueID{uniqueID},
-          mName{name},
-          mColors{colors} {
-        checkIfValid();
-    }
-
-
-    /// default constructor
-    Palette()
-        : Palette(cor::UUID::invalidID(),
-                  kInvalidPaletteName,
-                  std::vector<QColor>(1, QColor(0, 0, 0))) {
-        checkIfValid();
+        : mData{intern(uniqueID, name, colors)} {}
+
+
+    /// default constructor, shares the default data, which is only interned once.
+    Palette() : mData{defaultData()} {}
+
+    /*!
+     * \brief unshared creates a palette without interning it, for palettes that are discarded
+     * soon, such as previews, or that can never equal another palette, such as palettes with a new
+     * UUID. Comparing it to another palette compares contents instead of pointers.
+     */
+    static Palette unshared(const cor::UUID& uniqueID,
+                            const QString& name,
+                            const std::vector<QColor>& colors) {
+        auto data = makeData(uniqueID, name, colors);
+        data.isInterned = false;
+        return Palette(std::make_shared<const Data>(std::move(data)));
     }
 
     /// getter for uniqueID
-    const cor::UUID& uniqueID() const noexcept { return mUniqueID; }
+    const cor::UUID& uniqueID() const noexcept { return mData->uniqueID; }
 
     /// getter for name of the palette
-    const QString& name() const noexcept { return mName; }
+    const QString& name() const noexcept { return mData->name; }
 
     /// getter for the vector of colors
-    const std::vector<QColor>& colors() const noexcept { return mColors; }
+    const std::vector<QColor>& colors() const noexcept { return mData->colors; }
 
-    /// setter for colors
-    void colors(const std::vector<QColor>& colors) { mColors = colors; }
+    /// setter for colors, points this palette to the data with the new colors.
+    void colors(const std::vector<QColor>& colors) {
+        mData = intern(mData->uniqueID, mData->name, colors);
+    }
+
+    /// canonical form of the colors, which doesn't depend on their order.
+    const cor::PaletteSignature& signature() const noexcept { return mData->signature; }
+
+    /*!
+     * \brief colorsMatch true if the palettes have the same colors, in any order, within the
+     * tolerance. Black colors in this palette match any color. This is a hash check in the common
+     * case, and only compares colors when the hashes differ.
+     */
+    bool colorsMatch(const Palette& other, float tolerance) const noexcept {
+        if (mData == other.mData) {
+            return true;
+        }
+        return mData->signature.matches(other.mData->signature, tolerance);
+    }
 
     /// averages all colors together for a palette to give a single color representation.
     QColor averageColor() const noexcept {
         auto r = 0u;
         auto g = 0u;
         auto b = 0u;
-        for (const auto& color : mColors) {
+        const auto& colors = mData->colors;
+        for (const auto& color : colors) {
             r += color.red();
             g += color.green();
             b += color.blue();
         }
-        return QColor(r / mColors.size(), g / mColors.size(), b / mColors.size());
+        return QColor(r / colors.size(), g / colors.size(), b / colors.size());
     }
 
     /// true if a color exists in the palette that is at least 95% similar to the given color.
     bool colorIsInPalette(const QColor& colorToCheck) const noexcept {
-        for (const auto& color : mColors) {
+        for (const auto& color : mData->colors) {
             if (cor::colorDifference(colorToCheck, color) < 0.05) {
                 return true;
             }
@@ -117,21 +150,19 @@ public:
 
     /// true if the palette has all the required values
     bool isValid() const noexcept {
-        return !mColors.empty() || !mUniqueID.isValid() || !mName.isEmpty();
+        return !colors().empty() || !uniqueID().isValid() || !name().isEmpty();
     }
 
-    bool operator==(const Palette& rhs) const {
-        bool result = true;
-        if (uniqueID() != rhs.uniqueID()) {
-            result = false;
-        }
-        if (name() != rhs.name()) {
-            result = false;
+    /// interned palettes that are equal always share their data, so only unshared palettes need
+    /// their contents compared.
+    bool operator==(const Palette& rhs) const noexcept {
+        if (mData == rhs.mData) {
+            return true;
         }
-        if (colors() != rhs.colors()) {
-            result = false;
+        if (mData->isInterned && rhs.mData->isInterned) {
+            return false;
         }
-        return result;
+        return *mData == *rhs.mData;
     }
 
     bool operator!=(const Palette& rhs) const { return !(*this == rhs); }
@@ -162,9 +193,9 @@ public:
         QJsonObject object;
         QJsonArray array;
         int index = 0;
-        object["name"] = mName;
-        object["uniqueID"] = mUniqueID.toString();
-        for (const auto& color : mColors) {
+        object["name"] = name();
+        object["uniqueID"] = uniqueID().toString();
+        for (const auto& color : colors()) {
             QJsonObject colorObject;
             colorObject["index"] = index;
             if (useHSV) {
@@ -180,7 +211,7 @@ public:
             ++index;
         }
         object["colors"] = array;
-        object["count"] = double(mColors.size());
+        object["count"] = double(colors().size());
         return object;
     }
 
@@ -189,20 +220,80 @@ public:
     }
 
 private:
-    /// throws exception if palette is not valid.
-    void checkIfValid() {
-        GUARD_EXCEPTION(!mColors.empty(), "palette does not have any colors");
-        GUARD_EXCEPTION(!mName.isEmpty(), "name for palette is empty");
+    /// the contents of a palette, shared by every palette with the same contents.
+    struct Data {
+        /// UUID to track palette regardless of color and name changes.
+        cor::UUID uniqueID;
+
+        /// name for the palette
+        QString name;
+
+        /// vector for the colors
+        std::vector<QColor> colors;
+
+        /// signature of the colors, computed once when the data is created.
+        cor::PaletteSignature signature;
+
+        /// true if the data is in the interner, false if it was made by unshared().
+        bool isInterned = true;
+
+        bool operator==(const Data& rhs) const {
+            // equal colors always have equal signatures, so this skips comparing most colors.
+            return signature.hash() == rhs.signature.hash() && uniqueID == rhs.uniqueID
+                   && name == rhs.name && colors == rhs.colors;
+        }
+    };
+
+    /// hashes the contents of a palette for the interner.
+    struct DataHash {
+        std::size_t operator()(const Data& data) const {
+            auto hash = std::size_t(data.signature.hash());
+            hash ^= std::size_t(qHash(data.uniqueID.toString())) + 0x9e3779b9u + (hash << 6u)
+                    + (hash >> 2u);
+            hash ^= std::size_t(qHash(data.name)) + 0x9e3779b9u + (hash << 6u) + (hash >> 2u);
+            return hash;
+        }
+    };
+
+    /// constructor for data that is already shared
+    explicit Palette(std::shared_ptr<const Data> data) : mData{std::move(data)} {}
+
+    /// checks the contents of a palette, and computes its signature. Throws an exception if the
+    /// palette is not valid.
+    static Data makeData(const cor::UUID& uniqueID,
+                         const QString& name,
+                         const std::vector<QColor>& colors) {
+        GUARD_EXCEPTION(!colors.empty(), "palette does not have any colors");
+        GUARD_EXCEPTION(!name.isEmpty(), "name for palette is empty");
+        std::vector<cor::PaletteSignature::Color> signatureColors;
+        signatureColors.reserve(colors.size());
+        for (const auto& color : colors) {
+            signatureColors.push_back({std::uint8_t(color.red()),
+                                       std::uint8_t(color.green()),
+                                       std::uint8_t(color.blue()),
+                                       -1.0f});
+        }
+        return Data{uniqueID, name, colors, cor::PaletteSignature(signatureColors), true};
     }
 
-    /// UUID to track palette regardless of color and name changes.
-    cor::UUID mUniqueID;
+    /// checks the contents of a palette, and returns the data shared by every equal palette.
+    static std::shared_ptr<const Data> intern(const cor::UUID& uniqueID,
+                                              const QString& name,
+                                              const std::vector<QColor>& colors) {
+        static cor::Interner<Data, DataHash> interner;
+        return interner.intern(makeData(uniqueID, name, colors));
+    }
 
-    /// name for the palette
-    QString mName;
+    /// data of the default palette, interned once and shared by every default palette.
+    static const std::shared_ptr<const Data>& defaultData() {
+        static const auto kData = intern(cor::UUID::invalidID(),
+                                         kInvalidPaletteName,
+                                         std::vector<QColor>(1, QColor(0, 0, 0)));
+        return kData;
+    }
 
-    /// vector for the colors
-    std::vector<QColor> mColors;
+    /// contents of the palette, shared with every equal palette.
+    std::shared_ptr<const Data> mData;
 };
 
 
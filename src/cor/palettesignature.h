@@ -0,0 +1,183 @@
+#ifndef COR_PALETTE_SIGNATURE_H
+#define COR_PALETTE_SIGNATURE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+namespace cor {
+
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ *
+ * \brief The PaletteSignature class is a canonical form of the colors of a palette, used to
+ * compare palettes without caring about the order of their colors. It stores the colors sorted by
+ * hue, and a hash of the colors after they are quantized and sorted. Two palettes with the same
+ * colors in any order have the same hash, and palettes whose colors only differ by rounding
+ * usually do too.
+ *
+ * Signatures are computed once when a palette is created. The hash only short-circuits a
+ * comparison when the colors are exactly the same, since colors in the same quantized bucket can
+ * still be further apart than the tolerance. Otherwise each color is checked against the
+ * tolerance.
+ */
+class PaletteSignature {
+public:
+    /// a single RGB color, with its hue.
+    struct Color {
+        /// red value, between 0 and 255
+        std::uint8_t red;
+
+        /// green value, between 0 and 255
+        std::uint8_t green;
+
+        /// blue value, between 0 and 255
+        std::uint8_t blue;
+
+        /// hue in degrees, between 0 and 360, or -1 for colors without a hue, such as grey.
+        float hue;
+    };
+
+    /// number of bits of each channel kept when quantizing colors for the hash.
+    static constexpr int kQuantizeBits = 4;
+
+    /// default constructor, for a palette without colors
+    PaletteSignature() : mHash{0u} {}
+
+    /// constructor, takes the colors as RGB values in the order they are stored in the palette.
+    explicit PaletteSignature(const std::vector<Color>& colors) : mColors{colors} {
+        for (auto& color : mColors) {
+            color.hue = hue(color.red, color.green, color.blue);
+        }
+        std::sort(mColors.begin(), mColors.end(), lessThan);
+
+        std::vector<Color> quantized;
+        quantized.reserve(mColors.size());
+        for (const auto& color : mColors) {
+            auto red = std::uint8_t(color.red >> (8 - kQuantizeBits));
+            auto green = std::uint8_t(color.green >> (8 - kQuantizeBits));
+            auto blue = std::uint8_t(color.blue >> (8 - kQuantizeBits));
+            quantized.push_back({red, green, blue, hue(red, green, blue)});
+        }
+        std::sort(quantized.begin(), quantized.end(), lessThan);
+
+        mHash = mix(std::uint64_t(quantized.size()));
+        for (const auto& color : quantized) {
+            auto packed = (std::uint64_t(color.red) << 16u) | (std::uint64_t(color.green) << 8u)
+                          | std::uint64_t(color.blue);
+            mHash = mix(mHash ^ (packed + 0x9e3779b97f4a7c15ULL + (mHash << 6u) + (mHash >> 2u)));
+        }
+    }
+
+    /// hash of the quantized, hue sorted colors.
+    std::uint64_t hash() const noexcept { return mHash; }
+
+    /// the colors, sorted by hue.
+    const std::vector<Color>& colors() const noexcept { return mColors; }
+
+    /*!
+     * \brief matches true if both palettes have the same number of colors, and each color of this
+     * palette is within the tolerance of the color with the same position in the other palette,
+     * when both are sorted by hue. Black colors in this palette match any color.
+     * \param other palette to compare against
+     * \param tolerance max difference between two colors, between 0 and 1.
+     */
+    bool matches(const PaletteSignature& other, float tolerance) const noexcept {
+        if (mColors.size() != other.mColors.size()) {
+            return false;
+        }
+        if (mHash == other.mHash
+            && std::equal(mColors.begin(), mColors.end(), other.mColors.begin(), isSameColor)) {
+            return true;
+        }
+        for (std::size_t i = 0u; i < mColors.size(); ++i) {
+            const auto& color = mColors[i];
+            if (isBlack(color)) {
+                continue;
+            }
+            if (difference(color, other.mColors[i]) > tolerance) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// computes the hue of a color in degrees, or -1 if it has no hue, the same way QColor does.
+    static float hue(int red, int green, int blue) noexcept {
+        auto max = std::max(red, std::max(green, blue));
+        auto min = std::min(red, std::min(green, blue));
+        auto delta = float(max - min);
+        if (max == min) {
+            return -1.0f;
+        }
+        float hue;
+        if (max == red) {
+            hue = float(green - blue) / delta;
+        } else if (max == green) {
+            hue = 2.0f + float(blue - red) / delta;
+        } else {
+            hue = 4.0f + float(red - green) / delta;
+        }
+        hue *= 60.0f;
+        if (hue < 0.0f) {
+            hue += 360.0f;
+        }
+        return hue;
+    }
+
+    /// difference between two colors, between 0 and 1. Matches cor::colorDifference.
+    static float difference(const Color& first, const Color& second) noexcept {
+        auto red = std::abs(int(first.red) - int(second.red)) / 255.0f;
+        auto green = std::abs(int(first.green) - int(second.green)) / 255.0f;
+        auto blue = std::abs(int(first.blue) - int(second.blue)) / 255.0f;
+        return (red + green + blue) / 3.0f;
+    }
+
+private:
+    /// sorts by hue, colors without a hue first. Ties are sorted by RGB, so the order is stable.
+    static bool lessThan(const Color& a, const Color& b) noexcept {
+        if (a.hue != b.hue) {
+            return a.hue < b.hue;
+        }
+        if (a.red != b.red) {
+            return a.red < b.red;
+        }
+        if (a.green != b.green) {
+            return a.green < b.green;
+        }
+        return a.blue < b.blue;
+    }
+
+    /// true if both colors have the same RGB values.
+    static bool isSameColor(const Color& a, const Color& b) noexcept {
+        return a.red == b.red && a.green == b.green && a.blue == b.blue;
+    }
+
+    /// true if the color has no brightness.
+    static bool isBlack(const Color& color) noexcept {
+        return color.red == 0u && color.green == 0u && color.blue == 0u;
+    }
+
+    /// scrambles the bits of a 64 bit value.
+    static std::uint64_t mix(std::uint64_t value) noexcept {
+        value ^= value >> 30u;
+        value *= 0xbf58476d1ce4e5b9ULL;
+        value ^= value >> 27u;
+        value *= 0x94d049bb133111ebULL;
+        value ^= value >> 31u;
+        return value;
+    }
+
+    /// the colors, sorted by hue.
+    std::vector<Color> mColors;
+
+    /// hash of the quantized, hue sorted colors.
+    std::uint64_t mHash;
+};
+
+} // namespace cor
+
+#endif // COR_PALETTE_SIGNATURE_H
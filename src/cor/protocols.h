@@ -4,6 +4,8 @@
 #include <QDebug>
 #include <QPixmap>
 
+#include "cor/routine.h"
+
 /*!
  * \copyright
  * Copyright (C) 2015 - 2020.
@@ -166,6 +168,9 @@ inline EPage stringToPage(const QString& string) {
  */
 enum class EColorMode { HSV, dimmable, CT, XY, MAX };
 
+/// type of colors allowed by selected lights
+enum class EColorPickerType { dimmable, CT, color };
+
 /*!
  * \brief colorModeToString helper for converting a color mode to a
  *        human readable string
@@ -222,78 +227,6 @@ Q_DECLARE_METATYPE(EConnectionState)
 
 
 
-/*!
- * \enum ERoutine Each routine makes the LEDs shine in different ways. There are
- *       two main types of routines: Single Color Routines use a single color while Multi
- *       Color Routines rely on an EPalette.
- */
-enum class ERoutine {
-    /*!
-     * <b>0</b><br>
-     * <i>Shows a single color at a fixed brightness.</i>
-     */
-    singleSolid,
-    /*!
-     * <b>1</b><br>
-     * <i>Alternates between showing a single color at a fixed
-     * brightness and turning the LEDs completely off.</i>
-     */
-    singleBlink,
-    /*!
-     * <b>2</b><br>
-     * <i>Linear fade of the brightness of the LEDs.</i>
-     */
-    singleWave,
-    /*!
-     * <b>3</b><br>
-     * <i> Randomly dims some of the LEDs to give a glimmer effect.</i>
-     */
-    singleGlimmer,
-    /*!
-     * <b>4</b><br>
-     * <i>Fades the brightness in and out of the LEDs. Takes a parameter of either
-     * 0 or 1. If its 0, it fades linearly. If its 1, it fades using a sine wave, so less time
-     * in the mid range of brightness and more time in the full and very dim light.</i>
-     */
-    singleFade,
-    /*!
-     * <b>5</b><br>
-     * <i>fades in or out using a sawtooth function. Takes a parameter of either 0 or
-     * 1. If its 0, it starts off and fades to full brightness. If its 1, it starts at full
-     * brightness and fades to zero. The fade is linear. </i>
-     */
-    singleSawtoothFade,
-    /*!
-     * <b>6</b><br>
-     * <i> Uses the first color of the array as the base color
-     * and uses the other colors for a glimmer effect.</i>
-     */
-    multiGlimmer,
-    /*!
-     * <b>7</b><br>
-     * <i>Fades slowly between each color in the array.</i>
-     */
-    multiFade,
-    /*!
-     * <b>8</b><br>
-     * <i>Chooses a random color from the array and lights all
-     * all LEDs to match that color.</i>
-     */
-    multiRandomSolid,
-    /*!
-     * <b>9</b><br>
-     * <i>Chooses a random color from the array for each
-     * individual LED.</i>
-     */
-    multiRandomIndividual,
-    /*!
-     * <b>10</b><br>
-     * <i>Draws the colors of the array in alternating
-     *  groups of equal size.</i>
-     */
-    multiBars,
-    MAX // total number of modes
-};
 Q_DECLARE_METATYPE(ERoutine)
 
 /// converts a ERoutine object to a string
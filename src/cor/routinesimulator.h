@@ -0,0 +1,330 @@
+#ifndef COR_ROUTINE_SIMULATOR_H
+#define COR_ROUTINE_SIMULATOR_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "cor/routine.h"
+
+namespace cor {
+
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+/// a single RGB value in a simulated frame.
+struct FrameColor {
+    /// red value, between 0 and 255
+    std::uint8_t red;
+
+    /// green value, between 0 and 255
+    std::uint8_t green;
+
+    /// blue value, between 0 and 255
+    std::uint8_t blue;
+
+    /// equal operator
+    bool operator==(const FrameColor& rhs) const {
+        return red == rhs.red && green == rhs.green && blue == rhs.blue;
+    }
+
+    /// not equal operator
+    bool operator!=(const FrameColor& rhs) const { return !(*this == rhs); }
+};
+
+/*!
+ * \brief The RoutineSimulator class renders ArduCor routines in software. Given a routine, a color
+ * or palette, a speed, and a number of lights, it produces the frame that the hardware displays for
+ * any frame index. Frames are deterministic: the same settings, seed, and frame index always give
+ * the same frame, so they can drive animated previews and be compared against known output in tests.
+ * The simulator does not depend on Qt.
+ */
+class RoutineSimulator {
+public:
+    /// number of frames it takes a fading routine to go from off to full brightness.
+    static constexpr std::uint32_t kFadeSteps = 32u;
+
+    /// percent of LEDs that glimmer when the routine's param is not set.
+    static constexpr int kDefaultGlimmerPercent = 15;
+
+    /// size of each bar when the routine's param is not set.
+    static constexpr int kDefaultBarSize = 2;
+
+    /// constructor
+    RoutineSimulator(ERoutine routine, std::uint32_t lightCount, std::uint32_t seed = 0u)
+        : mRoutine{routine},
+          mLightCount{lightCount},
+          mSeed{seed},
+          mColor{255u, 255u, 255u},
+          mPalette{FrameColor{255u, 255u, 255u}},
+          mParam{-1},
+          mSpeed{100},
+          mBrightness{100} {}
+
+    /// getter for the routine
+    ERoutine routine() const noexcept { return mRoutine; }
+
+    /// setter for the routine
+    void routine(ERoutine routine) { mRoutine = routine; }
+
+    /// getter for the number of lights in each frame
+    std::uint32_t lightCount() const noexcept { return mLightCount; }
+
+    /// setter for the number of lights in each frame
+    void lightCount(std::uint32_t count) { mLightCount = count; }
+
+    /// getter for the color used by single color routines
+    const FrameColor& color() const noexcept { return mColor; }
+
+    /// setter for the color used by single color routines
+    void color(const FrameColor& color) { mColor = color; }
+
+    /// getter for the palette used by multi color routines
+    const std::vector<FrameColor>& palette() const noexcept { return mPalette; }
+
+    /// setter for the palette used by multi color routines. An empty palette is treated as black.
+    void palette(const std::vector<FrameColor>& palette) {
+        mPalette = palette;
+        if (mPalette.empty()) {
+            mPalette.push_back({0u, 0u, 0u});
+        }
+    }
+
+    /// getter for the routine's parameter, a negative value uses the routine's default.
+    int param() const noexcept { return mParam; }
+
+    /// setter for the routine's parameter
+    void param(int param) { mParam = param; }
+
+    /// getter for the speed, in the same units as cor::LightState::speed()
+    int speed() const noexcept { return mSpeed; }
+
+    /// setter for the speed
+    void speed(int speed) { mSpeed = speed; }
+
+    /// getter for the brightness, between 0 and 100
+    int brightness() const noexcept { return mBrightness; }
+
+    /// setter for the brightness, between 0 and 100
+    void brightness(int brightness) { mBrightness = brightness; }
+
+    /*!
+     * \brief frameInterval number of milliseconds each frame is displayed for. ArduCor treats the
+     * speed as frames per second multiplied by 100, so a speed of 100 displays one frame per
+     * second. Speeds above 100000 display one frame per millisecond.
+     */
+    std::uint32_t frameInterval() const noexcept {
+        if (mSpeed <= 0) {
+            return 0u;
+        }
+        return std::max(1u, std::uint32_t(100000 / mSpeed));
+    }
+
+    /// index of the frame displayed after the given number of milliseconds.
+    std::uint64_t frameIndex(std::uint64_t elapsedMsec) const noexcept {
+        auto interval = frameInterval();
+        if (interval == 0u) {
+            return 0u;
+        }
+        return elapsedMsec / interval;
+    }
+
+    /// renders a frame and returns it.
+    std::vector<FrameColor> frame(std::uint64_t frameIndex) const {
+        std::vector<FrameColor> buffer;
+        renderFrame(frameIndex, buffer);
+        return buffer;
+    }
+
+    /*!
+     * \brief renderFrame renders a frame into the provided buffer. The buffer is resized to
+     * lightCount(), so reusing the same buffer across frames avoids allocating.
+     *
+     * \param frameIndex index of the frame to render.
+     * \param buffer buffer to fill.
+     */
+    void renderFrame(std::uint64_t frameIndex, std::vector<FrameColor>& buffer) const {
+        buffer.resize(mLightCount);
+        Random random(mSeed, frameIndex);
+        auto paletteSize = std::uint32_t(mPalette.size());
+        switch (mRoutine) {
+            case ERoutine::singleSolid:
+                fill(buffer, mColor);
+                break;
+            case ERoutine::singleBlink:
+                fill(buffer, (frameIndex % 2u) == 0u ? mColor : FrameColor{0u, 0u, 0u});
+                break;
+            case ERoutine::singleWave:
+                for (auto i = 0u; i < mLightCount; ++i) {
+                    buffer[i] = scale(mColor, triangle(frameIndex + i));
+                }
+                break;
+            case ERoutine::singleGlimmer:
+                for (auto i = 0u; i < mLightCount; ++i) {
+                    if (random.percent() < glimmerPercent()) {
+                        buffer[i] = scale(mColor, 0.2f + 0.7f * float(random.percent()) / 100.0f);
+                    } else {
+                        buffer[i] = mColor;
+                    }
+                }
+                break;
+            case ERoutine::singleFade:
+                if (mParam == 1) {
+                    auto position = float(frameIndex % (2u * kFadeSteps)) / float(2u * kFadeSteps);
+                    auto level = (1.0f - std::cos(position * 2.0f * 3.14159265f)) / 2.0f;
+                    fill(buffer, scale(mColor, level));
+                } else {
+                    fill(buffer, scale(mColor, triangle(frameIndex)));
+                }
+                break;
+            case ERoutine::singleSawtoothFade: {
+                auto level = float(frameIndex % kFadeSteps) / float(kFadeSteps - 1u);
+                if (mParam == 1) {
+                    level = 1.0f - level;
+                }
+                fill(buffer, scale(mColor, level));
+                break;
+            }
+            case ERoutine::multiGlimmer:
+                for (auto i = 0u; i < mLightCount; ++i) {
+                    if (paletteSize > 1u && random.percent() < glimmerPercent()) {
+                        buffer[i] = mPalette[1u + random.next() % (paletteSize - 1u)];
+                    } else {
+                        buffer[i] = mPalette[0];
+                    }
+                }
+                break;
+            case ERoutine::multiFade: {
+                auto index = std::uint32_t((frameIndex / kFadeSteps) % paletteSize);
+                auto level = float(frameIndex % kFadeSteps) / float(kFadeSteps);
+                fill(buffer, blend(mPalette[index], mPalette[(index + 1u) % paletteSize], level));
+                break;
+            }
+            case ERoutine::multiRandomSolid:
+                fill(buffer, mPalette[random.next() % paletteSize]);
+                break;
+            case ERoutine::multiRandomIndividual:
+                for (auto i = 0u; i < mLightCount; ++i) {
+                    buffer[i] = mPalette[random.next() % paletteSize];
+                }
+                break;
+            case ERoutine::multiBars: {
+                auto barSize = std::uint64_t(mParam > 0 ? mParam : kDefaultBarSize);
+                for (auto i = 0u; i < mLightCount; ++i) {
+                    buffer[i] = mPalette[std::size_t(((frameIndex + i) / barSize) % paletteSize)];
+                }
+                break;
+            }
+            case ERoutine::MAX:
+            default:
+                // if a routine doesn't exist, just draw things black.
+                fill(buffer, {0u, 0u, 0u});
+                break;
+        }
+
+        if (mBrightness < 100) {
+            auto level = mBrightness > 0 ? float(mBrightness) / 100.0f : 0.0f;
+            for (auto&& color : buffer) {
+                color = scale(color, level);
+            }
+        }
+    }
+
+private:
+    /// small xorshift generator, seeded per frame so any frame can be rendered on its own.
+    class Random {
+    public:
+        /// constructor
+        Random(std::uint32_t seed, std::uint64_t frameIndex) {
+            mState = (std::uint64_t(seed) << 32u) ^ (frameIndex * 0x9e3779b97f4a7c15ULL);
+            mState ^= mState >> 29u;
+            mState *= 0xbf58476d1ce4e5b9ULL;
+            mState ^= mState >> 32u;
+            if (mState == 0u) {
+                mState = 0x2545f4914f6cdd1dULL;
+            }
+        }
+
+        /// next random value
+        std::uint32_t next() {
+            mState ^= mState << 13u;
+            mState ^= mState >> 7u;
+            mState ^= mState << 17u;
+            return std::uint32_t(mState >> 32u);
+        }
+
+        /// random value between 0 and 99
+        int percent() { return int(next() % 100u); }
+
+    private:
+        /// state of the generator
+        std::uint64_t mState;
+    };
+
+    /// percent of LEDs that glimmer each frame
+    int glimmerPercent() const noexcept {
+        return mParam >= 0 && mParam <= 100 ? mParam : kDefaultGlimmerPercent;
+    }
+
+    /// level of a triangle wave that rises for kFadeSteps frames and falls for kFadeSteps frames.
+    static float triangle(std::uint64_t step) {
+        auto position = std::uint32_t(step % (2u * kFadeSteps));
+        if (position > kFadeSteps) {
+            position = 2u * kFadeSteps - position;
+        }
+        return float(position) / float(kFadeSteps);
+    }
+
+    /// scales a color by a level between 0 and 1
+    static FrameColor scale(const FrameColor& color, float level) {
+        return {std::uint8_t(std::lround(color.red * level)),
+                std::uint8_t(std::lround(color.green * level)),
+                std::uint8_t(std::lround(color.blue * level))};
+    }
+
+    /// blends between two colors, a level of 0 returns the first color.
+    static FrameColor blend(const FrameColor& first, const FrameColor& second, float level) {
+        return {std::uint8_t(std::lround(first.red + (second.red - first.red) * level)),
+                std::uint8_t(std::lround(first.green + (second.green - first.green) * level)),
+                std::uint8_t(std::lround(first.blue + (second.blue - first.blue) * level))};
+    }
+
+    /// fills the buffer with a single color
+    static void fill(std::vector<FrameColor>& buffer, const FrameColor& color) {
+        for (auto&& value : buffer) {
+            value = color;
+        }
+    }
+
+    /// routine to render
+    ERoutine mRoutine;
+
+    /// number of lights in each frame
+    std::uint32_t mLightCount;
+
+    /// seed for routines with random elements
+    std::uint32_t mSeed;
+
+    /// color for single color routines
+    FrameColor mColor;
+
+    /// palette for multi color routines
+    std::vector<FrameColor> mPalette;
+
+    /// parameter for routines that take one
+    int mParam;
+
+    /// speed of the routine
+    int mSpeed;
+
+    /// brightness of the routine, between 0 and 100
+    int mBrightness;
+};
+
+} // namespace cor
+
+#endif // COR_ROUTINE_SIMULATOR_H
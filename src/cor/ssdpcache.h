@@ -0,0 +1,113 @@
+#ifndef COR_SSDPCACHE_H
+#define COR_SSDPCACHE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include "cor/ssdpmessage.h"
+
+namespace cor {
+
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ *
+ * \brief The SSDPCache class drops repeat SSDP announcements. UPnP devices announce every service
+ * they have every few seconds, so on a busy network most packets repeat something that was
+ * already heard. Each announcement is cached by its sender and USN for its max-age, capped so
+ * that a device that was missed by discovery is still passed along every so often. Only messages
+ * that are new, expired, or from a new sender are passed along.
+ *
+ * Messages without a USN can't be deduplicated, so they are always passed along. Byebye messages
+ * remove their device from the cache and are not passed along, since a device that leaves has
+ * nothing to discover. Searches from other control points are never passed along either.
+ */
+class SSDPCache {
+public:
+    /*!
+     * \brief SSDPCache constructor, all times are in msec.
+     * \param minTTL shortest time an announcement is cached for
+     * \param maxTTL longest time an announcement is cached for, even if its max-age is longer.
+     */
+    SSDPCache(std::int64_t minTTL, std::int64_t maxTTL)
+        : mMinTTL{minTTL},
+          mMaxTTL{maxTTL},
+          mSweepSize{64u} {}
+
+    /// number of announcements cached, including expired ones that have not been swept.
+    std::size_t size() const noexcept { return mExpirations.size(); }
+
+    /// removes all cached announcements, so the next announcement of every device is passed along.
+    void clear() { mExpirations.clear(); }
+
+    /*!
+     * \brief shouldPass checks a message against the cache, and caches it if it is passed along.
+     * \param sender address of the sender of the message
+     * \param message the parsed message
+     * \param now current time
+     * \return true if the message should be passed along to listeners, false if it is a repeat
+     * or has nothing to discover.
+     */
+    bool shouldPass(const std::string& sender, const SSDPMessage& message, std::int64_t now) {
+        if (message.type() == ESSDPType::search) {
+            return false;
+        }
+        const auto& usn = message.usn();
+        if (usn.empty()) {
+            return true;
+        }
+        auto key = sender + "|" + usn;
+        if (message.isByeBye()) {
+            mExpirations.erase(key);
+            return false;
+        }
+
+        auto result = mExpirations.find(key);
+        if (result != mExpirations.end() && result->second > now) {
+            return false;
+        }
+        auto ttl = std::int64_t(message.maxAge()) * 1000;
+        ttl = std::min(std::max(ttl, mMinTTL), mMaxTTL);
+        if (result != mExpirations.end()) {
+            result->second = now + ttl;
+        } else {
+            mExpirations.emplace(key, now + ttl);
+            if (mExpirations.size() >= mSweepSize) {
+                sweep(now);
+            }
+        }
+        return true;
+    }
+
+private:
+    /// removes expired announcements, and sets the size of the next sweep.
+    void sweep(std::int64_t now) {
+        for (auto it = mExpirations.begin(); it != mExpirations.end();) {
+            if (it->second <= now) {
+                it = mExpirations.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        mSweepSize = std::max<std::size_t>(64u, mExpirations.size() * 2u);
+    }
+
+    /// shortest time an announcement is cached for
+    std::int64_t mMinTTL;
+
+    /// longest time an announcement is cached for
+    std::int64_t mMaxTTL;
+
+    /// size of the cache that triggers the next sweep
+    std::size_t mSweepSize;
+
+    /// time each announcement expires, keyed by sender and USN
+    std::unordered_map<std::string, std::int64_t> mExpirations;
+};
+
+} // namespace cor
+
+#endif // COR_SSDPCACHE_H
@@ -0,0 +1,157 @@
+#ifndef COR_SSDPMESSAGE_H
+#define COR_SSDPMESSAGE_H
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace cor {
+
+/// the kind of SSDP message
+enum class ESSDPType { notify, response, search };
+
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ *
+ * \brief The SSDPMessage class is a parsed SSDP packet, as sent by UPnP devices announcing
+ * themselves or answering a search. Packets are parsed once when they are received, so listeners
+ * look up headers by name instead of scanning the raw payload. Header names are case insensitive
+ * in SSDP, so they are stored in lower case, and values are stored with surrounding whitespace
+ * removed.
+ */
+class SSDPMessage {
+public:
+    /// default constructor, for an empty NOTIFY message
+    SSDPMessage() : mType{ESSDPType::notify} {}
+
+    /*!
+     * \brief parse parses the payload of a UDP packet.
+     * \param payload raw payload of the packet
+     * \return the message, and true if the payload is a valid SSDP message.
+     */
+    static std::pair<SSDPMessage, bool> parse(const std::string& payload) {
+        SSDPMessage message;
+        std::size_t lineStart = 0u;
+        bool isFirstLine = true;
+        while (lineStart < payload.size()) {
+            auto lineEnd = payload.find_first_of("\r\n", lineStart);
+            if (lineEnd == std::string::npos) {
+                lineEnd = payload.size();
+            }
+            if (lineEnd > lineStart) {
+                auto line = payload.substr(lineStart, lineEnd - lineStart);
+                if (isFirstLine) {
+                    if (line.compare(0, 6, "NOTIFY") == 0) {
+                        message.mType = ESSDPType::notify;
+                    } else if (line.compare(0, 8, "M-SEARCH") == 0) {
+                        message.mType = ESSDPType::search;
+                    } else if (line.compare(0, 5, "HTTP/") == 0) {
+                        message.mType = ESSDPType::response;
+                    } else {
+                        return std::make_pair(SSDPMessage(), false);
+                    }
+                    isFirstLine = false;
+                } else {
+                    auto colon = line.find(':');
+                    if (colon != std::string::npos) {
+                        auto name = trim(line.substr(0u, colon));
+                        std::transform(name.begin(), name.end(), name.begin(), [](char c) {
+                            return char(std::tolower(static_cast<unsigned char>(c)));
+                        });
+                        message.mHeaders.emplace_back(name, trim(line.substr(colon + 1u)));
+                    }
+                }
+            }
+            lineStart = lineEnd + 1u;
+        }
+        return std::make_pair(message, !isFirstLine);
+    }
+
+    /// the kind of message
+    ESSDPType type() const noexcept { return mType; }
+
+    /// value of a header, or an empty string if the message doesn't have it. Name is lower case.
+    const std::string& header(const std::string& name) const {
+        static const std::string kEmpty;
+        for (const auto& header : mHeaders) {
+            if (header.first == name) {
+                return header.second;
+            }
+        }
+        return kEmpty;
+    }
+
+    /// all headers, in the order they were received
+    const std::vector<std::pair<std::string, std::string>>& headers() const noexcept {
+        return mHeaders;
+    }
+
+    /// unique service name, which identifies the device and service that sent the message.
+    const std::string& usn() const { return header("usn"); }
+
+    /// URL of the description of the device.
+    const std::string& location() const { return header("location"); }
+
+    /// operating system and UPnP stack of the device.
+    const std::string& server() const { return header("server"); }
+
+    /// notification type of a NOTIFY, or search target of a response.
+    const std::string& target() const {
+        if (mType == ESSDPType::notify) {
+            return header("nt");
+        }
+        return header("st");
+    }
+
+    /// true if the message says that the device is leaving the network.
+    bool isByeBye() const { return header("nts") == "ssdp:byebye"; }
+
+    /// seconds the announcement is valid for, from the max-age of CACHE-CONTROL, or 0 if missing.
+    std::uint32_t maxAge() const {
+        const auto& cacheControl = header("cache-control");
+        auto index = cacheControl.find("max-age");
+        if (index == std::string::npos) {
+            return 0u;
+        }
+        index = cacheControl.find('=', index);
+        if (index == std::string::npos) {
+            return 0u;
+        }
+        std::uint32_t age = 0u;
+        for (++index; index < cacheControl.size(); ++index) {
+            auto c = cacheControl[index];
+            if (std::isdigit(static_cast<unsigned char>(c))) {
+                age = age * 10u + std::uint32_t(c - '0');
+            } else if (c != ' ') {
+                break;
+            }
+        }
+        return age;
+    }
+
+private:
+    /// removes spaces and tabs from both ends of a string.
+    static std::string trim(const std::string& string) {
+        auto first = string.find_first_not_of(" \t");
+        if (first == std::string::npos) {
+            return std::string();
+        }
+        auto last = string.find_last_not_of(" \t");
+        return string.substr(first, last - first + 1u);
+    }
+
+    /// the kind of message
+    ESSDPType mType;
+
+    /// headers of the message, with lower case names
+    std::vector<std::pair<std::string, std::string>> mHeaders;
+};
+
+} // namespace cor
+
+#endif // COR_SSDPMESSAGE_H
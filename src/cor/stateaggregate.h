@@ -0,0 +1,325 @@
+#ifndef COR_STATEAGGREGATE_H
+#define COR_STATEAGGREGATE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace cor {
+
+/// the parts of a light's state that are summed up by a StateAggregate.
+struct LightContribution {
+    /// true if the light is on
+    bool isOn = false;
+
+    /// true if the light is reachable
+    bool isReachable = false;
+
+    /// brightness of the light, between 0 and 100
+    std::uint32_t brightness = 0u;
+
+    bool operator==(const LightContribution& rhs) const noexcept {
+        return isOn == rhs.isOn && isReachable == rhs.isReachable && brightness == rhs.brightness;
+    }
+
+    bool operator!=(const LightContribution& rhs) const noexcept { return !(*this == rhs); }
+};
+
+/// running totals of the lights in a selection or a group.
+struct StateCounts {
+    /// number of lights whose state is known
+    std::uint32_t count = 0u;
+
+    /// number of lights that are on
+    std::uint32_t onCount = 0u;
+
+    /// number of lights that are reachable
+    std::uint32_t reachableCount = 0u;
+
+    /// sum of the brightness of all lights
+    std::int64_t brightnessSum = 0;
+
+    /// true if any light is on
+    bool anyOn() const noexcept { return onCount > 0u; }
+
+    /// average brightness of the lights, 0 if there are no lights.
+    std::uint32_t averageBrightness() const noexcept {
+        if (count == 0u || brightnessSum <= 0) {
+            return 0u;
+        }
+        return std::uint32_t(brightnessSum / std::int64_t(count));
+    }
+
+    /// adds (sign = 1) or removes (sign = -1) a light's contribution to the totals.
+    void apply(const LightContribution& light, int sign) {
+        count += sign;
+        if (light.isOn) {
+            onCount += sign;
+        }
+        if (light.isReachable) {
+            reachableCount += sign;
+        }
+        brightnessSum += sign * std::int64_t(light.brightness);
+    }
+
+    bool operator==(const StateCounts& rhs) const noexcept {
+        return count == rhs.count && onCount == rhs.onCount && reachableCount == rhs.reachableCount
+               && brightnessSum == rhs.brightnessSum;
+    }
+
+    bool operator!=(const StateCounts& rhs) const noexcept { return !(*this == rhs); }
+};
+
+/// the totals that changed while updating a StateAggregate.
+struct StateChanges {
+    /// true if the totals of the selection changed
+    bool selection = false;
+
+    /// keys of the groups whose totals changed, without duplicates.
+    std::vector<std::string> groups;
+
+    /// true if nothing changed
+    bool empty() const noexcept { return !selection && groups.empty(); }
+
+    /// marks a group as changed
+    void addGroup(const std::string& key) {
+        if (std::find(groups.begin(), groups.end(), key) == groups.end()) {
+            groups.push_back(key);
+        }
+    }
+};
+
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ *
+ * \brief The StateAggregate class keeps running totals of the states of the selected lights and of
+ * the lights in each group. Each light remembers its last contribution and which totals it belongs
+ * to, so a light update only touches the totals that contain that light, and asking whether any
+ * selected light is on never has to look at the lights themselves.
+ *
+ * A light can be selected or grouped before its state is known, in which case it only starts
+ * counting once updateLight() is called for it.
+ */
+class StateAggregate {
+public:
+    /// totals of the selected lights
+    const StateCounts& selection() const noexcept { return mSelection; }
+
+    /// totals of a group, false if the group is unknown.
+    std::pair<StateCounts, bool> group(const std::string& key) const {
+        auto result = mGroups.find(key);
+        if (result == mGroups.end()) {
+            return std::make_pair(StateCounts(), false);
+        }
+        return std::make_pair(result->second.counts, true);
+    }
+
+    /// number of groups with totals
+    std::size_t groupCount() const noexcept { return mGroups.size(); }
+
+    /// true if the light is selected, whether or not its state is known.
+    bool isSelected(const std::string& key) const {
+        auto result = mLights.find(key);
+        return result != mLights.end() && result->second.isSelected;
+    }
+
+    /// adds or updates the state of a light, recording which totals changed.
+    void updateLight(const std::string& key,
+                     const LightContribution& contribution,
+                     StateChanges& changes) {
+        auto& light = mLights[key];
+        if (light.isKnown && light.contribution == contribution) {
+            return;
+        }
+        if (light.isKnown) {
+            applyLight(light, -1);
+        }
+        light.contribution = contribution;
+        light.isKnown = true;
+        applyLight(light, 1);
+        recordChanges(light, changes);
+    }
+
+    /// removes the state of a light, recording which totals changed. The light stays selected and
+    /// grouped, so it counts again if it comes back.
+    void removeLight(const std::string& key, StateChanges& changes) {
+        auto result = mLights.find(key);
+        if (result == mLights.end() || !result->second.isKnown) {
+            return;
+        }
+        auto& light = result->second;
+        applyLight(light, -1);
+        light.isKnown = false;
+        recordChanges(light, changes);
+        eraseIfUnused(result);
+    }
+
+    /// replaces the selected lights, returns true if the totals of the selection changed.
+    bool setSelection(const std::vector<std::string>& keys) {
+        auto previous = mSelection;
+        for (const auto& key : mSelectedKeys) {
+            auto result = mLights.find(key);
+            if (result != mLights.end()) {
+                result->second.isSelected = false;
+            }
+        }
+        mSelection = StateCounts();
+        mSelectedKeys.clear();
+        for (const auto& key : keys) {
+            auto& light = mLights[key];
+            if (light.isSelected) {
+                continue;
+            }
+            light.isSelected = true;
+            mSelectedKeys.push_back(key);
+            if (light.isKnown) {
+                mSelection.apply(light.contribution, 1);
+            }
+        }
+        eraseUnused();
+        return previous != mSelection;
+    }
+
+    /// adds or replaces a group, returns true if its totals changed.
+    bool setGroup(const std::string& key, const std::vector<std::string>& lightKeys) {
+        auto previous = group(key);
+        removeMembership(key);
+        auto& group = mGroups[key];
+        for (const auto& lightKey : lightKeys) {
+            auto& light = mLights[lightKey];
+            if (std::find(light.groups.begin(), light.groups.end(), key) != light.groups.end()) {
+                continue;
+            }
+            light.groups.push_back(key);
+            group.lights.push_back(lightKey);
+            if (light.isKnown) {
+                group.counts.apply(light.contribution, 1);
+            }
+        }
+        eraseUnused();
+        return !previous.second || previous.first != group.counts;
+    }
+
+    /// removes a group, returns true if the group existed.
+    bool removeGroup(const std::string& key) {
+        if (mGroups.count(key) == 0u) {
+            return false;
+        }
+        removeMembership(key);
+        mGroups.erase(key);
+        eraseUnused();
+        return true;
+    }
+
+    /// keys of all groups with totals
+    std::vector<std::string> groupKeys() const {
+        std::vector<std::string> keys;
+        keys.reserve(mGroups.size());
+        for (const auto& group : mGroups) {
+            keys.push_back(group.first);
+        }
+        return keys;
+    }
+
+private:
+    /// a light and the totals it belongs to
+    struct LightEntry {
+        /// last contribution of the light, only counted if isKnown is true.
+        LightContribution contribution;
+
+        /// true if the state of the light is known
+        bool isKnown = false;
+
+        /// true if the light is selected
+        bool isSelected = false;
+
+        /// keys of the groups that contain the light
+        std::vector<std::string> groups;
+    };
+
+    /// a group's lights and totals
+    struct GroupEntry {
+        /// keys of the lights in the group
+        std::vector<std::string> lights;
+
+        /// totals of the lights in the group
+        StateCounts counts;
+    };
+
+    /// adds or removes a light's contribution to every total it belongs to.
+    void applyLight(const LightEntry& light, int sign) {
+        if (light.isSelected) {
+            mSelection.apply(light.contribution, sign);
+        }
+        for (const auto& key : light.groups) {
+            mGroups[key].counts.apply(light.contribution, sign);
+        }
+    }
+
+    /// records every total that a light belongs to as changed.
+    void recordChanges(const LightEntry& light, StateChanges& changes) {
+        if (light.isSelected) {
+            changes.selection = true;
+        }
+        for (const auto& key : light.groups) {
+            changes.addGroup(key);
+        }
+    }
+
+    /// removes a group from its lights and clears its totals, keeping the group itself.
+    void removeMembership(const std::string& key) {
+        auto result = mGroups.find(key);
+        if (result == mGroups.end()) {
+            return;
+        }
+        for (const auto& lightKey : result->second.lights) {
+            auto light = mLights.find(lightKey);
+            if (light != mLights.end()) {
+                auto& groups = light->second.groups;
+                groups.erase(std::remove(groups.begin(), groups.end(), key), groups.end());
+            }
+        }
+        result->second = GroupEntry();
+    }
+
+    /// erases a light if nothing refers to it anymore.
+    void eraseIfUnused(std::unordered_map<std::string, LightEntry>::iterator light) {
+        const auto& entry = light->second;
+        if (!entry.isKnown && !entry.isSelected && entry.groups.empty()) {
+            mLights.erase(light);
+        }
+    }
+
+    /// erases every light that nothing refers to anymore.
+    void eraseUnused() {
+        for (auto it = mLights.begin(); it != mLights.end();) {
+            const auto& entry = it->second;
+            if (!entry.isKnown && !entry.isSelected && entry.groups.empty()) {
+                it = mLights.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    /// every light that is known, selected, or grouped
+    std::unordered_map<std::string, LightEntry> mLights;
+
+    /// totals of each group
+    std::unordered_map<std::string, GroupEntry> mGroups;
+
+    /// keys of the selected lights
+    std::vector<std::string> mSelectedKeys;
+
+    /// totals of the selected lights
+    StateCounts mSelection;
+};
+
+} // namespace cor
+
+#endif // COR_STATEAGGREGATE_H
@@ -0,0 +1,194 @@
+#ifndef COR_TIMEOUTTABLE_H
+#define COR_TIMEOUTTABLE_H
+
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace cor {
+
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ *
+ * \brief The TimeoutTable class tracks which lights need their timeouts reconciled with the
+ * timeouts stored on their devices, so that a sync only visits those lights instead of all of
+ * them.
+ *
+ * A light needs reconciling when it is new, when its desired timeout changes, or when the
+ * schedules of its group (such as a bridge's schedule list) change. Lights whose timeout is a
+ * schedule that counts down from the last time they were used also need reconciling when there
+ * is activity, but only if their schedule was last synced more than the refresh interval ago.
+ * Those lights are kept in a priority queue ordered by when their schedule can next be
+ * refreshed, so handling activity only pops the lights that are due.
+ *
+ * Lights whose device state is not known yet cannot be reconciled, and are kept aside as
+ * unavailable instead of dirty, so they do not hold up a sync. They are retried on the next sync.
+ */
+template <typename Key, typename Hash = std::hash<Key>>
+class TimeoutTable {
+public:
+    /// constructor, the refresh interval is in msec.
+    explicit TimeoutTable(std::int64_t refreshInterval = 60000)
+        : mRefreshInterval{refreshInterval} {}
+
+    /// number of lights in the table
+    std::size_t size() const noexcept { return mEntries.size(); }
+
+    /// number of lights that need reconciling
+    std::size_t dirtyCount() const noexcept { return mDirty.size(); }
+
+    /// number of lights that could not be reconciled since their device state is unknown
+    std::size_t unavailableCount() const noexcept { return mUnavailable.size(); }
+
+    /*!
+     * \brief desiredTimeout sets the timeout a light should have. The light is marked as dirty if
+     * it is new or if its timeout changed.
+     * \param key unique ID of the light
+     * \param minutes timeout in minutes, 0 if timeouts are disabled.
+     * \param group group of lights that share schedules, such as a protocol.
+     * \param refreshOnActivity true if the timeout needs to be refreshed when there is activity.
+     */
+    void desiredTimeout(const Key& key, int minutes, int group, bool refreshOnActivity) {
+        auto result = mEntries.find(key);
+        if (result == mEntries.end()) {
+            mEntries.emplace(key, Entry{minutes, group, refreshOnActivity, 0u});
+            mDirty.insert(key);
+        } else if (result->second.minutes != minutes) {
+            result->second.minutes = minutes;
+            mDirty.insert(key);
+        }
+    }
+
+    /// removes a light from the table, returns true if it was in the table.
+    bool remove(const Key& key) {
+        mDirty.erase(key);
+        mUnavailable.erase(key);
+        return mEntries.erase(key) > 0u;
+    }
+
+    /// marks a light as needing reconciling
+    void markDirty(const Key& key) {
+        if (mEntries.find(key) != mEntries.end()) {
+            mDirty.insert(key);
+        }
+    }
+
+    /// marks all lights in a group as needing reconciling, used when the group's schedules change.
+    void markGroupDirty(int group) {
+        for (const auto& entry : mEntries) {
+            if (entry.second.group == group) {
+                mDirty.insert(entry.first);
+            }
+        }
+    }
+
+    /*!
+     * \brief activity marks every light that refreshes on activity and that was last synced more
+     * than the refresh interval ago as dirty.
+     * \param now current time, in msec.
+     */
+    void activity(std::int64_t now) {
+        while (!mRefreshQueue.empty() && mRefreshQueue.top().refreshTime <= now) {
+            auto refresh = mRefreshQueue.top();
+            mRefreshQueue.pop();
+            auto result = mEntries.find(refresh.key);
+            // skip lights that were removed or synced again since this was queued.
+            if (result != mEntries.end() && result->second.generation == refresh.generation) {
+                mDirty.insert(refresh.key);
+            }
+        }
+    }
+
+    /// marks a light whose device state is unknown, so it is not dirty until retryUnavailable().
+    void unavailable(const Key& key) {
+        if (mEntries.find(key) != mEntries.end()) {
+            mUnavailable.insert(key);
+        }
+    }
+
+    /// marks every unavailable light as dirty, used when a new sync starts.
+    void retryUnavailable() {
+        mDirty.insert(mUnavailable.begin(), mUnavailable.end());
+        mUnavailable.clear();
+    }
+
+    /// returns all lights that need reconciling and clears them. Lights that fail to reconcile
+    /// should be marked as dirty again.
+    std::vector<Key> takeDirty() {
+        std::vector<Key> dirty(mDirty.begin(), mDirty.end());
+        mDirty.clear();
+        return dirty;
+    }
+
+    /*!
+     * \brief synced records that a light's timeout matches its device.
+     * \param key unique ID of the light
+     * \param now current time, in msec.
+     */
+    void synced(const Key& key, std::int64_t now) {
+        auto result = mEntries.find(key);
+        if (result == mEntries.end()) {
+            return;
+        }
+        auto& entry = result->second;
+        ++entry.generation;
+        if (entry.refreshOnActivity && entry.minutes > 0) {
+            mRefreshQueue.push(Refresh{now + mRefreshInterval, entry.generation, key});
+        }
+    }
+
+private:
+    /// the timeout settings of a light
+    struct Entry {
+        /// desired timeout in minutes
+        int minutes;
+
+        /// group of lights that share schedules
+        int group;
+
+        /// true if the timeout needs to be refreshed on activity
+        bool refreshOnActivity;
+
+        /// incremented every sync, so older entries in mRefreshQueue can be skipped.
+        std::uint64_t generation;
+    };
+
+    /// the earliest time a light's timeout can be refreshed by activity
+    struct Refresh {
+        /// time in msec
+        std::int64_t refreshTime;
+
+        /// generation of the light when this was queued
+        std::uint64_t generation;
+
+        /// unique ID of the light
+        Key key;
+
+        /// orders the queue so the earliest refresh is on top.
+        bool operator>(const Refresh& rhs) const { return refreshTime > rhs.refreshTime; }
+    };
+
+    /// msec after a sync before activity refreshes a light's timeout.
+    std::int64_t mRefreshInterval;
+
+    /// timeout settings of each light
+    std::unordered_map<Key, Entry, Hash> mEntries;
+
+    /// lights that need reconciling
+    std::unordered_set<Key, Hash> mDirty;
+
+    /// lights that could not be reconciled since their device state is unknown
+    std::unordered_set<Key, Hash> mUnavailable;
+
+    /// lights waiting to be refreshed by activity, earliest first.
+    std::priority_queue<Refresh, std::vector<Refresh>, std::greater<Refresh>> mRefreshQueue;
+};
+
+} // namespace cor
+
+#endif // COR_TIMEOUTTABLE_H
@@ -0,0 +1,159 @@
+#ifndef COR_TIMINGWHEEL_H
+#define COR_TIMINGWHEEL_H
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+namespace cor {
+
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ *
+ * \brief The TimingWheel class is a hashed timing wheel that tracks a deadline for each key.
+ * Deadlines are sorted into slots by the tick they expire on, so scheduling, rescheduling, and
+ * cancelling a key is constant time, and advancing the wheel only visits the slots that have
+ * passed since the last advance and the keys in those slots. Keys whose deadline is more than one
+ * revolution of the wheel away stay in their slot until a later revolution reaches them.
+ *
+ * Times are in msec and must come from a monotonic clock.
+ */
+template <typename Key, typename Hash = std::hash<Key>>
+class TimingWheel {
+public:
+    /*!
+     * \brief constructor
+     * \param tickInterval msec covered by each slot of the wheel.
+     * \param slotCount number of slots in the wheel, rounded up to a power of two.
+     */
+    explicit TimingWheel(std::int64_t tickInterval = 100, std::size_t slotCount = 256u)
+        : mTickInterval{tickInterval < 1 ? 1 : tickInterval},
+          mCurrentTick{0} {
+        std::size_t size = 1u;
+        while (size < slotCount) {
+            size <<= 1u;
+        }
+        mSlots.resize(size);
+        mMask = size - 1u;
+    }
+
+    /// number of keys with a deadline
+    std::size_t size() const noexcept { return mEntries.size(); }
+
+    /// true if the key has a deadline
+    bool contains(const Key& key) const { return mEntries.find(key) != mEntries.end(); }
+
+    /*!
+     * \brief schedule sets the deadline of a key, replacing its previous deadline if it has one.
+     * A deadline that has already passed expires on the next advance.
+     */
+    void schedule(const Key& key, std::int64_t deadline) {
+        auto tick = std::max(deadline / mTickInterval, mCurrentTick);
+        auto& slot = mSlots[std::size_t(tick) & mMask];
+        auto result = mEntries.find(key);
+        if (result == mEntries.end()) {
+            slot.push_back(key);
+            mEntries.emplace(key, Entry{deadline, &slot, std::prev(slot.end())});
+        } else {
+            auto& entry = result->second;
+            // move the existing node instead of allocating a new one.
+            slot.splice(slot.end(), *entry.slot, entry.position);
+            entry.deadline = deadline;
+            entry.slot = &slot;
+        }
+    }
+
+    /// removes the deadline of a key, returns true if it had one.
+    bool cancel(const Key& key) {
+        auto result = mEntries.find(key);
+        if (result == mEntries.end()) {
+            return false;
+        }
+        result->second.slot->erase(result->second.position);
+        mEntries.erase(result);
+        return true;
+    }
+
+    /*!
+     * \brief advance moves the wheel forward to the given time, removes every key whose deadline
+     * has passed, and calls the function with each of them. The function may schedule keys again.
+     * \param now current time, in msec.
+     * \param function called as function(const Key&)
+     * \return the number of keys that expired.
+     */
+    template <typename Function>
+    std::size_t advance(std::int64_t now, Function&& function) {
+        auto targetTick = now / mTickInterval;
+        if (targetTick < mCurrentTick) {
+            return 0u;
+        }
+        // visiting every slot once covers all deadlines, no matter how far time jumped.
+        auto firstTick = std::max(mCurrentTick, targetTick - std::int64_t(mMask));
+        mCurrentTick = targetTick + 1;
+
+        mExpired.clear();
+        for (auto tick = firstTick; tick <= targetTick; ++tick) {
+            auto& slot = mSlots[std::size_t(tick) & mMask];
+            for (auto it = slot.begin(); it != slot.end();) {
+                auto entry = mEntries.find(*it);
+                if (entry->second.deadline <= now) {
+                    mExpired.push_back(std::move(*it));
+                    mEntries.erase(entry);
+                    it = slot.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+
+        // call the function after the slots are updated, so it can safely reschedule keys.
+        for (const auto& key : mExpired) {
+            function(key);
+        }
+        return mExpired.size();
+    }
+
+    /// removes all deadlines
+    void clear() {
+        for (auto& slot : mSlots) {
+            slot.clear();
+        }
+        mEntries.clear();
+    }
+
+private:
+    /// the deadline of a key and where it is stored in the wheel.
+    struct Entry {
+        std::int64_t deadline;
+        std::list<Key>* slot;
+        typename std::list<Key>::iterator position;
+    };
+
+    /// msec covered by each slot.
+    std::int64_t mTickInterval;
+
+    /// the next tick to be processed by advance.
+    std::int64_t mCurrentTick;
+
+    /// mask to convert a tick to an index in mSlots.
+    std::size_t mMask;
+
+    /// keys stored by the tick their deadline falls on, modulo the size of the wheel.
+    std::vector<std::list<Key>> mSlots;
+
+    /// the deadline and position of each key
+    std::unordered_map<Key, Entry, Hash> mEntries;
+
+    /// keys expired by the current advance, reused between advances.
+    std::vector<Key> mExpired;
+};
+
+} // namespace cor
+
+#endif // COR_TIMINGWHEEL_H
@@ -0,0 +1,102 @@
+#ifndef COR_TOKENIZER_H
+#define COR_TOKENIZER_H
+
+#include <algorithm>
+#include <bitset>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace cor {
+
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ *
+ * \brief The Tokenizer class splits strings on a set of single character delimiters. The
+ * delimiters are compiled into a lookup table once, so a tokenizer should be built once and kept,
+ * typically as a constant in the file that uses it. Tokens are views into the input, so splitting
+ * never copies or allocates, but the input must outlive the tokens.
+ *
+ * By default, empty tokens are skipped, so consecutive delimiters act as one. When empty tokens
+ * are kept, the input is split like std::getline would: an empty token is returned between
+ * consecutive delimiters, but not after a trailing delimiter.
+ *
+ * Char is char for bytes, and char16_t for the UTF-16 data of a QString.
+ */
+template <typename Char>
+class Tokenizer {
+public:
+    /// a token, which points into the input it was split from.
+    using Token = std::basic_string_view<Char>;
+
+    /// constructor, takes every delimiter as a single character.
+    explicit Tokenizer(Token delimiters, bool skipEmpty = true) : mSkipEmpty{skipEmpty} {
+        for (auto delimiter : delimiters) {
+            auto unit = codeUnit(delimiter);
+            if (unit < kTableSize) {
+                mTable.set(unit);
+            } else {
+                mWideDelimiters.push_back(unit);
+            }
+        }
+    }
+
+    /// true if the character is a delimiter
+    bool isDelimiter(Char c) const noexcept {
+        auto unit = codeUnit(c);
+        if (unit < kTableSize) {
+            return mTable.test(unit);
+        }
+        return std::find(mWideDelimiters.begin(), mWideDelimiters.end(), unit)
+               != mWideDelimiters.end();
+    }
+
+    /// calls onToken with each token of the input, in order.
+    template <typename Function>
+    void forEach(Token input, Function onToken) const {
+        std::size_t start = 0u;
+        for (std::size_t i = 0u; i < input.size(); ++i) {
+            if (isDelimiter(input[i])) {
+                if (!mSkipEmpty || i > start) {
+                    onToken(input.substr(start, i - start));
+                }
+                start = i + 1u;
+            }
+        }
+        if (start < input.size()) {
+            onToken(input.substr(start));
+        }
+    }
+
+    /// splits the input into its tokens.
+    std::vector<Token> split(Token input) const {
+        std::vector<Token> tokens;
+        forEach(input, [&tokens](Token token) { tokens.push_back(token); });
+        return tokens;
+    }
+
+private:
+    /// number of code units stored in the lookup table, the rest are searched.
+    static constexpr std::uint32_t kTableSize = 256u;
+
+    /// the unsigned code unit of a character
+    static std::uint32_t codeUnit(Char c) noexcept {
+        return std::uint32_t(static_cast<std::make_unsigned_t<Char>>(c));
+    }
+
+    /// true to skip empty tokens
+    bool mSkipEmpty;
+
+    /// delimiters with code units below kTableSize
+    std::bitset<kTableSize> mTable;
+
+    /// delimiters with code units of kTableSize or more
+    std::vector<std::uint32_t> mWideDelimiters;
+};
+
+} // namespace cor
+
+#endif // COR_TOKENIZER_H
@@ -0,0 +1,236 @@
+#ifndef COR_TRAFFICLOG_H
+#define COR_TRAFFICLOG_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <istream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace cor {
+
+/// direction of a traffic event. For HTTP, a request is sent and a response is received.
+enum class ETrafficDirection { sent, received };
+
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ *
+ * \brief The TrafficEvent struct is a packet or HTTP message that crossed a CommType's boundary,
+ * as stored by a TrafficLog.
+ */
+struct TrafficEvent {
+    /// msec since the capture started
+    std::int64_t time = 0;
+
+    /// CommType that owns the traffic, such as "UDP" or "Hue".
+    std::string source;
+
+    /// true if the event was sent to a device, false if it was received from one.
+    ETrafficDirection direction = ETrafficDirection::sent;
+
+    /// IP address or serial port of the device, or the URL of an HTTP message.
+    std::string endpoint;
+
+    /// HTTP method of a request or response, such as "GET". Empty for packets.
+    std::string method;
+
+    /// pairs an HTTP response with its request, 0 for packets.
+    std::uint64_t requestID = 0u;
+
+    /// error of an HTTP response, 0 if it succeeded.
+    int status = 0;
+
+    /// raw bytes of the packet or HTTP body
+    std::string payload;
+
+    /// true if the event is part of an HTTP exchange, false if it is a packet.
+    bool isHTTP() const noexcept { return !method.empty(); }
+};
+
+namespace traffic {
+
+/// escapes the characters that would break a line of a traffic log.
+inline std::string escape(std::string_view value) {
+    std::string escaped;
+    escaped.reserve(value.size());
+    for (auto c : value) {
+        auto unit = static_cast<unsigned char>(c);
+        if (unit == '%' || unit < 0x20u || unit == 0x7Fu) {
+            char code[4];
+            std::snprintf(code, sizeof(code), "%%%02X", unsigned(unit));
+            escaped += code;
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+/// reverses escape(), returns false if the value has a malformed escape.
+inline bool unescape(std::string_view value, std::string* unescaped) {
+    unescaped->clear();
+    unescaped->reserve(value.size());
+    for (std::size_t i = 0u; i < value.size(); ++i) {
+        if (value[i] != '%') {
+            *unescaped += value[i];
+            continue;
+        }
+        if (i + 2u >= value.size()) {
+            return false;
+        }
+        unsigned code = 0u;
+        for (auto digit : value.substr(i + 1u, 2u)) {
+            code *= 16u;
+            if (digit >= '0' && digit <= '9') {
+                code += unsigned(digit - '0');
+            } else if (digit >= 'A' && digit <= 'F') {
+                code += unsigned(digit - 'A' + 10);
+            } else {
+                return false;
+            }
+        }
+        *unescaped += char(code);
+        i += 2u;
+    }
+    return true;
+}
+
+} // namespace traffic
+
+/// encodes an event as a single line of tab separated fields, without the newline.
+inline std::string encodeTrafficEvent(const TrafficEvent& event) {
+    std::string line = std::to_string(event.time);
+    line += '\t';
+    line += traffic::escape(event.source);
+    line += event.direction == ETrafficDirection::sent ? "\tsent\t" : "\treceived\t";
+    line += traffic::escape(event.endpoint);
+    line += '\t';
+    line += traffic::escape(event.method);
+    line += '\t';
+    line += std::to_string(event.requestID);
+    line += '\t';
+    line += std::to_string(event.status);
+    line += '\t';
+    line += traffic::escape(event.payload);
+    return line;
+}
+
+/// decodes a line written by encodeTrafficEvent, returns false if the line is malformed.
+inline std::pair<TrafficEvent, bool> decodeTrafficEvent(std::string_view line) {
+    std::vector<std::string_view> fields;
+    std::size_t start = 0u;
+    for (std::size_t i = 0u; i <= line.size(); ++i) {
+        if (i == line.size() || line[i] == '\t') {
+            fields.push_back(line.substr(start, i - start));
+            start = i + 1u;
+        }
+    }
+    TrafficEvent event;
+    if (fields.size() != 8u || (fields[2] != "sent" && fields[2] != "received")) {
+        return std::make_pair(event, false);
+    }
+    try {
+        event.time = std::stoll(std::string(fields[0]));
+        event.requestID = std::stoull(std::string(fields[5]));
+        event.status = std::stoi(std::string(fields[6]));
+    } catch (const std::exception&) {
+        return std::make_pair(event, false);
+    }
+    event.direction =
+        fields[2] == "sent" ? ETrafficDirection::sent : ETrafficDirection::received;
+    bool isValid = traffic::unescape(fields[1], &event.source)
+                   && traffic::unescape(fields[3], &event.endpoint)
+                   && traffic::unescape(fields[4], &event.method)
+                   && traffic::unescape(fields[7], &event.payload);
+    return std::make_pair(event, isValid);
+}
+
+/// reads every event of a traffic log, skipping malformed lines.
+inline std::vector<TrafficEvent> readTrafficLog(std::istream& input) {
+    std::vector<TrafficEvent> events;
+    std::string line;
+    while (std::getline(input, line)) {
+        auto result = decodeTrafficEvent(line);
+        if (result.second) {
+            events.push_back(std::move(result.first));
+        }
+    }
+    return events;
+}
+
+/*!
+ * \brief The TrafficLog class captures the traffic of the CommTypes, so that it can be replayed
+ * later by a TrafficReplay without the devices present. Each event is timestamped when it is
+ * recorded. A log either keeps its events in memory, or writes each one to a file as a line of
+ * tab separated fields, flushing it so that a capture of a crash is complete. Events can be
+ * recorded from any thread.
+ */
+class TrafficLog {
+public:
+    /// constructor, keeps the events in memory.
+    TrafficLog() : mStart{Clock::now()}, mWritesFile{false} {}
+
+    /// constructor, writes the events to a file, replacing its contents.
+    explicit TrafficLog(const std::string& path)
+        : mStart{Clock::now()},
+          mWritesFile{true},
+          mFile(path) {}
+
+    /// false if the log was given a file and it could not be opened.
+    bool isOpen() const { return !mWritesFile || mFile.is_open(); }
+
+    /// msec since the log was created
+    std::int64_t elapsed() const {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - mStart)
+            .count();
+    }
+
+    /// records an event, overwriting its time with the current time of the log.
+    void record(TrafficEvent event) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        // stamped under the lock, so the events of a file are in order.
+        event.time = elapsed();
+        if (mWritesFile) {
+            mFile << encodeTrafficEvent(event) << '\n';
+            mFile.flush();
+        } else {
+            mEvents.push_back(std::move(event));
+        }
+    }
+
+    /// events recorded in memory, empty if the log writes to a file.
+    std::vector<TrafficEvent> events() const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mEvents;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    /// time the log was created
+    Clock::time_point mStart;
+
+    /// true if the events are written to mFile, false if they are kept in memory.
+    bool mWritesFile;
+
+    /// file the events are written to
+    std::ofstream mFile;
+
+    /// events recorded in memory
+    std::vector<TrafficEvent> mEvents;
+
+    /// guards mFile and mEvents
+    mutable std::mutex mMutex;
+};
+
+} // namespace cor
+
+#endif // COR_TRAFFICLOG_H
@@ -0,0 +1,211 @@
+#ifndef COR_TRAFFICREPLAY_H
+#define COR_TRAFFICREPLAY_H
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "cor/trafficlog.h"
+
+namespace cor {
+
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ *
+ * \brief The TrafficReplay class plays back a capture made by a TrafficLog in place of the
+ * devices. Packets that were received from devices are taken in the order and at the times they
+ * were captured. HTTP requests are answered with the response that was captured for the same
+ * request, after the latency that was captured. Times are scaled by the speed of the replay, so a
+ * capture can be replayed at real speed or accelerated.
+ *
+ * Requests are matched by their CommType, method, and URL, and by their body when possible. Each
+ * captured response is returned once, in order, and once they run out the last one is repeated,
+ * so polling keeps working after the capture ends. Packets sent to devices are not replayed, since
+ * nothing listens to them.
+ */
+class TrafficReplay {
+public:
+    /// constructor. A speed of 2.0 replays the capture twice as fast as it was captured.
+    TrafficReplay(std::vector<TrafficEvent> events, double speed)
+        : mSpeed{speed > 0.0 ? speed : 1.0},
+          mNextPacket{0u},
+          mMissedRequests{0u} {
+        std::unordered_map<std::string, TrafficEvent> pendingRequests;
+        for (auto& event : events) {
+            if (!event.isHTTP()) {
+                if (event.direction == ETrafficDirection::received) {
+                    mPackets.push_back(std::move(event));
+                }
+                continue;
+            }
+            auto exchangeKey =
+                event.source + '\n' + std::to_string(event.requestID) + '\n' + event.endpoint;
+            if (event.direction == ETrafficDirection::sent) {
+                pendingRequests[exchangeKey] = std::move(event);
+                continue;
+            }
+            auto request = pendingRequests.find(exchangeKey);
+            if (request == pendingRequests.end()) {
+                continue;
+            }
+            const auto& sent = request->second;
+            auto& responses = mResponses[requestKey(sent.source, sent.method, sent.endpoint)];
+            responses.bodies[sent.payload].indices.push_back(responses.exchanges.size());
+            responses.exchanges.push_back(
+                Exchange{std::max<std::int64_t>(0, event.time - sent.time), std::move(event)});
+            responses.isReplayed.push_back(false);
+            pendingRequests.erase(request);
+        }
+        std::stable_sort(mPackets.begin(), mPackets.end(), [](const auto& a, const auto& b) {
+            return a.time < b.time;
+        });
+    }
+
+    /// speed of the replay
+    double speed() const noexcept { return mSpeed; }
+
+    /// msec into the replay that the next packet is received, -1 if there are none left.
+    std::int64_t nextPacketTime() const noexcept {
+        if (mNextPacket >= mPackets.size()) {
+            return -1;
+        }
+        return scale(mPackets[mNextPacket].time);
+    }
+
+    /// true if every packet has been taken
+    bool isFinished() const noexcept { return mNextPacket >= mPackets.size(); }
+
+    /// takes the packets received up to the given msec into the replay, in order.
+    std::vector<TrafficEvent> takePackets(std::int64_t now) {
+        std::vector<TrafficEvent> packets;
+        while (mNextPacket < mPackets.size() && scale(mPackets[mNextPacket].time) <= now) {
+            packets.push_back(mPackets[mNextPacket]);
+            ++mNextPacket;
+        }
+        return packets;
+    }
+
+    /*!
+     * \brief respond finds the captured response to an HTTP request.
+     * \param source CommType that sends the request
+     * \param method HTTP method of the request, such as "GET"
+     * \param endpoint URL of the request
+     * \param body body of the request
+     * \return the response, with its time set to the msec it should take at the speed of the
+     * replay, and false if the capture has no response to the request.
+     */
+    std::pair<TrafficEvent, bool> respond(const std::string& source,
+                                          const std::string& method,
+                                          const std::string& endpoint,
+                                          const std::string& body) {
+        auto result = mResponses.find(requestKey(source, method, endpoint));
+        if (result == mResponses.end()) {
+            ++mMissedRequests;
+            return std::make_pair(TrafficEvent(), false);
+        }
+        const auto& exchange = takeExchange(result->second, body);
+        auto response = exchange.response;
+        response.time = scale(exchange.latency);
+        return std::make_pair(response, true);
+    }
+
+    /// number of HTTP requests that had no captured response
+    std::size_t missedRequests() const noexcept { return mMissedRequests; }
+
+private:
+    /// a captured response, and the msec between its request and it.
+    struct Exchange {
+        /// msec between the request and the response
+        std::int64_t latency;
+
+        /// the response
+        TrafficEvent response;
+    };
+
+    /// the responses captured for requests with the same body, as indices into all responses.
+    struct BodyResponses {
+        /// indices of the responses, in order.
+        std::vector<std::size_t> indices;
+
+        /// position in indices of the first response that may not be replayed yet
+        std::size_t next = 0u;
+    };
+
+    /// the responses captured for a request, in order.
+    struct Responses {
+        /// the responses
+        std::vector<Exchange> exchanges;
+
+        /// true for each response that has been replayed
+        std::vector<bool> isReplayed;
+
+        /// index of the first response that may not be replayed yet
+        std::size_t next = 0u;
+
+        /// the responses of each body the request was captured with
+        std::unordered_map<std::string, BodyResponses> bodies;
+    };
+
+    /// key of a request
+    static std::string requestKey(const std::string& source,
+                                  const std::string& method,
+                                  const std::string& endpoint) {
+        return source + '\n' + method + '\n' + endpoint;
+    }
+
+    /*!
+     * \brief takeExchange takes the next response that has not been replayed. A response captured
+     * for the same body is preferred over one captured for another body. Once every candidate is
+     * replayed, the last one is repeated.
+     */
+    static const Exchange& takeExchange(Responses& responses, const std::string& body) {
+        std::size_t index = 0u;
+        auto result = responses.bodies.find(body);
+        if (result != responses.bodies.end()) {
+            auto& sameBody = result->second;
+            while (sameBody.next < sameBody.indices.size()
+                   && responses.isReplayed[sameBody.indices[sameBody.next]]) {
+                ++sameBody.next;
+            }
+            index = sameBody.next < sameBody.indices.size() ? sameBody.indices[sameBody.next]
+                                                            : sameBody.indices.back();
+        } else {
+            while (responses.next < responses.exchanges.size()
+                   && responses.isReplayed[responses.next]) {
+                ++responses.next;
+            }
+            index = std::min(responses.next, responses.exchanges.size() - 1u);
+        }
+        responses.isReplayed[index] = true;
+        return responses.exchanges[index];
+    }
+
+    /// converts msec of the capture to msec of the replay
+    std::int64_t scale(std::int64_t time) const noexcept {
+        return std::int64_t(double(time) / mSpeed);
+    }
+
+    /// speed of the replay
+    double mSpeed;
+
+    /// packets received from devices, in order.
+    std::vector<TrafficEvent> mPackets;
+
+    /// index of the next packet to take
+    std::size_t mNextPacket;
+
+    /// captured responses, keyed by their request without its body.
+    std::unordered_map<std::string, Responses> mResponses;
+
+    /// number of HTTP requests that had no captured response
+    std::size_t mMissedRequests;
+};
+
+} // namespace cor
+
+#endif // COR_TRAFFICREPLAY_H
@@ -0,0 +1,92 @@
+#ifndef COR_TRANSITIONPLANNER_H
+#define COR_TRANSITIONPLANNER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+
+namespace cor {
+
+/// how a kind of device moves from its current state to a new one.
+struct TransitionCapability {
+    /// true if the device can fade to a new state by itself
+    bool isNative = false;
+
+    /// shortest time between two commands to the same device, in msec
+    std::uint32_t interval = 100u;
+
+    /// shortest fade the device accepts, in msec. fades are rounded up to it.
+    std::uint32_t resolution = 1u;
+};
+
+/// what to send to a device that is out of sync.
+struct TransitionStep {
+    /// true if a command should be sent now, false if the device should wait for a later pass
+    bool shouldSend = false;
+
+    /// fade to send with the command, in msec. Always 0 for devices without native transitions.
+    std::uint32_t fade = 0u;
+};
+
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ *
+ * \brief The TransitionPlanner class decides when a device that is out of sync gets its next
+ * command, and how long the device should fade to it.
+ *
+ * Dragging a slider changes the desired state of lights many times per second. Devices that can
+ * fade by themselves only get a command once per interval of their TransitionCapability, and
+ * each command asks them to fade to the latest state over that same interval. The device then
+ * moves smoothly through the values in between without being sent any of them, and arrives at
+ * each state about when the next one is sent. Devices without native transitions are sent the
+ * latest state once per interval, with no fade.
+ *
+ * Nothing is queued: a device that has to wait is still out of sync, so the next pass of the
+ * sync routine plans it again, with whatever the desired state is by then.
+ */
+template <typename Key, typename Hash = std::hash<Key>>
+class TransitionPlanner {
+public:
+    /// number of devices that have been sent a command
+    std::size_t size() const noexcept { return mLastSent.size(); }
+
+    /*!
+     * \brief plan decides whether a device that is out of sync should be sent a command.
+     * \param key unique ID of the device
+     * \param capability how the device handles transitions
+     * \param now current time, in msec
+     * \return whether to send a command now, and the fade to send with it.
+     */
+    TransitionStep plan(const Key& key,
+                        const TransitionCapability& capability,
+                        std::int64_t now) const {
+        auto result = mLastSent.find(key);
+        if (result != mLastSent.end() && now - result->second < std::int64_t(capability.interval)) {
+            return {};
+        }
+        TransitionStep step;
+        step.shouldSend = true;
+        if (capability.isNative) {
+            auto resolution = std::max(capability.resolution, 1u);
+            step.fade = (capability.interval + resolution - 1u) / resolution * resolution;
+        }
+        return step;
+    }
+
+    /// records that a command was sent to a device.
+    void sent(const Key& key, std::int64_t now) { mLastSent[key] = now; }
+
+    /// forgets a device, its next command is sent without waiting.
+    void remove(const Key& key) { mLastSent.erase(key); }
+
+private:
+    /// time the last command was sent to each device, in msec
+    std::unordered_map<Key, std::int64_t, Hash> mLastSent;
+};
+
+} // namespace cor
+
+#endif // COR_TRANSITIONPLANNER_H
@@ -0,0 +1,284 @@
+#ifndef COR_VIRTUALLIST_H
+#define COR_VIRTUALLIST_H
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace cor {
+
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ *
+ * \brief The VirtualList class is the model behind a scrolling list that only creates widgets for
+ * the rows that are visible. It keeps the rows sorted by a cached sort key, so sorting never has
+ * to look at the widgets, and it assigns each visible row to a slot. A slot is a reusable widget
+ * owned by the view, and when a row scrolls out of view, its slot is reused for a row that
+ * scrolls in.
+ *
+ * Rows are sorted lazily, so adding, updating, or removing many rows in a row only sorts once, on
+ * the next call that needs the sorted order. Changing the order or contents of the rows rebinds
+ * every visible row on the next call to bind().
+ */
+template <typename Key, typename SortKey, typename Hash = std::hash<Key>>
+class VirtualList {
+public:
+    /// a visible row that needs its slot updated to show it.
+    struct Binding {
+        /// index of the row, in sorted order
+        std::size_t row;
+
+        /// slot that shows the row
+        std::size_t slot;
+    };
+
+    /// value for a row or slot that doesn't exist.
+    static constexpr std::size_t kInvalid = std::numeric_limits<std::size_t>::max();
+
+    /// constructor, overscan is the number of extra rows bound above and below the visible rows.
+    explicit VirtualList(std::size_t overscan = 2u)
+        : mOverscan{overscan},
+          mIsSorted{true},
+          mRebindAll{false},
+          mFirst{0u},
+          mLast{0u} {}
+
+    /// number of rows
+    std::size_t size() const noexcept { return mRows.size(); }
+
+    /// number of slots that have been created. This never shrinks, since slots are reused.
+    std::size_t slotCount() const noexcept { return mSlotRows.size(); }
+
+    /// adds a row, or updates its sort key if it already exists.
+    void insert(const Key& key, const SortKey& sortKey) {
+        auto result = mSortKeys.find(key);
+        if (result == mSortKeys.end()) {
+            mSortKeys.emplace(key, sortKey);
+            mRowIndices.emplace(key, mRows.size());
+            mRows.push_back(Row{sortKey, key});
+            markUnsorted();
+        } else if (!(result->second == sortKey)) {
+            result->second = sortKey;
+            mRows[mRowIndices[key]].sortKey = sortKey;
+            markUnsorted();
+        }
+    }
+
+    /// removes a row, returns true if it existed.
+    bool remove(const Key& key) {
+        if (mSortKeys.erase(key) == 0u) {
+            return false;
+        }
+        // the last row takes the place of the removed row, and the rows are sorted again later.
+        auto result = mRowIndices.find(key);
+        auto index = result->second;
+        mRowIndices.erase(result);
+        if (index + 1u != mRows.size()) {
+            mRows[index] = std::move(mRows.back());
+            mRowIndices[mRows[index].key] = index;
+        }
+        mRows.pop_back();
+        markUnsorted();
+        return true;
+    }
+
+    /// removes all rows. Slots are kept so they can be reused.
+    void clear() {
+        mRows.clear();
+        mSortKeys.clear();
+        mRowIndices.clear();
+        mIsSorted = true;
+        mRebindAll = true;
+    }
+
+    /// key of the row at the given index, in sorted order.
+    const Key& key(std::size_t row) {
+        ensureSorted();
+        return mRows[row].key;
+    }
+
+    /// index of the row of a key, in sorted order, or kInvalid if it does not exist.
+    std::size_t row(const Key& key) {
+        ensureSorted();
+        auto result = mRowIndices.find(key);
+        if (result == mRowIndices.end()) {
+            return kInvalid;
+        }
+        return result->second;
+    }
+
+    /// slot showing a key, or kInvalid if the key is not bound to a slot. This never sorts, since
+    /// no row is bound while the rows are waiting for a sort.
+    std::size_t slot(const Key& key) {
+        if (mRebindAll) {
+            return kInvalid;
+        }
+        auto index = row(key);
+        if (index == kInvalid) {
+            return kInvalid;
+        }
+        auto result = mRowSlots.find(index);
+        if (result == mRowSlots.end()) {
+            return kInvalid;
+        }
+        return result->second;
+    }
+
+    /// forces every visible row to be rebound on the next call to bind().
+    void invalidate() noexcept { mRebindAll = true; }
+
+    /*!
+     * \brief bind computes the rows that are visible and assigns each one a slot. Slots of rows
+     * that are no longer visible are reused first, and new slots are only created when there are
+     * none to reuse.
+     * \param top position of the top of the viewport, relative to the top of the first row.
+     * \param height height of the viewport.
+     * \param rowHeight height of each row.
+     * \return the rows that need to be shown in their slot. Rows that were already bound to a slot
+     * are not returned.
+     */
+    std::vector<Binding> bind(int top, int height, int rowHeight) {
+        ensureSorted();
+        std::size_t first = 0u;
+        std::size_t last = 0u;
+        if (rowHeight > 0 && height > 0) {
+            auto firstVisible = std::size_t(std::max(0, top / rowHeight));
+            auto lastVisible = std::size_t(std::max(0, (top + height + rowHeight - 1) / rowHeight));
+            first = firstVisible > mOverscan ? firstVisible - mOverscan : 0u;
+            last = std::min(mRows.size(), lastVisible + mOverscan);
+            first = std::min(first, last);
+        }
+
+        if (mRebindAll) {
+            mRowSlots.clear();
+            mFreeSlots.clear();
+            for (std::size_t i = 0u; i < mSlotRows.size(); ++i) {
+                mSlotRows[i] = kInvalid;
+                mFreeSlots.push_back(i);
+            }
+            mRebindAll = false;
+        }
+
+        // release the slots of rows that are no longer visible
+        for (auto it = mRowSlots.begin(); it != mRowSlots.end();) {
+            if (it->first < first || it->first >= last) {
+                mSlotRows[it->second] = kInvalid;
+                mFreeSlots.push_back(it->second);
+                it = mRowSlots.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        std::vector<Binding> bindings;
+        for (auto index = first; index < last; ++index) {
+            if (mRowSlots.find(index) != mRowSlots.end()) {
+                continue;
+            }
+            std::size_t slot;
+            if (!mFreeSlots.empty()) {
+                slot = mFreeSlots.back();
+                mFreeSlots.pop_back();
+            } else {
+                slot = mSlotRows.size();
+                mSlotRows.push_back(kInvalid);
+            }
+            mSlotRows[slot] = index;
+            mRowSlots.emplace(index, slot);
+            bindings.push_back(Binding{index, slot});
+        }
+        mFirst = first;
+        mLast = last;
+        return bindings;
+    }
+
+    /// slots that are not showing a row, and should be hidden.
+    const std::vector<std::size_t>& freeSlots() const noexcept { return mFreeSlots; }
+
+    /// first row bound by the last call to bind()
+    std::size_t firstBoundRow() const noexcept { return mFirst; }
+
+    /// one past the last row bound by the last call to bind()
+    std::size_t lastBoundRow() const noexcept { return mLast; }
+
+private:
+    /// a row of the list
+    struct Row {
+        /// cached sort key of the row
+        SortKey sortKey;
+
+        /// key of the row
+        Key key;
+    };
+
+    /// marks the rows as needing a sort, and every visible row as needing a rebind.
+    void markUnsorted() noexcept {
+        mIsSorted = false;
+        mRebindAll = true;
+    }
+
+    /// sorts the rows by their sort key, then by their key, and rebuilds mRowIndices.
+    void ensureSorted() {
+        if (mIsSorted) {
+            return;
+        }
+        std::sort(mRows.begin(), mRows.end(), [](const Row& a, const Row& b) {
+            if (a.sortKey < b.sortKey) {
+                return true;
+            }
+            if (b.sortKey < a.sortKey) {
+                return false;
+            }
+            return a.key < b.key;
+        });
+        mRowIndices.clear();
+        mRowIndices.reserve(mRows.size());
+        for (std::size_t i = 0u; i < mRows.size(); ++i) {
+            mRowIndices.emplace(mRows[i].key, i);
+        }
+        mIsSorted = true;
+    }
+
+    /// number of extra rows bound above and below the visible rows
+    std::size_t mOverscan;
+
+    /// true if mRows and mRowIndices are sorted and current
+    bool mIsSorted;
+
+    /// true if every visible row should be rebound on the next bind
+    bool mRebindAll;
+
+    /// rows, sorted when mIsSorted is true
+    std::vector<Row> mRows;
+
+    /// sort key of each row, always current
+    std::unordered_map<Key, SortKey, Hash> mSortKeys;
+
+    /// index of each row in mRows, always current, and in sorted order when mIsSorted is true
+    std::unordered_map<Key, std::size_t, Hash> mRowIndices;
+
+    /// row shown by each slot, or kInvalid
+    std::vector<std::size_t> mSlotRows;
+
+    /// slot of each bound row
+    std::unordered_map<std::size_t, std::size_t> mRowSlots;
+
+    /// slots that are not showing a row
+    std::vector<std::size_t> mFreeSlots;
+
+    /// first row bound by the last call to bind()
+    std::size_t mFirst;
+
+    /// one past the last row bound by the last call to bind()
+    std::size_t mLast;
+};
+
+} // namespace cor
+
+#endif // COR_VIRTUALLIST_H
@@ -6,7 +6,10 @@
 
 #include "lightvectorwidget.h"
 
-#include "utils/qt.h"
+#include <QPainter>
+
+#include "cor/widgets/rendercache.h"
+#include "icondata.h"
 
 namespace cor {
 
@@ -19,105 +22,60 @@ LightVectorWidget::LightVectorWidget(std::uint32_t width,
       mHideOffLights{false},
       mMaximumSize{width * height},
       mWidth{width},
-      mHeight{height} {
-    // --------------
-    // Setup Layout
-    // --------------
-
-    mLayout = new QGridLayout;
-    mLayout->setContentsMargins(0, 0, 0, 0);
-    mLayout->setHorizontalSpacing(0);
-    setLayout(mLayout);
-
-    // --------------
-    // Setup Array Color Buttons
-    // --------------
-
-    mArrayColorsButtons = std::vector<cor::Button*>(std::uint32_t(mMaximumSize), nullptr);
-    mArrayLabels = std::vector<QLabel*>(std::uint32_t(mMaximumSize), nullptr);
-    std::uint32_t i = 0;
-    for (std::uint32_t h = 0; h < mHeight; ++h) {
-        for (std::uint32_t w = 0; w < mWidth; ++w) {
-            cor::LightState state;
-            state.routine(ERoutine::singleSolid);
-            state.color(QColor(0, 0, 0));
-            mArrayColorsButtons[i] = new cor::Button(this, state);
-            mArrayColorsButtons[i]->setIconPercent(1.0);
-            mArrayColorsButtons[i]->setLabelMode(true);
-            mArrayColorsButtons[i]->setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed);
-            connect(mArrayColorsButtons[std::size_t(i)],
-                    SIGNAL(clicked()),
-                    this,
-                    SLOT(toggleArrayColor()));
-
-            QSizePolicy sizePolicy = mArrayColorsButtons[std::size_t(i)]->sizePolicy();
-            sizePolicy.setRetainSizeWhenHidden(true);
-            mArrayColorsButtons[i]->setSizePolicy(sizePolicy);
-            mArrayColorsButtons[i]->setVisible(false);
-            mLayout->addWidget(mArrayColorsButtons[i], int(h), int(w));
-            ++i;
-        }
-    }
-}
+      mHeight{height},
+      mIconPercent{1.0f} {}
 
 void LightVectorWidget::updateLights(const std::vector<cor::Light>& lights) {
-    if (mFillFromLeft) {
-        std::uint32_t i = 0;
-        for (const auto& light : lights) {
-            auto state = light.state();
-            if (i < mMaximumSize) {
-                if (state.isOn() || !mHideOffLights) {
-                    mArrayColorsButtons[i]->updateRoutine(state);
-                    mArrayColorsButtons[i]->setVisible(true);
-                    ++i;
-                }
-            }
+    std::vector<cor::LightState> states;
+    states.reserve(mMaximumSize);
+    for (const auto& light : lights) {
+        if (states.size() == mMaximumSize) {
+            break;
         }
-        for (; i < mMaximumSize; ++i) {
-            mArrayColorsButtons[i]->setVisible(false);
-        }
-    } else {
-        std::uint32_t i = mMaximumSize - 1;
-        for (const auto& light : lights) {
-            auto state = light.state();
-            if (i > 0) {
-                if (state.isOn() || !mHideOffLights) {
-                    mArrayColorsButtons[i]->updateRoutine(state);
-                    mArrayColorsButtons[i]->setVisible(true);
-                    --i;
-                }
-            }
-        }
-        for (; i > 0; --i) {
-            mArrayColorsButtons[i]->setVisible(false);
+        const auto& state = light.state();
+        if (state.isOn() || !mHideOffLights) {
+            states.push_back(state);
         }
     }
-}
 
-uint32_t LightVectorWidget::selectedCount() {
-    uint32_t i = 0;
-    for (auto widget : mArrayColorsButtons) {
-        if (widget->isChecked()) {
-            ++i;
-        }
+    ContentHash content;
+    content.add(std::uint64_t(states.size()));
+    for (const auto& state : states) {
+        hashLightState(content, state);
+    }
+    if (content.value() != mContent.value()) {
+        mStates = std::move(states);
+        mContent = content;
+        update();
     }
-    return i;
-}
-
-void LightVectorWidget::toggleArrayColor() {
-    emit selectedCountChanged(int(selectedCount()));
 }
 
-void LightVectorWidget::enableButtonInteraction(bool enable) {
-    for (const auto& button : mArrayColorsButtons) {
-        button->setAttribute(Qt::WA_TransparentForMouseEvents, !enable);
-    }
+void LightVectorWidget::paintEvent(QPaintEvent*) {
+    auto content = mContent;
+    content.add(mFillFromLeft).add(mWidth).add(mHeight).add(double(mIconPercent));
+    auto pixmap = cachedRender("LightVectorWidget:",
+                               content,
+                               size(),
+                               devicePixelRatioF(),
+                               [this](QPainter& painter) { renderGrid(painter); });
+    QPainter painter(this);
+    painter.drawPixmap(0, 0, pixmap);
 }
 
-void LightVectorWidget::resizeEvent(QResizeEvent*) {
-    const QSize widgetSize(width() / int(mWidth), height() / int(mHeight));
-    for (auto widget : mArrayColorsButtons) {
-        widget->setFixedSize(widgetSize);
+void LightVectorWidget::renderGrid(QPainter& painter) {
+    const QSize cellSize(width() / int(mWidth), height() / int(mHeight));
+    auto iconSide = int(std::min(cellSize.width(), cellSize.height()) * mIconPercent);
+    for (std::uint32_t i = 0u; i < mStates.size(); ++i) {
+        auto cell = mFillFromLeft ? i : mMaximumSize - 1u - i;
+        auto column = int(cell % mWidth);
+        auto row = int(cell / mWidth);
+        QRect iconRect(column * cellSize.width() + (cellSize.width() - iconSide) / 2,
+                       row * cellSize.height() + (cellSize.height() - iconSide) / 2,
+                       iconSide,
+                       iconSide);
+        IconData icon;
+        icon.setRoutine(mStates[i]);
+        painter.drawImage(iconRect, icon.renderAsQImage());
     }
 }
 
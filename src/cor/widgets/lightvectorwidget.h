@@ -3,9 +3,8 @@
 
 #include <QWidget>
 
+#include "cor/contenthash.h"
 #include "cor/objects/light.h"
-#include "cor/widgets/button.h"
-#include "cor/widgets/slider.h"
 
 namespace cor {
 
@@ -16,9 +15,10 @@ namespace cor {
  *
  *
  *
- * \brief The LightVectorWidget class is a bottom layout for the color picker that allows the user
- * to choose up to 10 colors at once and change them all to a new color. It is used for multi color
- * routines. A slider is also on top to determine how many colors are used for this routine.
+ * \brief The LightVectorWidget class shows the states of a vector of lights as a grid of icons. It
+ * is used to preview the lights of moods and controllers. The grid is painted by this widget as a
+ * single cached pixmap, instead of being made of a button per light, so a list with many previews
+ * has fewer widgets and repaints without redrawing any icons it has already drawn.
  */
 class LightVectorWidget : public QWidget {
     Q_OBJECT
@@ -29,8 +29,8 @@ public:
                                bool fillFromLeft,
                                QWidget* parent);
     /*!
-     * \brief updateDevices update the lights in the cor::Button to show the exact routine.
-     * \param devices list of devices to display
+     * \brief updateLights update the icons to show the states of the lights.
+     * \param lights list of lights to display
      */
     void updateLights(const std::vector<cor::Light>& lights);
 
@@ -40,49 +40,20 @@ public:
     /// set whether or not to hide off lights
     void hideOffLights(bool shouldHide) { mHideOffLights = shouldHide; }
 
-    /// set the percent of an icon that each button should take up.
+    /// set the percent of a cell of the grid that each icon should take up.
     void setButtonIconPercent(float percent) {
-        for (auto button : mArrayColorsButtons) {
-            button->setIconPercent(percent);
-        }
+        mIconPercent = percent;
+        update();
     }
 
-    /*!
-     * \brief enableButtonInteraction true to allow button interaction, false to
-     *        ignore buttons and treat them as images instead. Clicks will go through buttons
-     *        to the widget.
-     * \param enable true to enable, false to disable.
-     */
-    void enableButtonInteraction(bool enable);
-
-    /*!
-     * \brief selectedCount number of selected lights by the ColorGrid
-     * \return  number of selected devices.
-     */
-    uint32_t selectedCount();
-
-    /// getter for vector of buttons in widget.
-    std::vector<cor::Button*> buttons() { return mArrayColorsButtons; }
-
-signals:
-    /*!
-     * \brief selectedCountChanged a button was pressed so the selected count has changed. emits new
-     * count.
-     */
-    void selectedCountChanged(int);
-
-private slots:
-    /*!
-     * \brief toggleArrayColor when called, the multi color array color at the given index is
-     * seletected or deselected, depending on its current state.
-     */
-    void toggleArrayColor();
-
 protected:
-    /// called when the widget resizes
-    virtual void resizeEvent(QResizeEvent*);
+    /// renders the grid
+    void paintEvent(QPaintEvent*) override;
 
 private:
+    /// renders the icons of the shown states.
+    void renderGrid(QPainter& painter);
+
     /// true if widget should fill new entries from left, false if it should fill from right
     bool mFillFromLeft;
 
@@ -101,19 +72,14 @@ private:
     /// number of rows of palettes
     std::uint32_t mHeight;
 
-    /// vector pushbuttons used for the multi layout
-    std::vector<cor::Button*> mArrayColorsButtons;
-
-    /// vector for storing labels for the palette
-    std::vector<QLabel*> mArrayLabels;
+    /// the percent of a cell that an icon takes up.
+    float mIconPercent;
 
-    /// color groups used to display color palette state
-    std::vector<std::vector<QColor>> mColorGroups;
+    /// states shown in each cell of the grid, in the order the cells are filled.
+    std::vector<cor::LightState> mStates;
 
-    /*!
-     * \brief mLayout layout used to arrange the slider and the buttons.
-     */
-    QGridLayout* mLayout;
+    /// hash of the shown states
+    ContentHash mContent;
 };
 
 } // namespace cor
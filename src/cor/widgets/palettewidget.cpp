@@ -2,25 +2,46 @@
 #include <QEvent>
 #include <QGraphicsOpacityEffect>
 #include <QPainter>
-#include <QStyleOption>
 #include <algorithm>
+#include "cor/widgets/rendercache.h"
 #include "icondata.h"
 
 namespace cor {
 
+namespace {
+
+/// seed for the content hash of solid colors
+const std::uint64_t kSolidColorsSeed = 1u;
+
+/// seed for the content hash of light states
+const std::uint64_t kLightStatesSeed = 2u;
+
+} // namespace
+
 PaletteWidget::PaletteWidget(QWidget* parent)
     : QWidget(parent),
       mPreferPalettesOverRoutines{false},
       mSkipOffLightStates{false},
+      mIsSolidColors{true},
       mIsSingleLine{false},
       mForceSquares{false},
       mUseMinimumBrightness{false},
       mMinBrightness{50},
-      mBrightnessMode{EBrightnessMode::none} {}
+      mBrightnessMode{EBrightnessMode::none},
+      mContent{kSolidColorsSeed} {}
 
 void PaletteWidget::show(const std::vector<QColor>& colors) {
+    ContentHash content(kSolidColorsSeed);
+    content.add(std::uint64_t(colors.size()));
+    for (const auto& color : colors) {
+        hashColor(content, color);
+    }
+    if (mIsSolidColors && content.value() == mContent.value()) {
+        return;
+    }
     mIsSolidColors = true;
     mSolidColors = colors;
+    mContent = content;
     update();
 }
 
@@ -56,8 +77,17 @@ void PaletteWidget::show(const std::vector<cor::LightState>& states) {
                   return hueA < hueB;
               });
 
+    ContentHash content(kLightStatesSeed);
+    content.add(std::uint64_t(statesCopy.size()));
+    for (const auto& state : statesCopy) {
+        hashLightState(content, state);
+    }
+    if (!mIsSolidColors && content.value() == mContent.value()) {
+        return;
+    }
     mIsSolidColors = false;
-    mStates = statesCopy;
+    mStates = std::move(statesCopy);
+    mContent = content;
     update();
 }
 
@@ -70,12 +100,25 @@ bool PaletteWidget::isShowingAnything() {
 }
 
 void PaletteWidget::paintEvent(QPaintEvent*) {
-    auto gridSize = generateGridSize();
-
-    QStyleOption opt;
-    opt.initFrom(this);
+    // the options change the render, so they are part of its content.
+    auto content = mContent;
+    content.add(mPreferPalettesOverRoutines)
+        .add(mIsSingleLine)
+        .add(mForceSquares)
+        .add(mUseMinimumBrightness)
+        .add(mMinBrightness)
+        .add(int(mBrightnessMode));
+    auto pixmap = cachedRender("PaletteWidget:",
+                               content,
+                               size(),
+                               devicePixelRatioF(),
+                               [this](QPainter& painter) { renderPalette(painter); });
     QPainter painter(this);
+    painter.drawPixmap(0, 0, pixmap);
+}
 
+void PaletteWidget::renderPalette(QPainter& painter) {
+    auto gridSize = generateGridSize();
     std::uint32_t i = 0;
     if (mIsSolidColors) {
         auto brightness = calculateBrightness(mSolidColors, mBrightnessMode);
@@ -207,7 +250,6 @@ void PaletteWidget::drawLightState(QPainter& painter,
             stateCopy.color(
                 QColor::fromHsvF(state.color().hueF(), state.color().saturationF(), brightness));
         } else {
-            auto paletteCopy = stateCopy.palette();
             stateCopy.paletteBrightness(brightness * 100.0f);
         }
     }
@@ -226,7 +268,6 @@ std::vector<std::pair<QColor, int>> PaletteWidget::convertStateColors(const cor:
             stateCopy.color(
                 QColor::fromHsvF(state.color().hueF(), state.color().saturationF(), brightness));
         } else {
-            auto paletteCopy = stateCopy.palette();
             stateCopy.paletteBrightness(brightness * 100.0f);
         }
     }
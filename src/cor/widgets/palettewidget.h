@@ -2,6 +2,7 @@
 #define PALETTEWIDGET_H
 
 #include <QWidget>
+#include "cor/contenthash.h"
 #include "cor/objects/lightstate.h"
 namespace cor {
 
@@ -20,6 +21,9 @@ enum class EBrightnessMode { none, average, max };
  * of LightStates. Unless non-standard options are set, the layout of the palette components is
  * automatically computed. This layout can be overriden to display all palette components in a
  * single line.
+ *
+ * Rendering is cached by content, so repainting a palette that has already been drawn at the same
+ * size, by this or any other PaletteWidget, only draws a cached pixmap.
  */
 class PaletteWidget : public QWidget {
     Q_OBJECT
@@ -71,6 +75,9 @@ protected:
     void changeEvent(QEvent* event) override;
 
 private:
+    /// renders the colors or light states.
+    void renderPalette(QPainter& painter);
+
     /// draws a single color on the palette widget in the defined region.
     void drawSolidColor(QPainter& painter,
                         const QColor& color,
@@ -145,6 +152,9 @@ private:
 
     /// mode for displaying the brightness of the widget
     EBrightnessMode mBrightnessMode;
+
+    /// hash of the colors or light states that are shown
+    ContentHash mContent;
 };
 
 } // namespace cor
@@ -0,0 +1,69 @@
+#ifndef COR_RENDERCACHE_H
+#define COR_RENDERCACHE_H
+
+#include <QColor>
+#include <QPainter>
+#include <QPixmap>
+#include <QPixmapCache>
+
+#include "cor/contenthash.h"
+#include "cor/objects/lightstate.h"
+
+namespace cor {
+
+/// adds a color to a content hash
+inline void hashColor(ContentHash& hash, const QColor& color) {
+    hash.add(std::uint64_t(quint64(color.rgba64())));
+}
+
+/// adds everything that changes how a light state is drawn to a content hash
+inline void hashLightState(ContentHash& hash, const cor::LightState& state) {
+    hash.add(state.isOn());
+    hash.add(int(state.routine()));
+    hash.add(state.param());
+    hash.add(state.paletteBrightness());
+    hash.add(state.temperature());
+    hashColor(hash, state.color());
+    const auto& colors = state.palette().colors();
+    hash.add(std::uint64_t(colors.size()));
+    for (const auto& color : colors) {
+        hashColor(hash, color);
+    }
+}
+
+/*!
+ * \brief cachedRender returns a pixmap of the given size from the QPixmapCache, rendering it first
+ * if nothing with the same content has been rendered at that size. Widgets that show the same
+ * content, such as the same mood in many lists, share a single render.
+ *
+ * \param prefix separates the renders of different widgets
+ * \param content hash of everything that changes the render, besides its size
+ * \param size size of the render, in device independent pixels
+ * \param devicePixelRatio device pixel ratio of the widget that will draw the render
+ * \param render draws the content, given a QPainter that covers the size
+ */
+template <typename Render>
+QPixmap cachedRender(const QString& prefix,
+                     ContentHash content,
+                     const QSize& size,
+                     qreal devicePixelRatio,
+                     Render render) {
+    content.add(size.width()).add(size.height()).add(double(devicePixelRatio));
+    auto key = prefix + QString::number(qulonglong(content.value()), 16);
+    QPixmap pixmap;
+    if (QPixmapCache::find(key, &pixmap)) {
+        return pixmap;
+    }
+    pixmap = QPixmap(size * devicePixelRatio);
+    pixmap.setDevicePixelRatio(devicePixelRatio);
+    pixmap.fill(Qt::transparent);
+    QPainter painter(&pixmap);
+    render(painter);
+    painter.end();
+    QPixmapCache::insert(key, pixmap);
+    return pixmap;
+}
+
+} // namespace cor
+
+#endif // COR_RENDERCACHE_H
@@ -0,0 +1,77 @@
+#-------------------------------------------------
+#
+# Corluma daemon
+# Copyright (C) 2015 - 2020.
+# Released under the GNU General Public License.
+# Full license in root of git repo.
+#
+# Runs the Corluma backend without a GUI. Shares its settings
+# and save data with the app.
+#
+#-------------------------------------------------
+
+TARGET = corlumad
+TEMPLATE = app
+VERSION = 0.22.03
+
+#----------
+# Build flags
+#----------
+
+# flag to use experimental features that may not be part of the standard release.
+SHOULD_USE_EXPERIMENTAL_FEATURES = 0
+# flag to use serial ArduCor devices. Not all versions of Qt have serial.
+SHOULD_USE_SERIAL = 1
+
+equals (QT_MAJOR_VERSION, 6) {
+    SHOULD_USE_SERIAL = 0
+    message("DEBUG: Overriding serial setting, QT 6.0.0 does not have qserialport.")
+}
+
+#----------
+# Variable definition
+#----------
+
+equals(SHOULD_USE_EXPERIMENTAL_FEATURES, 1) {
+    DEFINES += USE_EXPERIMENTAL_FEATURES=1
+}
+equals(SHOULD_USE_SERIAL, 1) {
+    DEFINES += USE_SERIAL=1
+}
+equals (QT_MAJOR_VERSION, 6) {
+    DEFINES += USE_QT_6=1
+}
+
+# stores the app version for --version
+DEFINES += APP_VERSION=\\\"$$VERSION\\\"
+
+#----------
+# Config
+#----------
+
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+#----------
+# Dependencies
+#----------
+
+# gui is linked for QColor, no platform plugin is loaded since the daemon runs a
+# QCoreApplication.
+QT = core gui network
+equals(SHOULD_USE_SERIAL, 1) {
+  QT += serialport
+}
+
+#----------
+# Sources
+#----------
+
+include(../backend.pri)
+
+RESOURCES = corlumad.qrc
+
+SOURCES += main.cpp \
+    corlumadaemon.cpp
+
+HEADERS += corlumadaemon.h
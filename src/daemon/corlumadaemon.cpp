@@ -0,0 +1,120 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include "corlumadaemon.h"
+
+#include <QDebug>
+#include <QSaveFile>
+#include <algorithm>
+
+#include "appsettings.h"
+#include "comm/commlayer.h"
+#include "comm/datasyncarduino.h"
+#include "comm/datasynchue.h"
+#include "comm/datasyncnanoleaf.h"
+#include "comm/datasynctimeout.h"
+#include "comm/lightstateservice.h"
+#include "cor/lightlist.h"
+#include "data/appdata.h"
+
+CorlumaDaemon::CorlumaDaemon(QObject* parent)
+    : QObject(parent),
+      mAppData{new AppData(this)},
+      mComm{new CommLayer(this, mAppData, mAppData->palettes())},
+      mData{new cor::LightList(this)},
+      mAppSettings{new AppSettings},
+      mDataSyncArduino{new DataSyncArduino(mData, mComm, mAppData->palettes(), mAppSettings)},
+      mDataSyncHue{new DataSyncHue(mData, mComm, mAppSettings)},
+      mDataSyncNanoLeaf{new DataSyncNanoLeaf(mData, mComm, mAppSettings)},
+      mDataSyncTimeout{new DataSyncTimeout(mData, mComm, mAppSettings, this)},
+      mMoodID{cor::UUID::invalidID()},
+      mReachableMoodLights{0u},
+      mMetricsTimer{new QTimer(this)} {
+    // disable experimental features if not experimental features are not enabled
+#ifndef USE_EXPERIMENTAL_FEATURES
+    mAppSettings->enableTimeout(false);
+#endif // USE_EXPERIMENTAL_FEATURES
+
+    connect(mComm,
+            SIGNAL(lightsAdded(std::vector<cor::LightID>)),
+            this,
+            SLOT(lightsChanged(std::vector<cor::LightID>)));
+    // lights of the mood that were discovered while unreachable are only synced once an update
+    // reports them as reachable.
+    connect(mComm,
+            SIGNAL(lightsUpdated(std::vector<cor::LightID>)),
+            this,
+            SLOT(lightsChanged(std::vector<cor::LightID>)));
+    connect(mMetricsTimer, SIGNAL(timeout()), this, SLOT(metricsTimeout()));
+
+    // keep the totals of the selected lights' reported states in sync with the selection.
+    mComm->lightStates()->trackSelection(mData);
+}
+
+void CorlumaDaemon::start() {
+    for (int i = 0; i < int(EProtocolType::MAX); ++i) {
+        auto type = EProtocolType(i);
+        if (mAppSettings->enabled(type)) {
+            mComm->startup(type);
+            mComm->startDiscovery(type);
+        }
+    }
+}
+
+bool CorlumaDaemon::applyMood(const QString& name) {
+    for (const auto& mood : mAppData->moods()->moods().items()) {
+        if (mood.name() == name) {
+            mMoodID = mood.uniqueID();
+            mReachableMoodLights = 0u;
+            selectMood();
+            return true;
+        }
+    }
+    return false;
+}
+
+void CorlumaDaemon::writeMetrics(const QString& path, int interval) {
+    mMetricsPath = path;
+    mMetricsTimer->start(interval);
+    mComm->probeEventLoopLag(true);
+}
+
+void CorlumaDaemon::lightsChanged(std::vector<cor::LightID>) {
+    if (mMoodID.isValid()) {
+        selectMood();
+    }
+}
+
+void CorlumaDaemon::selectMood() {
+    const auto& plan = mComm->moodPlan(mMoodID);
+    if (!plan.moodID().isValid()) {
+        return;
+    }
+    const auto& moodLights = mComm->lightsFromMoodPlan(plan);
+    auto reachableCount = std::size_t(std::count_if(moodLights.begin(),
+                                                    moodLights.end(),
+                                                    [](const cor::Light& light) {
+                                                        return light.isReachable();
+                                                    }));
+    // only reselect the mood when more of its lights can be synced, so that updates do not
+    // restart syncing lights that are already in the mood. Lights that become unreachable are
+    // counted too, so the mood is reselected when they come back.
+    if (reachableCount > mReachableMoodLights) {
+        mData->clearLights();
+        mData->addMood(moodLights);
+    }
+    mReachableMoodLights = reachableCount;
+}
+
+void CorlumaDaemon::metricsTimeout() {
+    QSaveFile file(mMetricsPath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qDebug() << "WARNING: could not write metrics to" << mMetricsPath;
+        return;
+    }
+    file.write(QByteArray::fromStdString(mComm->metrics().snapshotText()));
+    file.commit();
+}
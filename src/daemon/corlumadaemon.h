@@ -0,0 +1,110 @@
+#ifndef CORLUMADAEMON_H
+#define CORLUMADAEMON_H
+
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <vector>
+
+#include "cor/objects/lightid.h"
+#include "cor/objects/uuid.h"
+
+class AppData;
+class AppSettings;
+class CommLayer;
+class DataSyncArduino;
+class DataSyncHue;
+class DataSyncNanoLeaf;
+class DataSyncTimeout;
+namespace cor {
+class LightList;
+}
+
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ *
+ * \brief The CorlumaDaemon class runs the backend of Corluma without a GUI. It builds the same
+ * CommLayer, DataSync engines, and persistent data as the MainWindow, using the settings and save
+ * data of the app, then discovers and syncs lights until the process exits. Like the app, it only
+ * syncs the timeouts of lights in builds with USE_EXPERIMENTAL_FEATURES, and disables them
+ * otherwise.
+ */
+class CorlumaDaemon : public QObject {
+    Q_OBJECT
+public:
+    /// constructor
+    explicit CorlumaDaemon(QObject* parent);
+
+    /// starts every enabled protocol and begins discovery.
+    void start();
+
+    /*!
+     * \brief applyMood selects the lights of a saved mood and syncs them to the mood. Lights that
+     * are discovered later are synced as soon as they are found.
+     *
+     * \param name name of the saved mood
+     * \return true if a saved mood has that name, false otherwise.
+     */
+    bool applyMood(const QString& name);
+
+    /*!
+     * \brief writeMetrics writes a snapshot of the CommLayer's metrics to a file every interval,
+     * replacing the previous snapshot.
+     *
+     * \param path path of the file
+     * \param interval msec between snapshots
+     */
+    void writeMetrics(const QString& path, int interval);
+
+private slots:
+
+    /// handles when lights are discovered or report new states, such as becoming reachable.
+    void lightsChanged(std::vector<cor::LightID>);
+
+    /// writes a snapshot of the metrics
+    void metricsTimeout();
+
+private:
+    /// selects the reachable lights of the current mood
+    void selectMood();
+
+    /// groups, moods, and palettes, loaded from the app's save data
+    AppData* mAppData;
+
+    /// communicates with every type of light
+    CommLayer* mComm;
+
+    /// lights that are selected, the DataSync engines sync them to their desired state
+    cor::LightList* mData;
+
+    /// settings shared with the app, such as which protocols are enabled
+    AppSettings* mAppSettings;
+
+    /// syncs ArduCor lights
+    DataSyncArduino* mDataSyncArduino;
+
+    /// syncs Hue lights
+    DataSyncHue* mDataSyncHue;
+
+    /// syncs Nanoleaf lights
+    DataSyncNanoLeaf* mDataSyncNanoLeaf;
+
+    /// syncs the timeouts of lights
+    DataSyncTimeout* mDataSyncTimeout;
+
+    /// unique ID of the mood being applied, invalid if no mood has been requested
+    cor::UUID mMoodID;
+
+    /// number of lights in the mood that were reachable the last time it was selected
+    std::size_t mReachableMoodLights;
+
+    /// writes metrics snapshots
+    QTimer* mMetricsTimer;
+
+    /// path metrics snapshots are written to
+    QString mMetricsPath;
+};
+
+#endif // CORLUMADAEMON_H
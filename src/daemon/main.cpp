@@ -0,0 +1,63 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QSettings>
+
+#include "appsettings.h"
+#include "corlumadaemon.h"
+
+namespace {
+
+/// matches the key used by the app, so the daemon and the app share their first time setup
+const QString kFirstTimeOpenKey = QString("Corluma_FirstTimeOpen");
+
+/// msec between metrics snapshots
+const int kMetricsInterval = 10000;
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    // use the same organization and application as the app, so that settings and save data are
+    // shared between them.
+    QCoreApplication::setOrganizationName("Corluma");
+    QCoreApplication::setApplicationName("Corluma");
+    QCoreApplication::setApplicationVersion(APP_VERSION);
+
+    QCoreApplication a(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Discovers and syncs Corluma lights without a GUI.");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    QCommandLineOption moodOption("mood", "Applies the saved mood <name>.", "name");
+    parser.addOption(moodOption);
+    QCommandLineOption metricsOption("metrics",
+                                     "Writes a metrics snapshot to <file> every 10 seconds.",
+                                     "file");
+    parser.addOption(metricsOption);
+    parser.process(a);
+
+    QSettings settings;
+    if (settings.value(kFirstTimeOpenKey, QVariant(127)) == QVariant(127)) {
+        AppSettings::setToDefaults();
+        settings.setValue(kFirstTimeOpenKey, QString::number(10));
+        settings.sync();
+    }
+
+    CorlumaDaemon daemon(nullptr);
+    if (parser.isSet(moodOption) && !daemon.applyMood(parser.value(moodOption))) {
+        qDebug() << "ERROR: no saved mood is named" << parser.value(moodOption);
+        return 1;
+    }
+    if (parser.isSet(metricsOption)) {
+        daemon.writeMetrics(parser.value(metricsOption), kMetricsInterval);
+    }
+    daemon.start();
+    return a.exec();
+}
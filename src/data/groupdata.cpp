@@ -13,6 +13,7 @@ void GroupData::saveNewGroup(const cor::Group& group) {
         } else {
             mGroupDict.insert(key, group);
         }
+        ++mRevision;
 
         emit groupAdded(group.name());
     }
@@ -84,6 +85,7 @@ QString GroupData::removeGroup(cor::UUID uniqueID) {
         if (group.uniqueID() == uniqueID) {
             mGroupDict.remove(group);
             name = group.name();
+            ++mRevision;
         }
     }
     return name;
@@ -118,12 +120,17 @@ bool GroupData::removeLightFromGroups(const cor::LightID& uniqueID) {
             }
         }
     }
+    if (anyUpdates) {
+        ++mRevision;
+    }
     return anyUpdates;
 }
 
 namespace {
 
-void updateGroup(cor::Group& group, const cor::Group& externalGroup) {
+/// merges the lights of the external group into the group, returns true if any lights are added.
+bool updateGroup(cor::Group& group, const cor::Group& externalGroup) {
+    bool anyAdded = false;
     // merge new lights into it
     for (const auto& externalLightID : externalGroup.lights()) {
         // search for old light
@@ -133,8 +140,10 @@ void updateGroup(cor::Group& group, const cor::Group& externalGroup) {
             auto lights = group.lights();
             lights.push_back(externalLightID);
             group.lights(lights);
+            anyAdded = true;
         }
     }
+    return anyAdded;
 }
 
 } // namespace
@@ -148,14 +157,18 @@ void GroupData::updateExternallyStoredGroups(const std::vector<cor::Group>& exte
         if (lookupResult.second) {
             // get existing group
             auto groupCopy = lookupResult.first;
-            updateGroup(groupCopy, externalGroup);
+            if (updateGroup(groupCopy, externalGroup)) {
+                ++mRevision;
+            }
             mGroupDict.update(key, groupCopy);
         } else {
             bool foundGroup = false;
             for (const auto& internalGroup : mGroupDict.items()) {
                 if (internalGroup.name() == externalGroup.name()) {
                     auto groupCopy = internalGroup;
-                    updateGroup(groupCopy, externalGroup);
+                    if (updateGroup(groupCopy, externalGroup)) {
+                        ++mRevision;
+                    }
                     mGroupDict.update(internalGroup.uniqueID().toStdString(), groupCopy);
                     foundGroup = true;
                 }
@@ -165,6 +178,8 @@ void GroupData::updateExternallyStoredGroups(const std::vector<cor::Group>& exte
                 auto result = mGroupDict.insert(key, externalGroup);
                 if (!result) {
                     qDebug() << " insert failed" << externalGroup.name();
+                } else {
+                    ++mRevision;
                 }
             }
         }
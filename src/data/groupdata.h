@@ -23,6 +23,10 @@ class GroupData : public QObject {
 public:
     explicit GroupData(QObject* parent = nullptr);
 
+    /// incremented every time the groups change, used to detect when cached data that depends on
+    /// groups is stale.
+    std::uint64_t revision() const noexcept { return mRevision; }
+
     /// getter for the dictionary of all groups and rooms
     const cor::Dictionary<cor::Group>& groupDict() const noexcept { return mGroupDict; }
 
@@ -35,6 +39,7 @@ public:
                 mGroupDict.insert(group.uniqueID().toStdString(), group);
             }
         }
+        ++mRevision;
     }
 
     /*!
@@ -99,7 +104,10 @@ public:
     cor::UUID groupNameToID(const QString name);
 
     /// clear all group data
-    void clear() { mGroupDict = cor::Dictionary<cor::Group>(); }
+    void clear() {
+        mGroupDict = cor::Dictionary<cor::Group>();
+        ++mRevision;
+    }
 
     /// remove a light from all groups, removing groups if they are no longer valid.
     bool removeLightFromGroups(const cor::LightID& light);
@@ -134,6 +142,9 @@ private:
      * is easy to pull all possible collections without having to re-parse the JSON data each time.
      */
     cor::Dictionary<cor::Group> mGroupDict;
+
+    /// revision of the group data, see revision()
+    std::uint64_t mRevision = 0u;
 };
 
 #endif // GROUPDATA_H
@@ -27,6 +27,7 @@ void MoodData::saveNewMood(const cor::Mood& mood) {
     } else {
         mMoodDict.insert(key, mood);
     }
+    ++mRevision;
     emit moodAdded(mood.name());
 }
 
@@ -48,6 +49,9 @@ bool MoodData::removeLightFromMoods(const cor::LightID& uniqueID) {
             }
         }
     }
+    if (anyUpdates) {
+        ++mRevision;
+    }
     return anyUpdates;
 }
 
@@ -60,6 +64,7 @@ QString MoodData::removeMood(const cor::UUID& uniqueID) {
             if (!result) {
                 return {};
             } else {
+                ++mRevision;
                 emit moodDeleted(mood.name());
             }
             name = mood.name();
@@ -88,4 +93,5 @@ void MoodData::loadFromJson(const QJsonArray& array) {
             mMoodDict.insert(mood.uniqueID().toStdString(), mood);
         }
     }
+    ++mRevision;
 }
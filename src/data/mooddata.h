@@ -23,6 +23,10 @@ class MoodData : public QObject {
 public:
     MoodData();
 
+    /// incremented every time the moods change, used to detect when cached data that depends on
+    /// moods is stale.
+    std::uint64_t revision() const noexcept { return mRevision; }
+
     /*!
      * \brief moodList getter for all known moods.
      *
@@ -49,7 +53,10 @@ public:
     QString removeMood(const cor::UUID& uniqueID);
 
     /// clear all moods
-    void clear() { mMoodDict = cor::Dictionary<cor::Mood>(); }
+    void clear() {
+        mMoodDict = cor::Dictionary<cor::Mood>();
+        ++mRevision;
+    }
 
     /// convert to json array
     QJsonArray toJsonArray();
@@ -70,6 +77,9 @@ private:
      * easy to pull all possible moods without having to re-parse the JSON data each time.
      */
     cor::Dictionary<cor::Mood> mMoodDict;
+
+    /// revision of the mood data, see revision()
+    std::uint64_t mRevision = 0u;
 };
 
 #endif // MOODDATA_H
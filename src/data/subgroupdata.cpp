@@ -1,8 +1,11 @@
 #include "subgroupdata.h"
-#include "utils/qt.h"
+#include "utils/qtcore.h"
 
 namespace {
 
+/// splits names into words
+const cor::Tokenizer<char16_t> kWhitespace(u" \t\r\n\f\v");
+
 /// inserts a group in the subgroup map, by either creating a new key, or filling the vector of
 /// subgroups with an additional entry.
 void insertIntoSubgroupMaps(SubgroupMap& map,
@@ -31,13 +34,13 @@ void insertIntoSubgroupMaps(SubgroupMap& map,
 
 QString makeSimplifiedGroupName(const QString& parent, const QString& group) {
     // split the room name by spaces
-    auto roomStringList = cor::regexSplit(parent, "\\s+");
-    auto groupStringList = cor::regexSplit(group, "\\s+");
+    auto roomStringList = cor::tokenize(parent, kWhitespace);
+    auto groupStringList = cor::tokenize(group, kWhitespace);
     int charactersToSkip = 0;
-    int smallestWordCount = std::min(roomStringList.size(), groupStringList.size());
-    for (int i = 0; i < smallestWordCount; ++i) {
+    auto smallestWordCount = std::min(roomStringList.size(), groupStringList.size());
+    for (std::size_t i = 0u; i < smallestWordCount; ++i) {
         if (roomStringList[i] == groupStringList[i]) {
-            charactersToSkip += roomStringList[i].size() + 1;
+            charactersToSkip += int(roomStringList[i].size()) + 1;
         }
     }
     return group.mid(charactersToSkip, group.size());
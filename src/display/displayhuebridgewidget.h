@@ -3,6 +3,7 @@
 
 #include <QLabel>
 #include <QPainter>
+#include <QPushButton>
 #include <QStyleOption>
 #include <QWidget>
 #include "comm/hue/bridge.h"
@@ -196,7 +196,6 @@ private:
 
     void initLightVector(std::uint32_t lightCount) {
         mLightVector = new cor::LightVectorWidget(lightCount, 1, true, this);
-        mLightVector->enableButtonInteraction(false);
         mLightVector->setStyleSheet(cor::kTransparentStylesheet);
         if (lightCount == 1) {
             mLightVector->setButtonIconPercent(0.8f);
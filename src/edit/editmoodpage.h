@@ -106,9 +106,9 @@ private slots:
         auto mood = mReviewPage->mood();
         mood.lights(mLightsStateWidget->lights());
         mood.defaults(mGroupStatesWidget->defaults());
-        const auto& moodDict = mComm->makeMood(mood);
+        const auto& moodLights = mComm->makeMood(mood);
         mData->clearLights();
-        mData->addLights(moodDict.items());
+        mData->addLights(moodLights);
     }
 
 private:
@@ -2,6 +2,7 @@
 #define EDITPALETTEWIDGET_H
 
 #include <QLineEdit>
+#include <QPushButton>
 #include <QWidget>
 #include "colorpicker/colorpicker.h"
 #include "colorpicker/swatchvectorwidget.h"
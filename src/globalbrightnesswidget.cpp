@@ -6,17 +6,22 @@
 
 #include "globalbrightnesswidget.h"
 
+#include "comm/lightstateservice.h"
 #include "utils/qt.h"
 
-GlobalBrightnessWidget::GlobalBrightnessWidget(const QSize& size,
-                                               CommLayer* comm,
-                                               cor::LightList* data,
-                                               QWidget* parent)
+namespace {
+
+/// msec after the user changes the lights before the switch follows the lights' reported states
+/// again, so it doesn't flicker back while the change is still on its way.
+const qint64 kUserChangeDelay = 5000;
+
+} // namespace
+
+GlobalBrightnessWidget::GlobalBrightnessWidget(const QSize& size, CommLayer* comm, QWidget* parent)
     : QWidget(parent),
       mIsIn{false},
       mSize{size},
-      mComm{comm},
-      mData{data} {
+      mComm{comm} {
     // --------------
     // Setup Brightness Slider
     // --------------
@@ -39,8 +44,9 @@ GlobalBrightnessWidget::GlobalBrightnessWidget(const QSize& size,
 
 
     mOnOffCheckTimer = new QTimer(this);
+    mOnOffCheckTimer->setSingleShot(true);
     connect(mOnOffCheckTimer, SIGNAL(timeout()), this, SLOT(checkifOn()));
-    mOnOffCheckTimer->start(500);
+    connect(mComm->lightStates(), SIGNAL(selectionUpdated()), this, SLOT(checkifOn()));
 
     mElapsedTime.restart();
 }
@@ -116,22 +122,15 @@ void GlobalBrightnessWidget::brightnessSliderChanged(int newBrightness) {
 }
 
 void GlobalBrightnessWidget::checkifOn() {
-    if (mElapsedTime.elapsed() > 5000) {
-        // get comm representation of lights
-        auto commLights = mComm->commLightsFromVector(mData->lights());
-
-        bool isAnyOn = false;
-        for (const auto& light : commLights) {
-            if (light.state().isOn()) {
-                isAnyOn = true;
-                break;
-            }
-        }
-        if (isAnyOn) {
-            mOnOffSwitch->switchOn();
-        } else {
-            mOnOffSwitch->switchOff();
-        }
+    auto elapsed = mElapsedTime.elapsed();
+    if (elapsed <= kUserChangeDelay) {
+        mOnOffCheckTimer->start(int(kUserChangeDelay - elapsed) + 1);
+        return;
+    }
+    if (mComm->lightStates()->selection().anyOn()) {
+        mOnOffSwitch->switchOn();
+    } else {
+        mOnOffSwitch->switchOff();
     }
 }
 
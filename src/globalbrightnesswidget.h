@@ -22,10 +22,7 @@ class GlobalBrightnessWidget : public QWidget {
     Q_OBJECT
 public:
     /// constructor
-    explicit GlobalBrightnessWidget(const QSize& size,
-                                    CommLayer* comm,
-                                    cor::LightList* data,
-                                    QWidget* parent);
+    explicit GlobalBrightnessWidget(const QSize& size, CommLayer* comm, QWidget* parent);
 
     /// programmatically set if on
     bool isOn(bool);
@@ -78,7 +75,7 @@ private slots:
      */
     void changedSwitchState(bool state);
 
-    /// called from a timer to check whether or not the all lights are currently on.
+    /// called when the selected lights report new states, to check whether any of them are on.
     void checkifOn();
 
 private:
@@ -105,10 +102,8 @@ private:
     /// pointer to CommLayer to check on/off state
     CommLayer* mComm;
 
-    /// pointer to currently selected lights for checking on/off state
-    cor::LightList* mData;
-
-    /// timer for checking whether or not the widget is on or off
+    /// timer for checking the on/off state once the user's last change has had time to reach the
+    /// lights.
     QTimer* mOnOffCheckTimer;
 };
 
@@ -6,6 +6,8 @@
 
 #include "icondata.h"
 
+#include "cor/routinesimulator.h"
+
 IconData::IconData()
     : mWidth{4},
       mHeight{4},
@@ -89,6 +91,38 @@ void IconData::setRoutine(const cor::LightState& state) {
     }
 }
 
+void IconData::setRoutineFrame(const cor::LightState& state, std::uint64_t frameIndex) {
+    // catch edge case where off lights display funny
+    if (!state.isOn()) {
+        setSolidColor(QColor(0, 0, 0));
+        return;
+    }
+
+    cor::RoutineSimulator simulator(state.routine(), mWidth * mHeight);
+    const auto& color = state.color();
+    simulator.color(
+        {std::uint8_t(color.red()), std::uint8_t(color.green()), std::uint8_t(color.blue())});
+    std::vector<cor::FrameColor> palette;
+    for (const auto& paletteColor : state.palette().colors()) {
+        palette.push_back({std::uint8_t(paletteColor.red()),
+                           std::uint8_t(paletteColor.green()),
+                           std::uint8_t(paletteColor.blue())});
+    }
+    simulator.palette(palette);
+    simulator.param(state.param());
+    simulator.speed(state.speed());
+    if (state.routine() > cor::ERoutineSingleColorEnd) {
+        simulator.brightness(int(state.paletteBrightness()));
+    }
+
+    auto frame = simulator.frame(frameIndex);
+    for (std::uint32_t i = 0; i < frame.size(); ++i) {
+        mBuffer[i * 3] = frame[i].red;
+        mBuffer[i * 3 + 1] = frame[i].green;
+        mBuffer[i * 3 + 2] = frame[i].blue;
+    }
+}
+
 void IconData::setSolidColor(const QColor& color) {
     for (std::uint32_t i = 0; i < mDataLength; i = i + 3) {
         mBuffer[i] = std::uint8_t(color.red());
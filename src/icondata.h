@@ -32,6 +32,17 @@ public:
      */
     void setRoutine(const cor::LightState& state);
 
+    /*!
+     * \brief setRoutineFrame sets the icon as a single frame of a lighting routine, as rendered by
+     * cor::RoutineSimulator. Unlike setRoutine, which draws a static representation of the routine,
+     * this shows what the hardware displays at the given frame, so stepping the frame index
+     * animates the icon.
+     *
+     * \param state the state of the light, including its routine, palette, and speed.
+     * \param frameIndex index of the frame to show.
+     */
+    void setRoutineFrame(const cor::LightState& state, std::uint64_t frameIndex);
+
     /*!
      * \brief setSolidColor sets the icon as a solid color
      */
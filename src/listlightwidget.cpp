@@ -63,6 +63,11 @@ void ListLightWidget::updateWidget(const cor::Light& light) {
         shouldRender = true;
         mHasRendered = false;
     }
+    if (light.uniqueID().toString() != mKey) {
+        // the widget is being reused to show a different light.
+        mKey = light.uniqueID().toString();
+        shouldRender = true;
+    }
 
     if (mHardwareType != light.hardwareType()) {
         mTypePixmap = lightHardwareTypeToPixmap(light.hardwareType());
@@ -40,7 +40,8 @@ public:
                              QWidget* parent);
 
     /*!
-     * \brief updateWidget update the widget with a new state for the light.
+     * \brief updateWidget update the widget with a new state for the light. If the light is a
+     * different light than the one being shown, the widget switches to showing the new light.
      *
      * \param light the new state of the light
      * \param colors all the color groups in the data layer, in case the light uses
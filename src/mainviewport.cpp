@@ -201,7 +201,7 @@ void MainViewport::showMainPage(EPage page, bool skipTransition) {
 }
 
 void MainViewport::loadMoodPage() {
-    mMoodPage->show(mData->findCurrentMood(mAppData->moods()->moods()));
+    mMoodPage->show(mData->findCurrentMood(mComm->moodPlans()));
 }
 
 void MainViewport::hideMainPage(EPage page) {
@@ -15,11 +15,11 @@
 #include <algorithm>
 #include "comm/commhue.h"
 #include "comm/commnanoleaf.h"
+#include "comm/lightstateservice.h"
 #include "stateobserver.h"
 #include "topmenu.h"
 #include "utils/exception.h"
 #include "utils/qt.h"
-#include "utils/reachability.h"
 
 namespace {
 bool mDebugMode = false;
@@ -30,8 +30,7 @@ MainWindow::MainWindow(QWidget* parent, const QSize& startingSize, const QSize&
     : QMainWindow(parent),
       mAnyDiscovered{false},
       mIsFirstActivation{true},
-      mWifiFound{cor::wifiEnabled()},
-      mWifiChecker{new QTimer(this)},
+      mWifiFound{false},
       mShareChecker{new QTimer(this)},
       mNoWifiWidget{new NoWifiWidget(this)},
       mAppData{new AppData(this)},
@@ -123,11 +122,16 @@ MainWindow::MainWindow(QWidget* parent, const QSize& startingSize, const QSize&
     // --------------
     // Setup Wifi Checker
     // --------------
-    // handle checking for wifi availability
-    connect(mWifiChecker, SIGNAL(timeout()), this, SLOT(wifiChecker()));
+    // the comm layer signals when the network's availability changes
+    connect(mComm, SIGNAL(networkAvailabilityChanged(bool)), this, SLOT(wifiChecker()));
+#ifdef USE_SERIAL
+    connect(mComm, SIGNAL(lightsAdded(std::vector<cor::LightID>)), this, SLOT(wifiChecker()));
+    connect(mComm, SIGNAL(lightsDeleted(std::vector<cor::LightID>)), this, SLOT(wifiChecker()));
+#endif
 
     mNoWifiWidget->setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed);
-    mNoWifiWidget->setVisible(true);
+    // availability is only signaled when it changes, so apply the state at startup.
+    wifiChecker();
 
     // --------------
     // Settings Page
@@ -201,6 +205,9 @@ void MainWindow::setupBackend() {
             SLOT(syncStatusChanged(EDataSyncType, bool)));
     // timeout does not announce its sync status since its run in the background.
 
+    // keep the totals of the selected lights' reported states in sync with the selection.
+    mComm->lightStates()->trackSelection(mData);
+
     // --------------
     // Start Discovery
     // --------------
@@ -211,11 +218,6 @@ void MainWindow::setupBackend() {
             mComm->startDiscovery(type);
         }
     }
-
-    // --------------
-    // Finish up wifi check
-    // --------------
-    mWifiChecker->start(2500);
 }
 
 
@@ -667,7 +669,7 @@ void MainWindow::greyoutClicked() {
 }
 
 void MainWindow::wifiChecker() {
-    mWifiFound = cor::wifiEnabled();
+    mWifiFound = mComm->isNetworkAvailable();
     if (mDebugMode) {
         mWifiFound = true;
     }
@@ -196,7 +196,9 @@ private slots:
     void loadingPageComplete();
 
     /*!
-     * \brief wifiChecker checks whether wifi is enabled.
+     * \brief wifiChecker shows or hides the no wifi screen. Called once at startup, when the
+     * network's availability changes, and when lights are added or deleted, since serial lights
+     * don't need wifi.
      */
     void wifiChecker();
 
@@ -288,9 +290,6 @@ private:
     /// true if wifi found, false otherwise
     bool mWifiFound;
 
-    /// timer for checking whether or not wifi is enabled.
-    QTimer* mWifiChecker;
-
     /// check the time it took lights to be discovered
     QElapsedTimer mTimeToLights;
 
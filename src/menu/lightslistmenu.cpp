@@ -73,8 +73,7 @@ void LightsListMenu::removeLight(const cor::Light& light) {
     } else {
         qDebug() << "ERROR: light not found, shouldn't get here " << light;
     }
-    mLightContainer->clear();
-    mLightContainer->addLights(mLights);
+    mLightContainer->removeLight(light.uniqueID());
 }
 
 void LightsListMenu::removeLights(const std::vector<cor::LightID>& keys) {
@@ -85,8 +84,7 @@ void LightsListMenu::removeLights(const std::vector<cor::LightID>& keys) {
             mLights.erase(result);
         }
     }
-    mLightContainer->clear();
-    mLightContainer->addLights(mLights);
+    mLightContainer->removeLights(keys);
 }
 
 
@@ -9,119 +9,186 @@
 
 
 void MenuLightContainer::addLights(const std::vector<cor::Light>& lights) {
+    // insert every row before binding, so the rows are sorted once and every visible row is bound
+    // with its new state.
     for (const auto& light : lights) {
-        auto widgetResult = mLightLayout.widget(light.uniqueID().toString());
-        if (widgetResult.second) {
-            auto existingWidget = qobject_cast<ListLightWidget*>(widgetResult.first);
-            Q_ASSERT(existingWidget);
-            existingWidget->updateWidget(light);
-        } else {
-            auto widget = new ListLightWidget(light, true, EListLightWidgetType::standard, this);
-            if (!mAllowInteraction) {
-                widget->allowInteraction(false);
-            }
-            if (!mDisplayState) {
-                widget->displayState(false);
-            }
-            connect(widget,
-                    SIGNAL(clicked(cor::LightID)),
-                    this,
-                    SLOT(handleLightClicked(cor::LightID)));
-            mLightLayout.insertWidget(widget);
-        }
+        mLights[light.uniqueID()] = light;
+        mRows.insert(light.uniqueID(), sortKey(light));
     }
-
-    mLightLayout.sortDeviceWidgets();
-    setFixedHeight(mRowHeight * lights.size());
     moveLightWidgets(QSize(parentWidget()->width(), mRowHeight), QPoint(this->width() / 20, 0));
 }
 
 void MenuLightContainer::updateLights(const std::vector<cor::Light>& lights) {
+    std::vector<const cor::Light*> updatedLights;
     for (const auto& light : lights) {
-        auto widgetResult = mLightLayout.widget(light.uniqueID().toString());
-        if (widgetResult.second) {
-            auto existingWidget = qobject_cast<ListLightWidget*>(widgetResult.first);
-            Q_ASSERT(existingWidget);
-            existingWidget->updateWidget(light);
+        auto result = mLights.find(light.uniqueID());
+        if (result != mLights.end()) {
+            result->second = light;
+            mRows.insert(light.uniqueID(), sortKey(light));
+            updatedLights.push_back(&result->second);
+        }
+    }
+    // only lights with a widget need to be redrawn, the rest are drawn when scrolled to. If a sort
+    // key changed, no light has a slot, and every visible row is rebound instead.
+    for (const auto* light : updatedLights) {
+        auto slot = mRows.slot(light->uniqueID());
+        if (slot != mRows.kInvalid) {
+            mWidgets[slot]->updateWidget(*light);
         }
     }
+    bindVisibleRows();
 }
 
 void MenuLightContainer::moveLightWidgets(QSize size, QPoint offset) {
-    auto actualSize = QSize(size.width() - offset.x(), size.height() - offset.y());
-    actualSize = mLightLayout.widgetSize(actualSize);
-    for (std::size_t i = 0u; i < mLightLayout.widgets().size(); ++i) {
-        mLightLayout.widgets()[i]->setVisible(true);
-        QPoint position = mLightLayout.widgetPosition(mLightLayout.widgets()[i]);
-        mLightLayout.widgets()[i]->setFixedSize(actualSize);
-        mLightLayout.widgets()[i]->setGeometry(offset.x() + position.x() * size.width(),
-                                               offset.y() + position.y() * size.height(),
-                                               actualSize.width(),
-                                               actualSize.height());
+    mRowSize = size;
+    mRowOffset = offset;
+    mRows.invalidate();
+    setFixedHeight(mRowHeight * int(mRows.size()));
+    bindVisibleRows();
+}
+
+void MenuLightContainer::bindVisibleRows() {
+    if (mRowSize.height() <= 0) {
+        return;
+    }
+    // the container is moved within its parent when scrolled, so the parent is the viewport.
+    int viewportHeight = height();
+    if (parentWidget() != nullptr) {
+        viewportHeight = parentWidget()->height();
+    }
+    for (const auto& binding : mRows.bind(-y(), viewportHeight, mRowSize.height())) {
+        bindSlot(binding.slot, binding.row);
+    }
+    for (auto slot : mRows.freeSlots()) {
+        if (slot < mWidgets.size()) {
+            mWidgets[slot]->setVisible(false);
+        }
     }
-    setFixedHeight(mRowHeight * mLightLayout.widgets().size());
+}
+
+void MenuLightContainer::bindSlot(std::size_t slot, std::size_t row) {
+    const auto& key = mRows.key(row);
+    const auto& light = mLights[key];
+    while (slot >= mWidgets.size()) {
+        auto widget = new ListLightWidget(light, true, EListLightWidgetType::standard, this);
+        if (!mAllowInteraction) {
+            widget->allowInteraction(false);
+        }
+        if (!mDisplayState) {
+            widget->displayState(false);
+        }
+        connect(widget,
+                SIGNAL(clicked(cor::LightID)),
+                this,
+                SLOT(handleLightClicked(cor::LightID)));
+        mWidgets.push_back(widget);
+    }
+
+    auto widget = mWidgets[slot];
+    widget->updateWidget(light);
+    widget->setHighlightChecked(mHighlightedLights.find(key) != mHighlightedLights.end());
+    widget->displayTimeout(mShowTimeouts);
+    if (mShowTimeouts) {
+        auto timeoutResult = mTimeouts.find(key);
+        if (timeoutResult != mTimeouts.end()) {
+            widget->updateTimeout(timeoutResult->second);
+        }
+    }
+
+    auto actualSize =
+        QSize(mRowSize.width() - mRowOffset.x(), mRowSize.height() - mRowOffset.y());
+    widget->setFixedSize(actualSize);
+    widget->setGeometry(mRowOffset.x(),
+                        mRowOffset.y() + int(row) * mRowSize.height(),
+                        actualSize.width(),
+                        actualSize.height());
+    widget->setVisible(true);
+}
+
+void MenuLightContainer::moveEvent(QMoveEvent*) {
+    bindVisibleRows();
+}
+
+void MenuLightContainer::resizeEvent(QResizeEvent*) {
+    bindVisibleRows();
 }
 
 std::vector<cor::LightID> MenuLightContainer::highlightedLights() {
     std::vector<cor::LightID> lights;
-    for (const auto& existingWidget : mLightLayout.widgets()) {
-        auto widget = qobject_cast<ListLightWidget*>(existingWidget);
-        Q_ASSERT(widget);
-        if (widget->checked()) {
-            lights.push_back(widget->key());
+    for (std::size_t row = 0u; row < mRows.size(); ++row) {
+        const auto& key = mRows.key(row);
+        if (mHighlightedLights.find(key) != mHighlightedLights.end()) {
+            lights.push_back(key);
         }
     }
     return lights;
 }
 
 void MenuLightContainer::clear() {
-    mLightLayout.clear();
+    mRows.clear();
+    mLights.clear();
+    mHighlightedLights.clear();
+    mTimeouts.clear();
+    bindVisibleRows();
 }
 
 void MenuLightContainer::removeLight(cor::LightID lightID) {
-    mLightLayout.removeWidget(lightID.toString());
-    setFixedHeight(mRowHeight * mLightLayout.count());
+    removeLights({lightID});
+}
+
+void MenuLightContainer::removeLights(const std::vector<cor::LightID>& lightIDs) {
+    for (const auto& lightID : lightIDs) {
+        mRows.remove(lightID);
+        mLights.erase(lightID);
+        mHighlightedLights.erase(lightID);
+        mTimeouts.erase(lightID);
+    }
     moveLightWidgets(QSize(parentWidget()->width(), mRowHeight), QPoint(this->width() / 20, 0));
 }
 
 void MenuLightContainer::handleLightClicked(cor::LightID light) {
+    // the widget toggles its own highlight, so keep track of it for when the widget is reused.
+    auto slot = mRows.slot(light);
+    if (slot != mRows.kInvalid) {
+        if (mWidgets[slot]->checked()) {
+            mHighlightedLights.insert(light);
+        } else {
+            mHighlightedLights.erase(light);
+        }
+    }
     emit clickedLight(light);
 }
 
 void MenuLightContainer::highlightLights(const std::vector<cor::LightID>& selectedLights) {
-    for (const auto& existingWidget : mLightLayout.widgets()) {
-        auto widget = qobject_cast<ListLightWidget*>(existingWidget);
-        Q_ASSERT(widget);
-        bool found = false;
-        for (const auto& ID : selectedLights) {
-            if (ID == widget->key()) {
-                found = true;
-                widget->setHighlightChecked(true);
-            }
-        }
-        if (!found) {
-            widget->setHighlightChecked(false);
+    mHighlightedLights = std::unordered_set<cor::LightID>(selectedLights.begin(),
+                                                          selectedLights.end());
+    for (std::size_t row = mRows.firstBoundRow(); row < mRows.lastBoundRow(); ++row) {
+        const auto& key = mRows.key(row);
+        auto slot = mRows.slot(key);
+        if (slot != mRows.kInvalid) {
+            mWidgets[slot]->setHighlightChecked(mHighlightedLights.find(key)
+                                                != mHighlightedLights.end());
         }
     }
 }
 
 void MenuLightContainer::showTimeouts(bool shouldShowTimeouts) {
-    for (const auto& existingWidget : mLightLayout.widgets()) {
-        auto widget = qobject_cast<ListLightWidget*>(existingWidget);
-        Q_ASSERT(widget);
-        widget->displayTimeout(shouldShowTimeouts);
-    }
+    mShowTimeouts = shouldShowTimeouts;
+    mRows.invalidate();
+    bindVisibleRows();
 }
 
 void MenuLightContainer::updateTimeouts(
     const std::vector<std::pair<cor::LightID, std::uint32_t>> keyTimeoutPairs) {
-    for (const auto& existingWidget : mLightLayout.widgets()) {
-        auto widget = qobject_cast<ListLightWidget*>(existingWidget);
-        Q_ASSERT(widget);
-        for (const auto& keyTimeoutPair : keyTimeoutPairs) {
-            if (keyTimeoutPair.first == widget->light().uniqueID().toString()) {
-                widget->updateTimeout(keyTimeoutPair.second);
-            }
+    for (const auto& keyTimeoutPair : keyTimeoutPairs) {
+        // timeouts of lights that are not in the menu are not kept, since they are never shown.
+        if (mLights.find(keyTimeoutPair.first) == mLights.end()) {
+            continue;
+        }
+        mTimeouts[keyTimeoutPair.first] = keyTimeoutPair.second;
+        auto slot = mRows.slot(keyTimeoutPair.first);
+        if (slot != mRows.kInvalid) {
+            mWidgets[slot]->updateTimeout(keyTimeoutPair.second);
         }
     }
 }
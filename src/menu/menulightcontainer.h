@@ -3,7 +3,9 @@
 
 #include <QScroller>
 #include <QWidget>
-#include "cor/listlayout.h"
+#include <unordered_map>
+#include <unordered_set>
+#include "cor/virtuallist.h"
 #include "listlightwidget.h"
 
 /*!
@@ -16,6 +18,11 @@
  * ListLightWidgets. This widget controls its own height so that it can properly display enough
  * lights. The widget signals the unique ID of a light when a light is clicked. Lights can be
  * highlighted when selected.
+ *
+ * Only the rows that are visible in the parent's viewport have a ListLightWidget. The lights are
+ * kept in a cor::VirtualList sorted by reachability and name, and when the container is scrolled,
+ * the widgets of rows that scroll out of view are reused for the rows that scroll into view. This
+ * keeps opening a menu with thousands of lights from creating thousands of widgets.
  */
 class MenuLightContainer : public QWidget {
     Q_OBJECT
@@ -23,9 +30,10 @@ public:
     /// constructor
     explicit MenuLightContainer(QWidget* parent, bool allowInteraction, const QString& name)
         : QWidget(parent),
-          mLightLayout(cor::EListType::oneColumn),
+          mAllowUnreachableLights{false},
           mAllowInteraction{allowInteraction},
           mDisplayState{true},
+          mShowTimeouts{false},
           mRowHeight{10},
           mName{name} {
         QScroller::grabGesture(this, QScroller::LeftMouseButtonGesture);
@@ -48,6 +56,9 @@ public:
     /// remove a light from the container.
     void removeLight(cor::LightID lightID);
 
+    /// remove lights from the container, sorting and binding the remaining rows once.
+    void removeLights(const std::vector<cor::LightID>& lightIDs);
+
     /// updates the state of the light widgets, but will not add new lights if they don't exist
     void updateLights(const std::vector<cor::Light>& lights);
 
@@ -74,13 +85,52 @@ signals:
     /// emits when a light is clicked
     void clickedLight(cor::LightID);
 
+protected:
+    /// called when the container is scrolled within its parent, binds rows that came into view.
+    void moveEvent(QMoveEvent*);
+
+    /// called when the container is resized, binds rows that came into view.
+    void resizeEvent(QResizeEvent*);
+
 private slots:
     /// handles when a light is clicked
     void handleLightClicked(cor::LightID light);
 
 private:
-    /// stores ListLightWidgets, which show lights
-    cor::ListLayout mLightLayout;
+    /// sort key of a light, unreachable lights are sorted after reachable lights.
+    using SortKey = std::pair<bool, QString>;
+
+    /// computes the sort key for a light.
+    static SortKey sortKey(const cor::Light& light) {
+        return std::make_pair(!light.isReachable(), light.name());
+    }
+
+    /// binds the rows that are visible to widgets, and hides the widgets that are not used.
+    void bindVisibleRows();
+
+    /// shows a light in the widget of the given slot, creating the widget if needed.
+    void bindSlot(std::size_t slot, std::size_t row);
+
+    /// sorted rows of lights, and which rows are shown by which widget.
+    cor::VirtualList<cor::LightID, SortKey> mRows;
+
+    /// lights shown by the container, keyed by their unique ID.
+    std::unordered_map<cor::LightID, cor::Light> mLights;
+
+    /// widgets that show the visible rows, indexed by slot.
+    std::vector<ListLightWidget*> mWidgets;
+
+    /// lights that are highlighted.
+    std::unordered_set<cor::LightID> mHighlightedLights;
+
+    /// seconds until each light times out, shown when mShowTimeouts is true.
+    std::unordered_map<cor::LightID, std::uint32_t> mTimeouts;
+
+    /// size of each row, as given to moveLightWidgets.
+    QSize mRowSize;
+
+    /// offset of the rows, as given to moveLightWidgets.
+    QPoint mRowOffset;
 
     /// true if you can select unreachable lights, false otherwise
     bool mAllowUnreachableLights;
@@ -91,6 +141,9 @@ private:
     /// true to display state of the lights, false to just display the metadata
     bool mDisplayState;
 
+    /// true to show the timeouts of the lights
+    bool mShowTimeouts;
+
     /// the height of a button.
     int mRowHeight;
 
@@ -65,8 +65,7 @@ void StatelessLightsListMenu::removeLight(const cor::LightID& ID) {
     if (result != mLights.end()) {
         mLights.erase(result);
     }
-    mLightContainer->clear();
-    mLightContainer->addLights(mComm->lightsByIDs(mLights));
+    mLightContainer->removeLight(ID);
 }
 
 void StatelessLightsListMenu::addLights(const std::vector<cor::LightID>& IDs) {
@@ -15,7 +15,6 @@ MoodSyncWidget::MoodSyncWidget(QWidget* parent, CommLayer* comm)
       mLastRenderTime{QTime::currentTime()} {
     mLightVector->hideOffLights(false);
     mLightVector->setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed);
-    mLightVector->enableButtonInteraction(false);
 
     connect(mRenderThread, SIGNAL(timeout()), this, SLOT(updateUI()));
     mRenderThread->start(100);
@@ -25,10 +24,10 @@ void MoodSyncWidget::changeState(ESyncState state, const cor::Mood& desiredMood)
     mSyncWidget->changeState(state);
     mMood = desiredMood;
 
-    auto moodDict = mComm->makeMood(desiredMood);
+    auto moodLights = mComm->makeMood(desiredMood);
 
     // get the current state of the mood lights from the comm layer
-    auto currentStates = mComm->lightsByIDs(cor::lightVectorToIDs(moodDict.items()));
+    auto currentStates = mComm->lightsByIDs(cor::lightVectorToIDs(moodLights));
     // display the current states
     mLightVector->updateLights(currentStates);
 }
@@ -48,10 +47,10 @@ void MoodSyncWidget::updateUI() {
 
 void MoodSyncWidget::updateLights() {
     mLastRenderTime = QTime::currentTime();
-    // make a mood dict
-    auto moodDict = mComm->makeMood(mMood);
+    // make the lights for the mood
+    auto moodLights = mComm->makeMood(mMood);
     // get the current state of the mood lights from the comm layer
-    auto currentStates = mComm->lightsByIDs(cor::lightVectorToIDs(moodDict.items()));
+    auto currentStates = mComm->lightsByIDs(cor::lightVectorToIDs(moodLights));
     // display the current states
     mLightVector->updateLights(currentStates);
 }
@@ -2,7 +2,10 @@
 #define ROUTINEWIDGET_H
 
 #include <QLabel>
+#include <QTimer>
+#include <algorithm>
 #include "cor/objects/lightstate.h"
+#include "cor/routinesimulator.h"
 #include "cor/stylesheets.h"
 #include "cor/widgets/checkbox.h"
 #include "icondata.h"
@@ -21,6 +24,9 @@
  * \brief The RoutineWidget class is the base class for QWidgets taht display a routine. This
  * provides the basic widgets needed to display and select a routine. Derived widgets may have
  * additional widgets to adjust the routine (such as sliders or buttons)
+ *
+ * The icon of the routine is animated with the frames of a cor::RoutineSimulator while the widget
+ * is visible, so it previews what the lights will show.
  */
 class RoutineWidget : public QWidget {
 public:
@@ -31,7 +37,9 @@ public:
           mRectOptions{cor::EPaintRectOptions::noBottom},
           mCheckBox{new cor::CheckBox(this)},
           mName{new QLabel(name, this)},
-          mIcon{new QLabel(this)} {
+          mIcon{new QLabel(this)},
+          mAnimationTimer{new QTimer(this)},
+          mFrameIndex{0u} {
         mState.isOn(true);
         mState.color(QColor(0, 0, 0));
         mState.routine(routine);
@@ -39,6 +47,11 @@ public:
         mCheckBox->checkboxState(ECheckboxState::unchecked);
 
         mName->setStyleSheet(cor::kTransparentStylesheet);
+
+        connect(mAnimationTimer, &QTimer::timeout, [this]() {
+            ++mFrameIndex;
+            updateStateIcon();
+        });
     }
 
     virtual ~RoutineWidget() = default;
@@ -47,6 +60,7 @@ public:
     void updateState(const cor::LightState& state) {
         mState = state;
         updateStateIcon();
+        updateAnimation();
     }
 
     /// change the size of the checkbox, label, and state widget in the top left of the widget
@@ -102,6 +116,12 @@ protected:
      */
     void resizeEvent(QResizeEvent*) override { resize(); }
 
+    /// starts animating the icon
+    void showEvent(QShowEvent*) override { updateAnimation(); }
+
+    /// stops animating the icon, so hidden routines do not render frames.
+    void hideEvent(QHideEvent*) override { mAnimationTimer->stop(); }
+
     /// implements the resizing of the widget
     virtual void resize() = 0;
 
@@ -112,9 +132,23 @@ protected:
         // routine widgets
     }
 
+    /// starts the animation timer at the speed of the routine, or stops it if the routine does not
+    /// animate or the widget is hidden.
+    void updateAnimation() {
+        cor::RoutineSimulator simulator(mState.routine(), 1u);
+        simulator.speed(mState.speed());
+        auto interval = int(simulator.frameInterval());
+        if (!isVisible() || interval == 0 || mState.routine() == ERoutine::singleSolid) {
+            mAnimationTimer->stop();
+            return;
+        }
+        // the icon is small, so there is no need to redraw it faster than a few times a second.
+        mAnimationTimer->start(std::max(interval, kMinimumFrameInterval));
+    }
+
     /// updates and resizes the state icon
     void updateStateIcon() {
-        mIconData.setRoutine(mState);
+        mIconData.setRoutineFrame(mState, mFrameIndex);
         QPixmap pixmap = mIconData.renderAsQPixmap();
         pixmap = pixmap.scaled(mIconSize.width(),
                                mIconSize.height(),
@@ -171,6 +205,15 @@ protected:
 
     /// the icon for the widget.
     QLabel* mIcon;
+
+    /// steps the frames of the icon
+    QTimer* mAnimationTimer;
+
+    /// frame of the routine shown in the icon
+    std::uint64_t mFrameIndex;
+
+    /// shortest msec between two frames of the icon
+    static constexpr int kMinimumFrameInterval = 100;
 };
 
 #endif // ROUTINEWIDGET_H
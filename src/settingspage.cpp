@@ -7,6 +7,7 @@
 #include "settingspage.h"
 
 #include <QDebug>
+#include <QFile>
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QPainter>
@@ -28,6 +29,7 @@
 //#define USE_DEBUG_OPTIONS
 #ifdef USE_DEBUG_OPTIONS
 const static char* kDebugSpoof = "DEBUG: Spoof Connection";
+const static char* kDebugExportMetrics = "DEBUG: Export Metrics";
 #endif
 
 SettingsPage::SettingsPage(QWidget* parent,
@@ -50,6 +52,7 @@ SettingsPage::SettingsPage(QWidget* parent,
 #endif
 #ifdef USE_DEBUG_OPTIONS
               kDebugSpoof,
+              kDebugExportMetrics,
 #endif
               "Reset",
               "Copyright"},
@@ -64,6 +67,11 @@ SettingsPage::SettingsPage(QWidget* parent,
     mAppVersionLabel->setVisible(false);
 #endif
 
+#ifdef USE_DEBUG_OPTIONS
+    // the metrics can be exported, so record the event loop's lag in them.
+    mComm->probeEventLoopLag(true);
+#endif
+
     mAppVersionLabel->setText(QString("v" + mAppVersionLabel->text()));
     mAppVersionLabel->setStyleSheet(cor::kTransparentStylesheet);
 
@@ -293,6 +301,19 @@ void SettingsPage::settingsButtonPressed(const QString& title) {
     else if (title == kDebugSpoof) {
         emit enableDebugMode();
         emit closePressed();
+    } else if (title == kDebugExportMetrics) {
+#ifdef MOBILE_BUILD
+        qDebug() << mComm->metrics().snapshotText().c_str();
+#else
+        auto fileName = QFileDialog::getSaveFileName(this,
+                                                     tr("Export Metrics"),
+                                                     "CorlumaMetrics.json",
+                                                     tr("JSON (*.json)"));
+        QFile file(fileName);
+        if (!fileName.isEmpty() && file.open(QFile::WriteOnly | QFile::Truncate)) {
+            file.write(mComm->metrics().snapshotJSON().c_str());
+        }
+#endif
     }
 #endif // USE_DEBUG_OPTIONS
     else if (title == "Copyright") {
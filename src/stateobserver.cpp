@@ -160,12 +160,12 @@ void StateObserver::protocolSettingsChanged(EProtocolType type, bool enabled) {
 }
 
 void StateObserver::moodChanged(cor::Mood mood) {
-    const auto& result = mAppData->moods()->moods().item(mood.uniqueID().toStdString());
-    if (result.second) {
+    const auto& plan = mComm->moodPlan(mood.uniqueID());
+    if (plan.moodID().isValid()) {
         mData->clearLights();
-        const auto& moodDict = mComm->makeMood(result.first);
-        mData->addMood(moodDict.items());
-        if (!moodDict.items().empty()) {
+        const auto& moodLights = mComm->lightsFromMoodPlan(plan);
+        mData->addMood(moodLights);
+        if (!moodLights.empty()) {
             mTopMenu->lightCountChanged();
         }
     }
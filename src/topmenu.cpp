@@ -8,6 +8,7 @@
 
 #include <QGraphicsEffect>
 
+#include "comm/lightstateservice.h"
 #include "lightspage.h"
 #include "mainwindow.h"
 #include "topmenu.h"
@@ -41,7 +42,7 @@ TopMenu::TopMenu(QWidget* parent,
       mLastColorButtonKey{"HSV"},
       mRenderTimer{new QTimer(this)},
       mMenuButton{new QPushButton(this)},
-      mGlobalBrightness{new GlobalBrightnessWidget(mSize, mComm, mData, this)},
+      mGlobalBrightness{new GlobalBrightnessWidget(mSize, mComm, this)},
       mPaletteAndRoutineFloatingLayout{new FloatingLayout(mMainWindow)},
       mAddNewFloatingLayout{new FloatingLayout(mMainWindow)},
       mColorFloatingLayout{new FloatingLayout(mMainWindow)},
@@ -53,9 +54,11 @@ TopMenu::TopMenu(QWidget* parent,
       mSelectLightsButton{new SelectLightsButton(this)},
       mDiscoveryTopMenu{new DiscoveryTopMenu(mMainWindow, mAppSettings, mLightsPage)} {
     mDiscoveryTopMenu->setVisible(false);
-    // start render timer
+    // render when the selected lights report new states, at most once per render interval.
+    mRenderTimer->setSingleShot(true);
+    mRenderTimer->setInterval(100);
     connect(mRenderTimer, SIGNAL(timeout()), this, SLOT(updateUI()));
-    mRenderTimer->start(100);
+    connect(mComm->lightStates(), SIGNAL(selectionUpdated()), this, SLOT(scheduleRender()));
 
     // --------------
     // Setup menu button
@@ -745,6 +748,12 @@ void TopMenu::moveHiddenLayouts() {
     }
 }
 
+void TopMenu::scheduleRender() {
+    if (!mRenderTimer->isActive()) {
+        mRenderTimer->start();
+    }
+}
+
 void TopMenu::updateUI() {
     // get copy of data representation of lights
     auto currentLights = mComm->commLightsFromVector(mData->lights());
@@ -154,6 +154,9 @@ private slots:
     /// updates the UI
     void updateUI();
 
+    /// renders an update for the UI soon, unless one is already scheduled.
+    void scheduleRender();
+
     /// called when any button in a floating layout is pressed.
     void floatingLayoutButtonPressed(const QString&);
 
@@ -270,7 +273,7 @@ private:
     /// last key for color page.
     QString mLastColorButtonKey;
 
-    /// renders an update for the UI periodically
+    /// renders an update for the UI shortly after the selected lights change
     QTimer* mRenderTimer;
 
     /// hamburger icon in top left for opening the main menu
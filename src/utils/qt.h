@@ -16,11 +16,9 @@
 #include <QPropertyAnimation>
 #include <QPushButton>
 #include <QScreen>
-#ifdef USE_QT_6
-#include <QRegularExpression>
-#endif
 
 #include "cor/stylesheets.h"
+#include "utils/qtcore.h"
 
 #define TRANSITION_TIME_MSEC 150
 
@@ -166,13 +164,6 @@ inline QColor blendColors(const QColor& color1, const QColor& color2, float rati
     return QColor(r, g, b);
 }
 
-/// converts a QTime into a pretty string, useful for debugging.
-QString makePrettyTimeOutput(QTime);
-
-/// QT6 and later uses QRegularExpression, Qt5 and earlier uses QRegExp, this function allows the
-/// app to compile for both.
-QStringList regexSplit(const QString& input, const QString& regex);
-
 /*!
  * \brief applicationSize this returns the size of the MainWindow, in a pretty ugly but effective
  *        way.
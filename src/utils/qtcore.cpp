@@ -0,0 +1,31 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include "utils/qtcore.h"
+
+namespace cor {
+
+QString makePrettyTimeOutput(QTime time) {
+    QString output = time.toString();
+    auto timeAgo = time.msecsTo(QTime::currentTime()) / 1000;
+    if (timeAgo > 300) {
+        timeAgo = timeAgo / 60.0;
+        return output + " (" + QString::number(timeAgo) + "min ago)";
+    }
+    return output + " (" + QString::number(timeAgo) + "s ago)";
+}
+
+std::vector<QStringView> tokenize(const QString& input, const cor::Tokenizer<char16_t>& tokenizer) {
+    std::vector<QStringView> tokens;
+    auto data = reinterpret_cast<const char16_t*>(input.utf16());
+    tokenizer.forEach(std::u16string_view(data, std::size_t(input.size())),
+                      [&tokens](std::u16string_view token) {
+                          tokens.emplace_back(token.data(), qsizetype(token.size()));
+                      });
+    return tokens;
+}
+
+} // namespace cor
@@ -0,0 +1,31 @@
+#ifndef COR_UTILS_QTCORE_H
+#define COR_UTILS_QTCORE_H
+
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ *
+ * Qt utils that only need QtCore, so that the backend can use them without the widget stack. Utils
+ * that need widgets are in utils/qt.h.
+ */
+
+#include <QString>
+#include <QStringView>
+#include <QTime>
+#include <vector>
+
+#include "cor/tokenizer.h"
+
+namespace cor {
+
+/// converts a QTime into a pretty string, useful for debugging.
+QString makePrettyTimeOutput(QTime);
+
+/// splits a QString on the delimiters of a tokenizer. The tokens point into the input, so the input
+/// must outlive them.
+std::vector<QStringView> tokenize(const QString& input, const cor::Tokenizer<char16_t>& tokenizer);
+
+} // namespace cor
+
+#endif // COR_UTILS_QTCORE_H
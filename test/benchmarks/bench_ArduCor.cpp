@@ -0,0 +1,116 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include <regex>
+#include <sstream>
+
+#include "benchmark.h"
+#include "comm/arducor/arducorpacketvalues.h"
+#include "comm/arducor/crccalculator.h"
+#include "cor/tokenizer.h"
+#include "fixtures.h"
+
+namespace {
+
+const std::size_t kFleetSize = 1000u;
+
+/// the packets of a fleet, with the CRC that a controller would send instead of the fixture's.
+std::vector<std::string> makePacketsWithCRC() {
+    auto packets = bench::makeArduCorPackets(bench::makeFleet(kFleetSize));
+    CRCCalculator crc;
+    for (auto& packet : packets) {
+        auto crcStart = packet.find('#');
+        packet = packet.substr(0u, crcStart) + "#"
+                 + std::to_string(crc.calculate(packet.data(), crcStart)) + ";";
+    }
+    return packets;
+}
+
+/// UDP datagrams hold several packets, separated by semicolons, like UDPWorker receives them.
+std::vector<std::string> makeDatagrams() {
+    auto packets = bench::makeArduCorPackets(bench::makeFleet(kFleetSize));
+    std::vector<std::string> datagrams;
+    for (std::size_t i = 0u; i + 1u < packets.size(); i += 2u) {
+        datagrams.push_back(packets[i] + packets[i + 1u]);
+    }
+    return datagrams;
+}
+
+bench::Registrar kCRC("arducor/crc of packets", [](bench::State& state) {
+    auto packets = bench::makeArduCorPackets(bench::makeFleet(kFleetSize));
+    CRCCalculator crc;
+    state.itemsPerIteration(packets.size());
+    while (state.keepRunning()) {
+        for (const auto& packet : packets) {
+            bench::doNotOptimize(crc.calculate(packet.data(), packet.size()));
+        }
+    }
+});
+
+bench::Registrar kValues("arducor/packet values", [](bench::State& state) {
+    auto packets = bench::makeArduCorPackets(bench::makeFleet(kFleetSize));
+    state.itemsPerIteration(packets.size());
+    while (state.keepRunning()) {
+        for (const auto& packet : packets) {
+            bench::doNotOptimize(arduCorPacketValues(packet).size());
+        }
+    }
+});
+
+bench::Registrar kDecode("arducor/decode packets and check crc", [](bench::State& state) {
+    // the whole decode done on the comm thread, splitting the values and checking the CRC.
+    auto packets = makePacketsWithCRC();
+    state.itemsPerIteration(packets.size());
+    while (state.keepRunning()) {
+        for (const auto& packet : packets) {
+            bench::doNotOptimize(decodeArduCorPacket(packet).isCRCValid);
+        }
+    }
+});
+
+bench::Registrar kDatagrams("arducor/datagrams to packet values", [](bench::State& state) {
+    auto datagrams = makeDatagrams();
+    const cor::Tokenizer<char> kPacketDelimiters(";");
+    state.itemsPerIteration(datagrams.size());
+    while (state.keepRunning()) {
+        for (const auto& datagram : datagrams) {
+            kPacketDelimiters.forEach(datagram, [](std::string_view packet) {
+                bench::doNotOptimize(arduCorPacketValues(packet).size());
+            });
+        }
+    }
+});
+
+bench::Registrar kRegexDatagrams("arducor/datagrams, regex and getline", [](bench::State& state) {
+    // the parse that the tokenizer replaced: a regex split into packets, then std::getline splits
+    // of the messages and values, and a stream for each number.
+    auto datagrams = makeDatagrams();
+    state.itemsPerIteration(datagrams.size());
+    while (state.keepRunning()) {
+        for (const auto& datagram : datagrams) {
+            std::regex regex("(\\;)");
+            std::sregex_token_iterator it(datagram.begin(), datagram.end(), regex, -1);
+            for (; it != std::sregex_token_iterator(); ++it) {
+                std::istringstream packet(it->str());
+                std::string message;
+                std::size_t values = 0u;
+                while (std::getline(packet, message, '&')) {
+                    std::istringstream messageStream(message);
+                    std::string number;
+                    while (std::getline(messageStream, number, ',')) {
+                        std::istringstream numberStream(number);
+                        int i = 0;
+                        numberStream >> i;
+                        ++values;
+                    }
+                }
+                bench::doNotOptimize(values);
+            }
+        }
+    }
+});
+
+} // namespace
@@ -0,0 +1,64 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include <QUdpSocket>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "benchmark.h"
+#include "comm/commthread.h"
+#include "comm/udpworker.h"
+#include "qtfixtures.h"
+
+namespace {
+
+const std::size_t kFleetSize = 1000u;
+
+/// port the worker listens on, away from the ports ArduCor controllers use.
+const quint16 kPort = 45321u;
+
+/// a datagram that never arrives is given up on after this long, so a lost datagram cannot hang
+/// the benchmark.
+const auto kTimeout = std::chrono::seconds(5);
+
+bench::Registrar kStress("comm/packets through the comm thread", [](bench::State& state) {
+    // every packet of a 1000 light fleet is sent over loopback, and an iteration ends once the
+    // comm thread decoded all of them.
+    bench::ensureApplication();
+    auto packets = bench::makeArduCorPackets(bench::makeFleet(kFleetSize));
+    std::atomic<std::size_t> received{0u};
+    CommThread thread;
+    auto worker = new UDPWorker();
+    thread.moveToThread(worker);
+    QObject::connect(worker,
+                     &UDPWorker::packetReceived,
+                     [&received](QString, QString, ArduCorPacket) { ++received; });
+    QMetaObject::invokeMethod(
+        worker,
+        [worker]() { worker->bind(QHostAddress::LocalHost, kPort); },
+        Qt::BlockingQueuedConnection);
+
+    QUdpSocket sender;
+    state.itemsPerIteration(packets.size());
+    std::size_t expected = 0u;
+    while (state.keepRunning()) {
+        for (const auto& packet : packets) {
+            auto size = qint64(packet.size());
+            sender.writeDatagram(packet.data(), size, QHostAddress::LocalHost, kPort);
+        }
+        expected += packets.size();
+        auto deadline = std::chrono::steady_clock::now() + kTimeout;
+        while (received < expected && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::yield();
+        }
+        // count lost datagrams as received, so the next iteration waits for its own.
+        received = expected;
+    }
+    // the worker is deleted by the thread as it stops.
+});
+
+} // namespace
@@ -0,0 +1,82 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include "benchmark.h"
+#include "cor/dictionary.h"
+#include "fixtures.h"
+
+namespace {
+
+const std::size_t kFleetSize = 5000u;
+
+bench::Registrar kInsert("dictionary/insert 5000 lights", [](bench::State& state) {
+    auto fleet = bench::makeFleet(kFleetSize);
+    state.itemsPerIteration(fleet.size());
+    while (state.keepRunning()) {
+        cor::Dictionary<std::string> dictionary;
+        for (const auto& light : fleet) {
+            dictionary.insert(light.uniqueID, light.name);
+        }
+        bench::doNotOptimize(dictionary.size());
+    }
+});
+
+bench::Registrar kItem("dictionary/item by key", [](bench::State& state) {
+    auto fleet = bench::makeFleet(kFleetSize);
+    cor::Dictionary<std::string> dictionary;
+    for (const auto& light : fleet) {
+        dictionary.insert(light.uniqueID, light.name);
+    }
+    state.itemsPerIteration(fleet.size());
+    while (state.keepRunning()) {
+        for (const auto& light : fleet) {
+            bench::doNotOptimize(dictionary.item(light.uniqueID).second);
+        }
+    }
+});
+
+bench::Registrar kKey("dictionary/key by item", [](bench::State& state) {
+    auto fleet = bench::makeFleet(kFleetSize);
+    cor::Dictionary<std::string> dictionary;
+    for (const auto& light : fleet) {
+        dictionary.insert(light.uniqueID, light.name);
+    }
+    state.itemsPerIteration(fleet.size());
+    while (state.keepRunning()) {
+        for (const auto& light : fleet) {
+            bench::doNotOptimize(dictionary.key(light.name).second);
+        }
+    }
+});
+
+bench::Registrar kUpdate("dictionary/update", [](bench::State& state) {
+    auto fleet = bench::makeFleet(kFleetSize);
+    cor::Dictionary<std::string> dictionary;
+    for (const auto& light : fleet) {
+        dictionary.insert(light.uniqueID, light.name);
+    }
+    state.itemsPerIteration(fleet.size());
+    std::size_t generation = 0u;
+    while (state.keepRunning()) {
+        auto suffix = std::to_string(++generation);
+        for (const auto& light : fleet) {
+            dictionary.update(light.uniqueID, light.name + suffix);
+        }
+    }
+});
+
+bench::Registrar kItems("dictionary/items", [](bench::State& state) {
+    auto fleet = bench::makeFleet(kFleetSize);
+    cor::Dictionary<std::string> dictionary;
+    for (const auto& light : fleet) {
+        dictionary.insert(light.uniqueID, light.name);
+    }
+    while (state.keepRunning()) {
+        bench::doNotOptimize(dictionary.items().size());
+    }
+});
+
+} // namespace
@@ -0,0 +1,67 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include "benchmark.h"
+#include "cor/discoveryscheduler.h"
+#include "cor/ssdpcache.h"
+#include "cor/ssdpmessage.h"
+#include "fixtures.h"
+
+namespace {
+
+/// an SSDP announcement of a hue bridge
+const std::string kHueNotify =
+    "NOTIFY * HTTP/1.1\r\n"
+    "HOST: 239.255.255.250:1900\r\n"
+    "CACHE-CONTROL: max-age=100\r\n"
+    "LOCATION: http://192.168.1.10:80/description.xml\r\n"
+    "SERVER: Linux/3.14.0 UPnP/1.0 IpBridge/1.26.0\r\n"
+    "NTS: ssdp:alive\r\n"
+    "hue-bridgeid: 001788FFFE100491\r\n"
+    "NT: upnp:rootdevice\r\n"
+    "USN: uuid:2f402f80-da50-11e1-9b23-001788100491::upnp:rootdevice\r\n"
+    "\r\n";
+
+bench::Registrar kParse("discovery/ssdp parse", [](bench::State& state) {
+    while (state.keepRunning()) {
+        bench::doNotOptimize(cor::SSDPMessage::parse(kHueNotify).second);
+    }
+});
+
+bench::Registrar kCache("discovery/ssdp cache of 50 devices", [](bench::State& state) {
+    // 50 devices announcing every 3 seconds, most of which are dropped as repeats.
+    std::vector<std::pair<std::string, cor::SSDPMessage>> messages;
+    for (auto i = 0; i < 50; ++i) {
+        auto message = kHueNotify;
+        message.replace(message.find("001788100491"), 12u, std::to_string(100000000000 + i));
+        messages.emplace_back("192.168.1." + std::to_string(i),
+                              cor::SSDPMessage::parse(message).first);
+    }
+    cor::SSDPCache cache(10000, 60000);
+    std::int64_t now = 0;
+    state.itemsPerIteration(messages.size());
+    while (state.keepRunning()) {
+        now += 3000;
+        for (const auto& message : messages) {
+            bench::doNotOptimize(cache.shouldPass(message.first, message.second, now));
+        }
+    }
+});
+
+bench::Registrar kScheduler("discovery/scheduler with 300 stale devices", [](bench::State& state) {
+    cor::DiscoveryScheduler<std::string> scheduler(2500, 300000, 8u, 5000, bench::kSeed);
+    auto fleet = bench::makeFleet(300u);
+    for (const auto& light : fleet) {
+        scheduler.track(0, light.uniqueID, 0, 0);
+    }
+    std::int64_t now = 0;
+    while (state.keepRunning()) {
+        now += 2500;
+        bench::doNotOptimize(scheduler.takeDue(0, now).size());
+    }
+});
+
+} // namespace
@@ -0,0 +1,81 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include "benchmark.h"
+#include "comm/hue/huelightparser.h"
+#include "fixtures.h"
+
+namespace {
+
+/// the most lights a single bridge supports.
+const std::size_t kBridgeSize = 50u;
+
+/// makes the reply to a request for every light of a bridge, with a mix of the types of lights.
+QByteArray makeLightsReply() {
+    QJsonObject reply;
+    int index = 1;
+    for (const auto& light : bench::makeFleet(kBridgeSize)) {
+        QJsonObject state;
+        state["on"] = light.isOn;
+        state["reachable"] = true;
+        state["bri"] = light.brightness * 254 / 100;
+        QJsonObject object;
+        switch (index % 4) {
+            case 0:
+                object["type"] = "Extended color light";
+                state["colormode"] = "xy";
+                state["xy"] = QJsonArray{0.3 + light.red / 1000.0, 0.3 + light.green / 1000.0};
+                break;
+            case 1:
+                object["type"] = "Extended color light";
+                state["colormode"] = "hs";
+                state["hue"] = light.red * 257;
+                state["sat"] = light.green;
+                break;
+            case 2:
+                object["type"] = "Color temperature light";
+                state["colormode"] = "ct";
+                state["ct"] = 153 + light.blue;
+                break;
+            default:
+                object["type"] = "Dimmable light";
+                break;
+        }
+        object["state"] = state;
+        object["name"] = QString::fromStdString(light.name);
+        object["modelid"] = "LCT016";
+        object["manufacturername"] = "Philips";
+        object["uniqueid"] = QString::fromStdString(light.uniqueID);
+        object["swversion"] = "1.46.13_r26312";
+        reply[QString::number(index)] = object;
+        ++index;
+    }
+    return QJsonDocument(reply).toJson(QJsonDocument::Compact);
+}
+
+bench::Registrar kParse("hue/parse reply for 50 lights", [](bench::State& state) {
+    // the comm thread parses the bytes of the reply, then decodes each light from the JSON.
+    auto reply = makeLightsReply();
+    state.itemsPerIteration(kBridgeSize);
+    while (state.keepRunning()) {
+        auto object = QJsonDocument::fromJson(reply).object();
+        bench::doNotOptimize(hue::parseLightUpdates(object).first.size());
+    }
+});
+
+bench::Registrar kDecode("hue/decode parsed reply for 50 lights", [](bench::State& state) {
+    auto object = QJsonDocument::fromJson(makeLightsReply()).object();
+    state.itemsPerIteration(kBridgeSize);
+    while (state.keepRunning()) {
+        bench::doNotOptimize(hue::parseLightUpdates(object).first.size());
+    }
+});
+
+} // namespace
@@ -0,0 +1,73 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include "benchmark.h"
+#include "cor/lightlist.h"
+#include "qtfixtures.h"
+
+namespace {
+
+/// number of selected lights, a large selection that should still stay under a msec per change.
+const std::size_t kSelectionSize = 2000u;
+
+bench::Registrar kSelect("lightlist/select and clear 2000 lights", [](bench::State& state) {
+    auto fleet = bench::makeQtFleet(kSelectionSize);
+    cor::LightList list(nullptr);
+    while (state.keepRunning()) {
+        list.addLights(fleet);
+        bench::doNotOptimize(list.brightness());
+        list.clearLights();
+    }
+});
+
+bench::Registrar kBrightness("lightlist/brightness drag on 2000 lights", [](bench::State& state) {
+    cor::LightList list(nullptr);
+    list.addLights(bench::makeQtFleet(kSelectionSize));
+    std::uint32_t brightness = 0u;
+    while (state.keepRunning()) {
+        brightness = (brightness + 1u) % 100u;
+        list.updateBrightness(brightness);
+        bench::doNotOptimize(list.brightness());
+    }
+});
+
+bench::Registrar kUpdateState("lightlist/update state of 2000 lights", [](bench::State& state) {
+    cor::LightList list(nullptr);
+    list.addLights(bench::makeQtFleet(kSelectionSize));
+    cor::LightState lightState;
+    lightState.isOn(true);
+    lightState.routine(ERoutine::singleSolid);
+    int hue = 0;
+    while (state.keepRunning()) {
+        hue = (hue + 1) % 360;
+        lightState.color(QColor::fromHsv(hue, 255, 255));
+        list.updateState(lightState);
+        bench::doNotOptimize(list.mainColor());
+    }
+});
+
+bench::Registrar kFindGroup("lightlist/find current group of 100", [](bench::State& state) {
+    auto fleet = bench::makeQtFleet(kSelectionSize);
+    std::vector<cor::Group> groups;
+    for (std::size_t i = 0u; i < 100u; ++i) {
+        std::vector<cor::LightID> lights;
+        for (std::size_t j = i * 20u; j < (i + 1u) * 20u; ++j) {
+            lights.push_back(fleet[j].uniqueID());
+        }
+        groups.emplace_back(cor::UUID(QString::number(i)),
+                            "Group " + QString::number(i),
+                            EGroupType::group,
+                            lights);
+    }
+    // the selection is the last group, so every group is checked.
+    cor::LightList list(nullptr);
+    list.addLights(std::vector<cor::Light>(fleet.end() - 20, fleet.end()));
+    while (state.keepRunning()) {
+        bench::doNotOptimize(list.findCurrentGroup(groups));
+    }
+});
+
+} // namespace
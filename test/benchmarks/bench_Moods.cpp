@@ -0,0 +1,78 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+#include "benchmark.h"
+#include "cor/objects/moodplan.h"
+#include "fixtures.h"
+#include "qtfixtures.h"
+
+namespace {
+
+const std::size_t kMoodCount = 500u;
+
+const std::size_t kLightCount = 1000u;
+
+/// lights in each mood
+const std::size_t kMoodSize = 40u;
+
+/// makes the plans of moods that each set a random subset of the fleet to a random state.
+std::vector<cor::MoodPlan> makePlans(const std::vector<cor::Light>& fleet) {
+    std::mt19937 random(bench::kSeed);
+    std::uniform_int_distribution<int> color(0, 255);
+    std::vector<std::size_t> indices(fleet.size());
+    std::iota(indices.begin(), indices.end(), 0u);
+    std::vector<cor::MoodPlan> plans;
+    plans.reserve(kMoodCount);
+    for (std::size_t i = 0u; i < kMoodCount; ++i) {
+        std::shuffle(indices.begin(), indices.end(), random);
+        std::vector<cor::Light> lights;
+        for (std::size_t j = 0u; j < kMoodSize; ++j) {
+            auto light = fleet[indices[j]];
+            auto state = light.state();
+            state.color(QColor(color(random), color(random), color(random)));
+            light.state(state);
+            lights.push_back(light);
+        }
+        plans.emplace_back(cor::UUID(QString::number(i)), lights);
+    }
+    return plans;
+}
+
+bench::Registrar kCompile("moods/index 500 moods over 1000 lights", [](bench::State& state) {
+    auto fleet = bench::makeQtFleet(kLightCount);
+    auto plans = makePlans(fleet);
+    state.itemsPerIteration(plans.size());
+    while (state.keepRunning()) {
+        cor::MoodPlanIndex index;
+        for (const auto& plan : plans) {
+            index.insert(plan);
+        }
+        bench::doNotOptimize(index.size());
+    }
+});
+
+bench::Registrar kFindMood("moods/find current mood of 500", [](bench::State& state) {
+    auto fleet = bench::makeQtFleet(kLightCount);
+    auto plans = makePlans(fleet);
+    cor::MoodPlanIndex index;
+    for (const auto& plan : plans) {
+        index.insert(plan);
+    }
+    // half of the lookups match a mood, the other half are a selection that matches nothing.
+    const auto& matching = plans[kMoodCount / 2u].lights();
+    std::vector<cor::Light> other(fleet.begin(), fleet.begin() + kMoodSize);
+    state.itemsPerIteration(2u);
+    while (state.keepRunning()) {
+        bench::doNotOptimize(index.findMood(matching));
+        bench::doNotOptimize(index.findMood(other));
+    }
+});
+
+} // namespace
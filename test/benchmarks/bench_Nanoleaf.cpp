@@ -0,0 +1,97 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark.h"
+#include "comm/nanoleaf/leafeffectcache.h"
+#include "fixtures.h"
+
+namespace {
+
+/// effects on a nanoleaf with a large library of downloaded effects.
+const int kEffectCount = 200;
+
+/// makes the reply to a request for every effect of a nanoleaf, with five colors per effect.
+QJsonArray makeAnimations() {
+    std::mt19937 random(bench::kSeed);
+    std::uniform_int_distribution<int> hue(0, 359);
+    QJsonArray animations;
+    for (int i = 0; i < kEffectCount; ++i) {
+        QJsonArray palette;
+        for (int j = 0; j < 5; ++j) {
+            QJsonObject color;
+            color["hue"] = hue(random);
+            color["saturation"] = 100;
+            color["brightness"] = 100;
+            palette.append(color);
+        }
+        QJsonObject animation;
+        animation["animName"] = "Effect " + QString::number(i);
+        animation["animType"] = "plugin";
+        animation["colorType"] = "HSB";
+        animation["pluginType"] = "color";
+        animation["pluginUuid"] = "027842e4-e1d6-4a4c-a731-be74a1ebd4cf";
+        animation["version"] = "2.0";
+        animation["palette"] = palette;
+        animations.append(animation);
+    }
+    return animations;
+}
+
+bench::Registrar kUnchanged("nanoleaf/effect cache of 200 unchanged", [](bench::State& state) {
+    auto animations = makeAnimations();
+    nano::LeafEffectCache cache;
+    std::vector<QJsonObject> changed;
+    std::vector<QString> removed;
+    cache.update(animations, changed, removed);
+    while (state.keepRunning()) {
+        bench::doNotOptimize(cache.update(animations, changed, removed));
+    }
+});
+
+bench::Registrar kOneChanged("nanoleaf/effect cache 1 of 200 changed", [](bench::State& state) {
+    // alternates between two lists that differ by one effect, so every update finds one change.
+    auto animations = makeAnimations();
+    auto edited = animations;
+    auto effect = edited[kEffectCount / 2].toObject();
+    effect["version"] = "2.1";
+    edited[kEffectCount / 2] = effect;
+    nano::LeafEffectCache cache;
+    std::vector<QJsonObject> changed;
+    std::vector<QString> removed;
+    bool isEdited = false;
+    while (state.keepRunning()) {
+        changed.clear();
+        isEdited = !isEdited;
+        bench::doNotOptimize(cache.update(isEdited ? edited : animations, changed, removed));
+    }
+});
+
+bench::Registrar kFirstFetch("nanoleaf/effect cache first fetch of 200", [](bench::State& state) {
+    // the cache is seeded with the stored effects, one of which was deleted from the nanoleaf.
+    auto animations = makeAnimations();
+    std::vector<std::string> stored;
+    for (int i = 0; i <= kEffectCount; ++i) {
+        stored.push_back("Effect " + std::to_string(i));
+    }
+    std::vector<QJsonObject> changed;
+    std::vector<QString> removed;
+    while (state.keepRunning()) {
+        nano::LeafEffectCache cache;
+        cache.seed(stored);
+        changed.clear();
+        removed.clear();
+        cache.update(animations, changed, removed);
+        bench::doNotOptimize(removed.size());
+    }
+});
+
+} // namespace
@@ -0,0 +1,54 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include <QColor>
+#include <QString>
+#include <vector>
+
+#include "benchmark.h"
+#include "comm/arducor/arducorpacketparser.h"
+#include "fixtures.h"
+
+namespace {
+
+const std::size_t kFleetSize = 1000u;
+
+/// makes the command packets that the app sends to change the state of each light of a fleet.
+std::vector<QString> makeCommandPackets(ArduCorPacketParser& parser) {
+    std::vector<QString> packets;
+    for (const auto& light : bench::makeFleet(kFleetSize)) {
+        packets.push_back(parser.turnOnPacket(light.index, light.isOn)
+                          + parser.brightnessPacket(light.index, light.brightness)
+                          + parser.arrayColorChangePacket(
+                              light.index, 0, QColor(light.red, light.green, light.blue)));
+    }
+    return packets;
+}
+
+bench::Registrar kParse("arducor/packet parser signals", [](bench::State& state) {
+    // parsing the palettes of routine packets is not covered, so there is no palette data.
+    ArduCorPacketParser parser(nullptr, nullptr);
+    auto packets = makeCommandPackets(parser);
+    std::size_t changes = 0u;
+    QObject::connect(&parser,
+                     &ArduCorPacketParser::receivedOnOffChange,
+                     [&changes](int, bool) { ++changes; });
+    QObject::connect(&parser,
+                     &ArduCorPacketParser::receivedBrightnessChange,
+                     [&changes](int, int) { ++changes; });
+    QObject::connect(&parser,
+                     &ArduCorPacketParser::receivedArrayColorChange,
+                     [&changes](int, int, QColor) { ++changes; });
+    state.itemsPerIteration(packets.size());
+    while (state.keepRunning()) {
+        for (const auto& packet : packets) {
+            parser.parsePacket(packet);
+        }
+    }
+    bench::doNotOptimize(changes);
+});
+
+} // namespace
@@ -0,0 +1,92 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include <vector>
+
+#include "benchmark.h"
+#include "cor/objects/lightstate.h"
+#include "cor/objects/palette.h"
+
+namespace {
+
+const std::size_t kLightCount = 10000u;
+
+/// palettes shared by the lights, most lights use one of a handful of palettes.
+const std::size_t kPaletteCount = 40u;
+
+/// makes the colors of a palette with 12 colors.
+std::vector<QColor> makeColors(std::size_t i) {
+    std::vector<QColor> colors;
+    for (int color = 0; color < 12; ++color) {
+        colors.push_back(QColor::fromHsv(int(i * 9u + std::size_t(color) * 30u) % 360, 255, 255));
+    }
+    return colors;
+}
+
+/// makes the states of a fleet, each with one of kPaletteCount palettes.
+std::vector<cor::LightState> makeStates() {
+    std::vector<cor::LightState> states;
+    states.reserve(kLightCount);
+    for (std::size_t i = 0u; i < kLightCount; ++i) {
+        cor::LightState state;
+        state.isOn(true);
+        auto index = i % kPaletteCount;
+        state.palette(cor::Palette(cor::UUID(QString::number(index)),
+                                   "Palette " + QString::number(index),
+                                   makeColors(index)));
+        states.push_back(state);
+    }
+    return states;
+}
+
+bench::Registrar kDefaultState("palette/default light state", [](bench::State& state) {
+    // every default state holds two default palettes, which share static data.
+    while (state.keepRunning()) {
+        cor::LightState lightState;
+        bench::doNotOptimize(lightState.palette().name());
+    }
+});
+
+bench::Registrar kInterned("palette/interned palette of 12 colors", [](bench::State& state) {
+    auto colors = makeColors(0u);
+    cor::UUID uniqueID("palette");
+    while (state.keepRunning()) {
+        cor::Palette palette(uniqueID, "Palette", colors);
+        bench::doNotOptimize(palette.colors().size());
+    }
+});
+
+bench::Registrar kUnshared("palette/unshared palette of 12 colors", [](bench::State& state) {
+    auto colors = makeColors(0u);
+    cor::UUID uniqueID("palette");
+    while (state.keepRunning()) {
+        auto palette = cor::Palette::unshared(uniqueID, "Palette", colors);
+        bench::doNotOptimize(palette.colors().size());
+    }
+});
+
+bench::Registrar kCopy("palette/copy 10000 light states", [](bench::State& state) {
+    auto states = makeStates();
+    state.itemsPerIteration(states.size());
+    while (state.keepRunning()) {
+        auto copy = states;
+        bench::doNotOptimize(copy.size());
+    }
+});
+
+bench::Registrar kCompare("palette/compare 10000 light states", [](bench::State& state) {
+    auto states = makeStates();
+    state.itemsPerIteration(states.size());
+    while (state.keepRunning()) {
+        std::size_t equal = 0u;
+        for (std::size_t i = 1u; i < states.size(); ++i) {
+            equal += states[i].palette() == states[i - 1u].palette() ? 1u : 0u;
+        }
+        bench::doNotOptimize(equal);
+    }
+});
+
+} // namespace
@@ -0,0 +1,59 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include <vector>
+
+#include "benchmark.h"
+#include "comm/nanoleaf/leafpanelimage.h"
+#include "qtfixtures.h"
+
+namespace {
+
+/// panels in a large layout of a single nanoleaf.
+const int kPanelCount = 30;
+
+/// makes the layout of a strip of triangles, alternating between pointing up and down.
+nano::Panels makePanels() {
+    QJsonArray positionData;
+    for (int i = 0; i < kPanelCount; ++i) {
+        QJsonObject panel;
+        panel["panelId"] = i + 1;
+        panel["x"] = i * 75;
+        panel["y"] = (i % 2) * 43;
+        panel["o"] = (i % 2) * 60;
+        panel["shapeType"] = int(EShapeType::triangle);
+        positionData.append(panel);
+    }
+    QJsonObject layout;
+    layout["numPanels"] = kPanelCount;
+    layout["sideLength"] = 150;
+    layout["positionData"] = positionData;
+    QJsonObject object;
+    object["layout"] = layout;
+    return nano::Panels(object);
+}
+
+bench::Registrar kDraw("nanoleaf/draw 30 panels", [](bench::State& state) {
+    // drawn each time the state or rotation of a nanoleaf in the light menus changes.
+    bench::ensureApplication();
+    auto panels = makePanels();
+    std::vector<QColor> colors;
+    for (int i = 0; i < 6; ++i) {
+        colors.push_back(QColor::fromHsv(i * 60, 255, 255));
+    }
+    cor::Palette palette(cor::UUID("bench"), "Bench", colors);
+    nano::LeafPanelImage image(nullptr);
+    int rotation = 0;
+    while (state.keepRunning()) {
+        rotation = (rotation + 15) % 360;
+        image.drawPanels(panels, rotation, palette, true);
+        bench::doNotOptimize(image.image().width());
+    }
+});
+
+} // namespace
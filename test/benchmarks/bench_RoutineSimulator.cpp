@@ -0,0 +1,47 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include <string>
+#include <vector>
+
+#include "benchmark.h"
+#include "cor/routinesimulator.h"
+#include "fixtures.h"
+
+namespace {
+
+const std::uint32_t kLightCount = 500u;
+
+cor::RoutineSimulator makeSimulator(ERoutine routine) {
+    cor::RoutineSimulator simulator(routine, kLightCount, bench::kSeed);
+    simulator.color({200u, 100u, 50u});
+    simulator.palette({{255u, 0u, 0u}, {0u, 255u, 0u}, {0u, 0u, 255u}, {255u, 255u, 0u}});
+    return simulator;
+}
+
+/// registers a benchmark of each routine, since their cost per frame differs.
+std::vector<bench::Registrar> registerRoutines() {
+    std::vector<bench::Registrar> registrars;
+    for (int routine = 0; routine < int(ERoutine::MAX); ++routine) {
+        auto name = "routines/frame of 500 lights, routine " + std::to_string(routine);
+        registrars.emplace_back(name, [routine](bench::State& state) {
+            auto simulator = makeSimulator(ERoutine(routine));
+            std::vector<cor::FrameColor> buffer;
+            std::uint64_t frame = 0u;
+            state.itemsPerIteration(kLightCount);
+            while (state.keepRunning()) {
+                simulator.renderFrame(frame, buffer);
+                bench::doNotOptimize(buffer.data());
+                ++frame;
+            }
+        });
+    }
+    return registrars;
+}
+
+const auto kRoutines = registerRoutines();
+
+} // namespace
@@ -0,0 +1,159 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include <algorithm>
+#include <memory>
+
+#include "benchmark.h"
+#include "cor/deltaqueue.h"
+#include "cor/interner.h"
+#include "cor/palettesignature.h"
+#include "cor/timingwheel.h"
+#include "cor/virtuallist.h"
+#include "fixtures.h"
+
+namespace {
+
+const std::size_t kFleetSize = 5000u;
+
+bench::Registrar kDeltaQueue("state/delta queue push and drain", [](bench::State& state) {
+    // state updates for a fleet, each light updated a few times per frame.
+    auto fleet = bench::makeFleet(500u);
+    cor::DeltaQueue<std::string, int> queue(4096u);
+    state.itemsPerIteration(fleet.size() * 4u);
+    while (state.keepRunning()) {
+        for (auto i = 0; i < 4; ++i) {
+            for (const auto& light : fleet) {
+                queue.push(light.uniqueID, light.brightness + i);
+            }
+        }
+        queue.drain([](const std::string&, int value) { bench::doNotOptimize(value); });
+    }
+});
+
+bench::Registrar kTimingWheel("state/timing wheel reschedule", [](bench::State& state) {
+    // every light is heard from every second, so its reachability deadline is pushed back.
+    auto fleet = bench::makeFleet(kFleetSize);
+    cor::TimingWheel<std::string> wheel(100, 256u);
+    std::int64_t now = 0;
+    state.itemsPerIteration(fleet.size());
+    while (state.keepRunning()) {
+        now += 1000;
+        for (const auto& light : fleet) {
+            wheel.schedule(light.uniqueID, now + 15000);
+        }
+        wheel.advance(now, [](const std::string& key) { bench::doNotOptimize(key); });
+    }
+});
+
+std::vector<cor::PaletteSignature::Color> paletteColors(const std::vector<bench::FleetLight>& fleet,
+                                                        std::size_t first) {
+    std::vector<cor::PaletteSignature::Color> colors;
+    for (std::size_t i = first; i < first + 12u && i < fleet.size(); ++i) {
+        colors.push_back({std::uint8_t(fleet[i].red),
+                          std::uint8_t(fleet[i].green),
+                          std::uint8_t(fleet[i].blue),
+                          -1.0f});
+    }
+    return colors;
+}
+
+bench::Registrar kSignature("state/palette signature", [](bench::State& state) {
+    auto colors = paletteColors(bench::makeFleet(12u), 0u);
+    while (state.keepRunning()) {
+        bench::doNotOptimize(cor::PaletteSignature(colors).hash());
+    }
+});
+
+bench::Registrar kSignatureMatch("state/palette signature match", [](bench::State& state) {
+    auto fleet = bench::makeFleet(24u);
+    cor::PaletteSignature a(paletteColors(fleet, 0u));
+    auto reversed = paletteColors(fleet, 0u);
+    std::reverse(reversed.begin(), reversed.end());
+    cor::PaletteSignature b(reversed);
+    cor::PaletteSignature c(paletteColors(fleet, 12u));
+    while (state.keepRunning()) {
+        bench::doNotOptimize(a.matches(b, 0.05f));
+        bench::doNotOptimize(a.matches(c, 0.05f));
+    }
+});
+
+bench::Registrar kCopySortMatch("state/palette copy and sort match", [](bench::State& state) {
+    // what a sync check did before signatures: copy, sort by hue, and compare both palettes.
+    auto sent = paletteColors(bench::makeFleet(12u), 0u);
+    auto received = sent;
+    std::reverse(received.begin(), received.end());
+    auto lessThan = [](const cor::PaletteSignature::Color& a,
+                       const cor::PaletteSignature::Color& b) {
+        return cor::PaletteSignature::hue(a.red, a.green, a.blue)
+               < cor::PaletteSignature::hue(b.red, b.green, b.blue);
+    };
+    while (state.keepRunning()) {
+        auto sortedSent = sent;
+        std::sort(sortedSent.begin(), sortedSent.end(), lessThan);
+        auto sortedReceived = received;
+        std::sort(sortedReceived.begin(), sortedReceived.end(), lessThan);
+        bool matches = true;
+        for (std::size_t i = 0u; i < sortedSent.size(); ++i) {
+            matches = matches
+                      && cor::PaletteSignature::difference(sortedSent[i], sortedReceived[i])
+                             <= 0.05f;
+        }
+        bench::doNotOptimize(matches);
+    }
+});
+
+/// stands in for the data of an interned palette
+struct PaletteData {
+    std::string name;
+    std::vector<std::uint32_t> colors;
+
+    bool operator==(const PaletteData& rhs) const {
+        return name == rhs.name && colors == rhs.colors;
+    }
+};
+
+struct PaletteDataHash {
+    std::size_t operator()(const PaletteData& data) const {
+        auto hash = std::hash<std::string>{}(data.name);
+        for (auto color : data.colors) {
+            hash ^= std::hash<std::uint32_t>{}(color) + 0x9e3779b9u + (hash << 6u) + (hash >> 2u);
+        }
+        return hash;
+    }
+};
+
+bench::Registrar kInterner("state/intern palettes of a fleet", [](bench::State& state) {
+    // lights share a handful of palettes, so almost every intern finds an existing palette.
+    auto fleet = bench::makeFleet(kFleetSize);
+    cor::Interner<PaletteData, PaletteDataHash> interner;
+    std::vector<std::shared_ptr<const PaletteData>> palettes;
+    state.itemsPerIteration(fleet.size());
+    while (state.keepRunning()) {
+        palettes.clear();
+        for (const auto& light : fleet) {
+            auto palette = std::uint32_t(light.index);
+            auto name = "palette" + std::to_string(palette);
+            palettes.push_back(
+                interner.intern(PaletteData{name, {palette, palette + 1u, palette + 2u}}));
+        }
+    }
+});
+
+bench::Registrar kVirtualList("state/light menu scroll", [](bench::State& state) {
+    auto fleet = bench::makeFleet(kFleetSize);
+    cor::VirtualList<std::string, std::pair<bool, std::string>> list;
+    for (const auto& light : fleet) {
+        list.insert(light.uniqueID, {!light.isOn, light.name});
+    }
+    int top = 0;
+    while (state.keepRunning()) {
+        top = (top + 40) % (int(kFleetSize) * 40);
+        bench::doNotOptimize(list.bind(top, 600, 40).size());
+    }
+});
+
+} // namespace
@@ -0,0 +1,54 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "benchmark.h"
+#include "cor/timeouttable.h"
+
+namespace {
+
+const int kLightCount = 1000;
+
+/// makes a table of lights that were all synced at time 0, with a 60 second refresh.
+cor::TimeoutTable<std::string> makeTable() {
+    cor::TimeoutTable<std::string> table(60000);
+    for (auto i = 0; i < kLightCount; ++i) {
+        table.desiredTimeout("light" + std::to_string(i), 30, 0, true);
+    }
+    for (const auto& key : table.takeDirty()) {
+        table.synced(key, 0);
+    }
+    return table;
+}
+
+bench::Registrar kNoneDue("timeouts/activity with none of 1000 due", [](bench::State& state) {
+    auto table = makeTable();
+    std::int64_t now = 0;
+    while (state.keepRunning()) {
+        // stays within the refresh interval of the last sync, so no light is ever due.
+        now = (now + 10) % 60000;
+        table.activity(now);
+        bench::doNotOptimize(table.takeDirty().size());
+    }
+});
+
+bench::Registrar kAllDue("timeouts/activity with all of 1000 due", [](bench::State& state) {
+    auto table = makeTable();
+    std::int64_t now = 0;
+    state.itemsPerIteration(kLightCount);
+    while (state.keepRunning()) {
+        now += 60000;
+        table.activity(now);
+        for (const auto& key : table.takeDirty()) {
+            table.synced(key, now);
+        }
+    }
+});
+
+} // namespace
@@ -0,0 +1,61 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include <QJsonObject>
+#include <vector>
+
+#include "benchmark.h"
+#include "comm/hue/bridge.h"
+
+namespace {
+
+const int kLightCount = 1000;
+
+/// schedules on the bridge, the limit of a hue bridge is 100.
+const int kScheduleCount = 50;
+
+/// makes a bridge with a timeout schedule for each of its first kScheduleCount lights.
+hue::Bridge makeBridge() {
+    cor::Dictionary<hue::Schedule> schedules;
+    for (int i = 0; i < kScheduleCount; ++i) {
+        QJsonObject command;
+        command["address"] = "/api/username/lights/" + QString::number(i) + "/state";
+        command["method"] = "PUT";
+        command["body"] = QJsonObject{{"on", false}};
+        QJsonObject object;
+        object["name"] = "Corluma_timeout_" + QString::number(i);
+        object["command"] = command;
+        object["localtime"] = "PT00:30:00";
+        object["time"] = "PT00:30:00";
+        object["created"] = "2020-01-01T00:00:00";
+        object["status"] = "enabled";
+        hue::Schedule schedule(object, i);
+        schedules.insert(schedule.name().toStdString(), schedule);
+    }
+    hue::Bridge bridge("192.168.0.2", "Bridge", "bridge");
+    bridge.schedules(schedules);
+    return bridge;
+}
+
+bench::Registrar kFullPass("timeouts/old pass over 1000 hue lights", [](bench::State& state) {
+    // the sync pass before the TimeoutTable visited every light. For each light, CommHue copied
+    // the bridge twice and its schedules once to find the light's timeout. This repeats those
+    // copies and lookups with the real bridge and schedule types.
+    std::vector<hue::Bridge> bridges{makeBridge()};
+    state.itemsPerIteration(kLightCount);
+    while (state.keepRunning()) {
+        for (int i = 0; i < kLightCount; ++i) {
+            auto bridge = bridges[0];
+            auto timeoutBridge = bridges[0];
+            auto name = "Corluma_timeout_" + QString::number(i);
+            auto result = timeoutBridge.schedules().item(name.toStdString());
+            bench::doNotOptimize(result.second);
+            bench::doNotOptimize(bridge.id());
+        }
+    }
+});
+
+} // namespace
@@ -0,0 +1,86 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "benchmark.h"
+#include "cor/timingwheel.h"
+
+namespace {
+
+/// lights that are polled every second, with a 15 second threshold and 100 msec ticks.
+const int kLightCount = 20000;
+
+const std::int64_t kThreshold = 15000;
+
+std::vector<std::string> makeKeys() {
+    std::vector<std::string> keys;
+    keys.reserve(kLightCount);
+    for (auto i = 0; i < kLightCount; ++i) {
+        keys.push_back("light" + std::to_string(i));
+    }
+    return keys;
+}
+
+bench::Registrar kIdleTick("timingwheel/idle tick with 20000 lights", [](bench::State& state) {
+    // deadlines are spread over the wheel like the 15 second threshold spreads them, but far
+    // enough out that no tick of the run expires a key.
+    const std::int64_t kFarFuture = std::int64_t(1) << 40;
+    auto keys = makeKeys();
+    cor::TimingWheel<std::string> wheel(100, 256u);
+    for (std::size_t i = 0u; i < keys.size(); ++i) {
+        wheel.schedule(keys[i], kFarFuture + std::int64_t(i % 150u) * 100);
+    }
+    std::int64_t now = 0;
+    while (state.keepRunning()) {
+        now += 100;
+        bench::doNotOptimize(wheel.advance(now, [](const std::string&) {}));
+    }
+});
+
+bench::Registrar kReschedule("timingwheel/reschedule 2000 of 20000", [](bench::State& state) {
+    // one tick of packets, a tenth of the lights are heard from every 100 msec.
+    auto keys = makeKeys();
+    cor::TimingWheel<std::string> wheel(100, 256u);
+    for (const auto& key : keys) {
+        wheel.schedule(key, kThreshold);
+    }
+    std::size_t next = 0u;
+    std::int64_t now = 0;
+    state.itemsPerIteration(keys.size() / 10u);
+    while (state.keepRunning()) {
+        now += 100;
+        for (std::size_t i = 0u; i < keys.size() / 10u; ++i) {
+            wheel.schedule(keys[next], now + kThreshold);
+            next = (next + 1u) % keys.size();
+        }
+    }
+});
+
+bench::Registrar kScan("timingwheel/full scan of 20000 lights", [](bench::State& state) {
+    // the scan that the timing wheel replaces, which looks up every light's update time each tick.
+    auto keys = makeKeys();
+    std::unordered_map<std::string, std::int64_t> updateTimes;
+    for (const auto& key : keys) {
+        updateTimes[key] = 0;
+    }
+    std::int64_t now = 0;
+    while (state.keepRunning()) {
+        now += 100;
+        std::size_t unreachable = 0u;
+        for (const auto& key : keys) {
+            if (updateTimes.find(key)->second < now - kThreshold) {
+                ++unreachable;
+            }
+        }
+        bench::doNotOptimize(unreachable);
+    }
+});
+
+} // namespace
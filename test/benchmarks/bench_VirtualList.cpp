@@ -0,0 +1,118 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "benchmark.h"
+#include "cor/virtuallist.h"
+
+namespace {
+
+const int kLightCount = 5000;
+
+/// sorts unreachable lights last, then by name, like the light menu.
+using SortKey = std::pair<bool, std::string>;
+
+using List = cor::VirtualList<std::string, SortKey>;
+
+/*!
+ * a mock of a ListLightWidget, not a QWidget. It has a virtual getter like the widget did when the
+ * menu sorted widgets, and a 2 KB payload as a rough stand in for the pixmaps and labels of each
+ * widget. These benchmarks measure allocating and sorting widgets, not the cost or the memory of
+ * creating real widgets, which is higher.
+ */
+class MockWidget {
+public:
+    MockWidget(std::string name, bool reachable) : mName{std::move(name)}, mReachable{reachable} {}
+    virtual ~MockWidget() = default;
+    virtual const std::string& name() const { return mName; }
+    virtual bool isReachable() const { return mReachable; }
+
+private:
+    std::string mName;
+    bool mReachable;
+    char mPayload[2048] = {};
+};
+
+/// the lights of the menu, in a scrambled order with every tenth light unreachable.
+std::vector<std::pair<std::string, SortKey>> makeLights() {
+    std::vector<std::pair<std::string, SortKey>> lights;
+    for (auto i = 0; i < kLightCount; ++i) {
+        auto key = "light" + std::to_string((i * 7919) % kLightCount);
+        lights.emplace_back(key, SortKey{i % 10 == 0, key});
+    }
+    return lights;
+}
+
+bench::Registrar kEveryWidget("virtuallist/open menu, 5000 mock widgets", [](bench::State& state) {
+    // the previous menu created a widget for every light, then sorted the widgets.
+    auto lights = makeLights();
+    while (state.keepRunning()) {
+        std::vector<std::unique_ptr<MockWidget>> widgets;
+        for (const auto& light : lights) {
+            widgets.emplace_back(new MockWidget(light.first, !light.second.first));
+        }
+        std::sort(widgets.begin(), widgets.end(), [](const auto& a, const auto& b) {
+            if (a->isReachable() != b->isReachable()) {
+                return a->isReachable();
+            }
+            return a->name() < b->name();
+        });
+        bench::doNotOptimize(widgets.size());
+    }
+});
+
+bench::Registrar kVisible("virtuallist/open menu, mock widgets for rows", [](bench::State& state) {
+    auto lights = makeLights();
+    while (state.keepRunning()) {
+        List list;
+        std::vector<std::unique_ptr<MockWidget>> widgets;
+        for (const auto& light : lights) {
+            list.insert(light.first, light.second);
+        }
+        for (const auto& binding : list.bind(0, 600, 40)) {
+            if (binding.slot >= widgets.size()) {
+                widgets.resize(binding.slot + 1u);
+            }
+            widgets[binding.slot].reset(new MockWidget(list.key(binding.row), true));
+        }
+        bench::doNotOptimize(list.slotCount());
+    }
+});
+
+bench::Registrar kInsert("virtuallist/insert and find slot, 5000 rows", [](bench::State& state) {
+    // the menu looks up the slot of each light it adds or updates, to redraw its widget.
+    auto lights = makeLights();
+    while (state.keepRunning()) {
+        List list;
+        list.bind(0, 600, 40);
+        std::size_t bound = 0u;
+        for (const auto& light : lights) {
+            list.insert(light.first, light.second);
+            bound += list.slot(light.first) != List::kInvalid;
+        }
+        bench::doNotOptimize(bound);
+    }
+});
+
+bench::Registrar kScroll("virtuallist/scroll 5000 rows by one row", [](bench::State& state) {
+    List list;
+    for (const auto& light : makeLights()) {
+        list.insert(light.first, light.second);
+    }
+    list.bind(0, 600, 40);
+    int top = 0;
+    while (state.keepRunning()) {
+        top = (top + 40) % (kLightCount * 40);
+        bench::doNotOptimize(list.bind(top, 600, 40).size());
+    }
+});
+
+} // namespace
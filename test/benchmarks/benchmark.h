@@ -0,0 +1,113 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace bench {
+
+/*!
+ * \brief The State class is given to each benchmark, and times the loop that calls keepRunning().
+ * Setup done before the loop is not timed. A benchmark that does more than one operation per
+ * iteration sets the number of items, so results are reported per item.
+ */
+class State {
+public:
+    /// constructor
+    explicit State(std::uint64_t iterations)
+        : mIterations{iterations},
+          mCount{0u},
+          mItemsPerIteration{1u} {}
+
+    /// true while the benchmark should run another iteration.
+    bool keepRunning() {
+        if (mCount == 0u) {
+            mStart = Clock::now();
+        }
+        if (mCount < mIterations) {
+            ++mCount;
+            return true;
+        }
+        mEnd = Clock::now();
+        return false;
+    }
+
+    /// number of iterations that are run
+    std::uint64_t iterations() const noexcept { return mIterations; }
+
+    /// sets the number of items handled by each iteration
+    void itemsPerIteration(std::uint64_t items) noexcept { mItemsPerIteration = items; }
+
+    /// number of items handled by each iteration
+    std::uint64_t itemsPerIteration() const noexcept { return mItemsPerIteration; }
+
+    /// time spent in the loop, in nsec
+    double elapsedNanoseconds() const {
+        return double(std::chrono::duration_cast<std::chrono::nanoseconds>(mEnd - mStart).count());
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    /// number of iterations that are run
+    std::uint64_t mIterations;
+
+    /// number of iterations started
+    std::uint64_t mCount;
+
+    /// number of items handled by each iteration
+    std::uint64_t mItemsPerIteration;
+
+    /// time the loop started
+    Clock::time_point mStart;
+
+    /// time the loop ended
+    Clock::time_point mEnd;
+};
+
+/// a benchmark and its name
+struct Benchmark {
+    /// name, as "group/case"
+    std::string name;
+
+    /// function that runs the benchmark
+    std::function<void(State&)> function;
+};
+
+/// all registered benchmarks
+inline std::vector<Benchmark>& registry() {
+    static std::vector<Benchmark> benchmarks;
+    return benchmarks;
+}
+
+/// registers a benchmark when it is constructed, used as a static in each benchmark file.
+struct Registrar {
+    Registrar(std::string name, std::function<void(State&)> function) {
+        registry().push_back(Benchmark{std::move(name), std::move(function)});
+    }
+};
+
+/// keeps the compiler from optimizing away a value that is computed but not used.
+template <typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+} // namespace bench
+
+#endif // BENCHMARK_H
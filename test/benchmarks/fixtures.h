@@ -0,0 +1,94 @@
+#ifndef BENCHMARK_FIXTURES_H
+#define BENCHMARK_FIXTURES_H
+
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+/// seed used by every fixture, so that every run benchmarks the same data.
+const std::uint32_t kSeed = 20200101u;
+
+/// a light in a synthetic fleet
+struct FleetLight {
+    /// unique ID of the light
+    std::string uniqueID;
+
+    /// name of the light
+    std::string name;
+
+    /// index of the light on its controller
+    int index;
+
+    /// true if the light is on
+    bool isOn;
+
+    /// red value of the light
+    int red;
+
+    /// green value of the light
+    int green;
+
+    /// blue value of the light
+    int blue;
+
+    /// brightness of the light, between 0 and 100
+    int brightness;
+};
+
+/// makes a fleet of lights, with IDs that look like the IDs of hue and nanoleaf lights.
+inline std::vector<FleetLight> makeFleet(std::size_t count) {
+    std::mt19937 random(kSeed);
+    std::uniform_int_distribution<int> color(0, 255);
+    std::uniform_int_distribution<int> brightness(0, 100);
+    std::vector<FleetLight> fleet;
+    fleet.reserve(count);
+    for (std::size_t i = 0u; i < count; ++i) {
+        auto number = std::to_string(i);
+        auto padding = std::string(8u - std::min<std::size_t>(8u, number.size()), '0');
+        fleet.push_back({"00:17:88:01:" + padding + number + "-0b",
+                         "Light " + number,
+                         int(i % 10u) + 1,
+                         random() % 2u == 0u,
+                         color(random),
+                         color(random),
+                         color(random),
+                         brightness(random)});
+    }
+    return fleet;
+}
+
+/// makes the packets an ArduCor controller sends for the lights of a fleet, with a CRC.
+inline std::vector<std::string> makeArduCorPackets(const std::vector<FleetLight>& fleet) {
+    std::vector<std::string> packets;
+    std::string packet;
+    for (std::size_t i = 0u; i < fleet.size(); ++i) {
+        const auto& light = fleet[i];
+        // state update: header, index, on, reachable, red, green, blue, white, brightness,
+        // routine, speed, timeout
+        packet += "7," + std::to_string(light.index) + "," + std::to_string(int(light.isOn))
+                  + ",1," + std::to_string(light.red) + "," + std::to_string(light.green) + ","
+                  + std::to_string(light.blue) + ",0," + std::to_string(light.brightness)
+                  + ",0,425,120&";
+        if (light.index == 10 || i + 1u == fleet.size()) {
+            auto crc = std::hash<std::string>{}(packet) % 100000u;
+            packets.push_back(packet + "#" + std::to_string(crc) + ";");
+            packet.clear();
+        }
+    }
+    return packets;
+}
+
+} // namespace bench
+
+#endif // BENCHMARK_FIXTURES_H
@@ -0,0 +1,193 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ *
+ * Runs the benchmarks of the hot paths of the app. Each benchmark is run until it takes long
+ * enough to time, then repeated, and the median time per item is reported.
+ *
+ * Usage: benchmarks [--filter TEXT] [--csv FILE] [--baseline FILE] [--tolerance FRACTION]
+ *                   [--smoke]
+ *
+ *  --filter     only runs benchmarks with TEXT in their name.
+ *  --csv        writes the results to FILE, as name,iterations,ns_per_item.
+ *  --baseline   compares the results to a FILE written by --csv, and fails if any benchmark is
+ *               slower than the baseline by more than the tolerance.
+ *  --tolerance  fraction a benchmark can be slower than the baseline, defaults to 0.15.
+ *  --smoke      runs each benchmark once without timing it, to check that they all run.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "benchmark.h"
+
+namespace {
+
+/// minimum time of a timed run, in nsec
+const double kMinRunTime = 50e6;
+
+/// number of timed runs, the median of which is reported
+const int kRepetitions = 5;
+
+/// the result of a benchmark
+struct Result {
+    /// name of the benchmark
+    std::string name;
+
+    /// iterations of each timed run
+    std::uint64_t iterations;
+
+    /// median time per item, in nsec
+    double nsPerItem;
+};
+
+/// runs a benchmark with the given number of iterations, returns the time per item.
+double runOnce(const bench::Benchmark& benchmark, std::uint64_t iterations, double* elapsed) {
+    bench::State state(iterations);
+    benchmark.function(state);
+    *elapsed = state.elapsedNanoseconds();
+    return *elapsed / double(iterations * state.itemsPerIteration());
+}
+
+/// runs a benchmark until it is long enough to time, then times it kRepetitions times.
+Result run(const bench::Benchmark& benchmark) {
+    std::uint64_t iterations = 1u;
+    double elapsed = 0.0;
+    runOnce(benchmark, iterations, &elapsed);
+    while (elapsed < kMinRunTime) {
+        auto scale = elapsed > 0.0 ? std::min(10.0, 1.2 * kMinRunTime / elapsed) : 10.0;
+        iterations = std::max(iterations + 1u, std::uint64_t(double(iterations) * scale));
+        runOnce(benchmark, iterations, &elapsed);
+    }
+
+    std::vector<double> times;
+    for (auto i = 0; i < kRepetitions; ++i) {
+        times.push_back(runOnce(benchmark, iterations, &elapsed));
+    }
+    std::sort(times.begin(), times.end());
+    return Result{benchmark.name, iterations, times[times.size() / 2u]};
+}
+
+/// reads a file written by --csv, returns the time per item of each benchmark.
+std::map<std::string, double> readBaseline(const std::string& path) {
+    std::map<std::string, double> baseline;
+    std::ifstream file(path);
+    std::string line;
+    std::getline(file, line); // header
+    while (std::getline(file, line)) {
+        std::stringstream stream(line);
+        std::string name;
+        std::string iterations;
+        std::string nsPerItem;
+        if (std::getline(stream, name, ',') && std::getline(stream, iterations, ',')
+            && std::getline(stream, nsPerItem, ',')) {
+            baseline[name] = std::atof(nsPerItem.c_str());
+        }
+    }
+    return baseline;
+}
+
+void printUsage() {
+    std::cout << "usage: benchmarks [--filter TEXT] [--csv FILE] [--baseline FILE]"
+                 " [--tolerance FRACTION] [--smoke]\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string filter;
+    std::string csvPath;
+    std::string baselinePath;
+    double tolerance = 0.15;
+    bool smoke = false;
+    for (auto i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--filter" && hasValue) {
+            filter = argv[++i];
+        } else if (arg == "--csv" && hasValue) {
+            csvPath = argv[++i];
+        } else if (arg == "--baseline" && hasValue) {
+            baselinePath = argv[++i];
+        } else if (arg == "--tolerance" && hasValue) {
+            tolerance = std::atof(argv[++i]);
+        } else if (arg == "--smoke") {
+            smoke = true;
+        } else {
+            printUsage();
+            return arg == "--help" ? 0 : 2;
+        }
+    }
+
+    auto benchmarks = bench::registry();
+    std::sort(benchmarks.begin(),
+              benchmarks.end(),
+              [](const bench::Benchmark& a, const bench::Benchmark& b) { return a.name < b.name; });
+
+    std::vector<Result> results;
+    for (const auto& benchmark : benchmarks) {
+        if (benchmark.name.find(filter) == std::string::npos) {
+            continue;
+        }
+        if (smoke) {
+            double elapsed = 0.0;
+            runOnce(benchmark, 1u, &elapsed);
+            std::cout << "ran " << benchmark.name << "\n";
+            continue;
+        }
+        results.push_back(run(benchmark));
+        char line[160];
+        std::snprintf(line,
+                      sizeof(line),
+                      "%-48s %12llu %14.1f ns/item",
+                      results.back().name.c_str(),
+                      static_cast<unsigned long long>(results.back().iterations),
+                      results.back().nsPerItem);
+        std::cout << line << std::endl;
+    }
+
+    if (!csvPath.empty()) {
+        std::ofstream file(csvPath);
+        file << "name,iterations,ns_per_item\n";
+        for (const auto& result : results) {
+            file << result.name << "," << result.iterations << "," << result.nsPerItem << "\n";
+        }
+    }
+
+    int regressions = 0;
+    if (!baselinePath.empty()) {
+        auto baseline = readBaseline(baselinePath);
+        if (baseline.empty()) {
+            std::cerr << "no results in baseline " << baselinePath << "\n";
+            return 2;
+        }
+        std::cout << "\ncompared to " << baselinePath << ":\n";
+        for (const auto& result : results) {
+            auto baselineResult = baseline.find(result.name);
+            if (baselineResult == baseline.end() || baselineResult->second <= 0.0) {
+                std::cout << "  new        " << result.name << "\n";
+                continue;
+            }
+            auto ratio = result.nsPerItem / baselineResult->second;
+            bool isRegression = ratio > 1.0 + tolerance;
+            regressions += isRegression ? 1 : 0;
+            char line[160];
+            std::snprintf(line,
+                          sizeof(line),
+                          "  %-10s %-48s %+6.1f%%",
+                          isRegression ? "REGRESSION" : "ok",
+                          result.name.c_str(),
+                          (ratio - 1.0) * 100.0);
+            std::cout << line << "\n";
+        }
+    }
+    return regressions > 0 ? 1 : 0;
+}
@@ -0,0 +1,53 @@
+#ifndef BENCHMARK_QTFIXTURES_H
+#define BENCHMARK_QTFIXTURES_H
+
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ *
+ * Fixtures for the benchmarks of code that uses Qt. They are built from the same synthetic fleets
+ * as the other fixtures, so every run benchmarks the same data.
+ */
+
+#include <QApplication>
+#include <vector>
+
+#include "cor/objects/light.h"
+#include "fixtures.h"
+
+namespace bench {
+
+/// creates the application the first time it is called, for benchmarks that need event loops or
+/// widgets. Widgets are drawn offscreen, so the benchmarks run without a display.
+inline void ensureApplication() {
+    static int argc = 1;
+    static char name[] = "benchmarks";
+    static char* argv[] = {name, nullptr};
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    static QApplication application(argc, argv);
+}
+
+/// makes a fleet of hue lights, with the states of the lights of a synthetic fleet.
+inline std::vector<cor::Light> makeQtFleet(std::size_t count) {
+    std::vector<cor::Light> fleet;
+    fleet.reserve(count);
+    for (const auto& fleetLight : makeFleet(count)) {
+        cor::Light light(cor::LightID(QString::fromStdString(fleetLight.uniqueID)), ECommType::hue);
+        light.name(QString::fromStdString(fleetLight.name));
+        light.isReachable(true);
+        cor::LightState state;
+        state.isOn(fleetLight.isOn);
+        state.routine(ERoutine::singleSolid);
+        state.color(QColor(fleetLight.red, fleetLight.green, fleetLight.blue));
+        light.state(state);
+        fleet.push_back(light);
+    }
+    return fleet;
+}
+
+} // namespace bench
+
+#endif // BENCHMARK_QTFIXTURES_H
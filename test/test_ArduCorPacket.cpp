@@ -0,0 +1,50 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include <string>
+
+#include "catch.hpp"
+#include "comm/arducor/arducorpacketvalues.h"
+
+namespace {
+
+/// appends a CRC message to a packet, the way an ArduCor that uses CRCs sends it.
+std::string withCRC(const std::string& packet) {
+    auto crc = CRCCalculator().calculate(packet.data(), packet.size());
+    return packet + "#" + std::to_string(crc) + "&";
+}
+
+} // namespace
+
+TEST_CASE("Packets are split into their values", "[ArduCorPacket]") {
+    auto packet = decodeArduCorPacket("7,1,1,255,0,0&8,1,50&");
+    REQUIRE(packet.values.size() == 2u);
+    REQUIRE(packet.values[0] == std::vector<int>{7, 1, 1, 255, 0, 0});
+    REQUIRE(packet.values[1] == std::vector<int>{8, 1, 50});
+    REQUIRE_FALSE(packet.hasCRC);
+    REQUIRE_FALSE(packet.isCRCValid);
+}
+
+TEST_CASE("CRCs are checked against the rest of the packet", "[ArduCorPacket]") {
+    auto packet = decodeArduCorPacket(withCRC("8,1,50&"));
+    REQUIRE(packet.hasCRC);
+    REQUIRE(packet.isCRCValid);
+    // the CRC is the last message, so it can be dropped once it is checked.
+    REQUIRE(packet.values.size() == 2u);
+    REQUIRE(packet.values[0] == std::vector<int>{8, 1, 50});
+
+    auto garbled = withCRC("8,1,50&");
+    garbled[4] = '9';
+    packet = decodeArduCorPacket(garbled);
+    REQUIRE(packet.hasCRC);
+    REQUIRE_FALSE(packet.isCRCValid);
+
+    // a CRC that is not a number, or a packet with more than one CRC, is never valid.
+    REQUIRE_FALSE(decodeArduCorPacket("8,1,50&#abc&").isCRCValid);
+    auto doubled = decodeArduCorPacket(withCRC(withCRC("8,1,50&")));
+    REQUIRE_FALSE(doubled.hasCRC);
+    REQUIRE_FALSE(doubled.isCRCValid);
+}
@@ -0,0 +1,133 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "catch.hpp"
+#include "commandqueue.h"
+
+namespace {
+
+/// a command's header and the index of the light it changes, index 0 is every light.
+using Key = std::pair<int, int>;
+
+/// commands overlap if they have the same header and one of them changes every light.
+bool overlaps(const Key& a, const Key& b) {
+    return a == b || (a.first == b.first && (a.second == 0 || b.second == 0));
+}
+
+std::vector<std::string> messages(const cor::CommandQueue<Key, std::string>& queue) {
+    std::vector<std::string> result;
+    for (std::size_t i = 0u; i < queue.size(); ++i) {
+        result.push_back(queue[i]);
+    }
+    return result;
+}
+
+/*!
+ * sends a command for every frame of a one second slider drag to a controller that takes
+ * roundTrip msec to reply to each request, with one request in flight at a time. Each frame
+ * changes the brightness and the color of light 1. Returns the msec between the last frame of the
+ * drag and the reply to the request that contains its commands. If isMerged is true, commands are
+ * queued in a CommandQueue and each request contains every queued command. Otherwise, every
+ * command is sent in its own request, in the order it was given.
+ */
+std::int64_t dragLatency(bool isMerged, std::int64_t roundTrip, std::uint32_t* requests) {
+    const std::int64_t kFrame = 16;
+    const std::int64_t kLastFrame = 1000 / kFrame * kFrame;
+    cor::CommandQueue<Key, std::string> queue;
+    std::vector<std::string> unmerged;
+    std::int64_t replyTime = -1;
+    bool isLastSent = false;
+    *requests = 0u;
+    for (std::int64_t now = 0;; ++now) {
+        if (now <= kLastFrame && now % kFrame == 0) {
+            auto frame = std::to_string(now / kFrame);
+            if (isMerged) {
+                queue.push({2, 1}, "brightness " + frame, overlaps);
+                queue.push({1, 1}, "color " + frame, overlaps);
+            } else {
+                unmerged.push_back("brightness " + frame);
+                unmerged.push_back("color " + frame);
+            }
+        }
+        if (replyTime >= 0 && now >= replyTime) {
+            replyTime = -1;
+            if (isLastSent) {
+                return now - kLastFrame;
+            }
+        }
+        if (replyTime < 0 && (!queue.empty() || !unmerged.empty())) {
+            if (isMerged) {
+                queue.pop(queue.size());
+            } else {
+                unmerged.erase(unmerged.begin());
+            }
+            isLastSent = now >= kLastFrame && queue.empty() && unmerged.empty();
+            replyTime = now + roundTrip;
+            ++*requests;
+        }
+    }
+}
+
+} // namespace
+
+TEST_CASE("Newer commands replace older ones in place", "[CommandQueue]") {
+    cor::CommandQueue<Key, std::string> queue;
+    REQUIRE_FALSE(queue.push({1, 1}, "color 1", overlaps));
+    REQUIRE_FALSE(queue.push({2, 1}, "brightness 1", overlaps));
+    REQUIRE_FALSE(queue.push({1, 2}, "color 2", overlaps));
+    REQUIRE(queue.push({1, 1}, "color 1b", overlaps));
+    REQUIRE(messages(queue) == std::vector<std::string>{"color 1b", "brightness 1", "color 2"});
+
+    queue.pop(2u);
+    REQUIRE(messages(queue) == std::vector<std::string>{"color 2"});
+    queue.clear();
+    REQUIRE(queue.empty());
+}
+
+TEST_CASE("Commands for every light keep their place before other lights", "[CommandQueue]") {
+    cor::CommandQueue<Key, std::string> queue;
+    queue.push({1, 0}, "all red", overlaps);
+    queue.push({2, 3}, "brightness 3", overlaps);
+    REQUIRE(queue.push({1, 0}, "all blue", overlaps));
+    REQUIRE(messages(queue) == std::vector<std::string>{"all blue", "brightness 3"});
+}
+
+TEST_CASE("Commands move behind overlapping commands", "[CommandQueue]") {
+    // light 3 is set after every light, so the newer command for every light has to be sent after
+    // it, or light 3 would end up green instead of blue.
+    cor::CommandQueue<Key, std::string> queue;
+    queue.push({1, 0}, "all red", overlaps);
+    queue.push({1, 3}, "3 green", overlaps);
+    REQUIRE(queue.push({1, 0}, "all blue", overlaps));
+    REQUIRE(messages(queue) == std::vector<std::string>{"3 green", "all blue"});
+
+    // the same goes for a single light queued before a command for every light.
+    queue.clear();
+    queue.push({1, 3}, "3 green", overlaps);
+    queue.push({1, 0}, "all red", overlaps);
+    REQUIRE(queue.push({1, 3}, "3 blue", overlaps));
+    REQUIRE(messages(queue) == std::vector<std::string>{"all red", "3 blue"});
+}
+
+TEST_CASE("Merging commands keeps a slider drag responsive", "[CommandQueue]") {
+    const std::int64_t kRoundTrip = 50;
+    std::uint32_t singleRequests = 0u;
+    std::uint32_t mergedRequests = 0u;
+    auto single = dragLatency(false, kRoundTrip, &singleRequests);
+    auto merged = dragLatency(true, kRoundTrip, &mergedRequests);
+
+    // sent one at a time, the 126 commands of the drag queue up behind each other and the last
+    // one lands seconds after the drag ends. merged, it lands within two round trips.
+    REQUIRE(singleRequests == 126u);
+    REQUIRE(single > 5000);
+    REQUIRE(merged <= 2 * kRoundTrip);
+    REQUIRE(mergedRequests <= 1000u / kRoundTrip + 2u);
+}
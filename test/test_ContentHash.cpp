@@ -0,0 +1,46 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+
+#include "catch.hpp"
+#include "contenthash.h"
+
+TEST_CASE("The same content hashes the same", "[ContentHash]") {
+    auto hash = [](std::uint64_t color, bool isOn, double brightness) {
+        return cor::ContentHash(1u).add(color).add(isOn).add(brightness).value();
+    };
+    REQUIRE(hash(0xff0000u, true, 0.5) == hash(0xff0000u, true, 0.5));
+    REQUIRE(hash(0xff0000u, true, 0.0) == hash(0xff0000u, true, -0.0));
+    REQUIRE(hash(0xff0000u, true, 0.5) != hash(0xff0000u, false, 0.5));
+    REQUIRE(hash(0xff0000u, true, 0.5) != hash(0xff0001u, true, 0.5));
+    REQUIRE(hash(0xff0000u, true, 0.5) != hash(0xff0000u, true, 0.50001));
+
+    // the seed keeps different kinds of content apart
+    REQUIRE(cor::ContentHash(1u).add(5).value() != cor::ContentHash(2u).add(5).value());
+}
+
+TEST_CASE("Order and boundaries change the hash", "[ContentHash]") {
+    REQUIRE(cor::ContentHash().add(1).add(2).value() != cor::ContentHash().add(2).add(1).value());
+    REQUIRE(cor::ContentHash().add(std::string("ab")).add(std::string("c")).value()
+            != cor::ContentHash().add(std::string("a")).add(std::string("bc")).value());
+    REQUIRE(cor::ContentHash().add(std::string()).value() != cor::ContentHash().value());
+}
+
+TEST_CASE("Nearby values do not collide", "[ContentHash]") {
+    // previews hash grids of colors, so every small grid of small values should be unique.
+    std::unordered_set<std::uint64_t> hashes;
+    for (std::uint64_t a = 0u; a < 64u; ++a) {
+        for (std::uint64_t b = 0u; b < 64u; ++b) {
+            for (std::uint64_t c = 0u; c < 16u; ++c) {
+                hashes.insert(cor::ContentHash().add(a).add(b).add(c).value());
+            }
+        }
+    }
+    REQUIRE(hashes.size() == 64u * 64u * 16u);
+}
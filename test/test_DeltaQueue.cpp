@@ -0,0 +1,127 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "catch.hpp"
+#include "deltaqueue.h"
+
+TEST_CASE("Capacity is rounded up to a power of two", "[DeltaQueue]") {
+    cor::DeltaQueue<int, int> queue(100u);
+    REQUIRE(queue.capacity() == 128u);
+}
+
+TEST_CASE("Deltas for the same key are coalesced", "[DeltaQueue]") {
+    cor::DeltaQueue<std::string, int> queue(16u);
+    REQUIRE(queue.empty());
+    REQUIRE(queue.push("b", 1));
+    REQUIRE_FALSE(queue.empty());
+    REQUIRE(queue.push("a", 1));
+    REQUIRE(queue.push("b", 2));
+    REQUIRE(queue.push("c", 1));
+    REQUIRE(queue.push("b", 3));
+
+    std::vector<std::pair<std::string, int>> deltas;
+    auto count = queue.drain(
+        [&deltas](const std::string& key, int value) { deltas.emplace_back(key, value); });
+    REQUIRE(count == 3u);
+    REQUIRE(queue.empty());
+    // keys keep the order they were first pushed in, with their newest values.
+    REQUIRE(deltas == std::vector<std::pair<std::string, int>>{{"b", 3}, {"a", 1}, {"c", 1}});
+
+    auto stats = queue.stats();
+    REQUIRE(stats.pushed == 5u);
+    REQUIRE(stats.delivered == 3u);
+    REQUIRE(stats.coalesced == 2u);
+    REQUIRE(stats.overflowed == 0u);
+
+    // everything was drained
+    REQUIRE(queue.drain([](const std::string&, int) {}) == 0u);
+}
+
+TEST_CASE("A full queue drops deltas and flags an overflow", "[DeltaQueue]") {
+    cor::DeltaQueue<int, int> queue(4u);
+    for (auto i = 0; i < 4; ++i) {
+        REQUIRE(queue.push(i, i));
+    }
+    REQUIRE_FALSE(queue.push(4, 4));
+    REQUIRE(queue.stats().overflowed == 1u);
+
+    REQUIRE(queue.drain([](int, int) {}) == 4u);
+    REQUIRE(queue.takeOverflow());
+    REQUIRE_FALSE(queue.takeOverflow());
+
+    // draining frees the slots, and the ring wraps around.
+    for (auto i = 0; i < 4; ++i) {
+        REQUIRE(queue.push(i, i + 10));
+    }
+    int sum = 0;
+    queue.drain([&sum](int, int value) { sum += value; });
+    REQUIRE(sum == 10 + 11 + 12 + 13);
+}
+
+TEST_CASE("Deltas cross threads in order", "[DeltaQueue]") {
+    cor::DeltaQueue<int, int> queue(64u);
+    const int kUpdates = 100000;
+    std::thread producer([&queue, kUpdates]() {
+        for (auto i = 0; i < kUpdates; ++i) {
+            while (!queue.push(i % 8, i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    // the newest value seen for each key must only ever increase.
+    std::vector<int> newest(8, -1);
+    bool inOrder = true;
+    while (newest[(kUpdates - 1) % 8] != kUpdates - 1) {
+        queue.drain([&newest, &inOrder](int key, int value) {
+            inOrder = inOrder && (value > newest[key]);
+            newest[key] = value;
+        });
+    }
+    producer.join();
+    REQUIRE(inOrder);
+    auto stats = queue.stats();
+    REQUIRE(stats.delivered + stats.coalesced == stats.pushed);
+}
+
+TEST_CASE("Draining every frame keeps up with a fast producer", "[DeltaQueue]") {
+    // a synthetic producer sends 10k updates a second for 100 lights while the consumer drains at
+    // 60 frames a second. Each frame has about 167 updates, which coalesce to at most 100 deltas.
+    const int kPolledLights = 100;
+    cor::DeltaQueue<std::string, int> queue(1024u);
+    std::thread producer([&queue, kPolledLights]() {
+        auto start = std::chrono::steady_clock::now();
+        for (auto i = 0; i < 10000; ++i) {
+            queue.push(std::to_string(i % kPolledLights), i);
+            if (i % 100 == 99) {
+                std::this_thread::sleep_until(start + std::chrono::milliseconds((i + 1) / 10));
+            }
+        }
+    });
+    std::size_t frames = 0u;
+    std::size_t maxDeltasPerFrame = 0u;
+    auto frameStart = std::chrono::steady_clock::now();
+    while (queue.stats().pushed + queue.stats().overflowed < 10000u || frames == 0u) {
+        frameStart += std::chrono::microseconds(16667);
+        std::this_thread::sleep_until(frameStart);
+        auto deltas = queue.drain([](const std::string&, int) {});
+        maxDeltasPerFrame = std::max(maxDeltasPerFrame, deltas);
+        ++frames;
+    }
+    producer.join();
+    queue.drain([](const std::string&, int) {});
+
+    auto stats = queue.stats();
+    REQUIRE(stats.overflowed == 0u);
+    REQUIRE(maxDeltasPerFrame <= std::size_t(kPolledLights));
+    REQUIRE(stats.delivered + stats.coalesced == stats.pushed);
+}
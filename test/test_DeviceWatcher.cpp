@@ -0,0 +1,167 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+#include "devicewatcher.h"
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#endif // __linux__
+
+namespace {
+
+using Names = std::vector<std::string>;
+
+#ifdef __linux__
+
+/// a pseudo-terminal, which stands in for a serial port.
+class PseudoTerminal {
+public:
+    PseudoTerminal() : mMaster{posix_openpt(O_RDWR | O_NOCTTY)} {
+        if (mMaster >= 0 && grantpt(mMaster) == 0 && unlockpt(mMaster) == 0) {
+            mSlavePath = ptsname(mMaster);
+        }
+    }
+
+    ~PseudoTerminal() {
+        if (mMaster >= 0) {
+            close(mMaster);
+        }
+    }
+
+    /// path to the device that a serial port would open
+    const std::string& slavePath() const { return mSlavePath; }
+
+private:
+    /// file descriptor of the master side
+    int mMaster;
+
+    /// path of the slave side, empty if the terminal could not be created.
+    std::string mSlavePath;
+};
+
+/// a directory that stands in for /dev, removed with its contents when destroyed.
+class TemporaryDirectory {
+public:
+    TemporaryDirectory() {
+        char path[] = "/tmp/corluma_devXXXXXX";
+        if (mkdtemp(path) != nullptr) {
+            mPath = path;
+        }
+    }
+
+    ~TemporaryDirectory() {
+        for (const auto& name : mEntries) {
+            unlink((mPath + "/" + name).c_str());
+        }
+        rmdir(mPath.c_str());
+    }
+
+    /// path to the directory
+    const std::string& path() const { return mPath; }
+
+    /// links a name in the directory to a device
+    void link(const std::string& name, const std::string& target) {
+        REQUIRE(symlink(target.c_str(), (mPath + "/" + name).c_str()) == 0);
+        mEntries.push_back(name);
+    }
+
+    /// removes a name from the directory
+    void remove(const std::string& name) { REQUIRE(unlink((mPath + "/" + name).c_str()) == 0); }
+
+private:
+    /// path to the directory
+    std::string mPath;
+
+    /// names created in the directory
+    std::vector<std::string> mEntries;
+};
+
+/// true if the watcher's file descriptor becomes readable within the timeout.
+bool waitForChanges(const cor::DeviceWatcher& watcher, int timeout) {
+    pollfd descriptor{watcher.fd(), POLLIN, 0};
+    return poll(&descriptor, 1, timeout) > 0;
+}
+
+#endif // __linux__
+
+} // namespace
+
+TEST_CASE("Devices are diffed against the known devices", "[DeviceWatcher]") {
+    std::unordered_set<std::string> known = {"ttyUSB0", "ttyACM0"};
+    auto changes = cor::diffDevices(known, {"ttyACM0", "ttyACM1"});
+    REQUIRE(changes.added == Names{"ttyACM1"});
+    REQUIRE(changes.removed == Names{"ttyUSB0"});
+    REQUIRE(cor::diffDevices(known, {"ttyUSB0", "ttyACM0"}).empty());
+}
+
+#ifdef __linux__
+
+TEST_CASE("Hotplugged pseudo-terminals are reported", "[DeviceWatcher]") {
+    TemporaryDirectory directory;
+    REQUIRE_FALSE(directory.path().empty());
+    PseudoTerminal existing;
+    REQUIRE_FALSE(existing.slavePath().empty());
+    directory.link("ttyACM0", existing.slavePath());
+
+    cor::DeviceWatcher watcher(directory.path(), {"ttyACM", "ttyUSB"});
+    REQUIRE(watcher.isValid());
+    REQUIRE(watcher.list() == Names{"ttyACM0"});
+
+    // while nothing changes, there is nothing to wake up for.
+    REQUIRE_FALSE(waitForChanges(watcher, 0));
+    REQUIRE(watcher.readChanges().empty());
+
+    PseudoTerminal plugged;
+    REQUIRE_FALSE(plugged.slavePath().empty());
+    directory.link("ttyUSB0", plugged.slavePath());
+    directory.link("console", plugged.slavePath());
+    REQUIRE(waitForChanges(watcher, 1000));
+    auto changes = watcher.readChanges();
+    REQUIRE(changes.added == Names{"ttyUSB0"});
+    REQUIRE(changes.removed.empty());
+    REQUIRE(watcher.list() == Names{"ttyACM0", "ttyUSB0"});
+
+    directory.remove("ttyACM0");
+    REQUIRE(waitForChanges(watcher, 1000));
+    changes = watcher.readChanges();
+    REQUIRE(changes.added.empty());
+    REQUIRE(changes.removed == Names{"ttyACM0"});
+    REQUIRE(watcher.list() == Names{"ttyUSB0"});
+}
+
+TEST_CASE("A device that is replaced is removed before it is added", "[DeviceWatcher]") {
+    TemporaryDirectory directory;
+    PseudoTerminal terminal;
+    cor::DeviceWatcher watcher(directory.path(), {"ttyUSB"});
+    REQUIRE(watcher.isValid());
+
+    directory.link("ttyUSB3", terminal.slavePath());
+    directory.remove("ttyUSB3");
+    directory.link("ttyUSB4", terminal.slavePath());
+    directory.remove("ttyUSB4");
+    directory.link("ttyUSB4", terminal.slavePath());
+    REQUIRE(waitForChanges(watcher, 1000));
+    auto changes = watcher.readChanges();
+    REQUIRE(changes.added == Names{"ttyUSB4"});
+    REQUIRE(changes.removed == Names{"ttyUSB3", "ttyUSB4"});
+}
+
+TEST_CASE("A directory that cannot be watched is not valid", "[DeviceWatcher]") {
+    cor::DeviceWatcher watcher("/nonexistent/corluma", {"ttyUSB"});
+    REQUIRE_FALSE(watcher.isValid());
+    REQUIRE(watcher.fd() == -1);
+    REQUIRE(watcher.readChanges().empty());
+    REQUIRE(watcher.list().empty());
+}
+
+#endif // __linux__
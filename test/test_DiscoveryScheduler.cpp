@@ -0,0 +1,138 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+#include "discoveryscheduler.h"
+
+namespace {
+
+using Scheduler = cor::DiscoveryScheduler<std::string>;
+
+} // namespace
+
+TEST_CASE("Devices back off after each probe", "[DiscoveryScheduler]") {
+    Scheduler scheduler(1000, 8000, 10u, 500, 1u);
+    scheduler.track(0, "a", 0, 0);
+    REQUIRE(scheduler.takeDue(0, 0) == std::vector<std::string>{"a"});
+
+    // each delay is the previous one doubled, within the jitter, up to the max interval.
+    std::int64_t now = 0;
+    std::vector<std::int64_t> delays;
+    while (now < 60000) {
+        now += 10;
+        if (!scheduler.takeDue(0, now).empty()) {
+            delays.push_back(now);
+        }
+    }
+    REQUIRE(delays.size() >= 8u);
+    std::int64_t previous = 0;
+    std::int64_t expected = 1000;
+    for (auto probe : delays) {
+        auto delay = probe - previous;
+        REQUIRE(delay >= std::int64_t(double(expected) * 0.8));
+        REQUIRE(delay <= std::int64_t(double(expected) * 1.2) + 10);
+        expected = std::min<std::int64_t>(expected * 2, 8000);
+        previous = probe;
+    }
+}
+
+TEST_CASE("The global cap prefers recently seen devices", "[DiscoveryScheduler]") {
+    Scheduler scheduler(1000, 8000, 2u, 500, 1u);
+    scheduler.track(0, "stale", 0, 0);
+    scheduler.track(0, "recent", 100, 0);
+    scheduler.track(0, "middle", 50, 0);
+    scheduler.track(1, "other", 0, 0);
+    REQUIRE(scheduler.takeDue(0, 0) == std::vector<std::string>{"recent", "middle"});
+    REQUIRE(scheduler.inFlight(0) == 2u);
+
+    // nothing else can be probed, in any group, until the probes time out
+    REQUIRE(scheduler.takeDue(1, 100).empty());
+    REQUIRE(scheduler.takeDue(0, 100).empty());
+    REQUIRE(scheduler.takeDue(0, 500) == std::vector<std::string>{"stale"});
+    REQUIRE(scheduler.takeDue(1, 500) == std::vector<std::string>{"other"});
+}
+
+TEST_CASE("Found devices cancel their probes", "[DiscoveryScheduler]") {
+    Scheduler scheduler(1000, 8000, 1u, 5000, 1u);
+    scheduler.track(0, "a", 0, 0);
+    scheduler.track(0, "b", 0, 0);
+    auto first = scheduler.takeDue(0, 0);
+    REQUIRE(first.size() == 1u);
+
+    // found by UPnP, so its probe no longer takes a slot and it is never probed again.
+    REQUIRE(scheduler.remove(0, first[0]));
+    REQUIRE(scheduler.inFlight(0) == 0u);
+    auto second = scheduler.takeDue(0, 0);
+    REQUIRE(second.size() == 1u);
+    REQUIRE(second[0] != first[0]);
+    REQUIRE(scheduler.size(0) == 1u);
+
+    // a device that is heard from is due again immediately.
+    scheduler.seen(0, second[0], 6000);
+    REQUIRE(scheduler.takeDue(0, 6000) == second);
+}
+
+TEST_CASE("Lost devices are probed by when they were last seen", "[DiscoveryScheduler]") {
+    Scheduler scheduler(1000, 8000, 1u, 500, 1u);
+    REQUIRE(scheduler.lastSeen(0, "early") == 0);
+    scheduler.track(0, "early", 0, 0);
+    scheduler.track(0, "late", 0, 0);
+    scheduler.found(0, "early", 100);
+    scheduler.found(0, "late", 200);
+    REQUIRE(scheduler.size(0) == 0u);
+    REQUIRE(scheduler.lastSeen(0, "late") == 200);
+    REQUIRE(scheduler.lastSeen(1, "late") == 0);
+
+    // both are lost again, and the one seen last is probed first.
+    scheduler.track(0, "early", scheduler.lastSeen(0, "early"), 1000);
+    scheduler.track(0, "late", scheduler.lastSeen(0, "late"), 1000);
+    REQUIRE(scheduler.takeDue(0, 1000) == std::vector<std::string>{"late"});
+}
+
+TEST_CASE("Simulated fleet with hundreds of stale entries", "[DiscoveryScheduler]") {
+    // 300 saved devices that never answer, 3 that are plugged back in after 5 minutes, over an
+    // hour of discovery ticks. The fixed timer probed every stale device on every tick.
+    const int kStale = 300;
+    const std::int64_t kTick = 2500;
+    const std::int64_t kDuration = 60 * 60 * 1000;
+    Scheduler scheduler(2500, 300000, 8u, 2000, 7u);
+    for (auto i = 0; i < kStale; ++i) {
+        scheduler.track(0, "stale" + std::to_string(i), 0, 0);
+    }
+    for (auto i = 0; i < 3; ++i) {
+        scheduler.track(1, "returning" + std::to_string(i), 0, 0);
+    }
+
+    std::size_t probes = 0u;
+    std::size_t maxPerTick = 0u;
+    std::vector<std::int64_t> foundTimes;
+    for (std::int64_t now = 0; now < kDuration; now += kTick) {
+        auto due = scheduler.takeDue(0, now);
+        auto returning = scheduler.takeDue(1, now);
+        maxPerTick = std::max(maxPerTick, due.size() + returning.size());
+        probes += due.size() + returning.size();
+        // returning devices answer their first probe after they are plugged back in.
+        for (const auto& key : returning) {
+            if (now >= 5 * 60 * 1000) {
+                scheduler.remove(1, key);
+                foundTimes.push_back(now);
+            }
+        }
+    }
+
+    auto fixedTimerProbes = std::size_t(kStale + 3) * std::size_t(kDuration / kTick);
+    REQUIRE(maxPerTick <= 8u);
+    REQUIRE(probes * 50u < fixedTimerProbes);
+    // returning devices are still found within one max interval plus the jitter.
+    REQUIRE(foundTimes.size() == 3u);
+    for (auto time : foundTimes) {
+        REQUIRE(time <= 5 * 60 * 1000 + 360000 + kTick * 10);
+    }
+}
@@ -0,0 +1,128 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+#include "interner.h"
+
+namespace {
+
+/// stands in for the data of a cor::Palette, a name and a vector of RGBA colors.
+struct PaletteData {
+    std::string name;
+    std::vector<std::uint32_t> colors;
+
+    bool operator==(const PaletteData& rhs) const {
+        return name == rhs.name && colors == rhs.colors;
+    }
+};
+
+struct PaletteDataHash {
+    std::size_t operator()(const PaletteData& data) const {
+        auto hash = std::hash<std::string>{}(data.name);
+        for (auto color : data.colors) {
+            hash ^= std::hash<std::uint32_t>{}(color) + 0x9e3779b9u + (hash << 6u) + (hash >> 2u);
+        }
+        return hash;
+    }
+};
+
+using Interner = cor::Interner<PaletteData, PaletteDataHash>;
+
+PaletteData palette(int i, std::size_t count) {
+    PaletteData data{"palette" + std::to_string(i), {}};
+    for (std::size_t color = 0u; color < count; ++color) {
+        data.colors.push_back(std::uint32_t(i) * 31u + std::uint32_t(color));
+    }
+    return data;
+}
+
+} // namespace
+
+TEST_CASE("Equal values share a handle", "[Interner]") {
+    Interner interner;
+    auto a = interner.intern(palette(1, 5));
+    auto b = interner.intern(palette(1, 5));
+    auto c = interner.intern(palette(2, 5));
+    REQUIRE(a == b);
+    REQUIRE(a != c);
+    REQUIRE(*a == palette(1, 5));
+    REQUIRE(interner.liveCount() == 2u);
+
+    // a value is freed with its last handle, and interning it again makes a new one.
+    a.reset();
+    REQUIRE(interner.liveCount() == 2u);
+    b.reset();
+    REQUIRE(interner.liveCount() == 1u);
+    auto d = interner.intern(palette(1, 5));
+    REQUIRE(*d == palette(1, 5));
+    REQUIRE(interner.liveCount() == 2u);
+}
+
+TEST_CASE("Expired entries are swept", "[Interner]") {
+    Interner interner;
+    auto kept = interner.intern(palette(0, 3));
+    for (auto i = 1; i < 1000; ++i) {
+        interner.intern(palette(i, 3));
+    }
+    REQUIRE(interner.liveCount() == 1u);
+    REQUIRE(interner.size() < 32u);
+    REQUIRE(interner.intern(palette(0, 3)) == kept);
+}
+
+namespace {
+
+/// a light state that owns its palettes, like cor::LightState did.
+struct OwnedLightState {
+    bool isOn;
+    int brightness;
+    PaletteData palette;
+    PaletteData customPalette;
+};
+
+/// a light state that holds interned palettes, like cor::LightState does now.
+struct SharedLightState {
+    bool isOn;
+    int brightness;
+    std::shared_ptr<const PaletteData> palette;
+    std::shared_ptr<const PaletteData> customPalette;
+};
+
+std::size_t heapBytes(const PaletteData& data) {
+    return data.name.capacity() + data.colors.capacity() * sizeof(std::uint32_t);
+}
+
+} // namespace
+
+TEST_CASE("Interned palettes take a fraction of the memory", "[Interner]") {
+    // lights mostly share a handful of palettes, and every light has the same custom palette.
+    const int kLights = 10000;
+    const int kPalettes = 40;
+    const std::size_t kColors = 12u;
+    Interner interner;
+    std::vector<OwnedLightState> owned;
+    std::vector<SharedLightState> shared;
+    for (auto i = 0; i < kLights; ++i) {
+        owned.push_back({true, i % 100, palette(i % kPalettes, kColors), palette(-1, kColors)});
+        shared.push_back({true,
+                          i % 100,
+                          interner.intern(palette(i % kPalettes, kColors)),
+                          interner.intern(palette(-1, kColors))});
+    }
+    REQUIRE(interner.liveCount() == std::size_t(kPalettes + 1));
+
+    std::size_t ownedBytes = owned.size() * sizeof(OwnedLightState);
+    for (const auto& state : owned) {
+        ownedBytes += heapBytes(state.palette) + heapBytes(state.customPalette);
+    }
+    std::size_t sharedBytes = shared.size() * sizeof(SharedLightState);
+    auto paletteBytes = sizeof(PaletteData) + heapBytes(palette(0, kColors));
+    sharedBytes += std::size_t(kPalettes + 1) * paletteBytes;
+    REQUIRE(sharedBytes * 4u < ownedBytes);
+}
@@ -0,0 +1,85 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include <thread>
+#include <vector>
+
+#include "catch.hpp"
+#include "metrics.h"
+
+TEST_CASE("Counters count from multiple threads", "[Metrics]") {
+    cor::MetricsRegistry registry;
+    auto& counter = registry.counter("comm.udp.packets_sent");
+    std::vector<std::thread> threads;
+    for (auto i = 0; i < 4; ++i) {
+        threads.emplace_back([&counter]() {
+            for (auto j = 0; j < 1000; ++j) {
+                counter.add();
+            }
+        });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+    REQUIRE(counter.value() == 4000u);
+    // looking up the same name returns the same counter
+    REQUIRE(&registry.counter("comm.udp.packets_sent") == &counter);
+}
+
+TEST_CASE("Histogram buckets and percentiles", "[Metrics]") {
+    cor::MetricHistogram histogram;
+    REQUIRE(histogram.percentile(50.0) == 0u);
+    REQUIRE(histogram.mean() == 0.0);
+
+    for (auto i = 0; i < 90; ++i) {
+        histogram.record(3u);
+    }
+    for (auto i = 0; i < 9; ++i) {
+        histogram.record(80u);
+    }
+    histogram.record(20000u);
+
+    REQUIRE(histogram.count() == 100u);
+    REQUIRE(histogram.max() == 20000u);
+    REQUIRE(histogram.sum() == 90u * 3u + 9u * 80u + 20000u);
+    // 3 falls in the (2, 5] bucket, 80 in (50, 100], 20000 in the overflow bucket
+    REQUIRE(histogram.bucket(2) == 90u);
+    REQUIRE(histogram.bucket(6) == 9u);
+    REQUIRE(histogram.bucket(cor::MetricHistogram::kBucketCount - 1u) == 1u);
+    REQUIRE(histogram.percentile(50.0) == 5u);
+    REQUIRE(histogram.percentile(95.0) == 100u);
+    REQUIRE(histogram.percentile(100.0) == 20000u);
+
+    histogram.reset();
+    REQUIRE(histogram.count() == 0u);
+    REQUIRE(histogram.max() == 0u);
+}
+
+TEST_CASE("Snapshots list metrics sorted by name", "[Metrics]") {
+    cor::MetricsRegistry registry;
+    registry.counter("b.count").add(2u);
+    registry.counter("a.count").add(1u);
+    registry.histogram("latency_ms").record(7u);
+
+    REQUIRE(registry.snapshotText()
+            == "a.count 1\nb.count 2\nlatency_ms count=1 mean=7 p50=10 p90=10 p99=10 max=7\n");
+    REQUIRE(registry.snapshotJSON()
+            == "{\"counters\":{\"a.count\":1,\"b.count\":2},\"histograms\":{\"latency_ms\":{"
+               "\"count\":1,\"sum\":7,\"max\":7,\"p50\":10,\"p90\":10,\"p99\":10,"
+               "\"buckets\":[0,0,0,1,0,0,0,0,0,0,0,0,0,0]}}}");
+
+    registry.reset();
+    REQUIRE(registry.counter("a.count").value() == 0u);
+    REQUIRE(registry.histogram("latency_ms").count() == 0u);
+}
+
+TEST_CASE("Snapshots escape metric names", "[Metrics]") {
+    cor::MetricsRegistry registry;
+    registry.counter("device.\"quoted\\name\".packets_sent").add();
+    REQUIRE(registry.snapshotJSON()
+            == "{\"counters\":{\"device.\\\"quoted\\\\name\\\".packets_sent\":1},"
+               "\"histograms\":{}}");
+}
@@ -0,0 +1,72 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include <chrono>
+#include <vector>
+
+#include "catch.hpp"
+#include "networkavailability.h"
+
+namespace {
+
+using Interfaces = std::vector<cor::NetworkInterfaceState>;
+
+/// an interface that can reach lights
+cor::NetworkInterfaceState wifi() {
+    return cor::NetworkInterfaceState{"wlan0", true, true, true};
+}
+
+} // namespace
+
+TEST_CASE("Only running LAN interfaces make the network available", "[NetworkAvailability]") {
+    REQUIRE_FALSE(cor::isNetworkAvailable({}));
+    REQUIRE(cor::isNetworkAvailable({wifi()}));
+
+    auto down = wifi();
+    down.isUp = false;
+    auto notRunning = wifi();
+    notRunning.isRunning = false;
+    auto loopback = cor::NetworkInterfaceState{"lo", false, true, true};
+    auto dummy = cor::NetworkInterfaceState{"dummy0", true, true, true};
+    REQUIRE_FALSE(cor::isNetworkAvailable({down, notRunning, loopback, dummy}));
+    REQUIRE(cor::isNetworkAvailable({down, notRunning, loopback, dummy, wifi()}));
+}
+
+TEST_CASE("Availability changes are reported once", "[NetworkAvailability]") {
+    Interfaces interfaces = {wifi()};
+    auto checks = 0;
+    cor::NetworkAvailability availability([&]() {
+        ++checks;
+        return interfaces;
+    });
+    REQUIRE(availability.isAvailable());
+    REQUIRE(checks == 1);
+
+    // the interfaces are only checked when asked to, so an idle network costs nothing.
+    REQUIRE_FALSE(availability.refresh());
+    REQUIRE(checks == 2);
+
+    interfaces[0].isRunning = false;
+    REQUIRE(availability.refresh());
+    REQUIRE_FALSE(availability.isAvailable());
+    REQUIRE_FALSE(availability.refresh());
+
+    interfaces.push_back(cor::NetworkInterfaceState{"eth0", true, true, true});
+    REQUIRE(availability.refresh());
+    REQUIRE(availability.isAvailable());
+}
+
+#ifdef __linux__
+TEST_CASE("Netlink events are read without blocking", "[NetworkAvailability]") {
+    cor::NetlinkWatcher watcher;
+    REQUIRE(watcher.isValid());
+    REQUIRE(watcher.fd() >= 0);
+    auto start = std::chrono::steady_clock::now();
+    // whether anything changed depends on the machine, but it must return right away.
+    watcher.readEvents();
+    REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::seconds(1));
+}
+#endif // __linux__
@@ -0,0 +1,73 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include <vector>
+
+#include "catch.hpp"
+#include "palettesignature.h"
+
+namespace {
+
+using Color = cor::PaletteSignature::Color;
+
+Color color(int red, int green, int blue) {
+    return {std::uint8_t(red), std::uint8_t(green), std::uint8_t(blue), -1.0f};
+}
+
+} // namespace
+
+TEST_CASE("Hue matches QColor", "[PaletteSignature]") {
+    REQUIRE(cor::PaletteSignature::hue(255, 0, 0) == Approx(0.0f));
+    REQUIRE(cor::PaletteSignature::hue(0, 255, 0) == Approx(120.0f));
+    REQUIRE(cor::PaletteSignature::hue(0, 0, 255) == Approx(240.0f));
+    REQUIRE(cor::PaletteSignature::hue(255, 0, 128) == Approx(329.88f).epsilon(0.001));
+    REQUIRE(cor::PaletteSignature::hue(128, 128, 128) == -1.0f);
+}
+
+TEST_CASE("Signatures don't depend on the order of colors", "[PaletteSignature]") {
+    cor::PaletteSignature a({color(255, 0, 0), color(0, 255, 0), color(0, 0, 255)});
+    cor::PaletteSignature b({color(0, 0, 255), color(255, 0, 0), color(0, 255, 0)});
+    REQUIRE(a.hash() == b.hash());
+    REQUIRE(a.matches(b, 0.0f));
+
+    // colors are stored sorted by hue
+    REQUIRE(b.colors()[0].red == 255u);
+    REQUIRE(b.colors()[1].green == 255u);
+    REQUIRE(b.colors()[2].blue == 255u);
+
+    // small differences are quantized away
+    cor::PaletteSignature c({color(250, 2, 3), color(1, 252, 0), color(0, 0, 249)});
+    REQUIRE(a.hash() == c.hash());
+}
+
+TEST_CASE("Equal hashes still check the tolerance", "[PaletteSignature]") {
+    // both colors quantize to the same bucket, but are further apart than a tight tolerance.
+    cor::PaletteSignature a({color(16, 16, 16), color(255, 0, 0)});
+    cor::PaletteSignature b({color(31, 31, 31), color(255, 0, 0)});
+    REQUIRE(a.hash() == b.hash());
+    REQUIRE_FALSE(a.matches(b, 0.01f));
+    REQUIRE(a.matches(b, 0.1f));
+    REQUIRE(a.matches(a, 0.0f));
+}
+
+TEST_CASE("Signatures fall back to a tolerance check", "[PaletteSignature]") {
+    cor::PaletteSignature a({color(255, 0, 0), color(0, 255, 0)});
+    cor::PaletteSignature close({color(0, 230, 20), color(230, 20, 0)});
+    cor::PaletteSignature far({color(0, 0, 255), color(255, 0, 0)});
+    REQUIRE(a.hash() != close.hash());
+    REQUIRE(a.matches(close, 0.28f));
+    REQUIRE_FALSE(a.matches(far, 0.28f));
+
+    // different sizes never match
+    cor::PaletteSignature bigger({color(255, 0, 0), color(0, 255, 0), color(0, 0, 255)});
+    REQUIRE_FALSE(a.matches(bigger, 1.0f));
+
+    // black colors match anything
+    cor::PaletteSignature withBlack({color(255, 0, 0), color(0, 0, 0)});
+    cor::PaletteSignature withGrey({color(200, 200, 200), color(255, 0, 0)});
+    REQUIRE(withBlack.matches(withGrey, 0.28f));
+    REQUIRE_FALSE(withGrey.matches(withBlack, 0.28f));
+}
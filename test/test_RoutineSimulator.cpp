@@ -0,0 +1,148 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include "catch.hpp"
+#include "routinesimulator.h"
+
+namespace {
+
+const std::vector<cor::FrameColor> kPalette = {{255u, 0u, 0u},
+                                               {0u, 255u, 0u},
+                                               {0u, 0u, 255u},
+                                               {255u, 255u, 0u}};
+
+/// FNV-1a hash of the first frameCount frames of a simulator
+std::uint64_t hashFrames(const cor::RoutineSimulator& simulator, std::uint64_t frameCount) {
+    std::uint64_t hash = 14695981039346656037ULL;
+    std::vector<cor::FrameColor> buffer;
+    for (std::uint64_t frame = 0u; frame < frameCount; ++frame) {
+        simulator.renderFrame(frame, buffer);
+        for (const auto& color : buffer) {
+            for (auto value : {color.red, color.green, color.blue}) {
+                hash ^= value;
+                hash *= 1099511628211ULL;
+            }
+        }
+    }
+    return hash;
+}
+
+cor::RoutineSimulator makeSimulator(ERoutine routine, std::uint32_t lightCount) {
+    cor::RoutineSimulator simulator(routine, lightCount, 42u);
+    simulator.color({200u, 100u, 50u});
+    simulator.palette(kPalette);
+    return simulator;
+}
+
+} // namespace
+
+TEST_CASE("Routine Simulator Frames", "[routinesimulator]") {
+    SECTION("solid") {
+        auto frame = makeSimulator(ERoutine::singleSolid, 10u).frame(7u);
+        REQUIRE(frame.size() == 10u);
+        for (const auto& color : frame) {
+            REQUIRE(color == cor::FrameColor{200u, 100u, 50u});
+        }
+    }
+
+    SECTION("blink alternates between color and off") {
+        auto simulator = makeSimulator(ERoutine::singleBlink, 4u);
+        REQUIRE(simulator.frame(0u)[0] == cor::FrameColor{200u, 100u, 50u});
+        REQUIRE(simulator.frame(1u)[0] == cor::FrameColor{0u, 0u, 0u});
+        REQUIRE(simulator.frame(2u)[0] == cor::FrameColor{200u, 100u, 50u});
+    }
+
+    SECTION("wave is offset by one frame per light") {
+        auto simulator = makeSimulator(ERoutine::singleWave, 8u);
+        auto first = simulator.frame(3u);
+        auto second = simulator.frame(4u);
+        for (auto i = 0u; i < 7u; ++i) {
+            REQUIRE(first[i + 1] == second[i]);
+        }
+    }
+
+    SECTION("fades start off and reach full brightness") {
+        auto simulator = makeSimulator(ERoutine::singleFade, 1u);
+        REQUIRE(simulator.frame(0u)[0] == cor::FrameColor{0u, 0u, 0u});
+        REQUIRE(simulator.frame(cor::RoutineSimulator::kFadeSteps)[0]
+                == cor::FrameColor{200u, 100u, 50u});
+
+        simulator.routine(ERoutine::singleSawtoothFade);
+        REQUIRE(simulator.frame(0u)[0] == cor::FrameColor{0u, 0u, 0u});
+        REQUIRE(simulator.frame(cor::RoutineSimulator::kFadeSteps - 1u)[0]
+                == cor::FrameColor{200u, 100u, 50u});
+        simulator.param(1);
+        REQUIRE(simulator.frame(0u)[0] == cor::FrameColor{200u, 100u, 50u});
+    }
+
+    SECTION("multi fade starts on each palette color") {
+        auto simulator = makeSimulator(ERoutine::multiFade, 2u);
+        for (auto i = 0u; i < kPalette.size(); ++i) {
+            REQUIRE(simulator.frame(i * cor::RoutineSimulator::kFadeSteps)[0] == kPalette[i]);
+        }
+    }
+
+    SECTION("bars") {
+        auto simulator = makeSimulator(ERoutine::multiBars, 8u);
+        simulator.param(2);
+        auto frame = simulator.frame(0u);
+        REQUIRE(frame[0] == kPalette[0]);
+        REQUIRE(frame[1] == kPalette[0]);
+        REQUIRE(frame[2] == kPalette[1]);
+        REQUIRE(frame[7] == kPalette[3]);
+        REQUIRE(simulator.frame(1u)[1] == kPalette[1]);
+    }
+
+    SECTION("brightness scales the frame") {
+        auto simulator = makeSimulator(ERoutine::singleSolid, 1u);
+        simulator.brightness(50);
+        REQUIRE(simulator.frame(0u)[0] == cor::FrameColor{100u, 50u, 25u});
+        simulator.brightness(0);
+        REQUIRE(simulator.frame(0u)[0] == cor::FrameColor{0u, 0u, 0u});
+    }
+
+    SECTION("unknown routines are black") {
+        auto frame = makeSimulator(ERoutine::MAX, 3u).frame(0u);
+        for (const auto& color : frame) {
+            REQUIRE(color == cor::FrameColor{0u, 0u, 0u});
+        }
+    }
+
+    SECTION("speed sets the frame interval") {
+        auto simulator = makeSimulator(ERoutine::singleSolid, 1u);
+        simulator.speed(100);
+        REQUIRE(simulator.frameInterval() == 1000u);
+        REQUIRE(simulator.frameIndex(2500u) == 2u);
+        simulator.speed(0);
+        REQUIRE(simulator.frameIndex(2500u) == 0u);
+
+        // speeds faster than one frame per msec still animate
+        simulator.speed(250000);
+        REQUIRE(simulator.frameInterval() == 1u);
+        REQUIRE(simulator.frameIndex(2500u) == 2500u);
+    }
+}
+
+TEST_CASE("Routine Simulator Golden Frames", "[routinesimulator]") {
+    // hashes of the first 64 frames of each routine across 16 lights. If a routine's output
+    // changes on purpose, these need to be regenerated.
+    const std::vector<std::uint64_t> goldenHashes = {16668639174182458149ULL,
+                                                      4586162864942613285ULL,
+                                                      5867378443095526677ULL,
+                                                      10446624339296502480ULL,
+                                                      8529876625810572581ULL,
+                                                      2785094833173400613ULL,
+                                                      15411665106511576299ULL,
+                                                      451968202096261477ULL,
+                                                      5632108188270976805ULL,
+                                                      10138182872246887807ULL,
+                                                      9620497791203356005ULL};
+    for (int routine = 0; routine < int(ERoutine::MAX); ++routine) {
+        auto simulator = makeSimulator(ERoutine(routine), 16u);
+        auto hash = hashFrames(simulator, 64u);
+        REQUIRE(hash == goldenHashes[std::size_t(routine)]);
+    }
+}
@@ -0,0 +1,187 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+#include "ssdpcache.h"
+#include "ssdpmessage.h"
+
+namespace {
+
+const std::string kHueNotify =
+    "NOTIFY * HTTP/1.1\r\n"
+    "HOST: 239.255.255.250:1900\r\n"
+    "CACHE-CONTROL: max-age=100\r\n"
+    "LOCATION: http://192.168.1.10:80/description.xml\r\n"
+    "SERVER: Linux/3.14.0 UPnP/1.0 IpBridge/1.26.0\r\n"
+    "NTS: ssdp:alive\r\n"
+    "hue-bridgeid: 001788FFFE100491\r\n"
+    "NT: upnp:rootdevice\r\n"
+    "USN: uuid:2f402f80-da50-11e1-9b23-001788100491::upnp:rootdevice\r\n"
+    "\r\n";
+
+const std::string kNanoleafResponse =
+    "HTTP/1.1 200 OK\r\n"
+    "Cache-Control: max-age=60\r\n"
+    "ST: nanoleaf_aurora:light\r\n"
+    "USN: uuid:7e2a5bb4-e4a7-4b2e-8d7c-4ab3d3c1b7c1\r\n"
+    "Location: http://192.168.1.11:16021\r\n"
+    "nl-deviceid: 3A:A5:D6:EC:01:7E\r\n"
+    "nl-devicename: Light Panels 55:01:3B\r\n"
+    "\r\n";
+
+/// an SSDP packet in a capture
+struct Packet {
+    /// time the packet was received, in msec
+    std::int64_t time;
+
+    /// address of the sender
+    std::string sender;
+
+    /// raw payload
+    std::string payload;
+};
+
+std::string notify(const std::string& usn, const std::string& target, int maxAge, bool alive) {
+    return "NOTIFY * HTTP/1.1\r\nHOST: 239.255.255.250:1900\r\nCACHE-CONTROL: max-age="
+           + std::to_string(maxAge) + "\r\nNT: " + target + "\r\nNTS: ssdp:"
+           + (alive ? "alive" : "byebye") + "\r\nSERVER: Linux UPnP/1.0 Generic/1.0\r\nUSN: "
+           + usn + "::" + target + "\r\n\r\n";
+}
+
+/*!
+ * generates a capture of a busy office network: 40 devices announcing 3 services each every 3
+ * seconds, a phone searching every 5 seconds, a hue bridge and a nanoleaf, and one device that
+ * leaves and comes back.
+ */
+std::vector<Packet> noisyCapture(std::int64_t duration) {
+    std::vector<Packet> packets;
+    const std::vector<std::string> targets = {"upnp:rootdevice",
+                                              "urn:schemas-upnp-org:device:MediaRenderer:1",
+                                              "urn:schemas-upnp-org:service:AVTransport:1"};
+    for (std::int64_t time = 0; time < duration; time += 3000) {
+        for (auto device = 0; device < 40; ++device) {
+            auto sender = "10.0.0." + std::to_string(device + 20);
+            auto usn = "uuid:device-" + std::to_string(device);
+            // device 5 says goodbye for a minute, starting at 2 minutes
+            bool isGone = device == 5 && time >= 120000 && time < 180000;
+            if (isGone && time < 123000) {
+                packets.push_back({time + device, sender, notify(usn, targets[0], 1800, false)});
+            }
+            if (!isGone) {
+                for (const auto& target : targets) {
+                    packets.push_back({time + device, sender, notify(usn, target, 1800, true)});
+                }
+            }
+        }
+        packets.push_back({time + 100, "192.168.1.10", kHueNotify});
+        packets.push_back({time + 200, "192.168.1.11", kNanoleafResponse});
+    }
+    for (std::int64_t time = 0; time < duration; time += 5000) {
+        packets.push_back({time + 50,
+                           "10.0.0.200",
+                           "M-SEARCH * HTTP/1.1\r\nHOST: 239.255.255.250:1900\r\nMAN: "
+                           "\"ssdp:discover\"\r\nMX: 1\r\nST: ssdp:all\r\n\r\n"});
+    }
+    std::stable_sort(packets.begin(), packets.end(), [](const Packet& a, const Packet& b) {
+        return a.time < b.time;
+    });
+    return packets;
+}
+
+} // namespace
+
+TEST_CASE("Headers are parsed once", "[SSDPCache]") {
+    auto result = cor::SSDPMessage::parse(kHueNotify);
+    REQUIRE(result.second);
+    const auto& message = result.first;
+    REQUIRE(message.type() == cor::ESSDPType::notify);
+    REQUIRE(message.server() == "Linux/3.14.0 UPnP/1.0 IpBridge/1.26.0");
+    REQUIRE(message.header("hue-bridgeid") == "001788FFFE100491");
+    REQUIRE(message.target() == "upnp:rootdevice");
+    REQUIRE(message.maxAge() == 100u);
+    REQUIRE_FALSE(message.isByeBye());
+    REQUIRE(message.header("missing").empty());
+
+    // header names are case insensitive, and values are trimmed
+    result = cor::SSDPMessage::parse(kNanoleafResponse);
+    REQUIRE(result.second);
+    REQUIRE(result.first.type() == cor::ESSDPType::response);
+    REQUIRE(result.first.location() == "http://192.168.1.11:16021");
+    REQUIRE(result.first.target() == "nanoleaf_aurora:light");
+    REQUIRE(result.first.header("nl-devicename") == "Light Panels 55:01:3B");
+
+    REQUIRE_FALSE(cor::SSDPMessage::parse("").second);
+    REQUIRE_FALSE(cor::SSDPMessage::parse("GET / HTTP/1.1\r\n\r\n").second);
+}
+
+TEST_CASE("Repeat announcements are dropped", "[SSDPCache]") {
+    cor::SSDPCache cache(10000, 60000);
+    auto hue = cor::SSDPMessage::parse(kHueNotify).first;
+    REQUIRE(cache.shouldPass("192.168.1.10", hue, 0));
+    REQUIRE_FALSE(cache.shouldPass("192.168.1.10", hue, 1000));
+    // the same device at a new address is passed along
+    REQUIRE(cache.shouldPass("192.168.1.12", hue, 1000));
+    // max-age is 100 seconds, which is capped to a minute
+    REQUIRE_FALSE(cache.shouldPass("192.168.1.10", hue, 59999));
+    REQUIRE(cache.shouldPass("192.168.1.10", hue, 60000));
+
+    // a byebye clears the device, so its next announcement is passed along
+    auto byebye = cor::SSDPMessage::parse(notify("uuid:a", "upnp:rootdevice", 1800, false)).first;
+    auto alive = cor::SSDPMessage::parse(notify("uuid:a", "upnp:rootdevice", 1800, true)).first;
+    REQUIRE(cache.shouldPass("10.0.0.1", alive, 0));
+    REQUIRE_FALSE(cache.shouldPass("10.0.0.1", byebye, 100));
+    REQUIRE(cache.shouldPass("10.0.0.1", alive, 200));
+
+    cache.clear();
+    REQUIRE(cache.shouldPass("192.168.1.10", hue, 60001));
+}
+
+TEST_CASE("Replay of a noisy SSDP capture", "[SSDPCache]") {
+    const std::int64_t kDuration = 10 * 60 * 1000;
+    auto capture = noisyCapture(kDuration);
+    cor::SSDPCache cache(10000, 60000);
+    std::size_t parsed = 0u;
+    std::size_t passed = 0u;
+    std::vector<std::int64_t> hueTimes;
+    std::vector<std::int64_t> nanoleafTimes;
+    std::vector<std::int64_t> returningTimes;
+    for (const auto& packet : capture) {
+        auto result = cor::SSDPMessage::parse(packet.payload);
+        REQUIRE(result.second);
+        ++parsed;
+        if (!cache.shouldPass(packet.sender, result.first, packet.time)) {
+            continue;
+        }
+        ++passed;
+        REQUIRE(result.first.type() != cor::ESSDPType::search);
+        if (result.first.server().find("IpBridge") != std::string::npos) {
+            hueTimes.push_back(packet.time);
+        }
+        if (result.first.target().find("nanoleaf") != std::string::npos) {
+            nanoleafTimes.push_back(packet.time);
+        }
+        if (packet.sender == "10.0.0.25" && packet.time >= 120000) {
+            returningTimes.push_back(packet.time);
+        }
+    }
+
+    // the old listeners scanned every packet, now they only see about 5% of them.
+    REQUIRE(parsed == capture.size());
+    REQUIRE(passed * 15u < parsed);
+    // devices are still passed along at least once a minute, starting with their first packet.
+    REQUIRE(hueTimes.front() == 100);
+    REQUIRE(hueTimes.size() == 10u);
+    REQUIRE(nanoleafTimes.front() == 200);
+    REQUIRE(nanoleafTimes.size() == 10u);
+    // the device that left is passed along as soon as it comes back.
+    REQUIRE_FALSE(returningTimes.empty());
+    REQUIRE(returningTimes.front() == 180005);
+    REQUIRE(cache.size() < 200u);
+}
@@ -0,0 +1,126 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+#include "stateaggregate.h"
+
+namespace {
+
+/// a reachable light
+cor::LightContribution light(bool isOn, std::uint32_t brightness) {
+    return cor::LightContribution{isOn, true, brightness};
+}
+
+} // namespace
+
+TEST_CASE("Selected lights are totaled as they update", "[StateAggregate]") {
+    cor::StateAggregate aggregate;
+    // neither light has a known state, so nothing counts yet.
+    REQUIRE_FALSE(aggregate.setSelection({"a", "b"}));
+    REQUIRE(aggregate.selection().count == 0u);
+
+    cor::StateChanges changes;
+    aggregate.updateLight("a", light(false, 40u), changes);
+    aggregate.updateLight("c", light(true, 100u), changes);
+    REQUIRE(changes.selection);
+    REQUIRE(aggregate.selection().count == 1u);
+    REQUIRE_FALSE(aggregate.selection().anyOn());
+
+    changes = cor::StateChanges();
+    aggregate.updateLight("b", light(true, 80u), changes);
+    REQUIRE(changes.selection);
+    REQUIRE(aggregate.selection().anyOn());
+    REQUIRE(aggregate.selection().reachableCount == 2u);
+    REQUIRE(aggregate.selection().averageBrightness() == 60u);
+
+    // an update that does not change the light changes nothing
+    changes = cor::StateChanges();
+    aggregate.updateLight("b", light(true, 80u), changes);
+    REQUIRE(changes.empty());
+
+    // unselected lights do not touch the selection
+    aggregate.updateLight("c", light(false, 0u), changes);
+    REQUIRE(changes.empty());
+
+    REQUIRE(aggregate.setSelection({"a", "c"}));
+    REQUIRE_FALSE(aggregate.selection().anyOn());
+    REQUIRE(aggregate.selection().brightnessSum == 40);
+    REQUIRE_FALSE(aggregate.setSelection({"c", "a", "a"}));
+    REQUIRE(aggregate.selection().count == 2u);
+
+    // selection is known before the state, and no longer than the light is selected.
+    REQUIRE(aggregate.isSelected("c"));
+    REQUIRE_FALSE(aggregate.isSelected("b"));
+    aggregate.setSelection({"d"});
+    REQUIRE(aggregate.isSelected("d"));
+    REQUIRE_FALSE(aggregate.isSelected("a"));
+}
+
+TEST_CASE("Groups are totaled alongside the selection", "[StateAggregate]") {
+    cor::StateAggregate aggregate;
+    cor::StateChanges changes;
+    aggregate.updateLight("a", light(true, 50u), changes);
+    aggregate.updateLight("b", light(false, 0u), changes);
+    REQUIRE(changes.empty());
+
+    REQUIRE(aggregate.setGroup("kitchen", {"a", "b"}));
+    REQUIRE(aggregate.setGroup("porch", {"b", "d"}));
+    REQUIRE(aggregate.group("kitchen").first.onCount == 1u);
+    REQUIRE(aggregate.group("porch").first.count == 1u);
+    REQUIRE_FALSE(aggregate.group("garage").second);
+
+    aggregate.updateLight("b", light(true, 20u), changes);
+    REQUIRE_FALSE(changes.selection);
+    REQUIRE(changes.groups == std::vector<std::string>{"kitchen", "porch"});
+    REQUIRE(aggregate.group("porch").first.anyOn());
+
+    // a removed light stops counting, but counts again once it comes back.
+    changes = cor::StateChanges();
+    aggregate.removeLight("b", changes);
+    REQUIRE(changes.groups.size() == 2u);
+    REQUIRE(aggregate.group("porch").first.count == 0u);
+    aggregate.updateLight("b", cor::LightContribution{false, false, 0u}, changes);
+    REQUIRE(aggregate.group("porch").first.count == 1u);
+    REQUIRE(aggregate.group("porch").first.reachableCount == 0u);
+
+    REQUIRE(aggregate.setGroup("kitchen", {"a"}));
+    REQUIRE(aggregate.group("kitchen").first.count == 1u);
+    changes = cor::StateChanges();
+    aggregate.updateLight("b", light(true, 10u), changes);
+    REQUIRE(changes.groups == std::vector<std::string>{"porch"});
+
+    REQUIRE(aggregate.removeGroup("porch"));
+    REQUIRE_FALSE(aggregate.removeGroup("porch"));
+    REQUIRE(aggregate.groupKeys() == std::vector<std::string>{"kitchen"});
+}
+
+TEST_CASE("Clearing the selection clears its totals", "[StateAggregate]") {
+    // the selection is cleared when a LightList is cleared, such as when loading a mood that has
+    // no reachable lights.
+    cor::StateAggregate aggregate;
+    cor::StateChanges changes;
+    aggregate.updateLight("a", light(true, 50u), changes);
+    aggregate.updateLight("b", light(false, 0u), changes);
+    REQUIRE(aggregate.setSelection({"a", "b"}));
+    REQUIRE(aggregate.selection().count == 2u);
+    REQUIRE(aggregate.selection().anyOn());
+
+    REQUIRE(aggregate.setSelection({}));
+    REQUIRE(aggregate.selection().count == 0u);
+    REQUIRE(aggregate.selection().reachableCount == 0u);
+    REQUIRE(aggregate.selection().brightnessSum == 0);
+    REQUIRE_FALSE(aggregate.selection().anyOn());
+    REQUIRE_FALSE(aggregate.isSelected("a"));
+
+    // lights that are no longer selected do not touch the selection
+    changes = cor::StateChanges();
+    aggregate.updateLight("b", light(true, 10u), changes);
+    REQUIRE_FALSE(changes.selection);
+    REQUIRE(aggregate.selection().count == 0u);
+}
@@ -0,0 +1,115 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+#include "timeouttable.h"
+
+namespace {
+
+std::vector<std::string> sorted(std::vector<std::string> keys) {
+    std::sort(keys.begin(), keys.end());
+    return keys;
+}
+
+} // namespace
+
+TEST_CASE("New and changed timeouts need reconciling", "[TimeoutTable]") {
+    cor::TimeoutTable<std::string> table(60000);
+    table.desiredTimeout("a", 30, 0, true);
+    table.desiredTimeout("b", 30, 1, false);
+    REQUIRE(sorted(table.takeDirty()) == std::vector<std::string>{"a", "b"});
+    REQUIRE(table.dirtyCount() == 0u);
+
+    // setting the same timeout again does nothing
+    table.desiredTimeout("a", 30, 0, true);
+    REQUIRE(table.takeDirty().empty());
+
+    table.desiredTimeout("b", 0, 1, false);
+    REQUIRE(table.takeDirty() == std::vector<std::string>{"b"});
+
+    // removed lights are never dirty
+    table.markDirty("a");
+    REQUIRE(table.remove("a"));
+    table.markDirty("a");
+    REQUIRE(table.takeDirty().empty());
+    REQUIRE(table.size() == 1u);
+}
+
+TEST_CASE("Schedule changes only mark their group", "[TimeoutTable]") {
+    cor::TimeoutTable<std::string> table(60000);
+    table.desiredTimeout("hue1", 30, 0, true);
+    table.desiredTimeout("hue2", 30, 0, true);
+    table.desiredTimeout("leaf", 30, 1, true);
+    table.takeDirty();
+
+    table.markGroupDirty(0);
+    REQUIRE(sorted(table.takeDirty()) == std::vector<std::string>{"hue1", "hue2"});
+}
+
+TEST_CASE("Activity only refreshes lights that are due", "[TimeoutTable]") {
+    cor::TimeoutTable<std::string> table(60000);
+    table.desiredTimeout("old", 30, 0, true);
+    table.desiredTimeout("new", 30, 0, true);
+    table.desiredTimeout("device", 30, 1, false);
+    table.desiredTimeout("disabled", 0, 0, true);
+    table.takeDirty();
+    table.synced("old", 0);
+    table.synced("device", 0);
+    table.synced("disabled", 0);
+    table.synced("new", 50000);
+
+    table.activity(30000);
+    REQUIRE(table.takeDirty().empty());
+
+    // only the light synced over a minute ago is refreshed, lights that handle their own
+    // timeouts and lights without timeouts never are.
+    table.activity(70000);
+    REQUIRE(table.takeDirty() == std::vector<std::string>{"old"});
+    table.synced("old", 70000);
+
+    table.activity(115000);
+    REQUIRE(table.takeDirty() == std::vector<std::string>{"new"});
+
+    // a light synced again for another reason skips its older refresh.
+    table.markDirty("new");
+    table.takeDirty();
+    table.synced("new", 120000);
+    table.activity(131000);
+    REQUIRE(table.takeDirty() == std::vector<std::string>{"old"});
+}
+
+TEST_CASE("Unavailable lights wait for the next sync", "[TimeoutTable]") {
+    cor::TimeoutTable<std::string> table(60000);
+    table.desiredTimeout("known", 30, 0, false);
+    table.desiredTimeout("unknown", 30, 0, false);
+    for (const auto& key : table.takeDirty()) {
+        if (key == "unknown") {
+            table.unavailable(key);
+        } else {
+            table.synced(key, 0);
+        }
+    }
+    // the unavailable light does not keep the sync going
+    REQUIRE(table.dirtyCount() == 0u);
+    REQUIRE(table.unavailableCount() == 1u);
+    REQUIRE(table.takeDirty().empty());
+
+    table.retryUnavailable();
+    REQUIRE(table.unavailableCount() == 0u);
+    REQUIRE(table.takeDirty() == std::vector<std::string>{"unknown"});
+
+    // removed lights are never retried
+    table.unavailable("unknown");
+    REQUIRE(table.remove("unknown"));
+    table.retryUnavailable();
+    REQUIRE(table.takeDirty().empty());
+    table.unavailable("missing");
+    REQUIRE(table.unavailableCount() == 0u);
+}
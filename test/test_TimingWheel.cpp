@@ -0,0 +1,72 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+#include "timingwheel.h"
+
+TEST_CASE("Keys expire once their deadline passes", "[TimingWheel]") {
+    cor::TimingWheel<std::string> wheel(100, 16u);
+    wheel.schedule("a", 1000);
+    wheel.schedule("b", 1500);
+    REQUIRE(wheel.size() == 2u);
+
+    std::vector<std::string> expired;
+    auto collect = [&expired](const std::string& key) { expired.push_back(key); };
+    REQUIRE(wheel.advance(999, collect) == 0u);
+    REQUIRE(wheel.advance(1000, collect) == 1u);
+    REQUIRE(expired == std::vector<std::string>{"a"});
+    REQUIRE(wheel.advance(2000, collect) == 1u);
+    REQUIRE(expired == std::vector<std::string>{"a", "b"});
+    REQUIRE(wheel.size() == 0u);
+}
+
+TEST_CASE("Rescheduling and cancelling keys", "[TimingWheel]") {
+    cor::TimingWheel<std::string> wheel(100, 16u);
+    wheel.schedule("a", 1000);
+    wheel.schedule("b", 1000);
+    // hearing from a light pushes its deadline back.
+    wheel.schedule("a", 3000);
+    REQUIRE(wheel.cancel("b"));
+    REQUIRE_FALSE(wheel.cancel("b"));
+
+    std::vector<std::string> expired;
+    auto collect = [&expired](const std::string& key) { expired.push_back(key); };
+    REQUIRE(wheel.advance(2000, collect) == 0u);
+    REQUIRE(wheel.contains("a"));
+    REQUIRE(wheel.advance(3000, collect) == 1u);
+    REQUIRE(expired == std::vector<std::string>{"a"});
+}
+
+TEST_CASE("Deadlines beyond one revolution of the wheel", "[TimingWheel]") {
+    // the wheel covers 1.6 seconds, so this deadline passes over its slot several times.
+    cor::TimingWheel<int> wheel(100, 16u);
+    wheel.schedule(1, 5050);
+    std::size_t count = 0u;
+    for (std::int64_t now = 0; now < 5000; now += 100) {
+        count += wheel.advance(now, [](int) {});
+    }
+    REQUIRE(count == 0u);
+    REQUIRE(wheel.advance(5100, [](int) {}) == 1u);
+
+    // a jump in time longer than the wheel still expires everything that is due.
+    wheel.schedule(2, 6000);
+    wheel.schedule(3, 7000);
+    wheel.schedule(4, 60000);
+    REQUIRE(wheel.advance(50000, [](int) {}) == 2u);
+    REQUIRE(wheel.contains(4));
+}
+
+TEST_CASE("Keys can be rescheduled while expiring", "[TimingWheel]") {
+    cor::TimingWheel<int> wheel(100, 16u);
+    wheel.schedule(1, 100);
+    wheel.advance(100, [&wheel](int key) { wheel.schedule(key, 500); });
+    REQUIRE(wheel.contains(1));
+    REQUIRE(wheel.advance(400, [](int) {}) == 0u);
+    REQUIRE(wheel.advance(500, [](int) {}) == 1u);
+}
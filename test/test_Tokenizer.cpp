@@ -0,0 +1,129 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include <charconv>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+#include "tokenizer.h"
+
+namespace {
+
+using Tokens = std::vector<std::string_view>;
+
+/// splits the way std::getline does, which CommArduCor used to parse packets.
+std::vector<std::string> getlineSplit(const std::string& input, char delimiter) {
+    std::vector<std::string> tokens;
+    std::istringstream stream(input);
+    std::string token;
+    while (std::getline(stream, token, delimiter)) {
+        tokens.push_back(token);
+    }
+    return tokens;
+}
+
+/// splits the way cor::regexSplit did: compile the pattern, then copy every token into a list.
+std::vector<std::string> regexSplit(const std::string& input, const std::string& pattern) {
+    std::regex regex(pattern);
+    std::vector<std::string> tokens;
+    std::sregex_token_iterator it(input.begin(), input.end(), regex, -1);
+    for (; it != std::sregex_token_iterator(); ++it) {
+        if (it->length() > 0) {
+            tokens.push_back(*it);
+        }
+    }
+    return tokens;
+}
+
+/// a datagram from an ArduCor controller with several lights, with a CRC at the end.
+std::string arduCorDatagram(int seed) {
+    std::string datagram;
+    for (auto index = 1; index <= 4; ++index) {
+        datagram += "7," + std::to_string(index) + "," + std::to_string((seed * 7) % 255) + ","
+                    + std::to_string((seed * 13) % 255) + "," + std::to_string((seed * 29) % 255)
+                    + ",100,120,5,0&";
+    }
+    return datagram + "#" + std::to_string(seed * 104729) + ";";
+}
+
+} // namespace
+
+TEST_CASE("Empty tokens are skipped by default", "[Tokenizer]") {
+    cor::Tokenizer<char> tokenizer(" \t");
+    REQUIRE(tokenizer.split("  living  room\tlamp ") == Tokens{"living", "room", "lamp"});
+    REQUIRE(tokenizer.split("").empty());
+    REQUIRE(tokenizer.split(" \t ").empty());
+    REQUIRE(tokenizer.isDelimiter('\t'));
+    REQUIRE_FALSE(tokenizer.isDelimiter('a'));
+
+    // multiple packets in one datagram
+    cor::Tokenizer<char> packets(";");
+    REQUIRE(packets.split("7,1,2;8,1,3;") == Tokens{"7,1,2", "8,1,3"});
+}
+
+TEST_CASE("Kept empty tokens match std::getline", "[Tokenizer]") {
+    cor::Tokenizer<char> tokenizer(",", false);
+    for (const std::string input : {"", "a", "a,b", "a,,b", ",a", "a,", "a,,", ",,", "1,2,3&#5;"}) {
+        auto expected = getlineSplit(input, ',');
+        auto tokens = tokenizer.split(input);
+        REQUIRE(tokens.size() == expected.size());
+        for (std::size_t i = 0u; i < tokens.size(); ++i) {
+            REQUIRE(tokens[i] == expected[i]);
+        }
+    }
+}
+
+TEST_CASE("Wide delimiters are supported", "[Tokenizer]") {
+    // an ideographic space is outside the lookup table
+    cor::Tokenizer<char16_t> tokenizer(u"  　");
+    auto tokens = tokenizer.split(u"a b　c d");
+    REQUIRE(tokens.size() == 4u);
+    REQUIRE(tokens[0] == u"a");
+    REQUIRE(tokens[3] == u"d");
+    REQUIRE(tokens[2].data() == std::u16string_view(u"a b　c d").data() + 4);
+}
+
+TEST_CASE("Tokenizer views parse the same values as regex and getline", "[Tokenizer]") {
+    std::vector<std::string> datagrams;
+    for (auto i = 0; i < 200; ++i) {
+        // UDP datagrams hold several packets separated by semicolons
+        datagrams.push_back(arduCorDatagram(i) + arduCorDatagram(i + 1));
+    }
+    const cor::Tokenizer<char> kPackets(";");
+    const cor::Tokenizer<char> kMessages("&", false);
+    const cor::Tokenizer<char> kValues(",", false);
+
+    std::vector<int> regexValues;
+    for (const auto& datagram : datagrams) {
+        for (const auto& packet : regexSplit(datagram, "(\\;)")) {
+            for (const auto& message : getlineSplit(packet, '&')) {
+                for (const auto& number : getlineSplit(message, ',')) {
+                    std::istringstream stream(number);
+                    int i = 0;
+                    stream >> i;
+                    regexValues.push_back(i);
+                }
+            }
+        }
+    }
+
+    std::vector<int> tokenizerValues;
+    for (const auto& datagram : datagrams) {
+        kPackets.forEach(datagram, [&](std::string_view packet) {
+            kMessages.forEach(packet, [&](std::string_view message) {
+                kValues.forEach(message, [&](std::string_view number) {
+                    int i = 0;
+                    std::from_chars(number.data(), number.data() + number.size(), i);
+                    tokenizerValues.push_back(i);
+                });
+            });
+        });
+    }
+    REQUIRE(tokenizerValues == regexValues);
+}
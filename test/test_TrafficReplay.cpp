@@ -0,0 +1,181 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "catch.hpp"
+#include "trafficlog.h"
+#include "trafficreplay.h"
+
+namespace {
+
+/// makes an event at a given time of a capture
+cor::TrafficEvent makeEvent(std::int64_t time,
+                            const std::string& source,
+                            cor::ETrafficDirection direction,
+                            const std::string& endpoint,
+                            const std::string& payload,
+                            const std::string& method = std::string(),
+                            std::uint64_t requestID = 0u) {
+    cor::TrafficEvent event;
+    event.time = time;
+    event.source = source;
+    event.direction = direction;
+    event.endpoint = endpoint;
+    event.method = method;
+    event.requestID = requestID;
+    event.payload = payload;
+    return event;
+}
+
+const auto kSent = cor::ETrafficDirection::sent;
+const auto kReceived = cor::ETrafficDirection::received;
+
+const std::string kHueLights = "http://192.168.1.10/api/user/lights";
+
+} // namespace
+
+TEST_CASE("Traffic events survive encoding", "[TrafficReplay]") {
+    auto event = makeEvent(1500, "Hue", kReceived, kHueLights, "{\"1\":\n\t{\"on\":true}} 100%");
+    event.method = "GET";
+    event.requestID = 42u;
+    event.status = 3;
+    auto line = cor::encodeTrafficEvent(event);
+    REQUIRE(line.find('\n') == std::string::npos);
+
+    auto result = cor::decodeTrafficEvent(line);
+    REQUIRE(result.second);
+    const auto& decoded = result.first;
+    REQUIRE(decoded.time == 1500);
+    REQUIRE(decoded.source == "Hue");
+    REQUIRE(decoded.direction == kReceived);
+    REQUIRE(decoded.endpoint == kHueLights);
+    REQUIRE(decoded.method == "GET");
+    REQUIRE(decoded.requestID == 42u);
+    REQUIRE(decoded.status == 3);
+    REQUIRE(decoded.payload == event.payload);
+
+    REQUIRE_FALSE(cor::decodeTrafficEvent("").second);
+    REQUIRE_FALSE(cor::decodeTrafficEvent("12\tUDP\tsideways\t1.2.3.4\t\t0\t0\t7,1;").second);
+    REQUIRE_FALSE(cor::decodeTrafficEvent("12\tUDP\tsent\t1.2.3.4\t\t0\t0\t7,1%4").second);
+    REQUIRE_FALSE(cor::decodeTrafficEvent("soon\tUDP\tsent\t1.2.3.4\t\t0\t0\t7,1;").second);
+}
+
+TEST_CASE("A traffic log can be read back", "[TrafficReplay]") {
+    cor::TrafficLog log;
+    std::vector<std::thread> threads;
+    for (auto i = 0; i < 4; ++i) {
+        threads.emplace_back([&log, i]() {
+            for (auto j = 0; j < 100; ++j) {
+                log.record(makeEvent(0, "UDP", kReceived, "192.168.1." + std::to_string(i), "7;"));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    auto events = log.events();
+    REQUIRE(events.size() == 400u);
+
+    std::stringstream file;
+    for (const auto& event : events) {
+        file << cor::encodeTrafficEvent(event) << '\n';
+    }
+    file << "a line that is not an event\n";
+    auto readEvents = cor::readTrafficLog(file);
+    REQUIRE(readEvents.size() == 400u);
+    for (std::size_t i = 1u; i < readEvents.size(); ++i) {
+        REQUIRE(readEvents[i - 1u].time <= readEvents[i].time);
+    }
+}
+
+TEST_CASE("Packets are replayed in order at the speed of the replay", "[TrafficReplay]") {
+    std::vector<cor::TrafficEvent> capture = {
+        makeEvent(0, "UDP", kSent, "192.168.1.20", "5&;"),
+        makeEvent(40, "UDP", kReceived, "192.168.1.20", "7,1,1;"),
+        makeEvent(400, "Serial", kReceived, "ttyUSB0", "7,2,0;"),
+        makeEvent(300, "UDP", kReceived, "192.168.1.21", "7,1,0;"),
+    };
+    cor::TrafficReplay replay(capture, 4.0);
+    REQUIRE(replay.nextPacketTime() == 10);
+    REQUIRE(replay.takePackets(9).empty());
+
+    auto packets = replay.takePackets(75);
+    REQUIRE(packets.size() == 2u);
+    REQUIRE(packets[0].payload == "7,1,1;");
+    REQUIRE(packets[1].endpoint == "192.168.1.21");
+    REQUIRE_FALSE(replay.isFinished());
+
+    packets = replay.takePackets(1000);
+    REQUIRE(packets.size() == 1u);
+    REQUIRE(packets[0].source == "Serial");
+    REQUIRE(replay.isFinished());
+    REQUIRE(replay.nextPacketTime() == -1);
+}
+
+TEST_CASE("HTTP requests are answered with their captured responses", "[TrafficReplay]") {
+    std::vector<cor::TrafficEvent> capture = {
+        makeEvent(0, "Hue", kSent, kHueLights, "", "GET", 1u),
+        makeEvent(5, "Hue", kSent, kHueLights + "/1/state", "{\"on\":true}", "PUT", 2u),
+        // request IDs are per client, so another CommType can reuse one
+        makeEvent(6, "Nanoleaf", kSent, "http://192.168.1.11:16021/api/v1/x", "", "GET", 1u),
+        makeEvent(80, "Hue", kReceived, kHueLights + "/1/state", "[{\"success\":1}]", "PUT", 2u),
+        makeEvent(120, "Hue", kReceived, kHueLights, "{\"1\":{}}", "GET", 1u),
+        makeEvent(1000, "Hue", kSent, kHueLights, "", "GET", 3u),
+        makeEvent(1030, "Hue", kReceived, kHueLights, "{\"1\":{},\"2\":{}}", "GET", 3u),
+    };
+    cor::TrafficReplay replay(capture, 2.0);
+
+    auto response = replay.respond("Hue", "GET", kHueLights, "");
+    REQUIRE(response.second);
+    REQUIRE(response.first.payload == "{\"1\":{}}");
+    REQUIRE(response.first.time == 60);
+
+    response = replay.respond("Hue", "GET", kHueLights, "");
+    REQUIRE(response.first.payload == "{\"1\":{},\"2\":{}}");
+    REQUIRE(response.first.time == 15);
+
+    // once the responses run out, the last one is repeated
+    response = replay.respond("Hue", "GET", kHueLights, "");
+    REQUIRE(response.first.payload == "{\"1\":{},\"2\":{}}");
+
+    // a body that was not captured falls back to a request to the same URL
+    response = replay.respond("Hue", "PUT", kHueLights + "/1/state", "{\"on\":false}");
+    REQUIRE(response.second);
+    REQUIRE(response.first.payload == "[{\"success\":1}]");
+
+    // the nanoleaf request never got a response
+    auto nanoleafURL = "http://192.168.1.11:16021/api/v1/x";
+    REQUIRE_FALSE(replay.respond("Nanoleaf", "GET", nanoleafURL, "").second);
+    REQUIRE_FALSE(replay.respond("Hue", "DELETE", kHueLights, "").second);
+    REQUIRE(replay.missedRequests() == 2u);
+}
+
+TEST_CASE("Each captured response is only replayed once", "[TrafficReplay]") {
+    auto stateURL = kHueLights + "/1/state";
+    std::vector<cor::TrafficEvent> capture = {
+        makeEvent(0, "Hue", kSent, stateURL, "{\"on\":true}", "PUT", 1u),
+        makeEvent(10, "Hue", kReceived, stateURL, "[{\"on\":true}]", "PUT", 1u),
+        makeEvent(20, "Hue", kSent, stateURL, "{\"on\":false}", "PUT", 2u),
+        makeEvent(30, "Hue", kReceived, stateURL, "[{\"on\":false}]", "PUT", 2u),
+    };
+    cor::TrafficReplay replay(capture, 1.0);
+    REQUIRE(replay.respond("Hue", "PUT", stateURL, "{\"on\":true}").first.payload
+            == "[{\"on\":true}]");
+
+    // a body that was not captured falls back to the responses that were not replayed yet.
+    REQUIRE(replay.respond("Hue", "PUT", stateURL, "{\"bri\":10}").first.payload
+            == "[{\"on\":false}]");
+
+    // once they are all replayed, a body repeats its own last response.
+    REQUIRE(replay.respond("Hue", "PUT", stateURL, "{\"on\":true}").first.payload
+            == "[{\"on\":true}]");
+    REQUIRE(replay.respond("Hue", "PUT", stateURL, "{\"on\":false}").first.payload
+            == "[{\"on\":false}]");
+}
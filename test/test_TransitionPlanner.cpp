@@ -0,0 +1,159 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+
+#include "catch.hpp"
+#include "transitionplanner.h"
+
+namespace {
+
+/// a hue light, sent a command at most every 400 msec with a fade in deciseconds.
+const cor::TransitionCapability kHue{true, 400u, 100u};
+
+/// a nanoleaf brightness change, sent at most every second with a fade in seconds.
+const cor::TransitionCapability kNanoleaf{true, 1000u, 1000u};
+
+/// an ArduCor controller, which has no fades and is sent every intermediate state.
+const cor::TransitionCapability kArduCor{false, 100u, 1u};
+
+/// a local stand-in for a device, it fades linearly to each value it is sent.
+class StandIn {
+public:
+    /// value shown by the device at a given time
+    double value(std::int64_t now) const {
+        if (mFade == 0u || now >= mStart + std::int64_t(mFade)) {
+            return mTo;
+        }
+        return mFrom + (mTo - mFrom) * double(now - mStart) / double(mFade);
+    }
+
+    /// value the device was last sent
+    double target() const noexcept { return mTo; }
+
+    /// number of commands the device was sent
+    std::uint32_t commands() const noexcept { return mCommands; }
+
+    /// sends the device a command
+    void command(double target, std::uint32_t fade, std::int64_t now) {
+        mFrom = value(now);
+        mTo = target;
+        mStart = now;
+        mFade = fade;
+        ++mCommands;
+    }
+
+private:
+    double mFrom = 0.0;
+    double mTo = 0.0;
+    std::int64_t mStart = 0;
+    std::uint32_t mFade = 0u;
+    std::uint32_t mCommands = 0u;
+};
+
+/// what a stand-in did during a scripted slider drag
+struct DragResult {
+    /// commands sent while the slider was moving
+    std::uint32_t dragCommands;
+
+    /// commands sent in total
+    std::uint32_t commands;
+
+    /// largest change of the shown value in a single frame
+    double largestJump;
+
+    /// value shown once everything settled
+    double finalValue;
+};
+
+/*!
+ * drags a slider from 0 to 100 over two seconds, updating it every frame. A sync pass runs every
+ * 100 msec, like the DataSync timers, and plans a command if the device is out of sync.
+ */
+DragResult drag(const cor::TransitionCapability& capability) {
+    const std::int64_t kFrame = 16;
+    const std::int64_t kDragLength = 2000;
+    const std::int64_t kSyncInterval = 100;
+    cor::TransitionPlanner<std::string> planner;
+    StandIn device;
+    DragResult result{0u, 0u, 0.0, 0.0};
+    double slider = 0.0;
+    double lastShown = 0.0;
+    for (std::int64_t now = 0; now <= kDragLength + 3000; now += kFrame / 4) {
+        if (now % kFrame == 0) {
+            slider = std::min(100.0, 100.0 * double(now) / double(kDragLength));
+            auto shown = device.value(now);
+            result.largestJump = std::max(result.largestJump, std::abs(shown - lastShown));
+            lastShown = shown;
+        }
+        if (now % kSyncInterval == 0 && device.target() != slider) {
+            auto step = planner.plan("light", capability, now);
+            if (step.shouldSend) {
+                device.command(slider, step.fade, now);
+                planner.sent("light", now);
+                if (now <= kDragLength) {
+                    ++result.dragCommands;
+                }
+            }
+        }
+    }
+    result.commands = device.commands();
+    result.finalValue = device.value(kDragLength + 3000);
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("Commands wait for the device's interval", "[TransitionPlanner]") {
+    cor::TransitionPlanner<std::string> planner;
+    REQUIRE(planner.plan("a", kHue, 0).shouldSend);
+    planner.sent("a", 0);
+    REQUIRE_FALSE(planner.plan("a", kHue, 399).shouldSend);
+    REQUIRE(planner.plan("a", kHue, 400).shouldSend);
+
+    // other devices are not held back
+    REQUIRE(planner.plan("b", kHue, 1).shouldSend);
+
+    // forgotten devices are sent right away
+    planner.remove("a");
+    REQUIRE(planner.plan("a", kHue, 1).shouldSend);
+    REQUIRE(planner.size() == 0u);
+}
+
+TEST_CASE("Fades cover the interval in the device's units", "[TransitionPlanner]") {
+    cor::TransitionPlanner<std::string> planner;
+    REQUIRE(planner.plan("a", kHue, 0).fade == 400u);
+    REQUIRE(planner.plan("a", kNanoleaf, 0).fade == 1000u);
+    REQUIRE(planner.plan("a", {true, 450u, 100u}, 0).fade == 500u);
+    REQUIRE(planner.plan("a", {true, 450u, 0u}, 0).fade == 450u);
+    REQUIRE(planner.plan("a", kArduCor, 0).fade == 0u);
+}
+
+TEST_CASE("Slider drags send fewer commands to devices that fade", "[TransitionPlanner]") {
+    auto streamed = drag(kArduCor);
+    auto hue = drag(kHue);
+    auto nanoleaf = drag(kNanoleaf);
+
+    // every device ends up at the end of the drag
+    REQUIRE(streamed.finalValue == Approx(100.0));
+    REQUIRE(hue.finalValue == Approx(100.0));
+    REQUIRE(nanoleaf.finalValue == Approx(100.0));
+
+    // a two second drag is about 10 commands per second when streamed, 2.5 to a hue and 1 to a
+    // nanoleaf.
+    REQUIRE(streamed.dragCommands >= 20u);
+    REQUIRE(hue.dragCommands <= 6u);
+    REQUIRE(nanoleaf.dragCommands <= 3u);
+    REQUIRE(hue.commands <= streamed.commands / 3u);
+
+    // streamed values jump between commands, fades move a little every frame.
+    REQUIRE(streamed.largestJump >= 4.0);
+    REQUIRE(hue.largestJump < 2.0);
+    REQUIRE(nanoleaf.largestJump < 2.0);
+}
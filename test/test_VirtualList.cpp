@@ -0,0 +1,130 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "catch.hpp"
+#include "virtuallist.h"
+
+namespace {
+
+/// sorts unreachable lights last, then by name, like the light menu.
+using SortKey = std::pair<bool, std::string>;
+
+using List = cor::VirtualList<std::string, SortKey>;
+
+std::string name(int i) {
+    auto number = std::to_string(i);
+    return "light" + std::string(4u - std::min<std::size_t>(4u, number.size()), '0') + number;
+}
+
+} // namespace
+
+TEST_CASE("Rows are sorted by their cached sort key", "[VirtualList]") {
+    List list;
+    list.insert("c", {false, "c"});
+    list.insert("a", {true, "a"});
+    list.insert("b", {false, "b"});
+    REQUIRE(list.size() == 3u);
+    REQUIRE(list.key(0) == "b");
+    REQUIRE(list.key(1) == "c");
+    REQUIRE(list.key(2) == "a");
+
+    // becoming unreachable moves a row to the end
+    list.insert("b", {true, "b"});
+    REQUIRE(list.key(0) == "c");
+    REQUIRE(list.row("b") == 2u);
+
+    REQUIRE(list.remove("a"));
+    REQUIRE_FALSE(list.remove("a"));
+    REQUIRE(list.row("a") == List::kInvalid);
+    REQUIRE(list.key(1) == "b");
+}
+
+TEST_CASE("Only visible rows get slots", "[VirtualList]") {
+    List list(1u);
+    for (auto i = 0; i < 1000; ++i) {
+        list.insert(name(i), {false, name(i)});
+    }
+    // rows are 10 high, the viewport shows 5 of them, plus one row of overscan below.
+    auto bindings = list.bind(0, 50, 10);
+    REQUIRE(bindings.size() == 6u);
+    REQUIRE(list.firstBoundRow() == 0u);
+    REQUIRE(list.slot(name(0)) != List::kInvalid);
+    REQUIRE(list.slot(name(500)) == List::kInvalid);
+
+    // binding again with nothing changed does nothing
+    REQUIRE(list.bind(0, 50, 10).empty());
+
+    // scrolling by one row reuses the slot of the row that scrolled out.
+    REQUIRE(list.bind(10, 50, 10).size() == 1u);
+    REQUIRE(list.slotCount() == 7u);
+    auto slot = list.slot(name(0));
+    bindings = list.bind(20, 50, 10);
+    REQUIRE(list.slotCount() == 7u);
+    REQUIRE(bindings.size() == 1u);
+    REQUIRE(bindings[0].row == 7u);
+    REQUIRE(bindings[0].slot == slot);
+    REQUIRE(list.slot(name(0)) == List::kInvalid);
+    REQUIRE(list.freeSlots().empty());
+
+    // jumping far away rebinds every slot without creating new ones
+    bindings = list.bind(5000, 50, 10);
+    REQUIRE(bindings.size() == 7u);
+    REQUIRE(list.slotCount() == 7u);
+    REQUIRE(std::find_if(bindings.begin(),
+                         bindings.end(),
+                         [slot](const List::Binding& binding) { return binding.slot == slot; })
+            != bindings.end());
+}
+
+TEST_CASE("Changing the rows rebinds the visible rows", "[VirtualList]") {
+    List list(0u);
+    for (auto i = 0; i < 10; ++i) {
+        list.insert(name(i), {false, name(i)});
+    }
+    REQUIRE(list.bind(0, 30, 10).size() == 3u);
+
+    list.insert("light", {false, "light"});
+    auto bindings = list.bind(0, 30, 10);
+    REQUIRE(bindings.size() == 3u);
+    REQUIRE(list.key(bindings[0].row) == "light");
+    REQUIRE(list.slotCount() == 3u);
+
+    list.clear();
+    REQUIRE(list.bind(0, 30, 10).empty());
+    REQUIRE(list.freeSlots().size() == 3u);
+}
+
+TEST_CASE("Batches of changes keep the rows in order", "[VirtualList]") {
+    List list(0u);
+    for (auto i = 0; i < 100; ++i) {
+        list.insert(name(i), {false, name(i)});
+        // rows waiting for a sort are not bound to a slot
+        REQUIRE(list.slot(name(i)) == List::kInvalid);
+    }
+    REQUIRE(list.bind(0, 30, 10).size() == 3u);
+    REQUIRE(list.slot(name(0)) != List::kInvalid);
+
+    // remove every even row and make every fifth row unreachable, without sorting in between.
+    for (auto i = 0; i < 100; i += 2) {
+        REQUIRE(list.remove(name(i)));
+    }
+    for (auto i = 5; i < 100; i += 10) {
+        list.insert(name(i), {true, name(i)});
+    }
+    REQUIRE(list.slot(name(1)) == List::kInvalid);
+    REQUIRE(list.size() == 50u);
+    REQUIRE(list.key(0) == name(1));
+    REQUIRE(list.key(1) == name(3));
+    REQUIRE(list.key(2) == name(7));
+    REQUIRE(list.row(name(5)) == 40u);
+    REQUIRE(list.key(49) == name(95));
+    REQUIRE(list.row(name(0)) == List::kInvalid);
+}
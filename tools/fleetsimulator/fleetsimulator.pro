@@ -0,0 +1,37 @@
+#-------------------------------------------------
+#
+# Fleet simulator, hosts simulated Hue bridges, Nanoleaf
+# controllers, and ArduCor controllers for load testing.
+#
+# Linux only, since serial controllers use ptys.
+#
+#-------------------------------------------------
+
+QT       += core network
+QT       -= gui
+
+TARGET = fleetsimulator
+CONFIG += console c++14
+CONFIG -= app_bundle
+TEMPLATE = app
+
+# share the CRC calculator with the app
+INCLUDEPATH += ../../src/
+
+LIBS += -lutil
+
+SOURCES += \
+    main.cpp \
+    simarducor.cpp \
+    simhttpserver.cpp \
+    simhue.cpp \
+    simnanoleaf.cpp \
+    ../../src/comm/arducor/crccalculator.cpp
+
+HEADERS += \
+    networkconditions.h \
+    simarducor.h \
+    simhttpserver.h \
+    simhue.h \
+    simnanoleaf.h \
+    ../../src/comm/arducor/crccalculator.h
@@ -0,0 +1,179 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ *
+ * The fleet simulator hosts simulated Hue bridges, Nanoleaf controllers, and ArduCor controllers
+ * so that Corluma's discovery, polling, and command paths can be load tested without hardware.
+ * Every simulated device gets its own loopback address, starting at --base-address, and listens
+ * on the same port as the real device. Linux routes all of 127.0.0.0/8 to the loopback interface,
+ * so thousands of devices can run on one machine without any network setup.
+ */
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QTextStream>
+#include <QTimer>
+#include <memory>
+#include <vector>
+
+#include "simarducor.h"
+#include "simhttpserver.h"
+#include "simhue.h"
+#include "simnanoleaf.h"
+
+namespace {
+
+/// adds an integer option to the parser
+void addOption(QCommandLineParser& parser,
+               const QString& name,
+               const QString& description,
+               const QString& defaultValue) {
+    parser.addOption(QCommandLineOption(name, description, "value", defaultValue));
+}
+
+/// reads an integer option from the parser
+int intOption(const QCommandLineParser& parser, const QString& name) {
+    return parser.value(name).toInt();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("fleetsimulator");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Simulates fleets of lights for load testing Corluma.");
+    parser.addHelpOption();
+    addOption(parser, "hue-bridges", "Number of Hue bridges.", "0");
+    addOption(parser, "hue-lights", "Number of lights on each Hue bridge.", "10");
+    addOption(parser, "hue-port", "Port Hue bridges listen on.", "80");
+    addOption(parser, "nanoleafs", "Number of Nanoleaf controllers.", "0");
+    addOption(parser, "nanoleaf-panels", "Number of panels on each Nanoleaf.", "9");
+    addOption(parser, "nanoleaf-effects", "Number of effects stored on each Nanoleaf.", "3");
+    addOption(parser, "nanoleaf-port", "Port Nanoleaf controllers listen on.", "16021");
+    addOption(parser, "arducor-udp", "Number of ArduCor controllers over UDP.", "0");
+    addOption(parser, "arducor-http", "Number of ArduCor controllers over HTTP.", "0");
+    addOption(parser, "arducor-serial", "Number of ArduCor controllers over serial ptys.", "0");
+    addOption(parser, "arducor-lights", "Number of lights on each ArduCor controller.", "1");
+    addOption(parser, "arducor-http-port", "Port ArduCor HTTP controllers listen on.", "80");
+    addOption(parser, "arducor-crc", "1 if ArduCor controllers use CRCs.", "0");
+    addOption(parser, "base-address", "First loopback address handed out.", "127.1.0.1");
+    addOption(parser, "latency", "Msec added before every response.", "0");
+    addOption(parser, "jitter", "Max random msec added on top of the latency.", "0");
+    addOption(parser, "loss", "Percent of packets dropped.", "0");
+    addOption(parser, "rate-limit", "Max requests per second per device, 0 for no limit.", "0");
+    parser.process(app);
+
+    sim::NetworkConditions conditions;
+    conditions.latency = intOption(parser, "latency");
+    conditions.jitter = intOption(parser, "jitter");
+    conditions.lossPercent = intOption(parser, "loss");
+    conditions.rateLimit = intOption(parser, "rate-limit");
+
+    QTextStream out(stdout);
+    auto nextAddress = QHostAddress(parser.value("base-address")).toIPv4Address();
+    std::vector<sim::HTTPServer*> servers;
+    std::vector<std::unique_ptr<sim::HueBridgeSim>> bridges;
+    std::vector<std::unique_ptr<sim::NanoleafSim>> nanoleafs;
+    std::vector<std::unique_ptr<sim::ArduCorControllerSim>> controllers;
+
+    // starts a HTTP server for a device on the next free address.
+    auto startServer = [&](const QString& type, quint16 port, sim::HTTPServer::Handler handler) {
+        QHostAddress address(nextAddress++);
+        auto server = new sim::HTTPServer(conditions, std::move(handler), &app);
+        if (!server->listen(address, port)) {
+            out << "WARNING: " << type << " could not listen on " << address.toString() << ":"
+                << port << "\n";
+        } else {
+            out << type << " " << address.toString() << ":" << port << "\n";
+        }
+        servers.push_back(server);
+    };
+
+    for (auto i = 0; i < intOption(parser, "hue-bridges"); ++i) {
+        QHostAddress address(nextAddress);
+        auto hueLights = intOption(parser, "hue-lights");
+        bridges.emplace_back(new sim::HueBridgeSim(i + 1, hueLights, address.toString()));
+        auto bridge = bridges.back().get();
+        startServer("hue",
+                    quint16(intOption(parser, "hue-port")),
+                    [bridge](const sim::HTTPRequest& request) {
+                        return bridge->handleRequest(request);
+                    });
+    }
+
+    for (auto i = 0; i < intOption(parser, "nanoleafs"); ++i) {
+        nanoleafs.emplace_back(new sim::NanoleafSim(i + 1,
+                                                    intOption(parser, "nanoleaf-panels"),
+                                                    intOption(parser, "nanoleaf-effects")));
+        auto nanoleaf = nanoleafs.back().get();
+        startServer("nanoleaf",
+                    quint16(intOption(parser, "nanoleaf-port")),
+                    [nanoleaf](const sim::HTTPRequest& request) {
+                        return nanoleaf->handleRequest(request);
+                    });
+    }
+
+    auto arduCorLights = intOption(parser, "arducor-lights");
+    auto useCRC = intOption(parser, "arducor-crc") == 1;
+    auto addController = [&](const QString& name) {
+        controllers.emplace_back(new sim::ArduCorControllerSim(name, arduCorLights, useCRC, 500));
+        return controllers.back().get();
+    };
+
+    for (auto i = 0; i < intOption(parser, "arducor-udp"); ++i) {
+        auto controller = addController(QString("Sim UDP %1").arg(i + 1));
+        QHostAddress address(nextAddress++);
+        auto transport = new sim::ArduCorUDPTransport(controller, conditions, &app);
+        if (!transport->bind(address, 10008)) {
+            out << "WARNING: arducor udp could not bind " << address.toString() << "\n";
+        } else {
+            out << "arducor udp " << address.toString() << "\n";
+        }
+    }
+
+    for (auto i = 0; i < intOption(parser, "arducor-http"); ++i) {
+        auto controller = addController(QString("Sim HTTP %1").arg(i + 1));
+        startServer("arducor http",
+                    quint16(intOption(parser, "arducor-http-port")),
+                    [controller](const sim::HTTPRequest& request) {
+                        // packets are sent as the path of the request, after /arduino/
+                        sim::HTTPResponse response;
+                        response.contentType = "text/plain";
+                        if (!request.path.startsWith("/arduino/")) {
+                            response.status = 404;
+                            return response;
+                        }
+                        auto packet = request.path.mid(QString("/arduino/").size());
+                        response.body = controller->handlePacket(packet).toUtf8();
+                        return response;
+                    });
+    }
+
+    for (auto i = 0; i < intOption(parser, "arducor-serial"); ++i) {
+        auto controller = addController(QString("Sim Serial %1").arg(i + 1));
+        auto transport = new sim::ArduCorSerialTransport(controller, conditions, &app);
+        if (!transport->open()) {
+            out << "WARNING: arducor serial could not open a pty\n";
+        } else {
+            out << "arducor serial " << transport->portPath() << "\n";
+        }
+    }
+    out.flush();
+
+    // report how many requests the HTTP devices have handled
+    QTimer statsTimer;
+    QObject::connect(&statsTimer, &QTimer::timeout, [&servers, &out]() {
+        std::uint64_t requests = 0u;
+        for (const auto& server : servers) {
+            requests += server->requestCount();
+        }
+        out << "http requests handled: " << requests << "\n";
+        out.flush();
+    });
+    statsTimer.start(10000);
+
+    return app.exec();
+}
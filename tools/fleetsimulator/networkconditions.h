@@ -0,0 +1,91 @@
+#ifndef SIM_NETWORK_CONDITIONS_H
+#define SIM_NETWORK_CONDITIONS_H
+
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+
+namespace sim {
+
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ *
+ * \brief The NetworkConditions struct describes how a simulated device responds to requests.
+ */
+struct NetworkConditions {
+    /// msec added before every response
+    int latency = 0;
+
+    /// up to this many random msec are added on top of the latency
+    int jitter = 0;
+
+    /// percent of packets that get dropped without a response, between 0 and 100
+    int lossPercent = 0;
+
+    /// max number of requests a device handles per second, 0 disables rate limiting.
+    int rateLimit = 0;
+};
+
+/*!
+ * \brief The ConditionedChannel class applies NetworkConditions to the traffic of a single device.
+ * Each device owns a channel, so rate limits apply per device, the same way real bridges and
+ * controllers limit their own traffic.
+ */
+class ConditionedChannel {
+public:
+    /// constructor
+    explicit ConditionedChannel(const NetworkConditions& conditions)
+        : mConditions{conditions},
+          mTokens{double(conditions.rateLimit)} {
+        mRefillTimer.start();
+    }
+
+    /// true if the next packet should be dropped
+    bool shouldDrop() const {
+        if (mConditions.lossPercent <= 0) {
+            return false;
+        }
+        return int(QRandomGenerator::global()->bounded(100)) < mConditions.lossPercent;
+    }
+
+    /// msec to wait before responding to the next packet
+    int delay() const {
+        auto delay = mConditions.latency;
+        if (mConditions.jitter > 0) {
+            delay += int(QRandomGenerator::global()->bounded(mConditions.jitter + 1));
+        }
+        return delay;
+    }
+
+    /// true if a request is allowed by the rate limit. Uses a token bucket that refills at
+    /// rateLimit tokens per second and holds at most one second of tokens.
+    bool allowRequest() {
+        if (mConditions.rateLimit <= 0) {
+            return true;
+        }
+        mTokens += double(mRefillTimer.restart()) * mConditions.rateLimit / 1000.0;
+        if (mTokens > mConditions.rateLimit) {
+            mTokens = mConditions.rateLimit;
+        }
+        if (mTokens < 1.0) {
+            return false;
+        }
+        mTokens -= 1.0;
+        return true;
+    }
+
+private:
+    /// conditions to apply
+    NetworkConditions mConditions;
+
+    /// tokens left in the rate limit's bucket
+    double mTokens;
+
+    /// tracks time since the bucket was last refilled
+    QElapsedTimer mRefillTimer;
+};
+
+} // namespace sim
+
+#endif // SIM_NETWORK_CONDITIONS_H
@@ -0,0 +1,324 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include "simarducor.h"
+
+#include <QNetworkDatagram>
+#include <QTimer>
+#include <fcntl.h>
+#include <pty.h>
+#include <set>
+#include <termios.h>
+#include <unistd.h>
+
+namespace sim {
+
+namespace {
+
+/// identifier that starts discovery packets
+const QString kDiscoveryPacketIdentifier = QString("DISCOVERY_PACKET");
+
+/// header of a state update request and its response
+const int kStateUpdateRequest = 6;
+
+/// header of a custom array request and its response
+const int kCustomArrayUpdateRequest = 7;
+
+/// integer value of EArduinoHardwareType::lightStrip
+const int kLightStripHardwareType = 3;
+
+/// max number of colors in a custom palette
+const int kMaxCustomColors = 10;
+
+/// splits a message into its integer values
+std::vector<int> messageValues(const QString& message) {
+    std::vector<int> values;
+    for (const auto& value : message.split(',')) {
+        values.push_back(value.trimmed().toInt());
+    }
+    return values;
+}
+
+} // namespace
+
+ArduCorControllerSim::ArduCorControllerSim(const QString& name,
+                                           int lightCount,
+                                           bool useCRC,
+                                           int maxPacketSize)
+    : mName{name},
+      mUseCRC{useCRC},
+      mMaxPacketSize{maxPacketSize},
+      mLights(std::size_t(lightCount)) {}
+
+QString ArduCorControllerSim::handlePacket(const QString& packet) {
+    auto payload = packet.trimmed();
+    if (payload.contains(kDiscoveryPacketIdentifier)) {
+        return discoveryPacket();
+    }
+
+    if (payload.contains('#')) {
+        auto content = payload.section('#', 0, 0);
+        auto givenCRC = payload.section('#', 1, 1).remove('&').toUInt();
+        if (mUseCRC && givenCRC != mCRC.calculate(content)) {
+            // ArduCor ignores packets that fail their CRC check.
+            return QString();
+        }
+        payload = content;
+    }
+
+    QString response;
+    std::set<std::size_t> changedLights;
+    for (const auto& message : payload.split('&')) {
+        if (message.isEmpty()) {
+            continue;
+        }
+        auto values = messageValues(message);
+        if (values.size() < 2) {
+            continue;
+        }
+        auto header = values[0];
+        auto index = std::size_t(values[1]);
+        if (index > mLights.size()) {
+            continue;
+        }
+
+        // an index of 0 targets every light on the controller
+        auto first = index == 0u ? 1u : index;
+        auto last = index == 0u ? mLights.size() : index;
+        for (auto i = first; i <= last; ++i) {
+            if (header == kStateUpdateRequest) {
+                response += stateMessage(i);
+            } else if (header == kCustomArrayUpdateRequest) {
+                response += customArrayMessage(i);
+            } else {
+                applyMessage(values, mLights[i - 1]);
+                changedLights.insert(i);
+            }
+        }
+    }
+
+    // like the hardware, respond to commands with the new state of the lights they changed.
+    for (auto index : changedLights) {
+        response += stateMessage(index);
+    }
+    if (response.isEmpty()) {
+        return response;
+    }
+    return finishPacket(response);
+}
+
+QString ArduCorControllerSim::discoveryPacket() {
+    QString names;
+    for (auto i = 0u; i < mLights.size(); ++i) {
+        if (i != 0u) {
+            names += ",";
+        }
+        names += QString("%1 %2,%3,1")
+                     .arg(mName, QString::number(i + 1), QString::number(kLightStripHardwareType));
+    }
+    return QString("%1,3,4,%2,0,%3,%4@%5&")
+        .arg(kDiscoveryPacketIdentifier,
+             QString::number(int(mUseCRC)),
+             QString::number(mMaxPacketSize),
+             QString::number(mLights.size()),
+             names);
+}
+
+QString ArduCorControllerSim::stateMessage(std::size_t index) {
+    const auto& light = mLights[index - 1];
+    QStringList values;
+    values << QString::number(kStateUpdateRequest) << QString::number(index)
+           << QString::number(int(light.isOn)) << QString::number(1) << QString::number(light.red)
+           << QString::number(light.green) << QString::number(light.blue)
+           << QString::number(light.routine) << QString::number(light.palette)
+           << QString::number(light.brightness) << QString::number(light.speed)
+           << QString::number(light.timeout) << QString::number(light.timeout);
+    return values.join(',') + "&";
+}
+
+QString ArduCorControllerSim::customArrayMessage(std::size_t index) {
+    const auto& light = mLights[index - 1];
+    QStringList values;
+    values << QString::number(kCustomArrayUpdateRequest) << QString::number(index)
+           << QString::number(light.customCount);
+    for (auto i = 0; i < light.customCount * 3; ++i) {
+        values << QString::number(light.customColors[std::size_t(i)]);
+    }
+    return values.join(',') + "&";
+}
+
+void ArduCorControllerSim::applyMessage(const std::vector<int>& message, ArduCorLightState& light) {
+    switch (message[0]) {
+        case 0: // onOffChange
+            if (message.size() > 2) {
+                light.isOn = message[2] != 0;
+            }
+            break;
+        case 1: // modeChange
+            if (message.size() > 2) {
+                light.routine = message[2];
+                std::size_t next = 3;
+                // single color routines send a color, multi color routines send a palette.
+                if (light.routine <= 5 && message.size() > 5) {
+                    light.red = message[3];
+                    light.green = message[4];
+                    light.blue = message[5];
+                    next = 6;
+                } else if (light.routine > 5 && message.size() > 3) {
+                    light.palette = message[3];
+                    next = 4;
+                }
+                if (light.routine != 0 && message.size() > next) {
+                    light.speed = message[next];
+                }
+                light.isOn = true;
+            }
+            break;
+        case 2: // customArrayColorChange
+            if (message.size() > 5 && message[2] >= 0 && message[2] < kMaxCustomColors) {
+                auto colorIndex = std::size_t(message[2]) * 3u;
+                light.customColors[colorIndex] = message[3];
+                light.customColors[colorIndex + 1] = message[4];
+                light.customColors[colorIndex + 2] = message[5];
+            }
+            break;
+        case 3: // brightnessChange
+            if (message.size() > 2) {
+                light.brightness = message[2];
+            }
+            break;
+        case 4: // customColorCountChange
+            if (message.size() > 2 && message[2] > 0 && message[2] <= kMaxCustomColors) {
+                light.customCount = message[2];
+            }
+            break;
+        case 5: // idleTimeoutChange
+            if (message.size() > 2) {
+                light.timeout = message[2];
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+QString ArduCorControllerSim::finishPacket(const QString& packet) {
+    if (!mUseCRC) {
+        return packet;
+    }
+    return packet + "#" + QString::number(mCRC.calculate(packet)) + "&";
+}
+
+//--------------------
+// UDP
+//--------------------
+
+ArduCorUDPTransport::ArduCorUDPTransport(ArduCorControllerSim* controller,
+                                         const NetworkConditions& conditions,
+                                         QObject* parent)
+    : QObject(parent),
+      mController{controller},
+      mSocket{new QUdpSocket(this)},
+      mChannel{conditions} {
+    connect(mSocket, SIGNAL(readyRead()), this, SLOT(readPendingDatagrams()));
+}
+
+bool ArduCorUDPTransport::bind(const QHostAddress& address, quint16 port) {
+    return mSocket->bind(address, port);
+}
+
+void ArduCorUDPTransport::readPendingDatagrams() {
+    while (mSocket->hasPendingDatagrams()) {
+        auto datagram = mSocket->receiveDatagram();
+        auto payload = QString::fromUtf8(datagram.data());
+        // a single datagram may contain multiple packets separated by ';'
+        for (const auto& packet : payload.split(';')) {
+            if (packet.isEmpty() || mChannel.shouldDrop() || !mChannel.allowRequest()) {
+                continue;
+            }
+            auto response = mController->handlePacket(packet).toUtf8();
+            if (response.isEmpty()) {
+                continue;
+            }
+            auto sender = datagram.senderAddress();
+            auto senderPort = quint16(datagram.senderPort());
+            QTimer::singleShot(mChannel.delay(), this, [this, response, sender, senderPort]() {
+                mSocket->writeDatagram(response, sender, senderPort);
+            });
+        }
+    }
+}
+
+//--------------------
+// Serial
+//--------------------
+
+ArduCorSerialTransport::ArduCorSerialTransport(ArduCorControllerSim* controller,
+                                               const NetworkConditions& conditions,
+                                               QObject* parent)
+    : QObject(parent),
+      mController{controller},
+      mChannel{conditions},
+      mMasterFD{-1},
+      mSlaveFD{-1},
+      mNotifier{nullptr} {}
+
+ArduCorSerialTransport::~ArduCorSerialTransport() {
+    if (mMasterFD >= 0) {
+        ::close(mMasterFD);
+    }
+    if (mSlaveFD >= 0) {
+        ::close(mSlaveFD);
+    }
+}
+
+bool ArduCorSerialTransport::open() {
+    char name[256];
+    if (openpty(&mMasterFD, &mSlaveFD, name, nullptr, nullptr) != 0) {
+        return false;
+    }
+    // raw mode, so packets pass through without line editing or echo
+    termios settings;
+    if (tcgetattr(mSlaveFD, &settings) == 0) {
+        cfmakeraw(&settings);
+        tcsetattr(mSlaveFD, TCSANOW, &settings);
+    }
+    fcntl(mMasterFD, F_SETFL, fcntl(mMasterFD, F_GETFL) | O_NONBLOCK);
+    mPortPath = QString::fromUtf8(name);
+
+    mNotifier = new QSocketNotifier(mMasterFD, QSocketNotifier::Read, this);
+    connect(mNotifier, SIGNAL(activated(int)), this, SLOT(handleReadyRead()));
+    return true;
+}
+
+void ArduCorSerialTransport::handleReadyRead() {
+    char data[512];
+    ssize_t size;
+    while ((size = ::read(mMasterFD, data, sizeof(data))) > 0) {
+        mBuffer += QString::fromUtf8(data, int(size));
+    }
+
+    // packets sent over serial are terminated by a ';'
+    auto end = mBuffer.indexOf(';');
+    while (end >= 0) {
+        auto packet = mBuffer.left(end);
+        mBuffer.remove(0, end + 1);
+        end = mBuffer.indexOf(';');
+        if (packet.isEmpty() || mChannel.shouldDrop() || !mChannel.allowRequest()) {
+            continue;
+        }
+        auto response = mController->handlePacket(packet);
+        if (response.isEmpty()) {
+            continue;
+        }
+        auto bytes = (response + ";").toUtf8();
+        QTimer::singleShot(mChannel.delay(), this, [this, bytes]() {
+            ::write(mMasterFD, bytes.constData(), std::size_t(bytes.size()));
+        });
+    }
+}
+
+} // namespace sim
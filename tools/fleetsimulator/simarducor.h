@@ -0,0 +1,192 @@
+#ifndef SIM_ARDUCOR_H
+#define SIM_ARDUCOR_H
+
+#include <QObject>
+#include <QSocketNotifier>
+#include <QUdpSocket>
+#include <vector>
+
+#include "comm/arducor/crccalculator.h"
+#include "networkconditions.h"
+
+namespace sim {
+
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ *
+ * \brief The ArduCorLightState struct is the state of a single light on a simulated ArduCor
+ * controller. It stores the same values that ArduCor sends in a state update packet.
+ */
+struct ArduCorLightState {
+    /// true if on
+    bool isOn = true;
+
+    /// red value of the main color
+    int red = 255;
+
+    /// green value of the main color
+    int green = 127;
+
+    /// blue value of the main color
+    int blue = 0;
+
+    /// integer value of the ERoutine
+    int routine = 0;
+
+    /// integer value of the EPalette
+    int palette = 1;
+
+    /// brightness, between 0 and 100
+    int brightness = 80;
+
+    /// speed of the routine
+    int speed = 200;
+
+    /// minutes of idle time before the light turns off, 0 disables the timeout.
+    int timeout = 120;
+
+    /// number of colors used in the custom palette
+    int customCount = 2;
+
+    /// colors of the custom palette, stored as r,g,b triplets
+    std::vector<int> customColors = std::vector<int>(30, 0);
+};
+
+/*!
+ * \brief The ArduCorControllerSim class simulates the packet handling of an ArduCor controller.
+ * It answers discovery packets, applies commands to its lights, and answers state update and
+ * custom array requests. It has no transport of its own, so the same controller logic is shared by
+ * the UDP, HTTP, and serial transports.
+ */
+class ArduCorControllerSim {
+public:
+    /// constructor
+    ArduCorControllerSim(const QString& name, int lightCount, bool useCRC, int maxPacketSize);
+
+    /// name of the controller
+    const QString& name() const noexcept { return mName; }
+
+    /*!
+     * \brief handlePacket handles a packet sent to the controller. Packets may contain multiple
+     * messages and an optional CRC.
+     *
+     * \param packet packet received by the controller
+     * \return the response to the packet, empty if the controller doesn't respond.
+     */
+    QString handlePacket(const QString& packet);
+
+private:
+    /// response to a discovery packet
+    QString discoveryPacket();
+
+    /// state update message for a single light, index starts at 1.
+    QString stateMessage(std::size_t index);
+
+    /// custom array message for a single light, index starts at 1.
+    QString customArrayMessage(std::size_t index);
+
+    /// applies a single message that changes the state of a light
+    void applyMessage(const std::vector<int>& message, ArduCorLightState& light);
+
+    /// adds a CRC to the end of a packet, if the controller uses CRCs.
+    QString finishPacket(const QString& packet);
+
+    /// name of the controller
+    QString mName;
+
+    /// true if packets include CRCs
+    bool mUseCRC;
+
+    /// largest packet the controller accepts
+    int mMaxPacketSize;
+
+    /// state of each light
+    std::vector<ArduCorLightState> mLights;
+
+    /// computes CRCs
+    CRCCalculator mCRC;
+};
+
+/*!
+ * \brief The ArduCorUDPTransport class serves a simulated ArduCor controller over UDP. Each
+ * controller binds its own address, since Corluma identifies UDP controllers by their IP address.
+ */
+class ArduCorUDPTransport : public QObject {
+    Q_OBJECT
+public:
+    /// constructor
+    ArduCorUDPTransport(ArduCorControllerSim* controller,
+                        const NetworkConditions& conditions,
+                        QObject* parent);
+
+    /// binds the socket, returns false if the address and port could not be bound.
+    bool bind(const QHostAddress& address, quint16 port);
+
+private slots:
+    /// handles incoming datagrams
+    void readPendingDatagrams();
+
+private:
+    /// simulated controller
+    ArduCorControllerSim* mController;
+
+    /// socket for the controller
+    QUdpSocket* mSocket;
+
+    /// applies the network conditions
+    ConditionedChannel mChannel;
+};
+
+/*!
+ * \brief The ArduCorSerialTransport class serves a simulated ArduCor controller over a pseudo
+ * terminal. The slave side of the pty acts as the controller's serial port.
+ */
+class ArduCorSerialTransport : public QObject {
+    Q_OBJECT
+public:
+    /// constructor
+    ArduCorSerialTransport(ArduCorControllerSim* controller,
+                           const NetworkConditions& conditions,
+                           QObject* parent);
+
+    /// destructor
+    ~ArduCorSerialTransport();
+
+    /// opens the pty, returns false if it could not be opened.
+    bool open();
+
+    /// path to the slave side of the pty, which clients open as a serial port.
+    const QString& portPath() const noexcept { return mPortPath; }
+
+private slots:
+    /// handles data written to the serial port
+    void handleReadyRead();
+
+private:
+    /// simulated controller
+    ArduCorControllerSim* mController;
+
+    /// applies the network conditions
+    ConditionedChannel mChannel;
+
+    /// file descriptor for the master side of the pty
+    int mMasterFD;
+
+    /// file descriptor for the slave side of the pty, kept open so the pty stays alive.
+    int mSlaveFD;
+
+    /// path to the slave side of the pty
+    QString mPortPath;
+
+    /// signals when the master side of the pty has data
+    QSocketNotifier* mNotifier;
+
+    /// data received but not yet terminated by a ';'
+    QString mBuffer;
+};
+
+} // namespace sim
+
+#endif // SIM_ARDUCOR_H
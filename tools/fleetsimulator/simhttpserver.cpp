@@ -0,0 +1,151 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include "simhttpserver.h"
+
+#include <QPointer>
+#include <QTimer>
+#include <QUrl>
+
+namespace sim {
+
+namespace {
+
+/// reason phrase for the status codes used by the simulated devices
+QByteArray reasonPhrase(int status) {
+    switch (status) {
+        case 200:
+            return "OK";
+        case 204:
+            return "No Content";
+        case 400:
+            return "Bad Request";
+        case 401:
+            return "Unauthorized";
+        case 404:
+            return "Not Found";
+        case 429:
+            return "Too Many Requests";
+        default:
+            return "Unknown";
+    }
+}
+
+} // namespace
+
+HTTPServer::HTTPServer(const NetworkConditions& conditions, Handler handler, QObject* parent)
+    : QObject(parent),
+      mServer{new QTcpServer(this)},
+      mChannel{conditions},
+      mHandler{std::move(handler)},
+      mRequestCount{0u} {
+    connect(mServer, SIGNAL(newConnection()), this, SLOT(handleNewConnection()));
+}
+
+bool HTTPServer::listen(const QHostAddress& address, quint16 port) {
+    return mServer->listen(address, port);
+}
+
+void HTTPServer::handleNewConnection() {
+    while (mServer->hasPendingConnections()) {
+        auto socket = mServer->nextPendingConnection();
+        mBuffers.emplace(socket, QByteArray());
+        connect(socket, SIGNAL(readyRead()), this, SLOT(handleReadyRead()));
+        connect(socket, SIGNAL(disconnected()), this, SLOT(handleDisconnected()));
+    }
+}
+
+void HTTPServer::handleReadyRead() {
+    auto socket = qobject_cast<QTcpSocket*>(sender());
+    if (socket == nullptr) {
+        return;
+    }
+    mBuffers[socket].append(socket->readAll());
+    processBuffer(socket);
+}
+
+void HTTPServer::handleDisconnected() {
+    auto socket = qobject_cast<QTcpSocket*>(sender());
+    if (socket == nullptr) {
+        return;
+    }
+    mBuffers.erase(socket);
+    socket->deleteLater();
+}
+
+void HTTPServer::processBuffer(QTcpSocket* socket) {
+    auto& buffer = mBuffers[socket];
+    while (true) {
+        auto headerEnd = buffer.indexOf("\r\n\r\n");
+        if (headerEnd < 0) {
+            return;
+        }
+
+        auto lines = buffer.left(headerEnd).split('\n');
+        auto requestLine = lines[0].trimmed().split(' ');
+        int contentLength = 0;
+        for (const auto& line : lines) {
+            auto separator = line.indexOf(':');
+            if (separator > 0
+                && line.left(separator).trimmed().toLower() == QByteArray("content-length")) {
+                contentLength = line.mid(separator + 1).trimmed().toInt();
+            }
+        }
+
+        auto bodyStart = headerEnd + 4;
+        if (buffer.size() < bodyStart + contentLength) {
+            // wait for the rest of the body
+            return;
+        }
+
+        HTTPRequest request;
+        if (requestLine.size() >= 2) {
+            request.method = QString::fromUtf8(requestLine[0]);
+            request.path = QUrl::fromPercentEncoding(requestLine[1]);
+        }
+        request.body = buffer.mid(bodyStart, contentLength);
+        buffer.remove(0, bodyStart + contentLength);
+        ++mRequestCount;
+
+        if (mChannel.shouldDrop()) {
+            socket->abort();
+            return;
+        }
+
+        HTTPResponse response;
+        if (!mChannel.allowRequest()) {
+            response.status = 429;
+        } else if (requestLine.size() < 2) {
+            response.status = 400;
+        } else {
+            response = mHandler(request);
+        }
+        respond(socket, response);
+    }
+}
+
+void HTTPServer::respond(QTcpSocket* socket, const HTTPResponse& response) {
+    QByteArray data = "HTTP/1.1 " + QByteArray::number(response.status) + " "
+                      + reasonPhrase(response.status) + "\r\n";
+    data += "Content-Type: " + response.contentType + "\r\n";
+    data += "Content-Length: " + QByteArray::number(response.body.size()) + "\r\n";
+    data += "Connection: keep-alive\r\n\r\n";
+    data += response.body;
+
+    auto delay = mChannel.delay();
+    if (delay <= 0) {
+        socket->write(data);
+        return;
+    }
+    QPointer<QTcpSocket> guardedSocket(socket);
+    QTimer::singleShot(delay, this, [guardedSocket, data]() {
+        if (!guardedSocket.isNull()) {
+            guardedSocket->write(data);
+        }
+    });
+}
+
+} // namespace sim
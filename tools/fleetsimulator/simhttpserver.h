@@ -0,0 +1,100 @@
+#ifndef SIM_HTTP_SERVER_H
+#define SIM_HTTP_SERVER_H
+
+#include <QByteArray>
+#include <QHostAddress>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <functional>
+#include <unordered_map>
+
+#include "networkconditions.h"
+
+namespace sim {
+
+/// a parsed HTTP request
+struct HTTPRequest {
+    /// method of the request, such as GET or PUT
+    QString method;
+
+    /// path of the request, percent decoded
+    QString path;
+
+    /// body of the request
+    QByteArray body;
+};
+
+/// a HTTP response
+struct HTTPResponse {
+    /// status code
+    int status = 200;
+
+    /// value of the Content-Type header
+    QByteArray contentType = "application/json";
+
+    /// body of the response
+    QByteArray body;
+};
+
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ *
+ * \brief The HTTPServer class is a minimal HTTP/1.1 server for simulated devices. It listens on a
+ * single address and port, parses requests, and hands them to a handler. Connections are kept
+ * alive between requests. Responses are delayed, dropped, or rate limited according to the
+ * server's NetworkConditions. A dropped request closes its connection, which the client sees as a
+ * network error.
+ */
+class HTTPServer : public QObject {
+    Q_OBJECT
+public:
+    /// function that turns a request into a response
+    using Handler = std::function<HTTPResponse(const HTTPRequest&)>;
+
+    /// constructor
+    HTTPServer(const NetworkConditions& conditions, Handler handler, QObject* parent);
+
+    /// starts listening, returns false if the address and port could not be bound.
+    bool listen(const QHostAddress& address, quint16 port);
+
+    /// number of requests handled
+    std::uint64_t requestCount() const noexcept { return mRequestCount; }
+
+private slots:
+    /// handles a new connection
+    void handleNewConnection();
+
+    /// handles data available on a connection
+    void handleReadyRead();
+
+    /// handles a connection closing
+    void handleDisconnected();
+
+private:
+    /// parses as many complete requests as possible out of a connection's buffer
+    void processBuffer(QTcpSocket* socket);
+
+    /// writes the response to the socket after the channel's delay
+    void respond(QTcpSocket* socket, const HTTPResponse& response);
+
+    /// server accepting connections
+    QTcpServer* mServer;
+
+    /// applies the network conditions
+    ConditionedChannel mChannel;
+
+    /// handles requests
+    Handler mHandler;
+
+    /// partially received data for each connection
+    std::unordered_map<QTcpSocket*, QByteArray> mBuffers;
+
+    /// number of requests handled
+    std::uint64_t mRequestCount;
+};
+
+} // namespace sim
+
+#endif // SIM_HTTP_SERVER_H
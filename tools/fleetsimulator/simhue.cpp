@@ -0,0 +1,294 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include "simhue.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+
+namespace sim {
+
+namespace {
+
+/// number of lights in each simulated room
+const int kLightsPerRoom = 10;
+
+/// username handed out to any client that asks for one
+const QString kUsername = QString("fleetsimulatoruser");
+
+/// builds a response from a JSON value
+HTTPResponse jsonResponse(const QJsonDocument& document) {
+    HTTPResponse response;
+    response.body = document.toJson(QJsonDocument::Compact);
+    return response;
+}
+
+/// builds a hue style error response
+HTTPResponse errorResponse(int type, const QString& address, const QString& description) {
+    QJsonObject error;
+    error["type"] = type;
+    error["address"] = address;
+    error["description"] = description;
+    QJsonObject wrapper;
+    wrapper["error"] = error;
+    return jsonResponse(QJsonDocument(QJsonArray{wrapper}));
+}
+
+/// builds a hue style success message
+QJsonObject successMessage(const QString& key, const QJsonValue& value) {
+    QJsonObject success;
+    success[key] = value;
+    QJsonObject wrapper;
+    wrapper["success"] = success;
+    return wrapper;
+}
+
+} // namespace
+
+HueBridgeSim::HueBridgeSim(int bridgeIndex, int lightCount, const QString& IP) {
+    auto bridgeID = QString("001788fffe%1").arg(bridgeIndex, 6, 16, QChar('0'));
+    mConfig["name"] = QString("Simulated Bridge %1").arg(bridgeIndex);
+    mConfig["bridgeid"] = bridgeID.toUpper();
+    mConfig["modelid"] = "BSB002";
+    mConfig["apiversion"] = "1.35.0";
+    mConfig["swversion"] = "1935144040";
+    mConfig["mac"] = QString("00:17:88:%1:%2:%3")
+                         .arg((bridgeIndex >> 16) & 0xFF, 2, 16, QChar('0'))
+                         .arg((bridgeIndex >> 8) & 0xFF, 2, 16, QChar('0'))
+                         .arg(bridgeIndex & 0xFF, 2, 16, QChar('0'));
+    mConfig["ipaddress"] = IP;
+
+    for (auto i = 1; i <= lightCount; ++i) {
+        QJsonObject state;
+        state["on"] = true;
+        state["bri"] = 254;
+        state["hue"] = (i * 6553) % 65536;
+        state["sat"] = 254;
+        state["ct"] = 366;
+        state["xy"] = QJsonArray{0.3, 0.3};
+        state["alert"] = "none";
+        state["effect"] = "none";
+        state["colormode"] = "hs";
+        state["reachable"] = true;
+
+        QJsonObject light;
+        light["state"] = state;
+        light["type"] = "Extended color light";
+        light["name"] = QString("Sim Hue %1-%2").arg(bridgeIndex).arg(i);
+        light["modelid"] = "LCT015";
+        light["manufacturername"] = "Signify Netherlands B.V.";
+        light["productname"] = "Hue color lamp";
+        light["swversion"] = "1.50.2_r30933";
+        light["uniqueid"] = QString("00:17:88:01:%1:%2:%3:%4-0b")
+                                .arg(bridgeIndex & 0xFF, 2, 16, QChar('0'))
+                                .arg((i >> 16) & 0xFF, 2, 16, QChar('0'))
+                                .arg((i >> 8) & 0xFF, 2, 16, QChar('0'))
+                                .arg(i & 0xFF, 2, 16, QChar('0'));
+        mLights[QString::number(i)] = light;
+
+        // add the light to its room, creating the room if needed
+        auto roomKey = QString::number((i - 1) / kLightsPerRoom + 1);
+        auto room = mGroups[roomKey].toObject();
+        if (room.isEmpty()) {
+            room["name"] = QString("Sim Room %1-%2").arg(bridgeIndex).arg(roomKey);
+            room["type"] = "Room";
+            room["class"] = "Living room";
+            room["action"] = state;
+        }
+        auto roomLights = room["lights"].toArray();
+        roomLights.append(QString::number(i));
+        room["lights"] = roomLights;
+        mGroups[roomKey] = room;
+    }
+}
+
+HTTPResponse HueBridgeSim::handleRequest(const HTTPRequest& request) {
+    QStringList path;
+    for (const auto& piece : request.path.split('/')) {
+        if (!piece.isEmpty()) {
+            path.append(piece);
+        }
+    }
+    if (path.isEmpty() || path[0] != "api") {
+        return errorResponse(4, request.path, "method, " + request.method + ", not available");
+    }
+
+    // creating a user, any device type is accepted without pressing the link button.
+    if (path.size() == 1 && request.method == "POST") {
+        return jsonResponse(QJsonDocument(QJsonArray{successMessage("username", kUsername)}));
+    }
+
+    // unauthorized config request, used to identify the bridge
+    if (path.size() == 2 && path[1] == "config") {
+        return jsonResponse(QJsonDocument(mConfig));
+    }
+
+    if (path.size() >= 2) {
+        return handleAuthorizedRequest(request, path.mid(2));
+    }
+    return errorResponse(1, request.path, "unauthorized user");
+}
+
+HTTPResponse HueBridgeSim::handleAuthorizedRequest(const HTTPRequest& request,
+                                                   const QStringList& path) {
+    auto body = QJsonDocument::fromJson(request.body).object();
+    if (path.isEmpty()) {
+        QJsonObject full;
+        full["config"] = mConfig;
+        full["lights"] = mLights;
+        full["groups"] = mGroups;
+        full["schedules"] = mSchedules;
+        return jsonResponse(QJsonDocument(full));
+    }
+
+    const auto& resource = path[0];
+    if (request.method == "GET") {
+        QJsonObject collection;
+        if (resource == "config") {
+            collection = mConfig;
+        } else if (resource == "lights") {
+            collection = mLights;
+        } else if (resource == "groups") {
+            collection = mGroups;
+        } else if (resource == "schedules") {
+            collection = mSchedules;
+        } else {
+            return errorResponse(3, request.path, "resource not available");
+        }
+        if (path.size() == 1) {
+            return jsonResponse(QJsonDocument(collection));
+        }
+        if (!collection.contains(path[1])) {
+            return errorResponse(3, request.path, "resource not available");
+        }
+        return jsonResponse(QJsonDocument(collection[path[1]].toObject()));
+    }
+
+    if (request.method == "PUT") {
+        // light state
+        if (resource == "lights" && path.size() == 3 && path[2] == "state") {
+            if (!mLights.contains(path[1])) {
+                return errorResponse(3, request.path, "resource not available");
+            }
+            return jsonResponse(QJsonDocument(applyLightState(path[1], body)));
+        }
+        // group action, applied to every light in the group. group 0 is all lights.
+        if (resource == "groups" && path.size() == 3 && path[2] == "action") {
+            QJsonArray lights;
+            if (path[1] == "0") {
+                for (const auto& key : mLights.keys()) {
+                    lights.append(key);
+                }
+            } else if (mGroups.contains(path[1])) {
+                lights = mGroups[path[1]].toObject()["lights"].toArray();
+            } else {
+                return errorResponse(3, request.path, "resource not available");
+            }
+            for (const auto& light : lights) {
+                applyLightState(light.toString(), body);
+            }
+            QJsonArray success;
+            for (const auto& key : body.keys()) {
+                success.append(
+                    successMessage("/groups/" + path[1] + "/action/" + key, body[key]));
+            }
+            return jsonResponse(QJsonDocument(success));
+        }
+        // renaming or editing lights, groups, and schedules
+        if (path.size() == 2) {
+            QJsonObject* collection = nullptr;
+            if (resource == "lights") {
+                collection = &mLights;
+            } else if (resource == "groups") {
+                collection = &mGroups;
+            } else if (resource == "schedules") {
+                collection = &mSchedules;
+            }
+            if (collection != nullptr && collection->contains(path[1])) {
+                auto object = (*collection)[path[1]].toObject();
+                QJsonArray success;
+                for (const auto& key : body.keys()) {
+                    object[key] = body[key];
+                    success.append(
+                        successMessage("/" + resource + "/" + path[1] + "/" + key, body[key]));
+                }
+                (*collection)[path[1]] = object;
+                return jsonResponse(QJsonDocument(success));
+            }
+        }
+        return errorResponse(3, request.path, "resource not available");
+    }
+
+    if (request.method == "POST" && path.size() == 1) {
+        QString key;
+        if (resource == "groups") {
+            key = addResource(mGroups, body);
+        } else if (resource == "schedules") {
+            key = addResource(mSchedules, body);
+        } else if (resource == "lights") {
+            // searching for new lights never finds any
+            return jsonResponse(
+                QJsonDocument(QJsonArray{successMessage("/lights", "Searching for new devices")}));
+        } else {
+            return errorResponse(3, request.path, "resource not available");
+        }
+        return jsonResponse(QJsonDocument(QJsonArray{successMessage("id", key)}));
+    }
+
+    if (request.method == "DELETE" && path.size() == 2) {
+        QJsonObject* collection = nullptr;
+        if (resource == "lights") {
+            collection = &mLights;
+        } else if (resource == "groups") {
+            collection = &mGroups;
+        } else if (resource == "schedules") {
+            collection = &mSchedules;
+        }
+        if (collection != nullptr && collection->contains(path[1])) {
+            collection->remove(path[1]);
+            return jsonResponse(QJsonDocument(
+                QJsonArray{QJsonObject{{"success", "/" + resource + "/" + path[1] + " deleted"}}}));
+        }
+        return errorResponse(3, request.path, "resource not available");
+    }
+
+    return errorResponse(4, request.path, "method, " + request.method + ", not available");
+}
+
+QJsonArray HueBridgeSim::applyLightState(const QString& lightKey, const QJsonObject& state) {
+    QJsonArray success;
+    auto light = mLights[lightKey].toObject();
+    auto lightState = light["state"].toObject();
+    for (const auto& key : state.keys()) {
+        if (key == "transitiontime") {
+            continue;
+        }
+        lightState[key] = state[key];
+        if (key == "hue" || key == "sat") {
+            lightState["colormode"] = "hs";
+        } else if (key == "ct") {
+            lightState["colormode"] = "ct";
+        } else if (key == "xy") {
+            lightState["colormode"] = "xy";
+        }
+        success.append(successMessage("/lights/" + lightKey + "/state/" + key, state[key]));
+    }
+    light["state"] = lightState;
+    mLights[lightKey] = light;
+    return success;
+}
+
+QString HueBridgeSim::addResource(QJsonObject& collection, const QJsonObject& resource) {
+    auto index = 1;
+    while (collection.contains(QString::number(index))) {
+        ++index;
+    }
+    auto key = QString::number(index);
+    collection[key] = resource;
+    return key;
+}
+
+} // namespace sim
@@ -0,0 +1,54 @@
+#ifndef SIM_HUE_H
+#define SIM_HUE_H
+
+#include <QJsonArray>
+#include <QJsonObject>
+
+#include "simhttpserver.h"
+
+namespace sim {
+
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ *
+ * \brief The HueBridgeSim class simulates the REST API of a Hue bridge. It serves the bridge's
+ * config, lights, groups, and schedules, accepts any username, and applies state changes sent to
+ * lights and groups. Every light is an extended color light, and the lights are split into rooms
+ * of up to ten lights each.
+ */
+class HueBridgeSim {
+public:
+    /// constructor
+    HueBridgeSim(int bridgeIndex, int lightCount, const QString& IP);
+
+    /// handles a request sent to the bridge
+    HTTPResponse handleRequest(const HTTPRequest& request);
+
+private:
+    /// handles requests made with a username, path is everything after the username.
+    HTTPResponse handleAuthorizedRequest(const HTTPRequest& request, const QStringList& path);
+
+    /// applies a state change to a light, returns the success messages for the response.
+    QJsonArray applyLightState(const QString& lightKey, const QJsonObject& state);
+
+    /// adds a resource to a collection, such as a schedule or group, and returns its key.
+    QString addResource(QJsonObject& collection, const QJsonObject& resource);
+
+    /// config of the bridge
+    QJsonObject mConfig;
+
+    /// lights, keyed by their index on the bridge
+    QJsonObject mLights;
+
+    /// groups, keyed by their index on the bridge
+    QJsonObject mGroups;
+
+    /// schedules, keyed by their index on the bridge
+    QJsonObject mSchedules;
+};
+
+} // namespace sim
+
+#endif // SIM_HUE_H
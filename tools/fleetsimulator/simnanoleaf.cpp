@@ -0,0 +1,253 @@
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ */
+
+#include "simnanoleaf.h"
+
+#include <QJsonDocument>
+
+namespace sim {
+
+namespace {
+
+/// auth token handed out to any client that asks for one
+const QString kAuthToken = QString("fleetSimulatorAuthToken0000000001");
+
+/// length of the side of a triangle panel
+const int kSideLength = 150;
+
+/// builds a response from a JSON value
+HTTPResponse jsonResponse(const QJsonDocument& document) {
+    HTTPResponse response;
+    response.body = document.toJson(QJsonDocument::Compact);
+    return response;
+}
+
+/// builds an empty response with a status code
+HTTPResponse statusResponse(int status) {
+    HTTPResponse response;
+    response.status = status;
+    return response;
+}
+
+/// builds a value object in the format nanoleaf uses for its state
+QJsonObject rangeValue(int value, int min, int max) {
+    QJsonObject object;
+    object["value"] = value;
+    object["min"] = min;
+    object["max"] = max;
+    return object;
+}
+
+/// builds a simple effect
+QJsonObject makeEffect(const QString& name,
+                       const QString& animType,
+                       const std::vector<int>& hues) {
+    QJsonArray palette;
+    for (auto hue : hues) {
+        QJsonObject color;
+        color["hue"] = hue;
+        color["saturation"] = 100;
+        color["brightness"] = 100;
+        palette.append(color);
+    }
+    QJsonObject effect;
+    effect["animName"] = name;
+    effect["animType"] = animType;
+    effect["colorType"] = "HSB";
+    effect["palette"] = palette;
+    effect["transTime"] = QJsonObject{{"minValue", 25}, {"maxValue", 100}};
+    effect["delayTime"] = QJsonObject{{"minValue", 25}, {"maxValue", 100}};
+    effect["loop"] = true;
+    effect["version"] = "1.0";
+    return effect;
+}
+
+} // namespace
+
+NanoleafSim::NanoleafSim(int controllerIndex, int panelCount, int effectCount) {
+    mInfo["name"] = QString("Sim Nanoleaf %1").arg(controllerIndex);
+    mInfo["serialNo"] = QString("S%1").arg(controllerIndex, 11, 10, QChar('0'));
+    mInfo["manufacturer"] = "Nanoleaf";
+    mInfo["firmwareVersion"] = "3.3.4";
+    mInfo["model"] = "NL22";
+
+    mState["on"] = QJsonObject{{"value", true}};
+    mState["brightness"] = rangeValue(100, 0, 100);
+    mState["hue"] = rangeValue(0, 0, 360);
+    mState["sat"] = rangeValue(0, 0, 100);
+    mState["ct"] = rangeValue(4000, 1200, 6500);
+    mState["colorMode"] = "effect";
+
+    mEffects.append(makeEffect("Flames", "random", {0, 20, 40}));
+    mEffects.append(makeEffect("Forest", "wheel", {90, 120, 150}));
+    mEffects.append(makeEffect("Northern Lights", "flow", {120, 180, 270}));
+    for (auto i = int(mEffects.size()); i < effectCount; ++i) {
+        // large libraries, for measuring the cost of syncing effects
+        mEffects.append(makeEffect(QString("Sim Effect %1").arg(i),
+                                   "random",
+                                   {(i * 37) % 360, (i * 71) % 360, (i * 113) % 360}));
+    }
+    mSelectedEffect = "Flames";
+
+    // lay the panels out in a row of alternating triangles
+    QJsonArray positionData;
+    for (auto i = 0; i < panelCount; ++i) {
+        QJsonObject panel;
+        panel["panelId"] = i + 1;
+        panel["x"] = i * kSideLength / 2;
+        panel["y"] = (i % 2) * kSideLength / 3;
+        panel["o"] = (i % 2) * 180;
+        panel["shapeType"] = 0;
+        positionData.append(panel);
+    }
+    QJsonObject layout;
+    layout["numPanels"] = panelCount;
+    layout["sideLength"] = kSideLength;
+    layout["positionData"] = positionData;
+    mPanelLayout["layout"] = layout;
+    mPanelLayout["globalOrientation"] = rangeValue(0, 0, 360);
+}
+
+HTTPResponse NanoleafSim::handleRequest(const HTTPRequest& request) {
+    QStringList path;
+    for (const auto& piece : request.path.split('/')) {
+        if (!piece.isEmpty()) {
+            path.append(piece);
+        }
+    }
+    if (path.size() < 3 || path[0] != "api" || path[1] != "v1") {
+        return statusResponse(404);
+    }
+
+    // pairing, the simulator behaves as if the power button was always held down.
+    if (path[2] == "new" && request.method == "POST") {
+        return jsonResponse(QJsonDocument(QJsonObject{{"auth_token", kAuthToken}}));
+    }
+    if (path[2] != kAuthToken) {
+        return statusResponse(401);
+    }
+
+    auto body = QJsonDocument::fromJson(request.body).object();
+    auto endpoint = path.mid(3);
+    if (endpoint.isEmpty()) {
+        return jsonResponse(QJsonDocument(fullInfo()));
+    }
+
+    if (endpoint[0] == "state") {
+        if (request.method == "GET") {
+            if (endpoint.size() == 2) {
+                return jsonResponse(QJsonDocument(mState[endpoint[1]].toObject()));
+            }
+            return jsonResponse(QJsonDocument(mState));
+        }
+        for (const auto& key : body.keys()) {
+            auto value = body[key].toObject();
+            if (!mState.contains(key) || !value.contains("value")) {
+                continue;
+            }
+            auto stateValue = mState[key].toObject();
+            stateValue["value"] = value["value"];
+            mState[key] = stateValue;
+            if (key == "hue" || key == "sat") {
+                mState["colorMode"] = "hs";
+            } else if (key == "ct") {
+                mState["colorMode"] = "ct";
+            }
+        }
+        return statusResponse(204);
+    }
+
+    if (endpoint[0] == "effects") {
+        if (request.method == "GET") {
+            if (endpoint.size() == 2 && endpoint[1] == "select") {
+                // a bare JSON string can't be stored in a QJsonDocument, so write it directly.
+                HTTPResponse response;
+                response.body = "\"" + mSelectedEffect.toUtf8() + "\"";
+                return response;
+            }
+            QJsonArray effectsList;
+            for (const auto& effect : mEffects) {
+                effectsList.append(effect.toObject().value("animName"));
+            }
+            return jsonResponse(QJsonDocument(
+                QJsonObject{{"select", mSelectedEffect}, {"effectsList", effectsList}}));
+        }
+        if (body["select"].isString()) {
+            mSelectedEffect = body["select"].toString();
+            mState["colorMode"] = "effect";
+            return statusResponse(204);
+        }
+        if (body["write"].isObject()) {
+            return handleEffectsWrite(body["write"].toObject());
+        }
+        return statusResponse(400);
+    }
+
+    if (endpoint[0] == "panelLayout" && request.method == "GET") {
+        if (endpoint.size() == 2) {
+            return jsonResponse(QJsonDocument(mPanelLayout[endpoint[1]].toObject()));
+        }
+        return jsonResponse(QJsonDocument(mPanelLayout));
+    }
+
+    if (endpoint[0] == "identify" && request.method == "PUT") {
+        return statusResponse(204);
+    }
+    return statusResponse(404);
+}
+
+QJsonObject NanoleafSim::fullInfo() {
+    QJsonArray effectsList;
+    for (const auto& effect : mEffects) {
+        effectsList.append(effect.toObject().value("animName"));
+    }
+    auto info = mInfo;
+    info["state"] = mState;
+    info["effects"] = QJsonObject{{"select", mSelectedEffect}, {"effectsList", effectsList}};
+    info["panelLayout"] = mPanelLayout;
+    info["rhythm"] = QJsonObject{{"rhythmConnected", false}};
+    return info;
+}
+
+HTTPResponse NanoleafSim::handleEffectsWrite(const QJsonObject& write) {
+    auto command = write["command"].toString();
+    if (command == "requestAll") {
+        return jsonResponse(QJsonDocument(QJsonObject{{"animations", mEffects}}));
+    }
+    if (command == "request") {
+        for (const auto& effect : mEffects) {
+            if (effect.toObject().value("animName") == write.value("animName")) {
+                return jsonResponse(QJsonDocument(effect.toObject()));
+            }
+        }
+        return statusResponse(404);
+    }
+    if (command == "add" || command == "display") {
+        // displayed effects without a name are temporary, and aren't stored.
+        if (command == "add" && write["animName"].isString()) {
+            auto effect = write;
+            effect.remove("command");
+            mEffects.append(effect);
+        }
+        if (write["animName"].isString()) {
+            mSelectedEffect = write["animName"].toString();
+        }
+        mState["colorMode"] = "effect";
+        return statusResponse(204);
+    }
+    if (command == "delete") {
+        for (auto i = 0; i < mEffects.size(); ++i) {
+            if (mEffects[i].toObject().value("animName") == write.value("animName")) {
+                mEffects.removeAt(i);
+                return statusResponse(204);
+            }
+        }
+        return statusResponse(404);
+    }
+    return statusResponse(400);
+}
+
+} // namespace sim
@@ -0,0 +1,53 @@
+#ifndef SIM_NANOLEAF_H
+#define SIM_NANOLEAF_H
+
+#include <QJsonArray>
+#include <QJsonObject>
+
+#include "simhttpserver.h"
+
+namespace sim {
+
+/*!
+ * \copyright
+ * Copyright (C) 2015 - 2020.
+ * Released under the GNU General Public License.
+ *
+ * \brief The NanoleafSim class simulates the REST API of a Nanoleaf controller. It hands out an
+ * auth token to any client, serves the controller's info, state, effects, and panel layout, and
+ * applies changes to the state and the selected effect.
+ */
+class NanoleafSim {
+public:
+    /// constructor, the first three effects are always the same, the rest are generated.
+    NanoleafSim(int controllerIndex, int panelCount, int effectCount);
+
+    /// handles a request sent to the controller
+    HTTPResponse handleRequest(const HTTPRequest& request);
+
+private:
+    /// full info of the controller, as returned by a GET on the root of the API
+    QJsonObject fullInfo();
+
+    /// handles a write command sent to the effects endpoint
+    HTTPResponse handleEffectsWrite(const QJsonObject& write);
+
+    /// info on the controller that doesn't change
+    QJsonObject mInfo;
+
+    /// state of the controller
+    QJsonObject mState;
+
+    /// name of the selected effect
+    QString mSelectedEffect;
+
+    /// effects stored on the controller
+    QJsonArray mEffects;
+
+    /// layout of the panels
+    QJsonObject mPanelLayout;
+};
+
+} // namespace sim
+
+#endif // SIM_NANOLEAF_H